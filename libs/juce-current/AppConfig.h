@@ -87,7 +87,9 @@
 /** Config: JUCE_JACK
     Enables JACK audio devices (Linux only).
 */
-#define JUCE_JACK 0
+#ifndef JUCE_JACK
+ #define JUCE_JACK 0
+#endif
 
 /** Config: JUCE_USE_ANDROID_OPENSLES
     Enables OpenSLES devices (Android only).
@@ -455,12 +457,16 @@
  #define JUCE_MODULE_AVAILABLE_juce_gui_extra  0
  #define JUCE_MODULE_AVAILABLE_juce_opengl     0
 
- #undef JUCE_ALSA
  #undef JUCE_PLUGINHOST_LADSPA
  #undef JUCE_PLUGINHOST_VST
- #define JUCE_ALSA              0
  #define JUCE_PLUGINHOST_LADSPA 0
  #define JUCE_PLUGINHOST_VST    0
+
+ // the headless runner still needs its audio devices
+ #if ! JUCE_PLUGIN_HEADLESS
+  #undef JUCE_ALSA
+  #define JUCE_ALSA             0
+ #endif
 #endif
 
 #endif // BUILD_JUCE_APPCONFIG_H_INCLUDED
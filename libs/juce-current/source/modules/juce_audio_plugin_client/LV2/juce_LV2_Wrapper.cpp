@@ -24,6 +24,15 @@
  #define JucePlugin_WantsLV2Latency 1
 #endif
 
+/** Enable DSP load output port, needs the 'load-telemetry' build option */
+#ifndef JucePlugin_WantsLV2DSPLoad
+ #define JucePlugin_WantsLV2DSPLoad JUCE_PLUGIN_LOAD_TELEMETRY
+#endif
+
+#if JucePlugin_WantsLV2DSPLoad && ! JUCE_PLUGIN_LOAD_TELEMETRY
+ #error "JucePlugin_WantsLV2DSPLoad requires JUCE_PLUGIN_LOAD_TELEMETRY"
+#endif
+
 /** Use non-parameter states */
 #ifndef JucePlugin_WantsLV2State
  #define JucePlugin_WantsLV2State 1
@@ -74,6 +83,7 @@
 #define JUCE_GUI_BASICS_INCLUDE_XHEADERS 1
 
 #include "../utility/juce_IncludeModuleHeaders.h"
+#include "JucePluginChannelRouter.h"
 
 #include <juce_audio_processors/format_types/juce_LegacyAudioParameter.cpp>
 
@@ -472,6 +482,9 @@ public:
         controlPortOffset += 1; // freewheel
 #if JucePlugin_WantsLV2Latency
         controlPortOffset += 1;
+#endif
+#if JucePlugin_WantsLV2DSPLoad
+        controlPortOffset += 1;
 #endif
         controlPortOffset += filter->getTotalNumInputChannels();
         controlPortOffset += filter->getTotalNumOutputChannels();
@@ -895,6 +908,9 @@ public:
 #if JucePlugin_WantsLV2Latency
         portLatency = nullptr;
 #endif
+#if JucePlugin_WantsLV2DSPLoad
+        portDSPLoad = nullptr;
+#endif
 
         portAudioIns.insertMultiple (0, nullptr, numInChans);
         portAudioOuts.insertMultiple (0, nullptr, numOutChans);
@@ -1032,6 +1048,14 @@ public:
         }
 #endif
 
+#if JucePlugin_WantsLV2DSPLoad
+        if (portId == index++)
+        {
+            portDSPLoad = (float*)dataLocation;
+            return;
+        }
+#endif
+
         for (int i=0; i < numInChans; ++i)
         {
             if (portId == index++)
@@ -1067,7 +1091,11 @@ public:
         filter->prepareToPlay (sampleRate, bufferSize);
         filter->setPlayConfigDetails (numInChans, numOutChans, sampleRate, bufferSize);
 
-        channels.calloc (numInChans + numOutChans);
+        channelRouter.prepare (numInChans, numOutChans, (int) bufferSize);
+
+       #if JUCE_PLUGIN_LOAD_TELEMETRY
+        loadMeter.prepare (sampleRate);
+       #endif
 
 #if (JucePlugin_WantsMidiInput || JucePlugin_ProducesMidiOutput)
         midiEvents.ensureSize (2048);
@@ -1081,18 +1109,33 @@ public:
 
         filter->releaseResources();
 
-        channels.free();
+        channelRouter.release();
     }
 
     void lv2Run (uint32 sampleCount)
     {
+       #if JUCE_PLUGIN_REALTIME_AUDIT
+        const JucePluginRealtimeAudit::ScopedAudioThread realtimeAuditScope;
+       #endif
+
         jassert (filter != nullptr);
 
+       #if JUCE_PLUGIN_LOAD_TELEMETRY
+        const JucePluginLoadTelemetry::ScopedMeasurement loadMeasurement (loadMeter, (int) sampleCount,
+                                                                          ! filter->isNonRealtime());
+       #endif
+
 #if JucePlugin_WantsLV2Latency
         if (portLatency != nullptr)
             *portLatency = filter->getLatencySamples();
 #endif
 
+#if JucePlugin_WantsLV2DSPLoad
+        // the load of the blocks before this one, in percent
+        if (portDSPLoad != nullptr)
+            *portDSPLoad = jmin (100.0f, loadMeter.getMeanLoad() * 100.0f);
+#endif
+
         if (portFreewheel != nullptr)
             filter->setNonRealtime (*portFreewheel >= 0.5f);
 
@@ -1140,18 +1183,6 @@ public:
             }
             else
             {
-                int i;
-                for (i = 0; i < numOutChans; ++i)
-                {
-                    channels[i] = portAudioOuts[i];
-
-                    if (i < numInChans && portAudioIns[i] != portAudioOuts[i])
-                        FloatVectorOperations::copy (portAudioOuts [i], portAudioIns[i], sampleCount);
-                }
-
-                for (; i < numInChans; ++i)
-                    channels [i] = portAudioIns[i];
-
 #if (JucePlugin_WantsMidiInput || JucePlugin_WantsLV2TimePos)
                 if (portEventsIn != nullptr)
                 {
@@ -1323,9 +1354,17 @@ public:
                     }
                 }
 #endif
+                if (auto* chans = channelRouter.beginBlock (portAudioIns.getRawDataPointer(),
+                                                            portAudioOuts.getRawDataPointer(), (int) sampleCount))
+                {
+                    filter->processBlock (*chans, midiEvents);
+                    channelRouter.endBlock ((int) sampleCount);
+                }
+                else
                 {
-                    AudioSampleBuffer chans (channels, jmax (numInChans, numOutChans), sampleCount);
-                    filter->processBlock (chans, midiEvents);
+                    for (int i = 0; i < numOutChans; ++i)
+                        if (portAudioOuts[i] != nullptr)
+                            zeromem (portAudioOuts[i], sizeof (float) * sampleCount);
                 }
             }
         }
@@ -1629,7 +1668,11 @@ private:
 #if ! JUCE_AUDIOPROCESSOR_NO_GUI
     std::unique_ptr<JuceLv2UIWrapper> ui;
 #endif
-    HeapBlock<float*> channels;
+    PluginChannelRouter<float> channelRouter;
+
+   #if JUCE_PLUGIN_LOAD_TELEMETRY
+    JucePluginLoadTelemetry::InstanceMeter loadMeter { JucePlugin_Name, "LV2" };
+   #endif
     MidiBuffer midiEvents;
     int numInChans, numOutChans;
 
@@ -1642,6 +1685,9 @@ private:
     float* portFreewheel;
 #if JucePlugin_WantsLV2Latency
     float* portLatency;
+#endif
+#if JucePlugin_WantsLV2DSPLoad
+    float* portDSPLoad;
 #endif
     Array<float*> portAudioIns;
     Array<float*> portAudioOuts;
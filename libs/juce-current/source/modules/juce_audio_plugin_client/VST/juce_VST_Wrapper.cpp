@@ -92,6 +92,7 @@ JUCE_END_IGNORE_WARNINGS_GCC_LIKE
 #define JUCE_GUI_BASICS_INCLUDE_XHEADERS 1
 
 #include "../utility/juce_IncludeModuleHeaders.h"
+#include "JucePluginChannelRouter.h"
 
 using namespace juce;
 
@@ -249,26 +250,6 @@ class JuceVSTWrapper  : public AudioProcessorListener,
                         private AudioProcessorParameter::Listener
 {
 private:
-    //==============================================================================
-    template <typename FloatType>
-    struct VstTempBuffers
-    {
-        VstTempBuffers() {}
-        ~VstTempBuffers() { release(); }
-
-        void release() noexcept
-        {
-            for (auto* c : tempChannels)
-                delete[] c;
-
-            tempChannels.clear();
-        }
-
-        HeapBlock<FloatType*> channels;
-        Array<FloatType*> tempChannels;  // see note in processReplacing()
-        juce::AudioBuffer<FloatType> processTempBuffer;
-    };
-
     /** Use the same names as the VST SDK. */
     struct VstOpCodeArguments
     {
@@ -366,7 +347,7 @@ public:
 
                 jassert (editorComp == nullptr);
 
-                deleteTempChannels();
+                releaseChannelRouters();
 
                 jassert (activePlugins.contains (this));
                 activePlugins.removeFirstMatchingValue (this);
@@ -390,8 +371,16 @@ public:
 
     template <typename FloatType>
     void internalProcessReplacing (FloatType** inputs, FloatType** outputs,
-                                   int32 numSamples, VstTempBuffers<FloatType>& tmpBuffers)
+                                   int32 numSamples, PluginChannelRouter<FloatType>& channelRouter)
     {
+       #if JUCE_PLUGIN_REALTIME_AUDIT
+        const JucePluginRealtimeAudit::ScopedAudioThread realtimeAuditScope;
+       #endif
+
+       #if JUCE_PLUGIN_LOAD_TELEMETRY
+        const JucePluginLoadTelemetry::ScopedMeasurement loadMeasurement (loadMeter, numSamples, ! processor->isNonRealtime());
+       #endif
+
         const bool isMidiEffect = processor->isMidiEffect();
 
         if (firstProcessCallback)
@@ -439,68 +428,30 @@ public:
             }
             else
             {
-                int i;
-                for (i = 0; i < numOut; ++i)
-                {
-                    auto* chan = tmpBuffers.tempChannels.getUnchecked(i);
-
-                    if (chan == nullptr)
-                    {
-                        chan = outputs[i];
-
-                        bool bufferPointerReusedForOtherChannels = false;
+                // the bus layout may have changed without the host suspending us first, the router
+                // was prepared for the largest one so this only rebinds
+                const bool layoutFits = channelRouter.setLayout (numIn, numOut);
+                jassert (layoutFits);
 
-                        for (int j = i; --j >= 0;)
-                        {
-                            if (outputs[j] == chan)
-                            {
-                                bufferPointerReusedForOtherChannels = true;
-                                break;
-                            }
-                        }
-
-                        // if some output channels are disabled, some hosts supply the same buffer
-                        // for multiple channels or supply a nullptr - this buggers up our method
-                        // of copying the inputs over the outputs, so we need to create unique temp
-                        // buffers in this case..
-                        if (bufferPointerReusedForOtherChannels || chan == nullptr)
-                        {
-                            chan = new FloatType [(size_t) blockSize * 2];
-                            tmpBuffers.tempChannels.set (i, chan);
-                        }
-                    }
+                // hosts may share or null output pointers of disabled channels, the router handles that
+                if (auto* chans = layoutFits ? channelRouter.beginBlock (inputs, outputs, numSamples) : nullptr)
+                {
+                    juce::AudioBuffer<FloatType> midiEffectChannels (chans->getArrayOfWritePointers(), 0, numSamples);
+                    auto& buffer = isMidiEffect ? midiEffectChannels : *chans;
 
-                    if (i < numIn)
-                    {
-                        if (chan != inputs[i])
-                            memcpy (chan, inputs[i], (size_t) numSamples * sizeof (FloatType));
-                    }
+                    if (isBypassed)
+                        processor->processBlockBypassed (buffer, midiEvents);
                     else
-                    {
-                        FloatVectorOperations::clear (chan, numSamples);
-                    }
+                        processor->processBlock (buffer, midiEvents);
 
-                    tmpBuffers.channels[i] = chan;
+                    channelRouter.endBlock (numSamples);
                 }
-
-                for (; i < numIn; ++i)
-                    tmpBuffers.channels[i] = inputs[i];
-
+                else
                 {
-                    const int numChannels = jmax (numIn, numOut);
-                    juce::AudioBuffer<FloatType> chans (tmpBuffers.channels, isMidiEffect ? 0 : numChannels, numSamples);
-
-                    if (isBypassed)
-                        processor->processBlockBypassed (chans, midiEvents);
-                    else
-                        processor->processBlock (chans, midiEvents);
+                    for (int i = 0; i < numOut; ++i)
+                        if (outputs[i] != nullptr)
+                            FloatVectorOperations::clear (outputs[i], numSamples);
                 }
-
-                // copy back any temp channels that may have been used..
-                for (i = 0; i < numOut; ++i)
-                    if (auto* chan = tmpBuffers.tempChannels.getUnchecked(i))
-                        if (auto* dest = outputs[i])
-                            memcpy (dest, chan, (size_t) numSamples * sizeof (FloatType));
             }
         }
 
@@ -547,7 +498,7 @@ public:
     void processReplacing (float** inputs, float** outputs, int32 sampleFrames)
     {
         jassert (! processor->isUsingDoublePrecision());
-        internalProcessReplacing (inputs, outputs, sampleFrames, floatTempBuffers);
+        internalProcessReplacing (inputs, outputs, sampleFrames, floatChannelRouter);
     }
 
     static void processReplacingCB (Vst2::VstEffectInterface* vstInterface, float** inputs, float** outputs, int32 sampleFrames)
@@ -558,7 +509,7 @@ public:
     void processDoubleReplacing (double** inputs, double** outputs, int32 sampleFrames)
     {
         jassert (processor->isUsingDoublePrecision());
-        internalProcessReplacing (inputs, outputs, sampleFrames, doubleTempBuffers);
+        internalProcessReplacing (inputs, outputs, sampleFrames, doubleChannelRouter);
     }
 
     static void processDoubleReplacingCB (Vst2::VstEffectInterface* vstInterface, double** inputs, double** outputs, int32 sampleFrames)
@@ -573,10 +524,6 @@ public:
         {
             isProcessing = true;
 
-            auto numInAndOutChannels = static_cast<size_t> (vstEffect.numInputChannels + vstEffect.numOutputChannels);
-            floatTempBuffers .channels.calloc (numInAndOutChannels);
-            doubleTempBuffers.channels.calloc (numInAndOutChannels);
-
             auto currentRate = sampleRate;
             auto currentBlockSize = blockSize;
 
@@ -585,10 +532,15 @@ public:
             processor->setNonRealtime (isProcessLevelOffline());
             processor->setRateAndBufferSizeDetails (currentRate, currentBlockSize);
 
-            deleteTempChannels();
-
             processor->prepareToPlay (currentRate, currentBlockSize);
 
+            prepareChannelRouter (floatChannelRouter);
+            prepareChannelRouter (doubleChannelRouter);
+
+           #if JUCE_PLUGIN_LOAD_TELEMETRY
+            loadMeter.prepare (currentRate);
+           #endif
+
             midiEvents.ensureSize (2048);
             midiEvents.clear();
 
@@ -632,10 +584,8 @@ public:
             outgoingEvents.freeEvents();
 
             isProcessing = false;
-            floatTempBuffers.channels.free();
-            doubleTempBuffers.channels.free();
 
-            deleteTempChannels();
+            releaseChannelRouters();
         }
     }
 
@@ -1456,19 +1406,19 @@ private:
 
     //==============================================================================
     template <typename FloatType>
-    void deleteTempChannels (VstTempBuffers<FloatType>& tmpBuffers)
+    void prepareChannelRouter (PluginChannelRouter<FloatType>& channelRouter)
     {
-        tmpBuffers.release();
-
-        if (processor != nullptr)
-            tmpBuffers.tempChannels.insertMultiple (0, nullptr, vstEffect.numInputChannels
-                                                                 + vstEffect.numOutputChannels);
+        // twice the block size, as some hosts go beyond the size they announced
+        channelRouter.prepare (jmax (maxNumInChannels,  processor->getTotalNumInputChannels()),
+                               jmax (maxNumOutChannels, processor->getTotalNumOutputChannels()),
+                               jmax (1, (int) blockSize) * 2);
+        channelRouter.setLayout (processor->getTotalNumInputChannels(), processor->getTotalNumOutputChannels());
     }
 
-    void deleteTempChannels()
+    void releaseChannelRouters()
     {
-        deleteTempChannels (floatTempBuffers);
-        deleteTempChannels (doubleTempBuffers);
+        floatChannelRouter.release();
+        doubleChannelRouter.release();
     }
 
     //==============================================================================
@@ -2103,8 +2053,12 @@ private:
    #endif
   #endif
 
-    VstTempBuffers<float> floatTempBuffers;
-    VstTempBuffers<double> doubleTempBuffers;
+    PluginChannelRouter<float> floatChannelRouter;
+    PluginChannelRouter<double> doubleChannelRouter;
+
+   #if JUCE_PLUGIN_LOAD_TELEMETRY
+    JucePluginLoadTelemetry::InstanceMeter loadMeter { JucePlugin_Name, "VST2" };
+   #endif
     int maxNumInChannels = 0, maxNumOutChannels = 0;
 
     HeapBlock<Vst2::VstSpeakerConfiguration> cachedInArrangement, cachedOutArrangement;
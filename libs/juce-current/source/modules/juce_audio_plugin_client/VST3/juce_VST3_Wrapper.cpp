@@ -46,6 +46,8 @@
 #include "../utility/juce_CheckSettingMacros.h"
 #include "../utility/juce_IncludeSystemHeaders.h"
 #include "../utility/juce_IncludeModuleHeaders.h"
+#include "JucePluginChannelRouter.h"
+#include "../utility/juce_VST3AutomationSubBlocks.h"
 #include "../utility/juce_WindowsHooks.h"
 #include "../utility/juce_FakeMouseMoveGenerator.h"
 #include <juce_audio_processors/format_types/juce_LegacyAudioParameter.cpp>
@@ -71,6 +73,19 @@
  #endif
 #endif
 
+/*  When enabled, every point in the host's parameter automation queues is applied at its own
+    sample position by splitting the block into sub-blocks at the change points. Sub-blocks are
+    at least JUCE_VST3_MIN_AUTOMATION_SUBBLOCK_SIZE samples long, points falling inside one are
+    applied at its end. Otherwise only the last point of each queue is applied, before the block.
+*/
+#ifndef JUCE_VST3_SAMPLE_ACCURATE_AUTOMATION
+ #define JUCE_VST3_SAMPLE_ACCURATE_AUTOMATION 0
+#endif
+
+#ifndef JUCE_VST3_MIN_AUTOMATION_SUBBLOCK_SIZE
+ #define JUCE_VST3_MIN_AUTOMATION_SUBBLOCK_SIZE 32
+#endif
+
 #if JUCE_LINUX
  #include <unordered_map>
 
@@ -1743,10 +1758,6 @@ namespace
     template <typename FloatType> struct AudioBusPointerHelper {};
     template <> struct AudioBusPointerHelper<float>  { static float**  impl (Vst::AudioBusBuffers& data) noexcept { return data.channelBuffers32; } };
     template <> struct AudioBusPointerHelper<double> { static double** impl (Vst::AudioBusBuffers& data) noexcept { return data.channelBuffers64; } };
-
-    template <typename FloatType> struct ChooseBufferHelper {};
-    template <> struct ChooseBufferHelper<float>  { static AudioBuffer<float>&  impl (AudioBuffer<float>& f, AudioBuffer<double>&  ) noexcept { return f; } };
-    template <> struct ChooseBufferHelper<double> { static AudioBuffer<double>& impl (AudioBuffer<float>&  , AudioBuffer<double>& d) noexcept { return d; } };
 }
 
 
@@ -1899,8 +1910,8 @@ public:
         {
             getPluginInstance().releaseResources();
 
-            deallocateChannelListAndBuffers (channelListFloat,  emptyBufferFloat);
-            deallocateChannelListAndBuffers (channelListDouble, emptyBufferDouble);
+            releaseHostChannels (hostChannelsFloat);
+            releaseHostChannels (hostChannelsDouble);
         }
         else
         {
@@ -1915,8 +1926,12 @@ public:
                             ? (int) processSetup.maxSamplesPerBlock
                             : bufferSize;
 
-            allocateChannelListAndBuffers (channelListFloat,  emptyBufferFloat);
-            allocateChannelListAndBuffers (channelListDouble, emptyBufferDouble);
+            prepareHostChannels (hostChannelsFloat,  bufferSize);
+            prepareHostChannels (hostChannelsDouble, bufferSize);
+
+           #if JUCE_PLUGIN_LOAD_TELEMETRY
+            loadMeter.prepare (sampleRate);
+           #endif
 
             preparePlugin (sampleRate, bufferSize);
         }
@@ -2631,13 +2646,30 @@ public:
         {
             if (auto* paramQueue = paramChanges.getParameterData (i))
             {
-                auto numPoints = paramQueue->getPointCount();
+               #if JUCE_VST3_SAMPLE_ACCURATE_AUTOMATION
+               #if JUCE_VST3_EMULATE_MIDI_CC_WITH_PARAMETERS
+                if (! (juceVST3EditController != nullptr && juceVST3EditController->isMidiControllerParamID (paramQueue->getParameterId())))
+               #endif
+                {
+                    automation.addQueue (*paramQueue, [this] (Vst::ParamID vstParamID, double value) { setParameterFromHost (vstParamID, value); });
+                    continue;
+                }
+               #endif
 
-                Steinberg::int32 offsetSamples = 0;
-                double value = 0.0;
+                auto numPoints = paramQueue->getPointCount();
 
-                if (paramQueue->getPoint (numPoints - 1, offsetSamples, value) == kResultTrue)
+               #if JUCE_VST3_SAMPLE_ACCURATE_AUTOMATION
+                for (Steinberg::int32 point = 0; point < numPoints; ++point)
+               #else
+                Steinberg::int32 point = numPoints - 1;
+               #endif
                 {
+                    Steinberg::int32 offsetSamples = 0;
+                    double value = 0.0;
+
+                    if (paramQueue->getPoint (point, offsetSamples, value) != kResultTrue)
+                        continue;
+
                     auto vstParamID = paramQueue->getParameterId();
 
                    #if JUCE_VST3_EMULATE_MIDI_CC_WITH_PARAMETERS
@@ -2645,20 +2677,27 @@ public:
                         addParameterChangeToMidiBuffer (offsetSamples, vstParamID, value);
                     else
                    #endif
-                    {
-                        auto floatValue = static_cast<float> (value);
-
-                        if (auto* param = comPluginInstance->getParamForVSTParamID (vstParamID))
-                        {
-                            param->setValue (floatValue);
-
-                            inParameterChangedCallback = true;
-                            param->sendValueChangedMessageToListeners (floatValue);
-                        }
-                    }
+                        setParameterFromHost (vstParamID, value);
                 }
             }
         }
+
+       #if JUCE_VST3_SAMPLE_ACCURATE_AUTOMATION
+        automation.sortPoints();
+       #endif
+    }
+
+    void setParameterFromHost (const Vst::ParamID vstParamID, const double value)
+    {
+        auto floatValue = static_cast<float> (value);
+
+        if (auto* param = comPluginInstance->getParamForVSTParamID (vstParamID))
+        {
+            param->setValue (floatValue);
+
+            inParameterChangedCallback = true;
+            param->sendValueChangedMessageToListeners (floatValue);
+        }
     }
 
     void addParameterChangeToMidiBuffer (const Steinberg::int32 offsetSamples, const Vst::ParamID id, const double value)
@@ -2683,9 +2722,18 @@ public:
 
     tresult PLUGIN_API process (Vst::ProcessData& data) override
     {
+       #if JUCE_PLUGIN_REALTIME_AUDIT
+        const JucePluginRealtimeAudit::ScopedAudioThread realtimeAuditScope;
+       #endif
+
         if (pluginInstance == nullptr)
             return kResultFalse;
 
+       #if JUCE_PLUGIN_LOAD_TELEMETRY
+        const JucePluginLoadTelemetry::ScopedMeasurement loadMeasurement (loadMeter, (int) data.numSamples,
+                                                                          processSetup.processMode != Vst::kOffline);
+       #endif
+
         if ((processSetup.symbolicSampleSize == Vst::kSample64) != pluginInstance->isUsingDoublePrecision())
             return kResultFalse;
 
@@ -2706,6 +2754,10 @@ public:
 
         midiBuffer.clear();
 
+       #if JUCE_VST3_SAMPLE_ACCURATE_AUTOMATION
+        automation.clear();
+       #endif
+
         if (data.inputParameterChanges != nullptr)
             processParameterChanges (*data.inputParameterChanges);
 
@@ -2721,13 +2773,19 @@ public:
 
             if ((pluginInstance->getTotalNumInputChannels() + pluginInstance->getTotalNumOutputChannels()) > 0
                  && (numInputChans + numOutputChans) == 0)
+            {
+                flushAutomation();
                 return kResultFalse;
+            }
         }
 
-        if      (processSetup.symbolicSampleSize == Vst::kSample32) processAudio<float>  (data, channelListFloat);
-        else if (processSetup.symbolicSampleSize == Vst::kSample64) processAudio<double> (data, channelListDouble);
+        if      (processSetup.symbolicSampleSize == Vst::kSample32) processAudio<float>  (data, hostChannelsFloat);
+        else if (processSetup.symbolicSampleSize == Vst::kSample64) processAudio<double> (data, hostChannelsDouble);
         else jassertfalse;
 
+        // blocks that weren't processed, while suspended or with mismatched channels, leave points behind
+        flushAutomation();
+
        #if JucePlugin_ProducesMidiOutput
         if (isMidiOutputBusEnabled && data.outputEvents != nullptr)
             MidiEventList::pluginToHostEventList (*data.outputEvents, midiBuffer);
@@ -2757,16 +2815,37 @@ private:
         JuceVST3EditController* controller = nullptr;
     };
 
+    // per-channel host pointers of the current block, and how they map onto the plugin's channels
+    template <typename FloatType>
+    struct HostChannels
+    {
+        HeapBlock<FloatType*> inputs, outputs;
+        PluginChannelRouter<FloatType> router;
+    };
+
     //==============================================================================
     template <typename FloatType>
-    void processAudio (Vst::ProcessData& data, Array<FloatType*>& channelList)
+    void processAudio (Vst::ProcessData& data, HostChannels<FloatType>& hostChannels)
     {
         int totalInputChans = 0, totalOutputChans = 0;
-        bool tmpBufferNeedsClearing = false;
 
         auto plugInInputChannels  = pluginInstance->getTotalNumInputChannels();
         auto plugInOutputChannels = pluginInstance->getTotalNumOutputChannels();
 
+        // the bus layout may have changed while active, the router was prepared for the largest one
+        if (! hostChannels.router.setLayout (plugInInputChannels, plugInOutputChannels))
+        {
+            jassertfalse;
+
+            for (int bus = 0; bus < data.numOutputs; ++bus)
+                if (auto** busChannels = getPointerForAudioBus<FloatType> (data.outputs[bus]))
+                    for (int i = 0; i < (int) data.outputs[bus].numChannels; ++i)
+                        if (busChannels[i] != nullptr)
+                            FloatVectorOperations::clear (busChannels[i], (int) data.numSamples);
+
+            return;
+        }
+
         // Wavelab workaround: wave-lab lies on the number of inputs/outputs so re-count here
         const auto countValidChannels = [] (Vst::AudioBusBuffers* buffers, int32 num)
         {
@@ -2779,111 +2858,34 @@ private:
         const auto vstInputs  = countValidChannels (data.inputs,  data.numInputs);
         const auto vstOutputs = countValidChannels (data.outputs, data.numOutputs);
 
+        // Flattens the host's buses into one pointer per plugin channel. Channels of buses the
+        // host doesn't provide are left as nullptr, the router gives them scratch memory.
+        const auto collectChannels = [this] (bool isInput, Vst::AudioBusBuffers* buffers, int numValidBuses,
+                                             int numPlugInChannels, FloatType** dest)
         {
-            auto n = jmax (vstOutputs, getNumAudioBuses (false));
+            int total = 0;
+            auto n = jmax (numValidBuses, getNumAudioBuses (isInput));
 
-            for (int bus = 0; bus < n && totalOutputChans < plugInOutputChannels; ++bus)
+            for (int bus = 0; bus < n && total < numPlugInChannels; ++bus)
             {
-                if (auto* busObject = pluginInstance->getBus (false, bus))
+                if (auto* busObject = pluginInstance->getBus (isInput, bus))
                     if (! busObject->isEnabled())
                         continue;
 
-                if (bus < vstOutputs)
-                {
-                    if (auto** const busChannels = getPointerForAudioBus<FloatType> (data.outputs[bus]))
-                    {
-                        auto numChans = jmin ((int) data.outputs[bus].numChannels, plugInOutputChannels - totalOutputChans);
-
-                        for (int i = 0; i < numChans; ++i)
-                        {
-                            if (auto dst = busChannels[i])
-                            {
-                                if (totalOutputChans >= plugInInputChannels)
-                                    FloatVectorOperations::clear (dst, (int) data.numSamples);
-
-                                channelList.set (totalOutputChans++, busChannels[i]);
-                            }
-                        }
-                    }
-                }
-                else
-                {
-                    const int numChans = jmin (pluginInstance->getChannelCountOfBus (false, bus), plugInOutputChannels - totalOutputChans);
+                auto** const busChannels = bus < numValidBuses ? getPointerForAudioBus<FloatType> (buffers[bus]) : nullptr;
+                auto numChans = jmin (bus < numValidBuses ? (int) buffers[bus].numChannels
+                                                          : pluginInstance->getChannelCountOfBus (isInput, bus),
+                                      numPlugInChannels - total);
 
-                    for (int i = 0; i < numChans; ++i)
-                    {
-                        if (auto* tmpBuffer = getTmpBufferForChannel<FloatType> (totalOutputChans, data.numSamples))\
-                        {
-                            tmpBufferNeedsClearing = true;
-                            channelList.set (totalOutputChans++, tmpBuffer);
-                        }
-                        else
-                            return;
-                    }
-                }
+                for (int i = 0; i < numChans; ++i)
+                    dest[total++] = busChannels != nullptr ? busChannels[i] : nullptr;
             }
-        }
 
-        {
-            auto n = jmax (vstInputs, getNumAudioBuses (true));
-
-            for (int bus = 0; bus < n && totalInputChans < plugInInputChannels; ++bus)
-            {
-                if (auto* busObject = pluginInstance->getBus (true, bus))
-                    if (! busObject->isEnabled())
-                        continue;
-
-                if (bus < vstInputs)
-                {
-                    if (auto** const busChannels = getPointerForAudioBus<FloatType> (data.inputs[bus]))
-                    {
-                        const int numChans = jmin ((int) data.inputs[bus].numChannels, plugInInputChannels - totalInputChans);
-
-                        for (int i = 0; i < numChans; ++i)
-                        {
-                            if (busChannels[i] != nullptr)
-                            {
-                                if (totalInputChans >= totalOutputChans)
-                                    channelList.set (totalInputChans, busChannels[i]);
-                                else
-                                {
-                                    auto* dst = channelList.getReference (totalInputChans);
-                                    auto* src = busChannels[i];
-
-                                    if (dst != src)
-                                        FloatVectorOperations::copy (dst, src, (int) data.numSamples);
-                                }
-                            }
-
-                            ++totalInputChans;
-                        }
-                    }
-                }
-                else
-                {
-                    auto numChans = jmin (pluginInstance->getChannelCountOfBus (true, bus), plugInInputChannels - totalInputChans);
-
-                    for (int i = 0; i < numChans; ++i)
-                    {
-                        if (auto* tmpBuffer = getTmpBufferForChannel<FloatType> (totalInputChans, data.numSamples))
-                        {
-                            tmpBufferNeedsClearing = true;
-                            channelList.set (totalInputChans++, tmpBuffer);
-                        }
-                        else
-                            return;
-                    }
-                }
-            }
-        }
-
-        if (tmpBufferNeedsClearing)
-            ChooseBufferHelper<FloatType>::impl (emptyBufferFloat, emptyBufferDouble).clear();
-
-        AudioBuffer<FloatType> buffer;
+            return total;
+        };
 
-        if (int totalChans = jmax (totalOutputChans, totalInputChans))
-            buffer.setDataToReferTo (channelList.getRawDataPointer(), totalChans, (int) data.numSamples);
+        totalOutputChans = collectChannels (false, data.outputs, vstOutputs, plugInOutputChannels, hostChannels.outputs);
+        totalInputChans  = collectChannels (true,  data.inputs,  vstInputs,  plugInInputChannels,  hostChannels.inputs);
 
         {
             const ScopedLock sl (pluginInstance->getCallbackLock());
@@ -2894,20 +2896,29 @@ private:
             const int numMidiEventsComingIn = midiBuffer.getNumEvents();
            #endif
 
-            if (pluginInstance->isSuspended())
+            AudioBuffer<FloatType>* buffer = nullptr;
+
+            if (! pluginInstance->isSuspended()
+                 && totalInputChans == plugInInputChannels
+                 && totalOutputChans == plugInOutputChannels)
+                buffer = hostChannels.router.beginBlock (hostChannels.inputs, hostChannels.outputs, (int) data.numSamples);
+
+            if (buffer != nullptr)
             {
-                buffer.clear();
+               #if JUCE_VST3_SAMPLE_ACCURATE_AUTOMATION
+                if (! automation.isEmpty())
+                    processAutomatedSubBlocks (*buffer);
+                else
+               #endif
+                    processBlockOrBypassed (*buffer, midiBuffer);
+
+                hostChannels.router.endBlock ((int) data.numSamples);
             }
             else
             {
-                if (totalInputChans == pluginInstance->getTotalNumInputChannels()
-                 && totalOutputChans == pluginInstance->getTotalNumOutputChannels())
-                {
-                    if (isBypassed())
-                        pluginInstance->processBlockBypassed (buffer, midiBuffer);
-                    else
-                        pluginInstance->processBlock (buffer, midiBuffer);
-                }
+                for (int i = 0; i < totalOutputChans; ++i)
+                    if (auto* output = hostChannels.outputs[i])
+                        FloatVectorOperations::clear (output, (int) data.numSamples);
             }
 
            #if JUCE_DEBUG && (! JucePlugin_ProducesMidiOutput)
@@ -2930,43 +2941,98 @@ private:
         }
     }
 
-    //==============================================================================
     template <typename FloatType>
-    void allocateChannelListAndBuffers (Array<FloatType*>& channelList, AudioBuffer<FloatType>& buffer)
+    void processBlockOrBypassed (AudioBuffer<FloatType>& buffer, MidiBuffer& midiMessages)
+    {
+        if (isBypassed())
+            pluginInstance->processBlockBypassed (buffer, midiMessages);
+        else
+            pluginInstance->processBlock (buffer, midiMessages);
+    }
+
+    void flushAutomation()
+    {
+       #if JUCE_VST3_SAMPLE_ACCURATE_AUTOMATION
+        automation.flush ([this] (Vst::ParamID vstParamID, double value) { setParameterFromHost (vstParamID, value); });
+       #endif
+    }
+
+   #if JUCE_VST3_SAMPLE_ACCURATE_AUTOMATION
+    template <typename FloatType>
+    void processAutomatedSubBlocks (AudioBuffer<FloatType>& buffer)
     {
-        channelList.clearQuick();
-        channelList.insertMultiple (0, nullptr, 128);
+        const auto blockContext = processContext;
+
+        subBlockMidiOutput.clear();
+
+        automation.process (buffer.getNumSamples(), JUCE_VST3_MIN_AUTOMATION_SUBBLOCK_SIZE,
+                            [this] (Vst::ParamID vstParamID, double value) { setParameterFromHost (vstParamID, value); },
+                            [this, &buffer, &blockContext] (int start, int numSubBlockSamples)
+        {
+            AudioBuffer<FloatType> subBlock (buffer.getArrayOfWritePointers(), buffer.getNumChannels(), start, numSubBlockSamples);
+
+            subBlockMidi.clear();
+            subBlockMidi.addEvents (midiBuffer, start, numSubBlockSamples, -start);
+
+            // let the play head report the position of the sub-block
+            processContext.projectTimeSamples = blockContext.projectTimeSamples + start;
+            processContext.continousTimeSamples = blockContext.continousTimeSamples + start;
+
+            if ((blockContext.state & Vst::ProcessContext::kProjectTimeMusicValid) != 0
+                 && (blockContext.state & Vst::ProcessContext::kTempoValid) != 0
+                 && blockContext.sampleRate > 0.0)
+                processContext.projectTimeMusic = blockContext.projectTimeMusic + start * blockContext.tempo / (60.0 * blockContext.sampleRate);
+
+            processBlockOrBypassed (subBlock, subBlockMidi);
+
+            subBlockMidiOutput.addEvents (subBlockMidi, 0, -1, start);
+        });
+
+        processContext = blockContext;
+        midiBuffer.swapWith (subBlockMidiOutput);
+    }
+   #endif
 
+    //==============================================================================
+    // the most channels the plugin's buses can have in any layout it supports
+    int getMaxTotalNumChannels (bool isInput) const
+    {
         auto& p = getPluginInstance();
-        buffer.setSize (jmax (p.getTotalNumInputChannels(), p.getTotalNumOutputChannels()), p.getBlockSize() * 4);
-        buffer.clear();
+        int total = 0;
+
+        for (int i = 0; i < p.getBusCount (isInput); ++i)
+            if (auto* bus = p.getBus (isInput, i))
+                total += jmax (bus->getNumberOfChannels(), bus->getMaxSupportedChannels());
+
+        return total;
     }
 
     template <typename FloatType>
-    void deallocateChannelListAndBuffers (Array<FloatType*>& channelList, AudioBuffer<FloatType>& buffer)
+    void prepareHostChannels (HostChannels<FloatType>& hostChannels, int bufferSize)
     {
-        channelList.clearQuick();
-        channelList.resize (0);
-        buffer.setSize (0, 0);
+        auto& p = getPluginInstance();
+
+        const auto maxIns  = jmax (p.getTotalNumInputChannels(),  getMaxTotalNumChannels (true));
+        const auto maxOuts = jmax (p.getTotalNumOutputChannels(), getMaxTotalNumChannels (false));
+
+        hostChannels.inputs.calloc (maxIns + 1);
+        hostChannels.outputs.calloc (maxOuts + 1);
+        hostChannels.router.prepare (maxIns, maxOuts, bufferSize);
+        hostChannels.router.setLayout (p.getTotalNumInputChannels(), p.getTotalNumOutputChannels());
     }
 
     template <typename FloatType>
-    static FloatType** getPointerForAudioBus (Vst::AudioBusBuffers& data) noexcept
+    void releaseHostChannels (HostChannels<FloatType>& hostChannels)
     {
-        return AudioBusPointerHelper<FloatType>::impl (data);
+        hostChannels.inputs.free();
+        hostChannels.outputs.free();
+        hostChannels.router.release();
     }
 
     template <typename FloatType>
-    FloatType* getTmpBufferForChannel (int channel, int numSamples) noexcept
+    static FloatType** getPointerForAudioBus (Vst::AudioBusBuffers& data) noexcept
     {
-        auto& buffer = ChooseBufferHelper<FloatType>::impl (emptyBufferFloat, emptyBufferDouble);
-
-        // we can't do anything if the host requests to render many more samples than the
-        // block size, we need to bail out
-        if (numSamples > buffer.getNumSamples() || channel >= buffer.getNumChannels())
-            return nullptr;
-
-        return buffer.getWritePointer (channel);
+        return AudioBusPointerHelper<FloatType>::impl (data);
     }
 
     void preparePlugin (double sampleRate, int bufferSize)
@@ -2978,6 +3044,12 @@ private:
 
         midiBuffer.ensureSize (2048);
         midiBuffer.clear();
+
+       #if JUCE_VST3_SAMPLE_ACCURATE_AUTOMATION
+        subBlockMidi.ensureSize (2048);
+        subBlockMidiOutput.ensureSize (2048);
+        automation.reserve (comPluginInstance->getNumParameters());
+       #endif
     }
 
     //==============================================================================
@@ -2999,11 +3071,18 @@ private:
     Vst::ProcessSetup processSetup;
 
     MidiBuffer midiBuffer;
-    Array<float*> channelListFloat;
-    Array<double*> channelListDouble;
 
-    AudioBuffer<float>  emptyBufferFloat;
-    AudioBuffer<double> emptyBufferDouble;
+    HostChannels<float>  hostChannelsFloat;
+    HostChannels<double> hostChannelsDouble;
+
+   #if JUCE_PLUGIN_LOAD_TELEMETRY
+    JucePluginLoadTelemetry::InstanceMeter loadMeter { JucePlugin_Name, "VST3" };
+   #endif
+
+   #if JUCE_VST3_SAMPLE_ACCURATE_AUTOMATION
+    VST3AutomationSubBlocks automation;
+    MidiBuffer subBlockMidi, subBlockMidiOutput;
+   #endif
 
    #if JucePlugin_WantsMidiInput
     std::atomic<bool> isMidiInputBusEnabled { true };
@@ -0,0 +1,167 @@
+/*
+  ==============================================================================
+
+   Juce VST3 Automation Sub-Blocks
+
+  ==============================================================================
+*/
+
+#pragma once
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Merges the points of the host's parameter automation queues for one VST3
+    process call and splits the block at them, see JUCE_VST3_SAMPLE_ACCURATE_AUTOMATION.
+
+    Sub-blocks are at least minSubBlockSize samples long. A point falling inside
+    one is applied at its end, and the last sub-block is extended instead of
+    leaving a remainder shorter than the minimum.
+
+    The points are read from the host's queues while the block is processed, so
+    only one entry per queue is stored however dense the automation is. The queues
+    have to stay valid until process() or flush() returned, which they do for the
+    duration of the host's process call. None of the calls allocate once reserve()
+    was called with the number of parameters.
+*/
+class VST3AutomationSubBlocks
+{
+public:
+    VST3AutomationSubBlocks() = default;
+
+    /** Not realtime-safe, call when the plugin is activated. */
+    void reserve (int numQueues)    { pending.reserve ((size_t) jmax (0, numQueues)); }
+
+    void clear() noexcept           { pending.clear(); }
+    bool isEmpty() const noexcept   { return pending.empty(); }
+
+    /** Adds one host queue. Points at the start of the block can't split it, they are passed
+        to applyNow (paramID, value) right away. So are all of the queue's points if there are
+        more queues than were reserved.
+    */
+    template <typename ApplyNow>
+    void addQueue (Steinberg::Vst::IParamValueQueue& queue, ApplyNow&& applyNow)
+    {
+        const auto paramID = queue.getParameterId();
+        const auto numPoints = queue.getPointCount();
+        const auto canDefer = pending.size() < pending.capacity();
+
+        jassert (canDefer || numPoints == 0);
+
+        for (Steinberg::int32 point = 0; point < numPoints; ++point)
+        {
+            Steinberg::int32 offsetSamples = 0;
+            double value = 0.0;
+
+            if (queue.getPoint (point, offsetSamples, value) == Steinberg::kResultTrue && (offsetSamples <= 0 || ! canDefer))
+                applyNow (paramID, value);
+        }
+
+        if (! canDefer)
+            return;
+
+        Queue entry { &queue, paramID, numPoints, 0, 0, 0.0, (int) pending.size() };
+
+        if (entry.advance())
+            pending.push_back (entry);
+    }
+
+    /** Orders the queues by their next point, call after the last addQueue(). */
+    void sortPoints()
+    {
+        std::make_heap (pending.begin(), pending.end(), Queue::later);
+    }
+
+    /** Calls processSubBlock (startSample, numSubBlockSamples) for each sub-block of a block,
+        after passing the points due by its start to applyPoint (paramID, value). Points after
+        the start of the last sub-block are applied once it was processed.
+    */
+    template <typename ApplyPoint, typename ProcessSubBlock>
+    void process (int numSamples, int minSubBlockSize, ApplyPoint&& applyPoint, ProcessSubBlock&& processSubBlock)
+    {
+        minSubBlockSize = jmax (1, minSubBlockSize);
+
+        for (int start = 0; start < numSamples;)
+        {
+            while (! pending.empty() && pending.front().sampleOffset <= start)
+                applyNext (applyPoint);
+
+            auto end = numSamples;
+
+            if (! pending.empty())
+            {
+                end = jmax (start + minSubBlockSize, (int) pending.front().sampleOffset);
+
+                // don't leave a remainder shorter than the minimum either
+                if (numSamples - end < minSubBlockSize)
+                    end = numSamples;
+            }
+
+            processSubBlock (start, end - start);
+            start = end;
+        }
+
+        // points past the last sub-block start still have to end up in the plugin's state
+        flush (applyPoint);
+    }
+
+    /** Passes the points that weren't applied yet to applyPoint (paramID, value) in time order.
+        Call it for blocks that aren't processed, so the plugin still ends up with the last values.
+    */
+    template <typename ApplyPoint>
+    void flush (ApplyPoint&& applyPoint)
+    {
+        while (! pending.empty())
+            applyNext (applyPoint);
+    }
+
+private:
+    struct Queue
+    {
+        Steinberg::Vst::IParamValueQueue* queue;
+        Steinberg::Vst::ParamID paramID;
+        Steinberg::int32 numPoints, nextPoint;
+        Steinberg::int32 sampleOffset;
+        double value;
+        int order;
+
+        // loads the queue's next point after the start of the block
+        bool advance()
+        {
+            while (nextPoint < numPoints)
+                if (queue->getPoint (nextPoint++, sampleOffset, value) == Steinberg::kResultTrue && sampleOffset > 0)
+                    return true;
+
+            return false;
+        }
+
+        // heap order, each queue is already in time order and the queue order decides for equal offsets
+        static bool later (const Queue& a, const Queue& b)
+        {
+            return a.sampleOffset != b.sampleOffset ? a.sampleOffset > b.sampleOffset
+                                                    : a.order > b.order;
+        }
+    };
+
+    template <typename ApplyPoint>
+    void applyNext (ApplyPoint& applyPoint)
+    {
+        std::pop_heap (pending.begin(), pending.end(), Queue::later);
+        auto& queue = pending.back();
+        applyPoint (queue.paramID, queue.value);
+
+        if (queue.advance())
+            std::push_heap (pending.begin(), pending.end(), Queue::later);
+        else
+            pending.pop_back();
+    }
+
+    // min-heap of the queues with points left in the current block, by their next point
+    std::vector<Queue> pending;
+
+    JUCE_DECLARE_NON_COPYABLE (VST3AutomationSubBlocks)
+};
+
+} // namespace juce
@@ -26,6 +26,15 @@
  #define JucePlugin_WantsLV2Latency 1
 #endif
 
+/** Enable DSP load output port, needs the 'load-telemetry' build option */
+#ifndef JucePlugin_WantsLV2DSPLoad
+ #define JucePlugin_WantsLV2DSPLoad JUCE_PLUGIN_LOAD_TELEMETRY
+#endif
+
+#if JucePlugin_WantsLV2DSPLoad && ! JUCE_PLUGIN_LOAD_TELEMETRY
+ #error "JucePlugin_WantsLV2DSPLoad requires JUCE_PLUGIN_LOAD_TELEMETRY"
+#endif
+
 /** Use non-parameter states */
 #ifndef JucePlugin_WantsLV2State
  #define JucePlugin_WantsLV2State 1
@@ -79,6 +88,7 @@
 #define JUCE_LV2_STATE_BINARY_URI "urn:juce:stateBinary"
 
 #include "../utility/juce_IncludeModuleHeaders.h"
+#include "JucePluginChannelRouter.h"
 
 using namespace juce;
 
@@ -473,6 +483,9 @@ public:
         controlPortOffset += 1; // freewheel
 #if JucePlugin_WantsLV2Latency
         controlPortOffset += 1;
+#endif
+#if JucePlugin_WantsLV2DSPLoad
+        controlPortOffset += 1;
 #endif
         controlPortOffset += filter->getTotalNumInputChannels();
         controlPortOffset += filter->getTotalNumOutputChannels();
@@ -857,6 +870,9 @@ public:
 #if JucePlugin_WantsLV2Latency
         portLatency = nullptr;
 #endif
+#if JucePlugin_WantsLV2DSPLoad
+        portDSPLoad = nullptr;
+#endif
 
         portAudioIns.insertMultiple (0, nullptr, numInChans);
         portAudioOuts.insertMultiple (0, nullptr, numOutChans);
@@ -994,6 +1010,14 @@ public:
         }
 #endif
 
+#if JucePlugin_WantsLV2DSPLoad
+        if (portId == index++)
+        {
+            portDSPLoad = (float*)dataLocation;
+            return;
+        }
+#endif
+
         for (int i=0; i < numInChans; ++i)
         {
             if (portId == index++)
@@ -1029,7 +1053,11 @@ public:
         filter->prepareToPlay (sampleRate, bufferSize);
         filter->setPlayConfigDetails (numInChans, numOutChans, sampleRate, bufferSize);
 
-        channels.calloc (numInChans + numOutChans);
+        channelRouter.prepare (numInChans, numOutChans, (int) bufferSize);
+
+       #if JUCE_PLUGIN_LOAD_TELEMETRY
+        loadMeter.prepare (sampleRate);
+       #endif
 
 #if (JucePlugin_WantsMidiInput || JucePlugin_ProducesMidiOutput)
         midiEvents.ensureSize (2048);
@@ -1043,18 +1071,33 @@ public:
 
         filter->releaseResources();
 
-        channels.free();
+        channelRouter.release();
     }
 
     void lv2Run (uint32 sampleCount)
     {
+       #if JUCE_PLUGIN_REALTIME_AUDIT
+        const JucePluginRealtimeAudit::ScopedAudioThread realtimeAuditScope;
+       #endif
+
         jassert (filter != nullptr);
 
+       #if JUCE_PLUGIN_LOAD_TELEMETRY
+        const JucePluginLoadTelemetry::ScopedMeasurement loadMeasurement (loadMeter, (int) sampleCount,
+                                                                          ! filter->isNonRealtime());
+       #endif
+
 #if JucePlugin_WantsLV2Latency
         if (portLatency != nullptr)
             *portLatency = filter->getLatencySamples();
 #endif
 
+#if JucePlugin_WantsLV2DSPLoad
+        // the load of the blocks before this one, in percent
+        if (portDSPLoad != nullptr)
+            *portDSPLoad = jmin (100.0f, loadMeter.getMeanLoad() * 100.0f);
+#endif
+
         if (portFreewheel != nullptr)
             filter->setNonRealtime (*portFreewheel >= 0.5f);
 
@@ -1096,18 +1139,6 @@ public:
             }
             else
             {
-                int i;
-                for (i = 0; i < numOutChans; ++i)
-                {
-                    channels[i] = portAudioOuts[i];
-
-                    if (i < numInChans && portAudioIns[i] != portAudioOuts[i])
-                        FloatVectorOperations::copy (portAudioOuts [i], portAudioIns[i], sampleCount);
-                }
-
-                for (; i < numInChans; ++i)
-                    channels [i] = portAudioIns[i];
-
 #if (JucePlugin_WantsMidiInput || JucePlugin_WantsLV2TimePos)
                 if (portEventsIn != nullptr)
                 {
@@ -1279,9 +1310,17 @@ public:
                     }
                 }
 #endif
+                if (auto* chans = channelRouter.beginBlock (portAudioIns.getRawDataPointer(),
+                                                            portAudioOuts.getRawDataPointer(), (int) sampleCount))
+                {
+                    filter->processBlock (*chans, midiEvents);
+                    channelRouter.endBlock ((int) sampleCount);
+                }
+                else
                 {
-                    AudioSampleBuffer chans (channels, jmax (numInChans, numOutChans), sampleCount);
-                    filter->processBlock (chans, midiEvents);
+                    for (int i = 0; i < numOutChans; ++i)
+                        if (portAudioOuts[i] != nullptr)
+                            zeromem (portAudioOuts[i], sizeof (float) * sampleCount);
                 }
             }
         }
@@ -1585,7 +1624,11 @@ private:
 #if ! JUCE_AUDIOPROCESSOR_NO_GUI
     ScopedPointer<JuceLv2UIWrapper> ui;
 #endif
-    HeapBlock<float*> channels;
+    PluginChannelRouter<float> channelRouter;
+
+   #if JUCE_PLUGIN_LOAD_TELEMETRY
+    JucePluginLoadTelemetry::InstanceMeter loadMeter { JucePlugin_Name, "LV2" };
+   #endif
     MidiBuffer midiEvents;
     int numInChans, numOutChans;
 
@@ -1598,6 +1641,9 @@ private:
     float* portFreewheel;
 #if JucePlugin_WantsLV2Latency
     float* portLatency;
+#endif
+#if JucePlugin_WantsLV2DSPLoad
+    float* portDSPLoad;
 #endif
     Array<float*> portAudioIns;
     Array<float*> portAudioOuts;
@@ -280,6 +280,22 @@ static const String makePluginFile (AudioProcessor* const filter, const int maxN
     text += "\n";
 #endif
 
+#if JucePlugin_WantsLV2DSPLoad
+    // DSP load port
+    text += "    lv2:port [\n";
+    text += "        a lv2:OutputPort, lv2:ControlPort ;\n";
+    text += "        lv2:index " + String(portIndex++) + " ;\n";
+    text += "        lv2:symbol \"lv2_dsp_load\" ;\n";
+    text += "        lv2:name \"DSP Load\" ;\n";
+    text += "        lv2:default 0.0 ;\n";
+    text += "        lv2:minimum 0.0 ;\n";
+    text += "        lv2:maximum 100.0 ;\n";
+    text += "        lv2:portProperty <" LV2_PORT_PROPS__notOnGUI "> ;\n";
+    text += "        <http://lv2plug.in/ns/extensions/units#unit> <http://lv2plug.in/ns/extensions/units#pc> ;\n";
+    text += "    ] ;\n";
+    text += "\n";
+#endif
+
     // Audio inputs
     for (int i=0; i < maxNumInputChannels; ++i)
     {
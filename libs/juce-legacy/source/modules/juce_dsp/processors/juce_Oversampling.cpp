@@ -29,6 +29,104 @@ namespace juce
 namespace dsp
 {
 
+#if JUCE_USE_SIMD
+//===============================================================================
+/** Multi-channel sample storage used between the oversampling stages when
+    several channels are processed together.
+
+    The channels are split in groups of SIMDRegister::size(), and each group
+    holds one register per sample, so that the lanes of a register are the
+    channels of the group at that sample. Unused lanes of the last group stay
+    at zero.
+*/
+template <typename SampleType>
+class OversamplingInterleavedBuffer
+{
+public:
+    typedef SIMDRegister<SampleType> Register;
+
+    //===============================================================================
+    OversamplingInterleavedBuffer() {}
+
+    static size_t getNumGroupsFor (size_t numChannels) noexcept
+    {
+        return (numChannels + Register::size() - 1) / Register::size();
+    }
+
+    void setSize (size_t newNumGroups, size_t newNumSamples)
+    {
+        numGroups = newNumGroups;
+        numSamples = newNumSamples;
+
+        // one register more, for the alignment
+        data.allocate ((numGroups * numSamples + 1) * sizeof (Register), true);
+        registers = reinterpret_cast<Register*> (Register::getNextSIMDAlignedPtr (reinterpret_cast<SampleType*> (data.getData())));
+    }
+
+    void clear() noexcept
+    {
+        zeromem (registers, numGroups * numSamples * sizeof (Register));
+    }
+
+    size_t getNumSamples() const noexcept          { return numSamples; }
+    Register* getGroup (size_t group) noexcept     { return registers + group * numSamples; }
+
+    //===============================================================================
+    void interleave (const dsp::AudioBlock<SampleType>& block) noexcept
+    {
+        jassert (getNumGroupsFor (block.getNumChannels()) <= numGroups && block.getNumSamples() <= numSamples);
+
+        const auto lanes = Register::size();
+        const auto num = block.getNumSamples();
+
+        for (size_t channel = 0; channel < block.getNumChannels(); channel++)
+        {
+            auto src = block.getChannelPointer (channel);
+            auto dst = reinterpret_cast<SampleType*> (getGroup (channel / lanes)) + (channel % lanes);
+
+            for (size_t i = 0; i < num; i++)
+                dst[i * lanes] = src[i];
+        }
+    }
+
+    void deinterleave (dsp::AudioBlock<SampleType>& block) noexcept
+    {
+        jassert (getNumGroupsFor (block.getNumChannels()) <= numGroups && block.getNumSamples() <= numSamples);
+
+        const auto lanes = Register::size();
+        const auto num = block.getNumSamples();
+
+        for (size_t channel = 0; channel < block.getNumChannels(); channel++)
+        {
+            auto src = reinterpret_cast<const SampleType*> (getGroup (channel / lanes)) + (channel % lanes);
+            auto dst = block.getChannelPointer (channel);
+
+            for (size_t i = 0; i < num; i++)
+                dst[i] = src[i * lanes];
+        }
+    }
+
+    /** Same as util::snapToZero on every lane, which is a no-op for registers. */
+    void snapToZero() noexcept
+    {
+        auto samples = reinterpret_cast<SampleType*> (registers);
+
+        for (size_t i = 0; i < numGroups * numSamples * Register::size(); i++)
+            util::snapToZero (samples[i]);
+    }
+
+private:
+    //===============================================================================
+    HeapBlock<char> data;
+    Register* registers = nullptr;
+    size_t numGroups = 0, numSamples = 0;
+
+    //===============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OversamplingInterleavedBuffer)
+};
+#endif
+
+//===============================================================================
 /** Abstract class for the provided oversampling engines used internally in
     the Oversampling class.
 */
@@ -57,6 +155,10 @@ public:
     virtual void reset()
     {
         buffer.clear();
+
+       #if JUCE_USE_SIMD
+        interleaved.clear();
+       #endif
     }
 
     dsp::AudioBlock<SampleType> getProcessedSamples (size_t numSamples)
@@ -67,11 +169,36 @@ public:
     virtual void processSamplesUp (dsp::AudioBlock<SampleType> &inputBlock) = 0;
     virtual void processSamplesDown (dsp::AudioBlock<SampleType> &outputBlock) = 0;
 
+   #if JUCE_USE_SIMD
+    //===============================================================================
+    /** Used instead of initProcessing when the channels are processed together,
+        the engine then reads and writes interleaved samples only.
+    */
+    virtual void initInterleavedProcessing (size_t maximumNumberOfSamplesBeforeOversampling)
+    {
+        interleaved.setSize (getNumGroups(), maximumNumberOfSamplesBeforeOversampling * factor);
+    }
+
+    OversamplingInterleavedBuffer<SampleType>& getInterleavedSamples() { return interleaved; }
+
+    /** Upsamples numSamples samples of input into the interleaved buffer of the engine. */
+    virtual void processSamplesUpInterleaved (OversamplingInterleavedBuffer<SampleType>& inputSamples, size_t numSamples) = 0;
+
+    /** Downsamples the interleaved buffer of the engine into numSamples samples of output. */
+    virtual void processSamplesDownInterleaved (OversamplingInterleavedBuffer<SampleType>& outputSamples, size_t numSamples) = 0;
+
+    size_t getNumGroups() const { return OversamplingInterleavedBuffer<SampleType>::getNumGroupsFor (numChannels); }
+   #endif
+
 protected:
     //===============================================================================
     AudioBuffer<SampleType> buffer;
     size_t factor;
     size_t numChannels;
+
+   #if JUCE_USE_SIMD
+    OversamplingInterleavedBuffer<SampleType> interleaved;
+   #endif
 };
 
 
@@ -111,6 +238,27 @@ public:
         outputBlock.copy (OversamplingEngine<SampleType>::getProcessedSamples (outputBlock.getNumSamples()));
     }
 
+   #if JUCE_USE_SIMD
+    void processSamplesUpInterleaved (OversamplingInterleavedBuffer<SampleType>& inputSamples, size_t numSamples) override
+    {
+        jassert (numSamples <= OversamplingEngine<SampleType>::interleaved.getNumSamples());
+
+        for (size_t group = 0; group < OversamplingEngine<SampleType>::getNumGroups(); group++)
+            std::copy (inputSamples.getGroup (group), inputSamples.getGroup (group) + numSamples,
+                       OversamplingEngine<SampleType>::interleaved.getGroup (group));
+    }
+
+    void processSamplesDownInterleaved (OversamplingInterleavedBuffer<SampleType>& outputSamples, size_t numSamples) override
+    {
+        jassert (numSamples <= outputSamples.getNumSamples());
+
+        for (size_t group = 0; group < OversamplingEngine<SampleType>::getNumGroups(); group++)
+            std::copy (OversamplingEngine<SampleType>::interleaved.getGroup (group),
+                       OversamplingEngine<SampleType>::interleaved.getGroup (group) + numSamples,
+                       outputSamples.getGroup (group));
+    }
+   #endif
+
 private:
     //===============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OversamplingDummy)
@@ -166,6 +314,14 @@ public:
         stateDown2.clear();
 
         position.fill (0);
+
+       #if JUCE_USE_SIMD
+        stateUpInterleaved.clear();
+        stateDownInterleaved.clear();
+        stateDown2Interleaved.clear();
+
+        positionInterleaved.fill (0);
+       #endif
     }
 
     void processSamplesUp (dsp::AudioBlock<SampleType> &inputBlock) override
@@ -257,12 +413,134 @@ public:
 
     }
 
+   #if JUCE_USE_SIMD
+    //===============================================================================
+    void initInterleavedProcessing (size_t maximumNumberOfSamplesBeforeOversampling) override
+    {
+        OversamplingEngine<SampleType>::initInterleavedProcessing (maximumNumberOfSamplesBeforeOversampling);
+
+        auto numGroups = OversamplingEngine<SampleType>::getNumGroups();
+
+        auto N = coefficientsUp.getFilterOrder() + 1;
+        stateUpInterleaved.setSize (numGroups, N);
+        firUpInterleaved.setSize (1, N);
+
+        for (size_t k = 0; k < N; k++)
+            firUpInterleaved.getGroup (0)[k] = Register::expand (coefficientsUp.getRawCoefficients()[k]);
+
+        N = coefficientsDown.getFilterOrder() + 1;
+        auto Ndiv4 = N / 4;
+
+        stateDownInterleaved.setSize (numGroups, N);
+        stateDown2Interleaved.setSize (numGroups, Ndiv4 + 1);
+        firDownInterleaved.setSize (1, N);
+
+        for (size_t k = 0; k < N; k++)
+            firDownInterleaved.getGroup (0)[k] = Register::expand (coefficientsDown.getRawCoefficients()[k]);
+
+        positionInterleaved.resize (static_cast<int> (numGroups));
+    }
+
+    void processSamplesUpInterleaved (OversamplingInterleavedBuffer<SampleType>& inputSamples, size_t numSamples) override
+    {
+        jassert (numSamples * OversamplingEngine<SampleType>::factor <= OversamplingEngine<SampleType>::interleaved.getNumSamples());
+
+        // Initialization
+        auto fir = firUpInterleaved.getGroup (0);
+        auto N = coefficientsUp.getFilterOrder() + 1;
+        auto Ndiv2 = N / 2;
+        auto two = Register::expand (static_cast<SampleType> (2.0));
+
+        // Processing
+        for (size_t group = 0; group < OversamplingEngine<SampleType>::getNumGroups(); group++)
+        {
+            auto bufferSamples = OversamplingEngine<SampleType>::interleaved.getGroup (group);
+            auto buf = stateUpInterleaved.getGroup (group);
+            auto samples = inputSamples.getGroup (group);
+
+            for (size_t i = 0; i < numSamples; i++)
+            {
+                // Input
+                buf[N - 1] = two * samples[i];
+
+                // Convolution
+                auto out = Register::expand (static_cast<SampleType> (0.0));
+                for (size_t k = 0; k < Ndiv2; k += 2)
+                    out += (buf[k] + buf[N - k - 1]) * fir[k];
+
+                // Outputs
+                bufferSamples[i << 1] = out;
+                bufferSamples[(i << 1) + 1] = buf[Ndiv2 + 1] * fir[Ndiv2];
+
+                // Shift data
+                for (size_t k = 0; k < N - 2; k += 2)
+                    buf[k] = buf[k + 2];
+            }
+        }
+    }
+
+    void processSamplesDownInterleaved (OversamplingInterleavedBuffer<SampleType>& outputSamples, size_t numSamples) override
+    {
+        jassert (numSamples <= outputSamples.getNumSamples());
+
+        // Initialization
+        auto fir = firDownInterleaved.getGroup (0);
+        auto N = coefficientsDown.getFilterOrder() + 1;
+        auto Ndiv2 = N / 2;
+        auto Ndiv4 = Ndiv2 / 2;
+
+        // Processing
+        for (size_t group = 0; group < OversamplingEngine<SampleType>::getNumGroups(); group++)
+        {
+            auto bufferSamples = OversamplingEngine<SampleType>::interleaved.getGroup (group);
+            auto buf = stateDownInterleaved.getGroup (group);
+            auto buf2 = stateDown2Interleaved.getGroup (group);
+            auto samples = outputSamples.getGroup (group);
+            auto pos = positionInterleaved.getUnchecked (static_cast<int> (group));
+
+            for (size_t i = 0; i < numSamples; i++)
+            {
+                // Input
+                buf[N - 1] = bufferSamples[i << 1];
+
+                // Convolution
+                auto out = Register::expand (static_cast<SampleType> (0.0));
+                for (size_t k = 0; k < Ndiv2; k += 2)
+                    out += (buf[k] + buf[N - k - 1]) * fir[k];
+
+                // Output
+                out += buf2[pos] * fir[Ndiv2];
+                buf2[pos] = bufferSamples[(i << 1) + 1];
+
+                samples[i] = out;
+
+                // Shift data
+                for (size_t k = 0; k < N - 2; k++)
+                    buf[k] = buf[k + 2];
+
+                // Circular buffer
+                pos = (pos == 0 ? Ndiv4 : pos - 1);
+            }
+
+            positionInterleaved.setUnchecked (static_cast<int> (group), pos);
+        }
+    }
+   #endif
+
 private:
     //===============================================================================
     dsp::FIR::Coefficients<SampleType> coefficientsUp, coefficientsDown;
     AudioBuffer<SampleType> stateUp, stateDown, stateDown2;
     Array<size_t> position;
 
+   #if JUCE_USE_SIMD
+    typedef typename OversamplingInterleavedBuffer<SampleType>::Register Register;
+
+    OversamplingInterleavedBuffer<SampleType> firUpInterleaved, firDownInterleaved;
+    OversamplingInterleavedBuffer<SampleType> stateUpInterleaved, stateDownInterleaved, stateDown2Interleaved;
+    Array<size_t> positionInterleaved;
+   #endif
+
     //===============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Oversampling2TimesEquirippleFIR)
 };
@@ -282,7 +560,7 @@ public:
                                     SampleType normalizedTransitionWidthUp,
                                     SampleType stopbandAttenuationdBUp,
                                     SampleType normalizedTransitionWidthDown,
-                                    SampleType stopbandAttenuationdBDown) : OversamplingEngine<SampleType> (2, numChannels)
+                                    SampleType stopbandAttenuationdBDown) : OversamplingEngine<SampleType> (numChannels, 2)
     {
         auto structureUp = dsp::FilterDesign<SampleType>::designIIRLowpassHalfBandPolyphaseAllpassMethod (normalizedTransitionWidthUp, stopbandAttenuationdBUp);
         dsp::IIR::Coefficients<SampleType> coeffsUp = getCoefficients (structureUp);
@@ -324,6 +602,12 @@ public:
         v1Up.clear();
         v1Down.clear();
         delayDown.fill (0);
+
+       #if JUCE_USE_SIMD
+        v1UpInterleaved.clear();
+        v1DownInterleaved.clear();
+        delayDownInterleaved.clear();
+       #endif
     }
 
     void processSamplesUp (dsp::AudioBlock<SampleType> &inputBlock) override
@@ -434,6 +718,134 @@ public:
         snapToZero (false);
     }
 
+   #if JUCE_USE_SIMD
+    //===============================================================================
+    void initInterleavedProcessing (size_t maximumNumberOfSamplesBeforeOversampling) override
+    {
+        OversamplingEngine<SampleType>::initInterleavedProcessing (maximumNumberOfSamplesBeforeOversampling);
+
+        auto numGroups = OversamplingEngine<SampleType>::getNumGroups();
+
+        v1UpInterleaved.setSize (numGroups, static_cast<size_t> (coefficientsUp.size()));
+        v1DownInterleaved.setSize (numGroups, static_cast<size_t> (coefficientsDown.size()));
+        delayDownInterleaved.setSize (numGroups, 1);
+
+        coefficientsUpInterleaved.setSize (1, static_cast<size_t> (coefficientsUp.size()));
+        coefficientsDownInterleaved.setSize (1, static_cast<size_t> (coefficientsDown.size()));
+
+        for (auto n = 0; n < coefficientsUp.size(); n++)
+            coefficientsUpInterleaved.getGroup (0)[n] = Register::expand (coefficientsUp.getUnchecked (n));
+
+        for (auto n = 0; n < coefficientsDown.size(); n++)
+            coefficientsDownInterleaved.getGroup (0)[n] = Register::expand (coefficientsDown.getUnchecked (n));
+    }
+
+    void processSamplesUpInterleaved (OversamplingInterleavedBuffer<SampleType>& inputSamples, size_t numSamples) override
+    {
+        jassert (numSamples * OversamplingEngine<SampleType>::factor <= OversamplingEngine<SampleType>::interleaved.getNumSamples());
+
+        // Initialization
+        auto coeffs = coefficientsUpInterleaved.getGroup (0);
+        auto numStages = coefficientsUp.size();
+        auto delayedStages = numStages / 2;
+        auto directStages = numStages - delayedStages;
+
+        // Processing
+        for (size_t group = 0; group < OversamplingEngine<SampleType>::getNumGroups(); group++)
+        {
+            auto bufferSamples = OversamplingEngine<SampleType>::interleaved.getGroup (group);
+            auto lv1 = v1UpInterleaved.getGroup (group);
+            auto samples = inputSamples.getGroup (group);
+
+            for (size_t i = 0; i < numSamples; i++)
+            {
+                // Direct path cascaded allpass filters
+                auto input = samples[i];
+                for (auto n = 0; n < directStages; n++)
+                {
+                    auto alpha = coeffs[n];
+                    auto output = alpha * input + lv1[n];
+                    lv1[n] = input - alpha * output;
+                    input = output;
+                }
+
+                // Output
+                bufferSamples[i << 1] = input;
+
+                // Delayed path cascaded allpass filters
+                input = samples[i];
+                for (auto n = directStages; n < numStages; n++)
+                {
+                    auto alpha = coeffs[n];
+                    auto output = alpha * input + lv1[n];
+                    lv1[n] = input - alpha * output;
+                    input = output;
+                }
+
+                // Output
+                bufferSamples[(i << 1) + 1] = input;
+            }
+        }
+
+        // Snap To Zero
+        v1UpInterleaved.snapToZero();
+    }
+
+    void processSamplesDownInterleaved (OversamplingInterleavedBuffer<SampleType>& outputSamples, size_t numSamples) override
+    {
+        jassert (numSamples <= outputSamples.getNumSamples());
+
+        // Initialization
+        auto coeffs = coefficientsDownInterleaved.getGroup (0);
+        auto numStages = coefficientsDown.size();
+        auto delayedStages = numStages / 2;
+        auto directStages = numStages - delayedStages;
+        auto half = Register::expand (static_cast<SampleType> (0.5));
+
+        // Processing
+        for (size_t group = 0; group < OversamplingEngine<SampleType>::getNumGroups(); group++)
+        {
+            auto bufferSamples = OversamplingEngine<SampleType>::interleaved.getGroup (group);
+            auto lv1 = v1DownInterleaved.getGroup (group);
+            auto samples = outputSamples.getGroup (group);
+            auto delay = delayDownInterleaved.getGroup (group)[0];
+
+            for (size_t i = 0; i < numSamples; i++)
+            {
+                // Direct path cascaded allpass filters
+                auto input = bufferSamples[i << 1];
+                for (auto n = 0; n < directStages; n++)
+                {
+                    auto alpha = coeffs[n];
+                    auto output = alpha * input + lv1[n];
+                    lv1[n] = input - alpha * output;
+                    input = output;
+                }
+                auto directOut = input;
+
+                // Delayed path cascaded allpass filters
+                input = bufferSamples[(i << 1) + 1];
+                for (auto n = directStages; n < numStages; n++)
+                {
+                    auto alpha = coeffs[n];
+                    auto output = alpha * input + lv1[n];
+                    lv1[n] = input - alpha * output;
+                    input = output;
+                }
+
+                // Output
+                samples[i] = (delay + directOut) * half;
+                delay = input;
+            }
+
+            delayDownInterleaved.getGroup (group)[0] = delay;
+        }
+
+        // Snap To Zero
+        v1DownInterleaved.snapToZero();
+    }
+   #endif
+
     void snapToZero (bool snapUpProcessing)
     {
         if (snapUpProcessing)
@@ -544,6 +956,13 @@ private:
     AudioBuffer<SampleType> v1Up, v1Down;
     Array<SampleType> delayDown;
 
+   #if JUCE_USE_SIMD
+    typedef typename OversamplingInterleavedBuffer<SampleType>::Register Register;
+
+    OversamplingInterleavedBuffer<SampleType> coefficientsUpInterleaved, coefficientsDownInterleaved;
+    OversamplingInterleavedBuffer<SampleType> v1UpInterleaved, v1DownInterleaved, delayDownInterleaved;
+   #endif
+
     //===============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Oversampling2TimesPolyphaseIIR)
 };
@@ -560,6 +979,11 @@ Oversampling<SampleType>::Oversampling (size_t newNumChannels, size_t newFactor,
     type = newType;
     numChannels = newNumChannels;
 
+   #if JUCE_USE_SIMD
+    // a single channel would leave most of the lanes empty
+    isInterleaved = (numChannels > 1 && newFactor > 0);
+   #endif
+
     if (newFactor == 0)
     {
         numStages = 1;
@@ -643,12 +1067,31 @@ void Oversampling<SampleType>::initProcessing (size_t maximumNumberOfSamplesBefo
 
     auto currentNumSamples = maximumNumberOfSamplesBeforeOversampling;
 
-    for (size_t n = 0; n < numStages; n++)
+   #if JUCE_USE_SIMD
+    if (isInterleaved)
     {
-        auto& engine = *engines[static_cast<int> (n)];
+        interleavedInput = new OversamplingInterleavedBuffer<SampleType>();
+        interleavedInput->setSize (OversamplingInterleavedBuffer<SampleType>::getNumGroupsFor (numChannels), currentNumSamples);
+        oversampledBuffer.setSize (static_cast<int> (numChannels), static_cast<int> (currentNumSamples * factorOversampling), false, false, true);
 
-        engine.initProcessing (currentNumSamples);
-        currentNumSamples *= engine.getFactor();
+        for (size_t n = 0; n < numStages; n++)
+        {
+            auto& engine = *engines[static_cast<int> (n)];
+
+            engine.initInterleavedProcessing (currentNumSamples);
+            currentNumSamples *= engine.getFactor();
+        }
+    }
+    else
+   #endif
+    {
+        for (size_t n = 0; n < numStages; n++)
+        {
+            auto& engine = *engines[static_cast<int> (n)];
+
+            engine.initProcessing (currentNumSamples);
+            currentNumSamples *= engine.getFactor();
+        }
     }
     isReady = true;
 
@@ -661,8 +1104,18 @@ void Oversampling<SampleType>::reset() noexcept
     jassert (engines.size() > 0);
 
     if (isReady)
+    {
         for (auto n = 0; n < engines.size(); n++)
             engines[n]->reset();
+
+       #if JUCE_USE_SIMD
+        if (isInterleaved)
+        {
+            interleavedInput->clear();
+            oversampledBuffer.clear();
+        }
+       #endif
+    }
 }
 
 template <typename SampleType>
@@ -673,6 +1126,31 @@ typename dsp::AudioBlock<SampleType> Oversampling<SampleType>::processSamplesUp
     if (! isReady)
         return dsp::AudioBlock<SampleType>();
 
+   #if JUCE_USE_SIMD
+    if (isInterleaved)
+    {
+        // the stages pass the samples on interleaved, only the result is split up again
+        auto currentNumSamples = inputBlock.getNumSamples();
+        auto input = interleavedInput.get();
+
+        input->interleave (inputBlock);
+
+        for (size_t n = 0; n < numStages; n++)
+        {
+            auto& engine = *engines[static_cast<int> (n)];
+            engine.processSamplesUpInterleaved (*input, currentNumSamples);
+
+            input = &engine.getInterleavedSamples();
+            currentNumSamples *= engine.getFactor();
+        }
+
+        auto audioBlock = dsp::AudioBlock<SampleType> (oversampledBuffer).getSubBlock (0, currentNumSamples);
+        input->deinterleave (audioBlock);
+
+        return audioBlock;
+    }
+   #endif
+
     dsp::AudioBlock<SampleType> audioBlock = inputBlock;
 
     for (size_t n = 0; n < numStages; n++)
@@ -693,6 +1171,27 @@ void Oversampling<SampleType>::processSamplesDown (dsp::AudioBlock<SampleType> &
     if (! isReady)
         return;
 
+   #if JUCE_USE_SIMD
+    if (isInterleaved)
+    {
+        auto currentNumSamples = outputBlock.getNumSamples() * factorOversampling;
+
+        engines.getLast()->getInterleavedSamples().interleave (dsp::AudioBlock<SampleType> (oversampledBuffer).getSubBlock (0, currentNumSamples));
+
+        for (size_t n = numStages - 1; n > 0; n--)
+        {
+            auto& engine = *engines[static_cast<int> (n)];
+
+            currentNumSamples /= engine.getFactor();
+            engine.processSamplesDownInterleaved (engines[static_cast<int> (n - 1)]->getInterleavedSamples(), currentNumSamples);
+        }
+
+        engines[static_cast<int> (0)]->processSamplesDownInterleaved (*interleavedInput, outputBlock.getNumSamples());
+        interleavedInput->deinterleave (outputBlock);
+        return;
+    }
+   #endif
+
     auto currentNumSamples = outputBlock.getNumSamples();
 
     for (size_t n = 0; n < numStages - 1; n++)
@@ -32,6 +32,9 @@ namespace dsp
 template <typename NumericType>
 class OversamplingEngine;
 
+template <typename NumericType>
+class OversamplingInterleavedBuffer;
+
 //===============================================================================
 /**
     A processing class performing multi-channel oversampling.
@@ -52,6 +55,11 @@ class OversamplingEngine;
     latency is maximum. With IIR filtering, the phase is compromised around the
     Nyquist frequency but the phase is minimum.
 
+    When SIMD is available and there is more than one channel, the channels are
+    filtered together, SIMDRegister::size() at a time, and the samples stay
+    interleaved between the stages. Only the block returned by processSamplesUp
+    and the one given to processSamplesDown are split in channels.
+
     @see FilterDesign.
 */
 template <typename SampleType>
@@ -138,6 +146,12 @@ private:
 
     OwnedArray<OversamplingEngine<SampleType>> engines;
 
+   #if JUCE_USE_SIMD
+    bool isInterleaved = false;
+    ScopedPointer<OversamplingInterleavedBuffer<SampleType>> interleavedInput;
+    AudioBuffer<SampleType> oversampledBuffer;
+   #endif
+
     //===============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Oversampling)
 };
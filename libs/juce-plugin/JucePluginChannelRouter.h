@@ -0,0 +1,303 @@
+/*
+  ==============================================================================
+
+   Channel router for juce plugins
+
+   Shared by the plugin wrappers of juce-current and juce-legacy.
+
+  ==============================================================================
+*/
+
+#ifndef JUCE_PLUGIN_CHANNEL_ROUTER_H_INCLUDED
+#define JUCE_PLUGIN_CHANNEL_ROUTER_H_INCLUDED
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Maps the host's input and output channel pointers onto the single in-place
+    channel array that AudioProcessor::processBlock() works on. All plugin
+    wrappers use it.
+
+    prepare() is called when the plugin is activated and does all allocation,
+    for the largest layout the plugin can switch to. setLayout(), beginBlock()
+    and endBlock() never allocate. The copy plan is recomputed only when the
+    layout or the host's set of pointers changes, which normally happens once.
+
+    Rules of the plan:
+     - An output that is also the matching input is processed in place, with
+       no copy.
+     - An output that aliases some other input is overwritten only after that
+       input has been read. Copies that form a cycle go through scratch memory.
+     - A null output, or one shared by several channels, gets a scratch
+       channel. Non-null ones are copied back in endBlock().
+     - Plugin input channels beyond the number of outputs refer to the host's
+       input buffers directly, unless the host passed the same buffer twice.
+
+    Layouts of 32 or more channels use JUCE's heap channel table. That table
+    is only reallocated when the plan or the block size changes.
+*/
+template <typename FloatType>
+class PluginChannelRouter
+{
+public:
+    PluginChannelRouter() = default;
+
+    /** Allocates for layouts of up to the given number of channels and selects the largest one.
+        Not realtime-safe, call when the plugin is activated.
+    */
+    void prepare (int maxInputChannels, int maxOutputChannels, int maximumBlockSize)
+    {
+        maxIns  = jmax (0, maxInputChannels);
+        maxOuts = jmax (0, maxOutputChannels);
+        maxBlockSize = jmax (1, maximumBlockSize);
+
+        const auto maxChannels = jmax (maxIns, maxOuts);
+
+        // one channel per plugin channel that can't use host memory, plus one per output to break cycles
+        scratch.setSize (jmax (1, maxChannels + maxOuts), maxBlockSize, false, true, false);
+
+        channels.calloc (maxChannels + 1);
+        lastInputs.calloc (maxIns + 1);
+        lastOutputs.calloc (maxOuts + 1);
+        pending.calloc (maxOuts + 1);
+        steps.calloc (maxIns + 2 * maxOuts + 1);
+        copyBacks.calloc (maxOuts + 1);
+
+        numIns = numOuts = -1;
+        setLayout (maxIns, maxOuts);
+    }
+
+    /** Switches to the plugin's current layout without allocating. Returns false if it has more
+        channels than were prepared for, beginBlock() must not be called then.
+    */
+    bool setLayout (int numInputChannels, int numOutputChannels) noexcept
+    {
+        if (numInputChannels == numIns && numOutputChannels == numOuts)
+            return true;
+
+        if (numInputChannels < 0 || numInputChannels > maxIns || numOutputChannels < 0 || numOutputChannels > maxOuts)
+            return false;
+
+        numIns  = numInputChannels;
+        numOuts = numOutputChannels;
+        numChannels = jmax (numIns, numOuts);
+        planIsValid = false;
+        return true;
+    }
+
+    void release()
+    {
+        scratch.setSize (0, 0);
+        channels.free();
+        lastInputs.free();
+        lastOutputs.free();
+        pending.free();
+        steps.free();
+        copyBacks.free();
+
+        numIns = numOuts = numChannels = maxIns = maxOuts = 0;
+        planIsValid = false;
+    }
+
+    /** Prepares the host's buffers for processing and returns the buffer to pass to processBlock().
+
+        inputs and outputs must hold the number of channels of the current layout, null entries are
+        allowed. Returns nullptr if the block is longer than the prepared maximum and the plan
+        needs scratch memory.
+    */
+    AudioBuffer<FloatType>* beginBlock (FloatType* const* inputs, FloatType* const* outputs, int numSamples) noexcept
+    {
+        bool needsNewReference = ! planIsValid || numSamples != buffer.getNumSamples() || buffer.hasBeenCleared();
+
+        if (! planMatches (inputs, outputs))
+        {
+            computePlan (inputs, outputs);
+            needsNewReference = true;
+        }
+
+        if (usesScratch && numSamples > maxBlockSize)
+        {
+            jassertfalse; // the host is exceeding the block size it announced
+            return nullptr;
+        }
+
+        for (int i = 0; i < numSteps; ++i)
+        {
+            if (steps[i].source != nullptr)
+                FloatVectorOperations::copy (steps[i].dest, steps[i].source, numSamples);
+            else
+                FloatVectorOperations::clear (steps[i].dest, numSamples);
+        }
+
+        // re-referring also resets the buffer's "is clear" flag a processor may have set last time
+        if (needsNewReference)
+            buffer.setDataToReferTo (channels.get(), numChannels, numSamples);
+
+        return &buffer;
+    }
+
+    /** Copies the output channels that were processed in scratch memory to the host. */
+    void endBlock (int numSamples) noexcept
+    {
+        for (int i = 0; i < numCopyBacks; ++i)
+            FloatVectorOperations::copy (copyBacks[i].dest, copyBacks[i].source, numSamples);
+    }
+
+    int getNumInputChannels() const noexcept   { return numIns; }
+    int getNumOutputChannels() const noexcept  { return numOuts; }
+
+private:
+    //==============================================================================
+    struct Step
+    {
+        FloatType* dest;
+        const FloatType* source;  // nullptr to clear dest
+    };
+
+    bool planMatches (FloatType* const* inputs, FloatType* const* outputs) const noexcept
+    {
+        if (! planIsValid)
+            return false;
+
+        for (int i = 0; i < numIns; ++i)
+            if (lastInputs[i] != inputs[i])
+                return false;
+
+        for (int i = 0; i < numOuts; ++i)
+            if (lastOutputs[i] != outputs[i])
+                return false;
+
+        return true;
+    }
+
+    bool isUsedByOtherChannel (const FloatType* ptr, int channel, FloatType* const* inputs, FloatType* const* outputs) const noexcept
+    {
+        for (int i = 0; i < channel; ++i)
+            if (outputs[i] == ptr)
+                return true;
+
+        // input channels beyond the outputs are processed in the host's memory
+        for (int i = numOuts; i < numIns; ++i)
+            if (inputs[i] == ptr)
+                return true;
+
+        return false;
+    }
+
+    void computePlan (FloatType* const* inputs, FloatType* const* outputs) noexcept
+    {
+        numSteps = 0;
+        numCopyBacks = 0;
+        usesScratch = false;
+
+        for (int i = 0; i < numOuts; ++i)
+        {
+            auto* out = outputs[i];
+
+            if (out == nullptr || isUsedByOtherChannel (out, i, inputs, outputs))
+            {
+                channels[i] = scratch.getWritePointer (i);
+                usesScratch = true;
+
+                if (out != nullptr)
+                    copyBacks[numCopyBacks++] = { out, channels[i] };
+            }
+            else
+            {
+                channels[i] = out;
+            }
+        }
+
+        for (int i = numOuts; i < numIns; ++i)
+        {
+            bool isDuplicate = false;
+
+            for (int j = numOuts; j < i && ! isDuplicate; ++j)
+                isDuplicate = (inputs[j] == inputs[i]);
+
+            if (inputs[i] != nullptr && ! isDuplicate)
+            {
+                channels[i] = inputs[i];
+            }
+            else
+            {
+                channels[i] = scratch.getWritePointer (i);
+                steps[numSteps++] = { channels[i], inputs[i] };
+                usesScratch = true;
+            }
+        }
+
+        // the copies of inputs into output channels, ordered so that no input is overwritten before it's read
+        int numPending = 0;
+
+        for (int i = 0; i < numOuts; ++i)
+        {
+            const FloatType* source = i < numIns ? inputs[i] : nullptr;
+
+            if (source != channels[i])
+                pending[numPending++] = { channels[i], source };
+        }
+
+        int numStashes = 0;
+
+        while (numPending > 0)
+        {
+            int ready = -1;
+
+            for (int i = 0; i < numPending && ready < 0; ++i)
+            {
+                bool destIsStillRead = false;
+
+                for (int j = 0; j < numPending && ! destIsStillRead; ++j)
+                    destIsStillRead = (j != i && pending[j].source == pending[i].dest);
+
+                if (! destIsStillRead)
+                    ready = i;
+            }
+
+            if (ready < 0)
+            {
+                // every destination left is read by another copy, i.e. a cycle: move one out of the way
+                auto* blockedDest = pending[0].dest;
+                auto* stash = scratch.getWritePointer (numChannels + numStashes++);
+
+                steps[numSteps++] = { stash, blockedDest };
+
+                for (int j = 1; j < numPending; ++j)
+                    if (pending[j].source == blockedDest)
+                        pending[j].source = stash;
+
+                usesScratch = true;
+                ready = 0;
+            }
+
+            steps[numSteps++] = pending[ready];
+            pending[ready] = pending[--numPending];
+        }
+
+        for (int i = 0; i < numIns; ++i)
+            lastInputs[i] = inputs[i];
+
+        for (int i = 0; i < numOuts; ++i)
+            lastOutputs[i] = outputs[i];
+
+        planIsValid = true;
+    }
+
+    //==============================================================================
+    int numIns = 0, numOuts = 0, numChannels = 0, maxIns = 0, maxOuts = 0, maxBlockSize = 0;
+    int numSteps = 0, numCopyBacks = 0;
+    bool planIsValid = false, usesScratch = false;
+
+    AudioBuffer<FloatType> scratch, buffer;
+    HeapBlock<FloatType*> channels, lastInputs, lastOutputs;
+    HeapBlock<Step> pending, steps, copyBacks;
+
+    JUCE_DECLARE_NON_COPYABLE (PluginChannelRouter)
+};
+
+} // namespace juce
+
+#endif // JUCE_PLUGIN_CHANNEL_ROUTER_H_INCLUDED
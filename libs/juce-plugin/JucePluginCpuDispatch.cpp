@@ -0,0 +1,62 @@
+/*
+  ==============================================================================
+
+   Runtime CPU dispatch for hot DSP code, see JucePluginCpuDispatch.h
+
+   The clones themselves are resolved by the dynamic loader. To find out which
+   one it picked, one more function is versioned for the same targets and
+   resolved the same way, each version returns its own name. Debug builds
+   report it once when the plugin binary is loaded, release builds only when
+   JUCE_PLUGIN_CPU_DISPATCH_REPORT is set in the environment.
+
+  ==============================================================================
+*/
+
+#include "JucePluginCpuDispatch.h"
+
+#if JUCE_PLUGIN_CPU_DISPATCH
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace JucePluginCpuDispatch
+{
+
+// the targets of JUCE_PLUGIN_CPU_DISPATCH_CLONES, the loader resolves this to the
+// version it resolves the marked functions to
+__attribute__((target ("default")))        static const char* resolvedVariantName() noexcept  { return "x86-64"; }
+__attribute__((target ("arch=x86-64-v2"))) static const char* resolvedVariantName() noexcept  { return "x86-64-v2"; }
+__attribute__((target ("arch=x86-64-v3"))) static const char* resolvedVariantName() noexcept  { return "x86-64-v3"; }
+
+const char* getActiveVariantName() noexcept
+{
+    return resolvedVariantName();
+}
+
+static const struct Reporter
+{
+    Reporter()
+    {
+        // no JUCE headers here, so check the build's own debug defines
+       #if ! (defined (DEBUG) || defined (_DEBUG))
+        if (std::getenv ("JUCE_PLUGIN_CPU_DISPATCH_REPORT") == nullptr)
+            return;
+       #endif
+
+       #if JucePlugin_Build_LV2
+        const char* const formatName = "LV2";
+       #elif JucePlugin_Build_VST
+        const char* const formatName = "VST2";
+       #elif JucePlugin_Build_VST3
+        const char* const formatName = "VST3";
+       #else
+        const char* const formatName = "Standalone";
+       #endif
+
+        std::fprintf (stderr, "%s (%s): using %s DSP code\n", JucePlugin_Name, formatName, getActiveVariantName());
+    }
+} reporter;
+
+}
+
+#endif // JUCE_PLUGIN_CPU_DISPATCH
@@ -0,0 +1,43 @@
+/*
+  ==============================================================================
+
+   Runtime CPU dispatch for hot DSP code
+
+   Enabled with the 'cpu-dispatch' meson option (x86-64 Linux, GCC 11 or
+   later). Functions marked with JUCE_PLUGIN_CPU_DISPATCH_CLONES are compiled
+   once each for the x86-64 baseline, x86-64-v2 and x86-64-v3. The dynamic
+   loader picks the best version the CPU supports when the plugin binary is
+   loaded, so there is still one binary per format. Debug builds print the
+   picked variant to stderr on load; set JUCE_PLUGIN_CPU_DISPATCH_REPORT in
+   the environment to get it from a release build.
+
+   Mark functions that loop over whole blocks. A marked function cannot be
+   inlined into its callers, but everything it calls is inlined into it
+   where possible, so the DSP code it runs is compiled for each target.
+   Function templates can be marked too, every instantiation gets its own
+   clones. Calls through virtual functions can't be followed, call the final
+   class directly instead.
+
+   This header has no JUCE dependency, DSP code that doesn't include
+   JuceHeader.h can include it directly.
+
+  ==============================================================================
+*/
+
+#ifndef JUCE_PLUGIN_CPU_DISPATCH_H_INCLUDED
+#define JUCE_PLUGIN_CPU_DISPATCH_H_INCLUDED
+
+#if JUCE_PLUGIN_CPU_DISPATCH
+ #define JUCE_PLUGIN_CPU_DISPATCH_CLONES \
+    __attribute__((target_clones ("default", "arch=x86-64-v2", "arch=x86-64-v3"), flatten))
+
+namespace JucePluginCpuDispatch
+{
+    /** Name of the variant the loader picked on this CPU, e.g. "x86-64-v3". */
+    const char* getActiveVariantName() noexcept;
+}
+#else
+ #define JUCE_PLUGIN_CPU_DISPATCH_CLONES
+#endif
+
+#endif // JUCE_PLUGIN_CPU_DISPATCH_H_INCLUDED
@@ -0,0 +1,411 @@
+/*
+  ==============================================================================
+
+   Shared filter building blocks for the plugin ports
+
+   JucePluginFilterLanes holds one sample of up to four channels. With GCC
+   and clang it is a vector register (SSE, NEON), otherwise a plain array.
+   Its operators do per lane exactly what the same float operators do, so
+   a mono filter turns into one that runs all channels at once by changing
+   the type of its state, and still gives the same output on every channel.
+
+   JucePluginSvf is a state variable filter in topology-preserving form
+   (trapezoidal integrators). It doesn't click or blow up when its cutoff
+   moves at audio rate. Its coefficients come from a rational tan()
+   approximation, and are only computed again when a parameter really
+   changes, so it can be set every few samples at little cost. Any first or
+   second order response that the bilinear transform turns into a biquad
+   can be set from its analog prototype, which covers the RBJ cookbook
+   filters.
+
+   This header has no JUCE dependency, DSP code that doesn't include
+   JuceHeader.h can include it directly.
+
+  ==============================================================================
+*/
+
+#ifndef JUCE_PLUGIN_FILTERS_H_INCLUDED
+#define JUCE_PLUGIN_FILTERS_H_INCLUDED
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined (__GNUC__)
+ #define JUCE_PLUGIN_FILTERS_VECTOR 1
+#else
+ #define JUCE_PLUGIN_FILTERS_VECTOR 0
+#endif
+
+//==============================================================================
+class JucePluginFilterLanes
+{
+public:
+    enum { size = 4 };
+
+    JucePluginFilterLanes()
+    {
+        for (int i = 0; i < size; ++i)
+            v[i] = 0.0f;
+    }
+
+    /** Puts the same value in all lanes, so floats mix freely with lanes. */
+    JucePluginFilterLanes (const float value)
+    {
+        for (int i = 0; i < size; ++i)
+            v[i] = value;
+    }
+
+    /** Reads sample index of each channel into its lane, the lanes after numChannels are 0. */
+    static JucePluginFilterLanes fromChannels (const float* const* channels, const int numChannels, const int index)
+    {
+        JucePluginFilterLanes result;
+
+        for (int i = 0; i < numChannels; ++i)
+            result.v[i] = channels[i][index];
+
+        return result;
+    }
+
+    /** Writes the first numChannels lanes to sample index of their channels. */
+    void toChannels (float* const* channels, const int numChannels, const int index) const
+    {
+        for (int i = 0; i < numChannels; ++i)
+            channels[i][index] = v[i];
+    }
+
+    /** Reads size consecutive floats, which need no particular alignment. */
+    static JucePluginFilterLanes fromArray (const float* const values)
+    {
+        JucePluginFilterLanes result;
+        std::memcpy (&result.v, values, sizeof (result.v));
+        return result;
+    }
+
+    /** Writes the lanes to size consecutive floats, which need no particular alignment. */
+    void toArray (float* const values) const
+    {
+        std::memcpy (values, &v, sizeof (v));
+    }
+
+    float get (const int lane) const                { return v[lane]; }
+    void set (const int lane, const float value)    { v[lane] = value; }
+
+    //==============================================================================
+    friend JucePluginFilterLanes operator+ (const JucePluginFilterLanes& a, const JucePluginFilterLanes& b)
+    {
+        JucePluginFilterLanes result;
+       #if JUCE_PLUGIN_FILTERS_VECTOR
+        result.v = a.v + b.v;
+       #else
+        for (int i = 0; i < size; ++i)
+            result.v[i] = a.v[i] + b.v[i];
+       #endif
+        return result;
+    }
+
+    friend JucePluginFilterLanes operator- (const JucePluginFilterLanes& a, const JucePluginFilterLanes& b)
+    {
+        JucePluginFilterLanes result;
+       #if JUCE_PLUGIN_FILTERS_VECTOR
+        result.v = a.v - b.v;
+       #else
+        for (int i = 0; i < size; ++i)
+            result.v[i] = a.v[i] - b.v[i];
+       #endif
+        return result;
+    }
+
+    friend JucePluginFilterLanes operator* (const JucePluginFilterLanes& a, const JucePluginFilterLanes& b)
+    {
+        JucePluginFilterLanes result;
+       #if JUCE_PLUGIN_FILTERS_VECTOR
+        result.v = a.v * b.v;
+       #else
+        for (int i = 0; i < size; ++i)
+            result.v[i] = a.v[i] * b.v[i];
+       #endif
+        return result;
+    }
+
+    friend JucePluginFilterLanes operator/ (const JucePluginFilterLanes& a, const JucePluginFilterLanes& b)
+    {
+        JucePluginFilterLanes result;
+       #if JUCE_PLUGIN_FILTERS_VECTOR
+        result.v = a.v / b.v;
+       #else
+        for (int i = 0; i < size; ++i)
+            result.v[i] = a.v[i] / b.v[i];
+       #endif
+        return result;
+    }
+
+    JucePluginFilterLanes operator-() const
+    {
+        JucePluginFilterLanes result;
+       #if JUCE_PLUGIN_FILTERS_VECTOR
+        result.v = -v;
+       #else
+        for (int i = 0; i < size; ++i)
+            result.v[i] = -v[i];
+       #endif
+        return result;
+    }
+
+    JucePluginFilterLanes& operator+= (const JucePluginFilterLanes& other)  { return *this = *this + other; }
+    JucePluginFilterLanes& operator-= (const JucePluginFilterLanes& other)  { return *this = *this - other; }
+    JucePluginFilterLanes& operator*= (const JucePluginFilterLanes& other)  { return *this = *this * other; }
+    JucePluginFilterLanes& operator/= (const JucePluginFilterLanes& other)  { return *this = *this / other; }
+
+    //==============================================================================
+    static JucePluginFilterLanes abs (const JucePluginFilterLanes& a)
+    {
+        JucePluginFilterLanes result;
+       #if JUCE_PLUGIN_FILTERS_VECTOR
+        const Mask signBits = { 0x7fffffff, 0x7fffffff, 0x7fffffff, 0x7fffffff };
+        result.v = (Vector) ((Mask) a.v & signBits);
+       #else
+        for (int i = 0; i < size; ++i)
+            result.v[i] = std::fabs (a.v[i]);
+       #endif
+        return result;
+    }
+
+    /** Returns a mask for select() of the lanes where a > b. */
+    static JucePluginFilterLanes greaterThan (const JucePluginFilterLanes& a, const JucePluginFilterLanes& b)
+    {
+        JucePluginFilterLanes result;
+       #if JUCE_PLUGIN_FILTERS_VECTOR
+        result.v = (Vector) (a.v > b.v);
+       #else
+        for (int i = 0; i < size; ++i)
+            result.v[i] = a.v[i] > b.v[i] ? 1.0f : 0.0f;
+       #endif
+        return result;
+    }
+
+    /** Takes the lanes of ifTrue where the mask is set, the ones of ifFalse elsewhere. */
+    static JucePluginFilterLanes select (const JucePluginFilterLanes& mask,
+                                         const JucePluginFilterLanes& ifTrue,
+                                         const JucePluginFilterLanes& ifFalse)
+    {
+        JucePluginFilterLanes result;
+       #if JUCE_PLUGIN_FILTERS_VECTOR
+        result.v = (Vector) (((Mask) mask.v & (Mask) ifTrue.v) | (~(Mask) mask.v & (Mask) ifFalse.v));
+       #else
+        for (int i = 0; i < size; ++i)
+            result.v[i] = mask.v[i] != 0.0f ? ifTrue.v[i] : ifFalse.v[i];
+       #endif
+        return result;
+    }
+
+    static bool allEqual (const JucePluginFilterLanes& a, const JucePluginFilterLanes& b)
+    {
+        for (int i = 0; i < size; ++i)
+            if (a.v[i] != b.v[i])
+                return false;
+
+        return true;
+    }
+
+private:
+   #if JUCE_PLUGIN_FILTERS_VECTOR
+    typedef float Vector __attribute__ ((vector_size (16)));
+    typedef int32_t Mask __attribute__ ((vector_size (16)));
+
+    Vector v;
+   #else
+    float v[size];
+   #endif
+};
+
+//==============================================================================
+class JucePluginSvf
+{
+public:
+    enum { maxChannels = JucePluginFilterLanes::size };
+
+    JucePluginSvf()
+        : sampleRate (44100.0),
+          cachedOrder (0)
+    {
+        setGain (1.0);
+        reset();
+    }
+
+    /** Clears the cached parameters, set the response again after this. */
+    void setSampleRate (const double newSampleRate)
+    {
+        sampleRate = newSampleRate > 0.0 ? newSampleRate : 44100.0;
+        cachedOrder = 0;
+    }
+
+    /** Clears the state of all channels. */
+    void reset()
+    {
+        ic1eq = ic2eq = 0.0f;
+    }
+
+    //==============================================================================
+    /** Second order Butterworth lowpass (q = 1/sqrt(2)), or resonant with a higher q. */
+    void setLowPass (const double frequency, const double q = 0.70710678118654752)
+    {
+        setSecondOrder (frequency, 1.0, 1.0 / q, 0.0, 0.0, 1.0);
+    }
+
+    void setHighPass (const double frequency, const double q = 0.70710678118654752)
+    {
+        setSecondOrder (frequency, 1.0, 1.0 / q, 1.0, 0.0, 0.0);
+    }
+
+    /** Lets the signal through, scaled by gain. */
+    void setGain (const double gain)
+    {
+        setSecondOrder (1000.0, 1.0, 1.0, gain, gain, gain);
+    }
+
+    /** Sets the response from its analog prototype
+            H(s) = (n2 s^2 + n1 s + n0) / (a s^2 + b s + 1)
+        where s = j at the given frequency. Both a and b must be above 0.
+        Does nothing if all values are the ones of the last call.
+    */
+    void setSecondOrder (const double frequency, const double a, const double b,
+                         const double n2, const double n1, const double n0)
+    {
+        if (cachedOrder == 2 && frequency == cachedFrequency && a == cachedA && b == cachedB
+             && n2 == cachedN2 && n1 == cachedN1 && n0 == cachedN0)
+            return;
+
+        cachedOrder = 2;
+        cachedFrequency = frequency;
+        cachedA = a; cachedB = b;
+        cachedN2 = n2; cachedN1 = n1; cachedN0 = n0;
+
+        // scale s so that the poles are at |s| = 1, the filter frequency moves with it
+        const double scale = std::sqrt (a);
+
+        g = prewarp (frequency, sampleRate) / scale;
+        k = b / scale;
+        r2 = n2 / a;
+        r1 = n1 / scale;
+        r0 = n0;
+
+        const double d1 = 1.0 / (1.0 + g * (g + k));
+
+        a1 = (float) d1;
+        a2 = (float) (g * d1);
+        a3 = (float) (g * g * d1);
+        m0 = (float) r2;
+        m1 = (float) (r1 - k * r2);
+        m2 = (float) (r0 - r2);
+    }
+
+    /** Sets a first order response H(s) = (n1 s + n0) / (s + 1), with s = j at the given frequency.
+        Does nothing if all values are the ones of the last call.
+    */
+    void setFirstOrder (const double frequency, const double n1, const double n0)
+    {
+        if (cachedOrder == 1 && frequency == cachedFrequency && n1 == cachedN1 && n0 == cachedN0)
+            return;
+
+        cachedOrder = 1;
+        cachedFrequency = frequency;
+        cachedN1 = n1; cachedN0 = n0;
+
+        g = prewarp (frequency, sampleRate);
+        k = 1.0;
+        r2 = 0.0;
+        r1 = n1;
+        r0 = n0;
+
+        a1 = (float) (g / (1.0 + g));
+        m0 = (float) n1;
+        m1 = (float) (n0 - n1);
+    }
+
+    //==============================================================================
+    /** Filters one sample of every channel. */
+    JucePluginFilterLanes processSample (const JucePluginFilterLanes& v0)
+    {
+        if (cachedOrder == 1)
+        {
+            const JucePluginFilterLanes v = (v0 - ic1eq) * a1;
+            const JucePluginFilterLanes lp = v + ic1eq;
+            ic1eq = lp + v;
+
+            return m0 * v0 + m1 * lp;
+        }
+
+        const JucePluginFilterLanes v3 = v0 - ic2eq;
+        const JucePluginFilterLanes v1 = a1 * ic1eq + a2 * v3;
+        const JucePluginFilterLanes v2 = ic2eq + a2 * ic1eq + a3 * v3;
+        ic1eq = v1 + v1 - ic1eq;
+        ic2eq = v2 + v2 - ic2eq;
+
+        return m0 * v0 + m1 * v1 + m2 * v2;
+    }
+
+    /** Filters numSamples of up to maxChannels channels in place. */
+    void processSamples (float* const* channels, const int numChannels, const int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            processSample (JucePluginFilterLanes::fromChannels (channels, numChannels, i))
+                .toChannels (channels, numChannels, i);
+    }
+
+    //==============================================================================
+    /** Returns the gain of the current response at this frequency. */
+    double getMagnitudeResponse (const double frequency) const
+    {
+        // the bilinear transform maps this frequency to s = jw on the prototype
+        const double w = prewarp (frequency, sampleRate) / g;
+
+        if (cachedOrder == 1)
+            return std::sqrt ((r0 * r0 + r1 * r1 * w * w) / (1.0 + w * w));
+
+        const double numRe = r0 - r2 * w * w, numIm = r1 * w;
+        const double denRe = 1.0 - w * w,     denIm = k * w;
+
+        return std::sqrt ((numRe * numRe + numIm * numIm) / (denRe * denRe + denIm * denIm));
+    }
+
+    /** tan (pi * frequency / sampleRate), frequency kept between 0 and just below nyquist. */
+    static double prewarp (double frequency, const double sampleRate)
+    {
+        const double pi = 3.14159265358979323846;
+
+        if (frequency > 0.499 * sampleRate)
+            frequency = 0.499 * sampleRate;
+        if (frequency < 1e-3)
+            frequency = 1e-3;
+
+        double x = pi * frequency / sampleRate;
+
+        // tan x = 1 / tan (pi/2 - x) keeps the rational approximation below pi/4,
+        // where it is within 2e-8 of tan
+        const bool reflect = x > 0.25 * pi;
+
+        if (reflect)
+            x = 0.5 * pi - x;
+
+        const double x2 = x * x;
+        const double t = x * (945.0 + x2 * (-105.0 + x2)) / (945.0 + x2 * (-420.0 + x2 * 15.0));
+
+        return reflect ? 1.0 / t : t;
+    }
+
+private:
+    //==============================================================================
+    double sampleRate;
+
+    int cachedOrder;
+    double cachedFrequency, cachedA, cachedB, cachedN2, cachedN1, cachedN0;
+
+    // the prototype with its poles at |s| = 1, for getMagnitudeResponse()
+    double g, k, r2, r1, r0;
+
+    JucePluginFilterLanes a1, a2, a3, m0, m1, m2;
+    JucePluginFilterLanes ic1eq, ic2eq;
+};
+
+#endif // JUCE_PLUGIN_FILTERS_H_INCLUDED
@@ -0,0 +1,638 @@
+/*
+  ==============================================================================
+
+   Headless realtime runner for juce plugins
+
+   Built instead of the standalone window in linux-embed builds, with the
+   'headless-standalone' meson option. It runs one plugin on an ALSA or JACK
+   device, with no window and no editor:
+
+    - the device is opened with the requested period size and sample rate
+    - all memory is locked with mlockall() before the device starts
+    - the audio thread pins itself to a CPU core and switches to SCHED_FIFO
+      in its first callback
+    - the plugin state can be loaded from a file saved by a host
+    - xruns and callback timing are reported every few seconds, on stdout
+      and to every client connected to an optional local socket
+
+   Report lines are key=value pairs, xruns and overruns (callbacks that took
+   longer than the audio they produced) count from the start, the timing
+   covers the last interval only.
+
+  ==============================================================================
+*/
+
+#include "JucePluginMain.h"
+#include "JucePluginLoadTelemetry.h"
+
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace juce;
+
+extern AudioProcessor* JUCE_CALLTYPE createPluginFilter();
+
+namespace JucePluginHeadlessRunner
+{
+
+//==============================================================================
+static const char* const usage =
+    "Usage: %s [options]\n"
+    "Runs the plugin on an audio device without a GUI\n"
+    "\n"
+    "  --device-type <type>     ALSA or JACK (default ALSA)\n"
+    "  --device <name>          Output device, and input device unless --input-device is given\n"
+    "  --input-device <name>    Input device\n"
+    "  --sample-rate <hz>       Sample rate (default: the device's)\n"
+    "  --period <samples>       Period size (default 256)\n"
+    "  --cpu <core>             Pin the audio thread to this CPU core\n"
+    "  --priority <1-99>        SCHED_FIFO priority of the audio thread (default 70, 0 to leave it)\n"
+    "  --state <file>           Load the plugin state from this file\n"
+    "  --report-interval <s>    Seconds between reports (default 5)\n"
+    "  --socket <path>          Also send reports to clients of this local socket\n"
+    "  --list-devices           List the available devices and exit\n";
+
+struct Options
+{
+    String deviceType { "ALSA" };
+    String outputDevice, inputDevice;
+    double sampleRate = 0.0;
+    int periodSize = 256;
+    int cpuCore = -1;
+    int priority = 70;
+    File stateFile;
+    String socketPath;
+    double reportInterval = 5.0;
+    bool listDevices = false;
+};
+
+static bool parseOptions (int argc, char* argv[], Options& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const String arg (argv[i]);
+
+        if (arg == "--list-devices")
+        {
+            options.listDevices = true;
+            continue;
+        }
+
+        if (i + 1 >= argc)
+            return false;
+
+        const String value (argv[++i]);
+
+        if (arg == "--device-type")
+            options.deviceType = value;
+        else if (arg == "--device")
+            options.outputDevice = value;
+        else if (arg == "--input-device")
+            options.inputDevice = value;
+        else if (arg == "--sample-rate")
+            options.sampleRate = value.getDoubleValue();
+        else if (arg == "--period")
+            options.periodSize = value.getIntValue();
+        else if (arg == "--cpu")
+            options.cpuCore = value.getIntValue();
+        else if (arg == "--priority")
+            options.priority = value.getIntValue();
+        else if (arg == "--state")
+            options.stateFile = File::getCurrentWorkingDirectory().getChildFile (value);
+        else if (arg == "--report-interval")
+            options.reportInterval = value.getDoubleValue();
+        else if (arg == "--socket")
+            options.socketPath = value;
+        else
+            return false;
+    }
+
+    if (options.inputDevice.isEmpty())
+        options.inputDevice = options.outputDevice;
+
+    return options.sampleRate >= 0.0
+        && options.periodSize > 0
+        && options.cpuCore < CPU_SETSIZE
+        && options.priority >= 0 && options.priority <= 99
+        && options.reportInterval > 0.0;
+}
+
+//==============================================================================
+/** Feeds the device's buffers through the plugin and keeps the timing statistics.
+    Nothing in the callback allocates, prints or blocks.
+*/
+class Player : public AudioIODeviceCallback
+{
+public:
+    Player (AudioProcessor& p, const Options& options)
+        : processor (p),
+          numIns (p.getTotalNumInputChannels()),
+          numOuts (p.getTotalNumOutputChannels()),
+          cpuCore (options.cpuCore),
+          priority (options.priority)
+    {
+    }
+
+    //==============================================================================
+    void audioDeviceAboutToStart (AudioIODevice* device) override
+    {
+        sampleRate = device->getCurrentSampleRate();
+        blockSize = jmax (1, device->getCurrentBufferSizeSamples());
+
+        processor.setPlayConfigDetails (numIns, numOuts, sampleRate, blockSize);
+        processor.prepareToPlay (sampleRate, blockSize);
+
+        buffer.setSize (jmax (1, numIns, numOuts), blockSize);
+        midiMessages.ensureSize (2048);
+
+       #if JUCE_PLUGIN_LOAD_TELEMETRY
+        loadMeter.prepare (sampleRate);
+       #endif
+
+        nanosPerSample = 1.0e9 / sampleRate;
+        threadIsSetUp = false;
+    }
+
+    void audioDeviceStopped() override
+    {
+        processor.releaseResources();
+    }
+
+    void audioDeviceError (const String&) override
+    {
+        numDeviceErrors.store (numDeviceErrors.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    void audioDeviceIOCallback (const float** inputs, int numInputs,
+                                float** outputs, int numOutputs, int numSamples) override
+    {
+        if (! threadIsSetUp)
+            setUpAudioThread();
+
+        const auto startTime = std::chrono::steady_clock::now();
+
+        {
+           #if JUCE_PLUGIN_LOAD_TELEMETRY
+            const JucePluginLoadTelemetry::ScopedMeasurement loadMeasurement (loadMeter, numSamples, true);
+           #endif
+
+            // devices may hand over more than the announced period, process it in pieces
+            for (int start = 0; start < numSamples; start += blockSize)
+                processChunk (inputs, numInputs, outputs, numOutputs, start, jmin (blockSize, numSamples - start));
+        }
+
+        const auto nanos = (int64) std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now() - startTime).count();
+
+        // one writer, so plain load + store is enough for the counters
+        numCallbacks.store (numCallbacks.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        totalNanos.store (totalNanos.load (std::memory_order_relaxed) + nanos, std::memory_order_relaxed);
+        totalSamples.store (totalSamples.load (std::memory_order_relaxed) + numSamples, std::memory_order_relaxed);
+
+        if ((double) nanos > numSamples * nanosPerSample)
+            numOverruns.store (numOverruns.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+        // the reporter resets this with exchange(), so it needs a real read-modify-write
+        auto worst = worstNanos.load (std::memory_order_relaxed);
+        while (nanos > worst && ! worstNanos.compare_exchange_weak (worst, nanos, std::memory_order_relaxed)) {}
+    }
+
+    //==============================================================================
+    /** Returns true once, after the audio thread has tried to set itself up. */
+    bool takeThreadSetupResult (int& affinityError, int& schedulingError) noexcept
+    {
+        if (! threadSetupDone.exchange (false, std::memory_order_acquire))
+            return false;
+
+        affinityError = affinityResult;
+        schedulingError = schedulingResult;
+        return true;
+    }
+
+    double getSampleRate() const noexcept  { return sampleRate; }
+    int getBlockSize() const noexcept      { return blockSize; }
+
+    std::atomic<int64> numCallbacks { 0 }, numOverruns { 0 }, totalNanos { 0 }, totalSamples { 0 }, worstNanos { 0 };
+    std::atomic<int> numDeviceErrors { 0 };
+
+private:
+    void setUpAudioThread() noexcept
+    {
+        threadIsSetUp = true;
+        affinityResult = 0;
+        schedulingResult = 0;
+
+        if (cpuCore >= 0)
+        {
+            cpu_set_t cpus;
+            CPU_ZERO (&cpus);
+            CPU_SET (cpuCore, &cpus);
+            affinityResult = pthread_setaffinity_np (pthread_self(), sizeof (cpus), &cpus);
+        }
+
+        if (priority > 0)
+        {
+            sched_param param;
+            zerostruct (param);
+            param.sched_priority = priority;
+            schedulingResult = pthread_setschedparam (pthread_self(), SCHED_FIFO, &param);
+        }
+
+        threadSetupDone.store (true, std::memory_order_release);
+    }
+
+    void processChunk (const float** inputs, int numInputs, float** outputs, int numOutputs, int start, int num) noexcept
+    {
+        const int numChannels = buffer.getNumChannels();
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            if (ch < numInputs && inputs[ch] != nullptr)
+                FloatVectorOperations::copy (buffer.getWritePointer (ch), inputs[ch] + start, num);
+            else
+                FloatVectorOperations::clear (buffer.getWritePointer (ch), num);
+        }
+
+        // refers to the preallocated channels, no allocation below 32 channels
+        AudioBuffer<float> block (buffer.getArrayOfWritePointers(), numChannels, num);
+        midiMessages.clear();
+
+        {
+            const ScopedLock sl (processor.getCallbackLock());
+
+            if (processor.isSuspended())
+                block.clear();
+            else
+                processor.processBlock (block, midiMessages);
+        }
+
+        for (int ch = 0; ch < numOutputs; ++ch)
+        {
+            if (outputs[ch] == nullptr)
+                continue;
+
+            if (ch < numChannels)
+                FloatVectorOperations::copy (outputs[ch] + start, block.getReadPointer (ch), num);
+            else
+                FloatVectorOperations::clear (outputs[ch] + start, num);
+        }
+    }
+
+    AudioProcessor& processor;
+    const int numIns, numOuts, cpuCore, priority;
+
+    double sampleRate = 44100.0, nanosPerSample = 0.0;
+    int blockSize = 1;
+    AudioBuffer<float> buffer;
+    MidiBuffer midiMessages;
+
+    bool threadIsSetUp = false;
+    int affinityResult = 0, schedulingResult = 0;
+    std::atomic<bool> threadSetupDone { false };
+
+   #if JUCE_PLUGIN_LOAD_TELEMETRY
+    JucePluginLoadTelemetry::InstanceMeter loadMeter { JucePlugin_Name, "Headless" };
+   #endif
+
+    JUCE_DECLARE_NON_COPYABLE (Player)
+};
+
+//==============================================================================
+/** Local stream socket that report lines are sent to, clients never block the runner. */
+class ReportSocket
+{
+public:
+    ~ReportSocket()
+    {
+        for (auto fd : clients)
+            ::close (fd);
+
+        if (listenSocket >= 0)
+        {
+            ::close (listenSocket);
+            ::unlink (path.toRawUTF8());
+        }
+    }
+
+    bool open (const String& socketPath)
+    {
+        sockaddr_un addr;
+        zerostruct (addr);
+        addr.sun_family = AF_UNIX;
+
+        if (socketPath.getNumBytesAsUTF8() >= sizeof (addr.sun_path))
+        {
+            std::fprintf (stderr, "Socket path is too long: %s\n", socketPath.toRawUTF8());
+            return false;
+        }
+
+        std::strcpy (addr.sun_path, socketPath.toRawUTF8());
+        ::unlink (addr.sun_path);
+
+        listenSocket = ::socket (AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+        if (listenSocket < 0
+            || ::bind (listenSocket, (const sockaddr*) &addr, sizeof (addr)) != 0
+            || ::listen (listenSocket, 4) != 0)
+        {
+            std::fprintf (stderr, "Couldn't open socket %s: %s\n", socketPath.toRawUTF8(), std::strerror (errno));
+
+            if (listenSocket >= 0)
+                ::close (listenSocket);
+
+            listenSocket = -1;
+            return false;
+        }
+
+        path = socketPath;
+        return true;
+    }
+
+    void acceptClients()
+    {
+        if (listenSocket < 0)
+            return;
+
+        for (int fd; (fd = ::accept4 (listenSocket, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0;)
+            clients.push_back (fd);
+    }
+
+    void send (const String& line)
+    {
+        for (size_t i = 0; i < clients.size();)
+        {
+            const ssize_t sent = ::send (clients[i], line.toRawUTF8(), line.getNumBytesAsUTF8(), MSG_NOSIGNAL);
+
+            // a client that doesn't keep up just misses lines, one that went away is dropped
+            if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                ::close (clients[i]);
+                clients.erase (clients.begin() + (long) i);
+                continue;
+            }
+
+            ++i;
+        }
+    }
+
+private:
+    int listenSocket = -1;
+    String path;
+    std::vector<int> clients;
+};
+
+//==============================================================================
+static volatile sig_atomic_t quitRequested = 0;
+
+static void handleQuitSignal (int)
+{
+    quitRequested = 1;
+}
+
+/** Runs on the message thread, prints the statistics and stops the message loop on SIGINT or SIGTERM. */
+class Reporter : private Timer
+{
+public:
+    Reporter (AudioDeviceManager& dm, Player& p, ReportSocket& s, double intervalSeconds)
+        : deviceManager (dm), player (p), socket (s),
+          ticksPerReport (jmax (1, roundToInt (intervalSeconds * 10.0)))
+    {
+        startTimer (100);
+    }
+
+private:
+    void timerCallback() override
+    {
+        if (quitRequested != 0)
+        {
+            stopTimer();
+            MessageManager::getInstance()->stopDispatchLoop();
+            return;
+        }
+
+        int affinityError, schedulingError;
+
+        if (player.takeThreadSetupResult (affinityError, schedulingError))
+        {
+            if (affinityError != 0)
+                std::fprintf (stderr, "Couldn't pin the audio thread: %s\n", std::strerror (affinityError));
+
+            if (schedulingError != 0)
+                std::fprintf (stderr, "Couldn't switch the audio thread to SCHED_FIFO: %s, check RLIMIT_RTPRIO or CAP_SYS_NICE\n",
+                              std::strerror (schedulingError));
+        }
+
+        socket.acceptClients();
+
+        if (++ticks >= ticksPerReport)
+        {
+            ticks = 0;
+            report();
+        }
+    }
+
+    void report()
+    {
+        const int64 callbacks = player.numCallbacks.load (std::memory_order_relaxed);
+        const int64 nanos = player.totalNanos.load (std::memory_order_relaxed);
+        const int64 samples = player.totalSamples.load (std::memory_order_relaxed);
+        const int64 worst = player.worstNanos.exchange (0, std::memory_order_relaxed);
+
+        const int64 newCallbacks = callbacks - lastCallbacks;
+        const double meanMicros = newCallbacks > 0 ? (double) (nanos - lastNanos) / newCallbacks * 0.001 : 0.0;
+        const double periodMicros = newCallbacks > 0 ? (double) (samples - lastSamples) / newCallbacks / player.getSampleRate() * 1.0e6 : 0.0;
+
+        lastCallbacks = callbacks;
+        lastNanos = nanos;
+        lastSamples = samples;
+
+        String line;
+        line << "time=" << String (juce::Time::getMillisecondCounterHiRes() * 0.001 - startSeconds, 1)
+             << " callbacks=" << callbacks
+             << " xruns=" << deviceManager.getXRunCount()
+             << " overruns=" << player.numOverruns.load (std::memory_order_relaxed)
+             << " device_errors=" << player.numDeviceErrors.load (std::memory_order_relaxed)
+             << " mean_us=" << String (meanMicros, 1)
+             << " worst_us=" << String ((double) worst * 0.001, 1)
+             << " period_us=" << String (periodMicros, 1)
+             << " load=" << String (periodMicros > 0.0 ? meanMicros / periodMicros * 100.0 : 0.0, 1)
+             << " worst_load=" << String (periodMicros > 0.0 ? (double) worst * 0.001 / periodMicros * 100.0 : 0.0, 1)
+             << "\n";
+
+        std::fputs (line.toRawUTF8(), stdout);
+        std::fflush (stdout);
+        socket.send (line);
+    }
+
+    AudioDeviceManager& deviceManager;
+    Player& player;
+    ReportSocket& socket;
+
+    const int ticksPerReport;
+    int ticks = 0;
+    int64 lastCallbacks = 0, lastNanos = 0, lastSamples = 0;
+    const double startSeconds = juce::Time::getMillisecondCounterHiRes() * 0.001;
+};
+
+//==============================================================================
+static void listDevices (AudioDeviceManager& deviceManager)
+{
+    for (auto* type : deviceManager.getAvailableDeviceTypes())
+    {
+        type->scanForDevices();
+
+        std::printf ("%s\n", type->getTypeName().toRawUTF8());
+
+        for (auto& name : type->getDeviceNames (false))
+            std::printf ("  output: %s\n", name.toRawUTF8());
+
+        for (auto& name : type->getDeviceNames (true))
+            std::printf ("  input:  %s\n", name.toRawUTF8());
+    }
+}
+
+static bool selectDeviceType (AudioDeviceManager& deviceManager, const String& wantedType)
+{
+    for (auto* type : deviceManager.getAvailableDeviceTypes())
+    {
+        if (type->getTypeName().equalsIgnoreCase (wantedType))
+        {
+            deviceManager.setCurrentAudioDeviceType (type->getTypeName(), true);
+            return true;
+        }
+    }
+
+    std::fprintf (stderr, "Device type %s isn't available in this build\n", wantedType.toRawUTF8());
+    return false;
+}
+
+static int run (const Options& options)
+{
+    AudioDeviceManager deviceManager;
+
+    if (options.listDevices)
+    {
+        listDevices (deviceManager);
+        return 0;
+    }
+
+    AudioProcessor::setTypeOfNextNewPlugin (AudioProcessor::wrapperType_Standalone);
+    std::unique_ptr<AudioProcessor> processor (createPluginFilter());
+    AudioProcessor::setTypeOfNextNewPlugin (AudioProcessor::wrapperType_Undefined);
+
+    if (processor == nullptr)
+    {
+        std::fprintf (stderr, "Couldn't create the plugin\n");
+        return 1;
+    }
+
+    if (options.stateFile != File())
+    {
+        MemoryBlock data;
+
+        if (! options.stateFile.loadFileAsData (data) || data.getSize() == 0)
+        {
+            std::fprintf (stderr, "Couldn't read state file %s\n", options.stateFile.getFullPathName().toRawUTF8());
+            return 1;
+        }
+
+        processor->setStateInformation (data.getData(), (int) data.getSize());
+    }
+
+    ReportSocket socket;
+
+    if (options.socketPath.isNotEmpty() && ! socket.open (options.socketPath))
+        return 1;
+
+    if (! selectDeviceType (deviceManager, options.deviceType))
+        return 1;
+
+    // everything the process maps from here on stays resident too, the device buffers included
+    if (::mlockall (MCL_CURRENT | MCL_FUTURE) != 0)
+        std::fprintf (stderr, "Couldn't lock memory: %s, check RLIMIT_MEMLOCK or CAP_IPC_LOCK\n", std::strerror (errno));
+
+    AudioDeviceManager::AudioDeviceSetup setup;
+    setup.outputDeviceName = options.outputDevice;
+    setup.inputDeviceName = processor->getTotalNumInputChannels() > 0 ? options.inputDevice : String();
+    setup.sampleRate = options.sampleRate;
+    setup.bufferSize = options.periodSize;
+
+    const String error (deviceManager.initialise (processor->getTotalNumInputChannels(),
+                                                  processor->getTotalNumOutputChannels(),
+                                                  nullptr, false, String(), &setup));
+
+    AudioIODevice* const device = deviceManager.getCurrentAudioDevice();
+
+    if (error.isNotEmpty() || device == nullptr)
+    {
+        std::fprintf (stderr, "Couldn't open the audio device: %s\n", error.isNotEmpty() ? error.toRawUTF8() : "no device");
+        return 1;
+    }
+
+    std::printf ("%s on %s %s, %.0f Hz, period %d\n", JucePlugin_Name,
+                 device->getTypeName().toRawUTF8(), device->getName().toRawUTF8(),
+                 device->getCurrentSampleRate(), device->getCurrentBufferSizeSamples());
+
+    // JACK decides the period itself
+    if (device->getCurrentBufferSizeSamples() != options.periodSize)
+        std::fprintf (stderr, "The device runs with a period of %d instead of %d\n",
+                      device->getCurrentBufferSizeSamples(), options.periodSize);
+
+    std::fflush (stdout);
+
+    Player player (*processor, options);
+    deviceManager.addAudioCallback (&player);
+
+    {
+        Reporter reporter (deviceManager, player, socket, options.reportInterval);
+        MessageManager::getInstance()->runDispatchLoop();
+    }
+
+    deviceManager.removeAudioCallback (&player);
+    deviceManager.closeAudioDevice();
+
+    return 0;
+}
+
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    using namespace JucePluginHeadlessRunner;
+
+    Options options;
+
+    if (! parseOptions (argc, argv, options))
+    {
+        std::fprintf (stderr, usage, argv[0]);
+        return 1;
+    }
+
+    struct sigaction action;
+    zerostruct (action);
+    action.sa_handler = handleQuitSignal;
+    ::sigaction (SIGINT, &action, nullptr);
+    ::sigaction (SIGTERM, &action, nullptr);
+    ::signal (SIGPIPE, SIG_IGN);
+
+    MessageManager::getInstance();
+
+    const int result = run (options);
+
+    DeletedAtShutdown::deleteAll();
+    MessageManager::deleteInstance();
+
+    return result;
+}
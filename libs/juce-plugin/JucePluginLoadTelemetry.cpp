@@ -0,0 +1,282 @@
+/*
+  ==============================================================================
+
+   DSP load telemetry for juce plugins, see JucePluginLoadTelemetry.h
+
+   The shared memory segment is created by whichever plugin process comes
+   first and never removed, so a monitor started later still finds it. Slots
+   of processes that died without releasing them are reclaimed by the next
+   instance in the same pid namespace that needs one.
+
+  ==============================================================================
+*/
+
+#include "JucePluginLoadTelemetry.h"
+
+#if JUCE_PLUGIN_LOAD_TELEMETRY
+
+#include <cmath>
+#include <mutex>
+
+#if JUCE_LINUX || JUCE_MAC
+ #include <fcntl.h>
+ #include <sys/mman.h>
+ #include <sys/stat.h>
+ #include <unistd.h>
+ #define JUCE_PLUGIN_LOAD_TELEMETRY_SHM 1
+#else
+ #define JUCE_PLUGIN_LOAD_TELEMETRY_SHM 0
+#endif
+
+namespace JucePluginLoadTelemetry
+{
+
+//==============================================================================
+static double getTicksPerSecond()
+{
+    static const double ticksPerSecond = []
+    {
+       #if JUCE_PLUGIN_LOAD_TELEMETRY_TSC && defined (__aarch64__)
+        uint64_t frequency;
+        asm volatile ("mrs %0, cntfrq_el0" : "=r" (frequency));
+        return (double) frequency;
+       #elif JUCE_PLUGIN_LOAD_TELEMETRY_TSC
+        // invariant TSC on anything recent, measure its rate against the system clock once
+        using Clock = std::chrono::steady_clock;
+
+        const auto clockStart = Clock::now();
+        const uint64_t ticksStart = readTimestamp();
+
+        while (Clock::now() - clockStart < std::chrono::milliseconds (5)) {}
+
+        const uint64_t ticksEnd = readTimestamp();
+        const double seconds = std::chrono::duration<double> (Clock::now() - clockStart).count();
+
+        return (double) (ticksEnd - ticksStart) / seconds;
+       #else
+        return (double) std::chrono::steady_clock::period::den / (double) std::chrono::steady_clock::period::num;
+       #endif
+    }();
+
+    return ticksPerSecond;
+}
+
+//==============================================================================
+#if JUCE_PLUGIN_LOAD_TELEMETRY_SHM
+static std::mutex sharedBlockLock;
+static SharedBlock* sharedBlock = nullptr;
+static int sharedBlockUsers = 0;
+
+static SharedBlock* attachSharedBlock()
+{
+    const std::lock_guard<std::mutex> sl (sharedBlockLock);
+
+    if (sharedBlockUsers++ > 0)
+        return sharedBlock;
+
+    const int fd = shm_open (sharedMemoryName, O_RDWR | O_CREAT, 0644);
+
+    if (fd < 0)
+        return nullptr;
+
+    struct stat st;
+
+    if (fstat (fd, &st) != 0
+        || (st.st_size == 0 && ftruncate (fd, sizeof (SharedBlock)) != 0)
+        || (st.st_size != 0 && st.st_size != (off_t) sizeof (SharedBlock)))
+    {
+        close (fd);
+        return nullptr;
+    }
+
+    void* const address = mmap (nullptr, sizeof (SharedBlock), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close (fd);
+
+    if (address == MAP_FAILED)
+        return nullptr;
+
+    auto* const block = static_cast<SharedBlock*> (address);
+
+    // a new segment is zero-filled; the first process to get here fills in the header
+    if (block->magic.load (std::memory_order_acquire) == 0)
+    {
+        block->version = sharedMemoryVersion;
+        block->numSlots = maxInstances;
+        block->slotSize = sizeof (Slot);
+
+        uint32_t expected = 0;
+        block->magic.compare_exchange_strong (expected, sharedMemoryMagic, std::memory_order_acq_rel);
+    }
+
+    if (block->magic.load (std::memory_order_acquire) != sharedMemoryMagic || block->version != sharedMemoryVersion)
+    {
+        munmap (address, sizeof (SharedBlock));
+        return nullptr;
+    }
+
+    sharedBlock = block;
+    return block;
+}
+
+static void detachSharedBlock()
+{
+    const std::lock_guard<std::mutex> sl (sharedBlockLock);
+
+    if (--sharedBlockUsers > 0 || sharedBlock == nullptr)
+        return;
+
+    munmap (sharedBlock, sizeof (SharedBlock));
+    sharedBlock = nullptr;
+}
+
+static Slot* claimSlot (SharedBlock& block)
+{
+    const int32_t ownPid = (int32_t) getpid();
+
+    for (int i = 0; i < maxInstances; ++i)
+    {
+        Slot& slot = block.slots[i];
+        int32_t pid = slot.pid.load (std::memory_order_acquire);
+
+        // a slot left behind by a process that no longer exists can be taken over,
+        // its pid only says so if it was in our namespace
+        if (pid == 0 || (pid > 0 && ! isOwnerAlive (pid, slot.pidNamespace.load (std::memory_order_relaxed))))
+        {
+            // nobody else checks the slot while it is claimingPid, so the pid and its
+            // namespace always show up together
+            if (slot.pid.compare_exchange_strong (pid, claimingPid, std::memory_order_acq_rel))
+            {
+                slot.pidNamespace.store (getPidNamespace(), std::memory_order_relaxed);
+                slot.pid.store (ownPid, std::memory_order_release);
+                return &slot;
+            }
+        }
+    }
+
+    return nullptr;
+}
+#endif
+
+//==============================================================================
+InstanceMeter::InstanceMeter (const char* pluginName, const char* format)
+{
+    std::memset (&stats, 0, sizeof (stats));
+
+   #if JUCE_PLUGIN_LOAD_TELEMETRY_SHM
+    if (SharedBlock* const block = attachSharedBlock())
+    {
+        slot = claimSlot (*block);
+
+        if (slot == nullptr)
+        {
+            detachSharedBlock();
+            return;
+        }
+
+        const uint32_t sequence = slot->sequence.load (std::memory_order_relaxed);
+        slot->sequence.store (sequence | 1, std::memory_order_relaxed);
+        std::atomic_thread_fence (std::memory_order_release);
+
+        slot->instanceId = block->nextInstanceId.fetch_add (1, std::memory_order_relaxed) + 1;
+        std::strncpy (slot->pluginName, pluginName, sizeof (slot->pluginName) - 1);
+        slot->pluginName[sizeof (slot->pluginName) - 1] = '\0';
+        std::strncpy (slot->format, format, sizeof (slot->format) - 1);
+        slot->format[sizeof (slot->format) - 1] = '\0';
+        std::memcpy (&slot->stats, &stats, sizeof (stats));
+
+        slot->sequence.store ((sequence | 1) + 1, std::memory_order_release);
+    }
+   #else
+    (void) pluginName;
+    (void) format;
+   #endif
+}
+
+InstanceMeter::~InstanceMeter()
+{
+   #if JUCE_PLUGIN_LOAD_TELEMETRY_SHM
+    if (slot != nullptr)
+    {
+        slot->pid.store (0, std::memory_order_release);
+        detachSharedBlock();
+    }
+   #endif
+}
+
+void InstanceMeter::prepare (double sampleRate)
+{
+    std::memset (&stats, 0, sizeof (stats));
+    stats.sampleRate = sampleRate;
+
+    microsPerTick = 1.0e6 / getTicksPerSecond();
+    samplesPerMicro = sampleRate * 1.0e-6;
+
+    // the mean follows changes with a time constant of about one second, the worst case is
+    // kept for one to two windows of a second each
+    smoothingPerSample = (float) (1.0 / std::fmax (1.0, sampleRate));
+    windowLength = (int64_t) std::fmax (1.0, sampleRate);
+    samplesInWindow = 0;
+    currentWindowWorst = previousWindowWorst = 0.0f;
+    currentWindowWorstMicros = previousWindowWorstMicros = 0.0f;
+
+    publish();
+}
+
+void InstanceMeter::addBlock (uint64_t startTime, int numSamples, bool isRealtime) noexcept
+{
+    const float micros = (float) ((double) (readTimestamp() - startTime) * microsPerTick);
+    const float load = samplesPerMicro > 0.0 ? (float) (micros * samplesPerMicro / numSamples) : 0.0f;
+
+    // the first block has nothing to smooth against
+    const float smoothing = stats.numBlocks == 0 ? 1.0f : std::fmin (1.0f, smoothingPerSample * (float) numSamples);
+
+    stats.meanLoad += (load - stats.meanLoad) * smoothing;
+    stats.meanMicros += (micros - stats.meanMicros) * smoothing;
+    stats.lastBlockSize = (uint32_t) numSamples;
+    ++stats.numBlocks;
+
+    if (isRealtime && load > nearOverrunLoad)
+    {
+        ++stats.numNearOverruns;
+
+        if (load > 1.0f)
+            ++stats.numOverruns;
+    }
+
+    if (load > currentWindowWorst)
+        currentWindowWorst = load;
+    if (micros > currentWindowWorstMicros)
+        currentWindowWorstMicros = micros;
+
+    if ((samplesInWindow += numSamples) >= windowLength)
+    {
+        previousWindowWorst = currentWindowWorst;
+        previousWindowWorstMicros = currentWindowWorstMicros;
+        currentWindowWorst = currentWindowWorstMicros = 0.0f;
+        samplesInWindow = 0;
+    }
+
+    stats.worstLoad = std::fmax (currentWindowWorst, previousWindowWorst);
+    stats.worstMicros = std::fmax (currentWindowWorstMicros, previousWindowWorstMicros);
+
+    publish();
+}
+
+void InstanceMeter::publish() noexcept
+{
+    if (slot == nullptr)
+        return;
+
+    const uint32_t sequence = slot->sequence.load (std::memory_order_relaxed);
+
+    slot->sequence.store (sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence (std::memory_order_release);
+
+    std::memcpy (&slot->stats, &stats, sizeof (stats));
+
+    slot->sequence.store (sequence + 2, std::memory_order_release);
+}
+
+}
+
+#endif // JUCE_PLUGIN_LOAD_TELEMETRY
@@ -0,0 +1,238 @@
+/*
+  ==============================================================================
+
+   DSP load telemetry for juce plugins
+
+   Enabled with the 'load-telemetry' meson option. Each plugin instance times
+   its process callback and keeps rolling statistics: mean and worst callback
+   time, the ratio of that time to the duration of the block (the DSP load)
+   and how many blocks came close to or went over it.
+
+   On Linux and macOS the statistics are published in a shared memory segment
+   that juce-plugin-load-monitor reads. LV2 plugins also report their mean
+   load on an output control port.
+
+   This header has no JUCE dependency, the monitor tool includes it too.
+
+  ==============================================================================
+*/
+
+#ifndef JUCE_PLUGIN_LOAD_TELEMETRY_H_INCLUDED
+#define JUCE_PLUGIN_LOAD_TELEMETRY_H_INCLUDED
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+
+#if defined (__i386__) || defined (__x86_64__) || defined (_M_IX86) || defined (_M_X64)
+ #ifdef _MSC_VER
+  #include <intrin.h>
+ #else
+  #include <x86intrin.h>
+ #endif
+ #define JUCE_PLUGIN_LOAD_TELEMETRY_TSC 1
+#elif defined (__aarch64__)
+ #define JUCE_PLUGIN_LOAD_TELEMETRY_TSC 1
+#else
+ #define JUCE_PLUGIN_LOAD_TELEMETRY_TSC 0
+#endif
+
+#if defined (__linux__) || defined (__APPLE__)
+ #include <cerrno>
+ #include <signal.h>
+ #include <sys/stat.h>
+#endif
+
+namespace JucePluginLoadTelemetry
+{
+    //==============================================================================
+    // Shared memory layout, bump sharedMemoryVersion when changing any of it. The
+    // segment is never removed, so the version is part of its name too.
+
+    static const char* const sharedMemoryName = "/distrho-ports-load-2";
+    static const uint32_t sharedMemoryMagic = 0x44504c44; // "DPLD"
+    static const uint32_t sharedMemoryVersion = 2;
+    static const int maxInstances = 256;
+
+    /** A block is counted as a near overrun when its load is above this. */
+    static const float nearOverrunLoad = 0.8f;
+
+    struct InstanceStats
+    {
+        uint64_t numBlocks;
+        uint64_t numOverruns;       // blocks that took longer than their duration
+        uint64_t numNearOverruns;   // blocks above nearOverrunLoad, overruns included
+        double sampleRate;
+        uint32_t lastBlockSize;
+        float meanLoad;             // smoothed over about a second
+        float worstLoad;            // worst block of the last one to two seconds
+        float meanMicros;
+        float worstMicros;
+    };
+
+    struct Slot
+    {
+        std::atomic<uint32_t> sequence;  // odd while the owner is writing
+        std::atomic<int32_t> pid;        // 0 while the slot is free, claimingPid while it is taken
+        std::atomic<uint64_t> pidNamespace;  // the pid is only valid in this namespace
+        uint32_t instanceId;
+        char pluginName[64];
+        char format[12];
+        InstanceStats stats;
+    };
+
+    struct SharedBlock
+    {
+        std::atomic<uint32_t> magic;     // set last, once the rest is initialised
+        uint32_t version;
+        uint32_t numSlots;
+        uint32_t slotSize;
+        std::atomic<uint32_t> nextInstanceId;
+        Slot slots[maxInstances];
+    };
+
+    /** Set while a slot is being taken, before the new owner has filled in its namespace. */
+    static const int32_t claimingPid = -1;
+
+    /** Copies a slot's contents without blocking its owner.
+        Returns false if the slot is free or kept changing while reading.
+    */
+    inline bool readSlot (const Slot& slot, int32_t& pid, uint64_t& pidNamespace, uint32_t& instanceId,
+                          char (&pluginName)[64], char (&format)[12], InstanceStats& stats) noexcept
+    {
+        for (int attempt = 0; attempt < 16; ++attempt)
+        {
+            const uint32_t before = slot.sequence.load (std::memory_order_acquire);
+
+            if ((before & 1) != 0)
+                continue;
+
+            pid = slot.pid.load (std::memory_order_relaxed);
+            pidNamespace = slot.pidNamespace.load (std::memory_order_relaxed);
+            instanceId = slot.instanceId;
+            std::memcpy (pluginName, slot.pluginName, sizeof (pluginName));
+            std::memcpy (format, slot.format, sizeof (format));
+            std::memcpy (&stats, &slot.stats, sizeof (stats));
+
+            std::atomic_thread_fence (std::memory_order_acquire);
+
+            if (slot.sequence.load (std::memory_order_relaxed) == before)
+            {
+                pluginName[sizeof (pluginName) - 1] = '\0';
+                format[sizeof (format) - 1] = '\0';
+                return pid > 0;
+            }
+        }
+
+        return false;
+    }
+
+   #if defined (__linux__) || defined (__APPLE__)
+    /** Identifies the pid namespace of this process, 0 where there are none.
+        Containers sharing /dev/shm can use the same pids for different processes.
+    */
+    inline uint64_t getPidNamespace() noexcept
+    {
+       #ifdef __linux__
+        static const uint64_t pidNamespace = []
+        {
+            struct stat st;
+            return stat ("/proc/self/ns/pid", &st) == 0 ? (uint64_t) st.st_ino : (uint64_t) 0;
+        }();
+
+        return pidNamespace;
+       #else
+        return 0;
+       #endif
+    }
+
+    /** False only if the owner of a slot is known to have exited.
+        Processes in another pid namespace can't be looked up and count as alive.
+    */
+    inline bool isOwnerAlive (int32_t pid, uint64_t pidNamespace) noexcept
+    {
+        if (pid <= 0 || pidNamespace != getPidNamespace())
+            return true;
+
+        return kill (pid, 0) == 0 || errno != ESRCH;
+    }
+   #endif
+
+   #if JUCE_PLUGIN_LOAD_TELEMETRY
+    //==============================================================================
+    /** Cheapest monotonic tick counter of the CPU, converted by calibration in prepare(). */
+    inline uint64_t readTimestamp() noexcept
+    {
+       #if JUCE_PLUGIN_LOAD_TELEMETRY_TSC && defined (__aarch64__)
+        uint64_t ticks;
+        asm volatile ("mrs %0, cntvct_el0" : "=r" (ticks));
+        return ticks;
+       #elif JUCE_PLUGIN_LOAD_TELEMETRY_TSC
+        return __rdtsc();
+       #else
+        return (uint64_t) std::chrono::steady_clock::now().time_since_epoch().count();
+       #endif
+    }
+
+    /** Per-instance statistics, owned by a plugin wrapper.
+        prepare() is called on activation, measure() around every process callback.
+    */
+    class InstanceMeter
+    {
+    public:
+        /** Claims a slot in the shared memory segment, if it can be opened. */
+        InstanceMeter (const char* pluginName, const char* format);
+        ~InstanceMeter();
+
+        /** Resets the statistics for a new sample rate. Not realtime-safe. */
+        void prepare (double sampleRate);
+
+        /** Adds one callback that started at startTime and processed numSamples.
+            Offline (freewheeling) blocks count towards the timing but not the overruns.
+        */
+        void addBlock (uint64_t startTime, int numSamples, bool isRealtime) noexcept;
+
+        /** Smoothed load of the previous blocks, 1.0 is the whole block duration. */
+        float getMeanLoad() const noexcept      { return stats.meanLoad; }
+
+    private:
+        void publish() noexcept;
+
+        Slot* slot = nullptr;
+        InstanceStats stats;
+        double microsPerTick = 0.0;
+        double samplesPerMicro = 0.0;
+        float smoothingPerSample = 0.0f;
+        float currentWindowWorst = 0.0f, previousWindowWorst = 0.0f;
+        float currentWindowWorstMicros = 0.0f, previousWindowWorstMicros = 0.0f;
+        int64_t samplesInWindow = 0, windowLength = 0;
+
+        InstanceMeter (const InstanceMeter&) = delete;
+        InstanceMeter& operator= (const InstanceMeter&) = delete;
+    };
+
+    /** Times the enclosing scope, two timestamp reads per block. */
+    struct ScopedMeasurement
+    {
+        ScopedMeasurement (InstanceMeter& m, int numSamplesToProcess, bool realtime) noexcept
+            : meter (m), startTime (readTimestamp()), numSamples (numSamplesToProcess), isRealtime (realtime) {}
+
+        ~ScopedMeasurement() noexcept
+        {
+            if (numSamples > 0)
+                meter.addBlock (startTime, numSamples, isRealtime);
+        }
+
+        InstanceMeter& meter;
+        const uint64_t startTime;
+        const int numSamples;
+        const bool isRealtime;
+
+        ScopedMeasurement (const ScopedMeasurement&) = delete;
+        ScopedMeasurement& operator= (const ScopedMeasurement&) = delete;
+    };
+   #endif // JUCE_PLUGIN_LOAD_TELEMETRY
+}
+
+#endif // JUCE_PLUGIN_LOAD_TELEMETRY_H_INCLUDED
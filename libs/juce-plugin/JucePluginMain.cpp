@@ -14,6 +14,8 @@
 #undef None
 
 #include "JucePluginMain.h"
+#include "JucePluginRealtimeAudit.h"
+#include "JucePluginLoadTelemetry.h"
 
 #if JucePlugin_Build_AU
  #include "modules/juce_audio_plugin_client/AU/juce_AU_Wrapper.mm"
@@ -35,6 +37,8 @@
  #include "modules/juce_audio_plugin_client/VST/juce_VST_Wrapper.cpp"
 #elif JucePlugin_Build_VST3
  #include "modules/juce_audio_plugin_client/VST3/juce_VST3_Wrapper.cpp"
+#elif JucePlugin_Build_Standalone && JUCE_AUDIOPROCESSOR_NO_GUI
+ #include "JucePluginHeadlessRunner.cpp"
 #elif JucePlugin_Build_Standalone
  #include "juce_StandaloneFilterApplication.cpp"
 #else
@@ -0,0 +1,418 @@
+/*
+  ==============================================================================
+
+   Realtime-safety audit for juce plugins, see JucePluginRealtimeAudit.h
+
+   Global operator new/delete are replaced on all systems. On Linux the
+   build also links with --wrap for the libc functions listed in
+   meson.build, which routes them through the __wrap_ functions below.
+
+  ==============================================================================
+*/
+
+#include "JucePluginRealtimeAudit.h"
+
+#if JUCE_PLUGIN_REALTIME_AUDIT
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#if JUCE_LINUX || JUCE_MAC
+ #include <execinfo.h>
+ #define JUCE_PLUGIN_REALTIME_AUDIT_BACKTRACE 1
+#else
+ #define JUCE_PLUGIN_REALTIME_AUDIT_BACKTRACE 0
+#endif
+
+#if JUCE_PLUGIN_REALTIME_AUDIT_WRAP
+ #include <cstdarg>
+ #include <fcntl.h>
+ #include <poll.h>
+ #include <pthread.h>
+ #include <semaphore.h>
+ #include <sys/select.h>
+ #include <time.h>
+ #include <unistd.h>
+#endif
+
+namespace JucePluginRealtimeAudit
+{
+
+enum ViolationType
+{
+    heapAllocation,
+    heapDeallocation,
+    mutexLock,
+    blockingCall
+};
+
+static const char* const violationTypeNames[] = {
+    "heap allocation",
+    "heap deallocation",
+    "mutex lock",
+    "blocking call"
+};
+
+#if JucePlugin_Build_LV2
+static const char* const formatName = "LV2";
+#elif JucePlugin_Build_VST
+static const char* const formatName = "VST2";
+#elif JucePlugin_Build_VST3
+static const char* const formatName = "VST3";
+#else
+static const char* const formatName = "Standalone";
+#endif
+
+static const bool strictMode = JUCE_PLUGIN_REALTIME_AUDIT >= 2;
+
+//==============================================================================
+// Everything here is preallocated, recording a violation must not cause any of its own.
+
+static const int maxCallSites = 256;
+static const int maxFrames = 32;
+
+struct CallSite
+{
+    std::atomic<uint64_t> hash;   // 0 while the slot is unused
+    std::atomic<bool> ready;
+    std::atomic<int64_t> count;
+    ViolationType type;
+    const char* function;
+    int numFrames;
+    void* frames[maxFrames];
+};
+
+static CallSite callSites[maxCallSites];
+static std::atomic<int64_t> droppedViolations;
+
+static thread_local int guardDepth = 0;
+static thread_local bool isRecording = false;
+
+static void printCallSite (FILE* const out, const CallSite& site)
+{
+    std::fprintf (out, "  %lld x %s in %s()\n",
+                  (long long) site.count.load(), violationTypeNames[site.type], site.function);
+
+   #if JUCE_PLUGIN_REALTIME_AUDIT_BACKTRACE
+    std::fflush (out);
+    backtrace_symbols_fd (site.frames, site.numFrames, fileno (out));
+    std::fputc ('\n', out);
+   #endif
+}
+
+static void recordViolation (const ViolationType type, const char* const function) noexcept
+{
+    if (guardDepth == 0 || isRecording)
+        return;
+
+    isRecording = true;
+
+    // the first frame is this function, which is left out of the report
+    void* trace[maxFrames + 1];
+    void** const frames = trace + 1;
+    int numFrames = 0;
+
+   #if JUCE_PLUGIN_REALTIME_AUDIT_BACKTRACE
+    numFrames = backtrace (trace, maxFrames + 1);
+    numFrames = numFrames > 0 ? numFrames - 1 : 0;
+   #endif
+
+    uint64_t hash = 14695981039346656037ULL ^ (uint64_t) type;
+
+    for (int i = 0; i < numFrames; ++i)
+        hash = (hash ^ (uint64_t) (uintptr_t) frames[i]) * 1099511628211ULL;
+
+    if (hash == 0)
+        hash = 1;
+
+    CallSite* site = nullptr;
+
+    for (int probe = 0; probe < maxCallSites && site == nullptr; ++probe)
+    {
+        CallSite& candidate = callSites[(hash + (uint64_t) probe) % maxCallSites];
+        uint64_t current = candidate.hash.load (std::memory_order_acquire);
+
+        if (current == 0 && candidate.hash.compare_exchange_strong (current, hash, std::memory_order_acq_rel))
+        {
+            candidate.type = type;
+            candidate.function = function;
+            candidate.numFrames = numFrames;
+
+            for (int i = 0; i < numFrames; ++i)
+                candidate.frames[i] = frames[i];
+
+            candidate.ready.store (true, std::memory_order_release);
+            site = &candidate;
+        }
+        else if (current == hash)
+        {
+            site = &candidate;
+        }
+    }
+
+    if (site != nullptr)
+        site->count.fetch_add (1, std::memory_order_relaxed);
+    else
+        droppedViolations.fetch_add (1, std::memory_order_relaxed);
+
+    if (strictMode)
+    {
+        std::fprintf (stderr, "realtime audit: %s %s: violation in process callback, aborting\n",
+                      JucePlugin_Name, formatName);
+
+        if (site != nullptr && site->ready.load (std::memory_order_acquire))
+            printCallSite (stderr, *site);
+
+        std::abort();
+    }
+
+    isRecording = false;
+}
+
+static void writeReport (FILE* const out)
+{
+    int64_t total = droppedViolations.load();
+    int numSites = 0;
+
+    for (const CallSite& site : callSites)
+    {
+        if (site.ready.load (std::memory_order_acquire))
+        {
+            total += site.count.load();
+            ++numSites;
+        }
+    }
+
+    std::fprintf (out, "realtime audit: %s %s: %lld violations at %d call sites\n",
+                  JucePlugin_Name, formatName, (long long) total, numSites);
+
+    for (const CallSite& site : callSites)
+        if (site.ready.load (std::memory_order_acquire))
+            printCallSite (out, site);
+
+    if (const int64_t dropped = droppedViolations.load())
+        std::fprintf (out, "  %lld x at call sites that did not fit in the table\n", (long long) dropped);
+
+    std::fflush (out);
+}
+
+struct Reporter
+{
+    Reporter()
+    {
+       #if JUCE_PLUGIN_REALTIME_AUDIT_BACKTRACE
+        // the first backtrace() loads the unwinder, which allocates
+        void* frames[2];
+        backtrace (frames, 2);
+       #endif
+    }
+
+    ~Reporter()
+    {
+        writeReport (stderr);
+
+        if (const char* const path = std::getenv ("JUCE_PLUGIN_REALTIME_AUDIT_LOG"))
+        {
+            if (FILE* const file = std::fopen (path, "a"))
+            {
+                writeReport (file);
+                std::fclose (file);
+            }
+        }
+    }
+};
+
+static Reporter reporter;
+
+//==============================================================================
+ScopedAudioThread::ScopedAudioThread() noexcept   { ++guardDepth; }
+ScopedAudioThread::~ScopedAudioThread() noexcept  { --guardDepth; }
+
+} // namespace JucePluginRealtimeAudit
+
+//==============================================================================
+#if JUCE_PLUGIN_REALTIME_AUDIT_WRAP
+
+#define JUCE_PLUGIN_REALTIME_AUDIT_WRAP_FUNCTION(violationType, returnType, name, params, args) \
+    returnType __real_##name params; \
+    returnType __wrap_##name params \
+    { \
+        JucePluginRealtimeAudit::recordViolation (JucePluginRealtimeAudit::violationType, #name); \
+        return __real_##name args; \
+    }
+
+extern "C"
+{
+    JUCE_PLUGIN_REALTIME_AUDIT_WRAP_FUNCTION (heapAllocation, void*, malloc, (size_t size), (size))
+    JUCE_PLUGIN_REALTIME_AUDIT_WRAP_FUNCTION (heapAllocation, void*, calloc, (size_t num, size_t size), (num, size))
+    JUCE_PLUGIN_REALTIME_AUDIT_WRAP_FUNCTION (heapAllocation, void*, realloc, (void* ptr, size_t size), (ptr, size))
+    JUCE_PLUGIN_REALTIME_AUDIT_WRAP_FUNCTION (heapAllocation, int, posix_memalign, (void** ptr, size_t alignment, size_t size), (ptr, alignment, size))
+
+    JUCE_PLUGIN_REALTIME_AUDIT_WRAP_FUNCTION (mutexLock, int, pthread_mutex_lock, (pthread_mutex_t* mutex), (mutex))
+    JUCE_PLUGIN_REALTIME_AUDIT_WRAP_FUNCTION (mutexLock, int, pthread_rwlock_rdlock, (pthread_rwlock_t* lock), (lock))
+    JUCE_PLUGIN_REALTIME_AUDIT_WRAP_FUNCTION (mutexLock, int, pthread_rwlock_wrlock, (pthread_rwlock_t* lock), (lock))
+
+    JUCE_PLUGIN_REALTIME_AUDIT_WRAP_FUNCTION (blockingCall, int, pthread_cond_wait, (pthread_cond_t* cond, pthread_mutex_t* mutex), (cond, mutex))
+    JUCE_PLUGIN_REALTIME_AUDIT_WRAP_FUNCTION (blockingCall, int, pthread_cond_timedwait, (pthread_cond_t* cond, pthread_mutex_t* mutex, const struct timespec* time), (cond, mutex, time))
+    JUCE_PLUGIN_REALTIME_AUDIT_WRAP_FUNCTION (blockingCall, int, pthread_join, (pthread_t thread, void** result), (thread, result))
+    JUCE_PLUGIN_REALTIME_AUDIT_WRAP_FUNCTION (blockingCall, int, sem_wait, (sem_t* sem), (sem))
+    JUCE_PLUGIN_REALTIME_AUDIT_WRAP_FUNCTION (blockingCall, int, nanosleep, (const struct timespec* time, struct timespec* remaining), (time, remaining))
+    JUCE_PLUGIN_REALTIME_AUDIT_WRAP_FUNCTION (blockingCall, int, usleep, (useconds_t usec), (usec))
+    JUCE_PLUGIN_REALTIME_AUDIT_WRAP_FUNCTION (blockingCall, unsigned int, sleep, (unsigned int seconds), (seconds))
+    JUCE_PLUGIN_REALTIME_AUDIT_WRAP_FUNCTION (blockingCall, int, poll, (struct pollfd* fds, nfds_t numFds, int timeout), (fds, numFds, timeout))
+    JUCE_PLUGIN_REALTIME_AUDIT_WRAP_FUNCTION (blockingCall, int, select, (int numFds, fd_set* readFds, fd_set* writeFds, fd_set* exceptFds, struct timeval* timeout), (numFds, readFds, writeFds, exceptFds, timeout))
+    JUCE_PLUGIN_REALTIME_AUDIT_WRAP_FUNCTION (blockingCall, ssize_t, read, (int fd, void* buffer, size_t size), (fd, buffer, size))
+    JUCE_PLUGIN_REALTIME_AUDIT_WRAP_FUNCTION (blockingCall, ssize_t, write, (int fd, const void* buffer, size_t size), (fd, buffer, size))
+    JUCE_PLUGIN_REALTIME_AUDIT_WRAP_FUNCTION (blockingCall, FILE*, fopen, (const char* path, const char* mode), (path, mode))
+    JUCE_PLUGIN_REALTIME_AUDIT_WRAP_FUNCTION (blockingCall, int, fclose, (FILE* file), (file))
+
+    void __real_free (void* ptr);
+    void __wrap_free (void* ptr)
+    {
+        if (ptr != nullptr)
+            JucePluginRealtimeAudit::recordViolation (JucePluginRealtimeAudit::heapDeallocation, "free");
+
+        __real_free (ptr);
+    }
+
+    int __real_open (const char* path, int flags, ...);
+    int __wrap_open (const char* path, int flags, ...)
+    {
+        JucePluginRealtimeAudit::recordViolation (JucePluginRealtimeAudit::blockingCall, "open");
+
+        mode_t mode = 0;
+
+        if ((flags & O_CREAT) != 0)
+        {
+            va_list args;
+            va_start (args, flags);
+            mode = (mode_t) va_arg (args, int);
+            va_end (args);
+        }
+
+        return __real_open (path, flags, mode);
+    }
+}
+
+#undef JUCE_PLUGIN_REALTIME_AUDIT_WRAP_FUNCTION
+
+static void* allocateUnaudited (size_t size) noexcept  { return __real_malloc (size != 0 ? size : 1); }
+static void freeUnaudited (void* ptr) noexcept         { __real_free (ptr); }
+
+static void* allocateAlignedUnaudited (size_t size, size_t alignment) noexcept
+{
+    void* ptr = nullptr;
+    return __real_posix_memalign (&ptr, alignment < sizeof (void*) ? sizeof (void*) : alignment, size != 0 ? size : 1) == 0 ? ptr : nullptr;
+}
+
+static void freeAlignedUnaudited (void* ptr) noexcept  { __real_free (ptr); }
+#elif JUCE_WINDOWS
+static void* allocateUnaudited (size_t size) noexcept  { return std::malloc (size != 0 ? size : 1); }
+static void freeUnaudited (void* ptr) noexcept         { std::free (ptr); }
+
+static void* allocateAlignedUnaudited (size_t size, size_t alignment) noexcept  { return _aligned_malloc (size != 0 ? size : 1, alignment); }
+static void freeAlignedUnaudited (void* ptr) noexcept                           { _aligned_free (ptr); }
+#else
+static void* allocateUnaudited (size_t size) noexcept  { return std::malloc (size != 0 ? size : 1); }
+static void freeUnaudited (void* ptr) noexcept         { std::free (ptr); }
+
+static void* allocateAlignedUnaudited (size_t size, size_t alignment) noexcept
+{
+    void* ptr = nullptr;
+    return posix_memalign (&ptr, alignment < sizeof (void*) ? sizeof (void*) : alignment, size != 0 ? size : 1) == 0 ? ptr : nullptr;
+}
+
+static void freeAlignedUnaudited (void* ptr) noexcept  { std::free (ptr); }
+#endif
+
+//==============================================================================
+static void* auditedNew (const char* const function, const size_t size) noexcept
+{
+    JucePluginRealtimeAudit::recordViolation (JucePluginRealtimeAudit::heapAllocation, function);
+    return allocateUnaudited (size);
+}
+
+static void auditedDelete (const char* const function, void* const ptr) noexcept
+{
+    if (ptr == nullptr)
+        return;
+
+    JucePluginRealtimeAudit::recordViolation (JucePluginRealtimeAudit::heapDeallocation, function);
+    freeUnaudited (ptr);
+}
+
+#if __cpp_aligned_new
+static void* auditedAlignedNew (const char* const function, const size_t size, const std::align_val_t alignment) noexcept
+{
+    JucePluginRealtimeAudit::recordViolation (JucePluginRealtimeAudit::heapAllocation, function);
+    return allocateAlignedUnaudited (size, static_cast<size_t> (alignment));
+}
+
+static void auditedAlignedDelete (const char* const function, void* const ptr) noexcept
+{
+    if (ptr == nullptr)
+        return;
+
+    JucePluginRealtimeAudit::recordViolation (JucePluginRealtimeAudit::heapDeallocation, function);
+    freeAlignedUnaudited (ptr);
+}
+#endif
+
+void* operator new (size_t size)
+{
+    if (void* const ptr = auditedNew ("operator new", size))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[] (size_t size)
+{
+    if (void* const ptr = auditedNew ("operator new[]", size))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void* operator new (size_t size, const std::nothrow_t&) noexcept    { return auditedNew ("operator new", size); }
+void* operator new[] (size_t size, const std::nothrow_t&) noexcept  { return auditedNew ("operator new[]", size); }
+
+void operator delete (void* ptr) noexcept                           { auditedDelete ("operator delete", ptr); }
+void operator delete[] (void* ptr) noexcept                         { auditedDelete ("operator delete[]", ptr); }
+void operator delete (void* ptr, const std::nothrow_t&) noexcept    { auditedDelete ("operator delete", ptr); }
+void operator delete[] (void* ptr, const std::nothrow_t&) noexcept  { auditedDelete ("operator delete[]", ptr); }
+void operator delete (void* ptr, size_t) noexcept                   { auditedDelete ("operator delete", ptr); }
+void operator delete[] (void* ptr, size_t) noexcept                 { auditedDelete ("operator delete[]", ptr); }
+
+#if __cpp_aligned_new
+void* operator new (size_t size, std::align_val_t alignment)
+{
+    if (void* const ptr = auditedAlignedNew ("operator new", size, alignment))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[] (size_t size, std::align_val_t alignment)
+{
+    if (void* const ptr = auditedAlignedNew ("operator new[]", size, alignment))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void* operator new (size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept    { return auditedAlignedNew ("operator new", size, alignment); }
+void* operator new[] (size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept  { return auditedAlignedNew ("operator new[]", size, alignment); }
+
+void operator delete (void* ptr, std::align_val_t) noexcept                           { auditedAlignedDelete ("operator delete", ptr); }
+void operator delete[] (void* ptr, std::align_val_t) noexcept                         { auditedAlignedDelete ("operator delete[]", ptr); }
+void operator delete (void* ptr, std::align_val_t, const std::nothrow_t&) noexcept    { auditedAlignedDelete ("operator delete", ptr); }
+void operator delete[] (void* ptr, std::align_val_t, const std::nothrow_t&) noexcept  { auditedAlignedDelete ("operator delete[]", ptr); }
+void operator delete (void* ptr, size_t, std::align_val_t) noexcept                   { auditedAlignedDelete ("operator delete", ptr); }
+void operator delete[] (void* ptr, size_t, std::align_val_t) noexcept                 { auditedAlignedDelete ("operator delete[]", ptr); }
+#endif
+
+#endif // JUCE_PLUGIN_REALTIME_AUDIT
@@ -0,0 +1,40 @@
+/*
+  ==============================================================================
+
+   Realtime-safety audit for juce plugins
+
+   Enabled with the 'realtime-audit' meson option. While a plugin wrapper is
+   inside its process callback, heap use, mutex locks and blocking calls made
+   on that thread are recorded together with their call stack. A report of
+   all call sites is written when the plugin binary is unloaded; in strict
+   mode the first violation aborts the host instead.
+
+   Set JUCE_PLUGIN_REALTIME_AUDIT_LOG to a file path to also append the
+   report there, hosts often swallow stderr.
+
+  ==============================================================================
+*/
+
+#ifndef JUCE_PLUGIN_REALTIME_AUDIT_H_INCLUDED
+#define JUCE_PLUGIN_REALTIME_AUDIT_H_INCLUDED
+
+#if JUCE_PLUGIN_REALTIME_AUDIT
+
+namespace JucePluginRealtimeAudit
+{
+    /** Marks the calling thread as being inside a plugin process callback for
+        as long as this object lives. Scopes may nest.
+    */
+    struct ScopedAudioThread
+    {
+        ScopedAudioThread() noexcept;
+        ~ScopedAudioThread() noexcept;
+
+        ScopedAudioThread (const ScopedAudioThread&) = delete;
+        ScopedAudioThread& operator= (const ScopedAudioThread&) = delete;
+    };
+}
+
+#endif // JUCE_PLUGIN_REALTIME_AUDIT
+
+#endif // JUCE_PLUGIN_REALTIME_AUDIT_H_INCLUDED
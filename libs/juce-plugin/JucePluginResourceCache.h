@@ -0,0 +1,105 @@
+/*
+  ==============================================================================
+
+   Shared cache for resources decoded from a plugin's embedded BinaryData
+
+   Typefaces and drawables created from embedded data are decoded once per
+   process, the first time any instance asks for them, and then shared by
+   all instances. Hold the cache through a SharedResourcePointer, it is
+   deleted with everything in it when the last holder goes away:
+
+       SharedResourcePointer<JucePluginResourceCache> resources;
+       Font font (resources->getTypeface (BinaryData::font_ttf, BinaryData::font_ttfSize));
+
+   Images don't need this, ImageCache::getFromMemory() already shares them.
+
+   Include after JuceHeader.h, works with both juce-legacy and juce-current.
+
+  ==============================================================================
+*/
+
+#ifndef JUCE_PLUGIN_RESOURCE_CACHE_H_INCLUDED
+#define JUCE_PLUGIN_RESOURCE_CACHE_H_INCLUDED
+
+class JucePluginResourceCache
+{
+public:
+   #if JUCE_MAJOR_VERSION >= 6
+    typedef std::unique_ptr<Drawable> DrawablePtr;
+   #else
+    typedef Drawable* DrawablePtr;
+   #endif
+
+    JucePluginResourceCache() {}
+
+    /** Returns the typeface in a font file (ttf, otf) embedded at this address. */
+    Typeface::Ptr getTypeface (const void* data, size_t size)
+    {
+        const ScopedLock sl (lock);
+        Entry& entry (getEntry (data));
+
+        if (entry.typeface == nullptr)
+            entry.typeface = Typeface::createSystemTypefaceFor (data, size);
+
+        return entry.typeface;
+    }
+
+    /** Returns the typeface that a CustomTypeface serialised into this data. */
+    Typeface::Ptr getCustomTypeface (const void* data, size_t size)
+    {
+        const ScopedLock sl (lock);
+        Entry& entry (getEntry (data));
+
+        if (entry.typeface == nullptr)
+        {
+            MemoryInputStream stream (data, size, false);
+            entry.typeface = new CustomTypeface (stream);
+        }
+
+        return entry.typeface;
+    }
+
+    /** Returns a new copy of the drawable in this image or SVG data, the caller owns it.
+        Copies of an image drawable share the decoded pixels.
+    */
+    DrawablePtr createDrawable (const void* data, size_t size)
+    {
+        const ScopedLock sl (lock);
+        Entry& entry (getEntry (data));
+
+        if (entry.drawable == nullptr)
+            entry.drawable = DrawableHolder (Drawable::createFromImageData (data, size));
+
+        return entry.drawable != nullptr ? entry.drawable->createCopy() : DrawablePtr();
+    }
+
+private:
+    //==============================================================================
+    typedef std::unique_ptr<Drawable> DrawableHolder;
+
+    struct Entry
+    {
+        const void* data;
+        Typeface::Ptr typeface;
+        DrawableHolder drawable;
+    };
+
+    // only a handful of resources per plugin, a linear search is fine
+    Entry& getEntry (const void* data)
+    {
+        for (auto* entry : entries)
+            if (entry->data == data)
+                return *entry;
+
+        auto* entry = entries.add (new Entry());
+        entry->data = data;
+        return *entry;
+    }
+
+    CriticalSection lock;
+    OwnedArray<Entry> entries;
+
+    JUCE_DECLARE_NON_COPYABLE (JucePluginResourceCache)
+};
+
+#endif // JUCE_PLUGIN_RESOURCE_CACHE_H_INCLUDED
@@ -25,6 +25,18 @@
  #include "modules/juce_audio_plugin_client/utility/juce_PluginUtilities.cpp"
 #endif
 
+#if JUCE_PLUGIN_REALTIME_AUDIT
+ #include "JucePluginRealtimeAudit.cpp"
+#endif
+
+#if JUCE_PLUGIN_LOAD_TELEMETRY
+ #include "JucePluginLoadTelemetry.cpp"
+#endif
+
+#if JUCE_PLUGIN_CPU_DISPATCH
+ #include "JucePluginCpuDispatch.cpp"
+#endif
+
 #if JUCE_MAC && (JucePlugin_Build_VST || JucePlugin_Build_VST3)
  #undef JUCE_CHECKSETTINGMACROS_H
  #include "modules/juce_audio_plugin_client/VST/juce_VST_Wrapper.mm"
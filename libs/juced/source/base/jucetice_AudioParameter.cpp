@@ -319,7 +319,7 @@ AudioParameterThread::~AudioParameterThread ()
 
 void AudioParameterThread::sendParameterChange (AudioParameter* parameter)
 {
-    parameterChanges.put (parameter);
+    parameterChanges.push (parameter);
 
     notify ();
 }
@@ -336,17 +336,18 @@ void AudioParameterThread::setParametersChangeChecksPerSecond (const int howMany
 
 void AudioParameterThread::run()
 {
-    AudioParameter* parameter;
+    AudioParameter* parameters [64];
+    int numParameters;
 
     while (! threadShouldExit ())
     {
         int32 currentWaitTime = Time::getMillisecondCounter ();
 
-        while (! parameterChanges.isEmpty ())
+        while ((numParameters = parameterChanges.pop (parameters, numElementsInArray (parameters))) > 0)
         {
-            parameter = (AudioParameter*) parameterChanges.get ();
-            if (parameter)
-                parameter->triggerAsyncUpdate ();
+            for (int i = 0; i < numParameters; ++i)
+                if (parameters[i] != nullptr)
+                    parameters[i]->triggerAsyncUpdate ();
         }
 
         currentWaitTime = 1000 / changeChecksPerSecond
@@ -148,7 +148,7 @@ public:
     
 private:
 
-    LockFreeFifo<AudioParameter*> parameterChanges;
+    LockFreeMPSCFifo<AudioParameter*> parameterChanges;
     int changeChecksPerSecond;    
 };
 
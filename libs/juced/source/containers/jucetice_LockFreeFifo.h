@@ -29,112 +29,340 @@
 #define __JUCETICE_LOCKFREEFIFO_HEADER__
 
 //==============================================================================
-/**
- * Exception to catch in the NOT - REALTIME thread polling for get !
- */
-class LockFreeFifoUnderrunException
+/*
+    Lock-free ring buffers for passing values between threads
+
+    - The capacity is rounded up to a power of two, and all of it can be used
+    - Bulk push and pop copy as many items as fit or are ready, and return
+      how many that was; nothing ever blocks, allocates or throws
+    - The read and write indices live on separate cache lines
+    - Only needs <atomic>, so tools can include it without the rest of juced
+*/
+namespace LockFreeFifoHelpers
 {
-public:
-    LockFreeFifoUnderrunException ()
+    enum { cacheLineSize = 64 };
+
+    inline unsigned int roundUpToPowerOfTwo (int minimumSize) noexcept
     {
+        unsigned int size = 1;
+
+        while (size < (unsigned int) minimumSize && size < (1u << 30))
+            size <<= 1;
+
+        return size;
     }
-};
+}
 
-class LockFreeFifoOverrunException
+//==============================================================================
+/**
+    Single writer, single reader FIFO
+
+    push() may only be called from one thread and pop() from one other thread
+    at a time. The size queries can be called from either of them.
+*/
+template<class ElementType>
+class LockFreeFifo
 {
 public:
-    LockFreeFifoOverrunException ()
+
+    //==============================================================================
+    /** Constructor */
+    explicit LockFreeFifo (int minimumCapacity)
+        : capacity (LockFreeFifoHelpers::roundUpToPowerOfTwo (minimumCapacity)),
+          mask (capacity - 1),
+          buffer (new ElementType [capacity])
+    {
+        writeIndex.store (0);
+        readIndex.store (0);
+        cachedReadIndex = 0;
+        cachedWriteIndex = 0;
+    }
+
+    ~LockFreeFifo ()
+    {
+        delete[] buffer;
+    }
+
+    //==============================================================================
+    /**
+        Copies up to numItems items into the FIFO, writer thread only
+
+        Returns the number of items that fitted.
+    */
+    int push (const ElementType* items, const int numItems) noexcept
+    {
+        const unsigned int write = writeIndex.load (std::memory_order_relaxed);
+
+        // only refresh the reader's index when the last known one isn't enough
+        if (capacity - (write - cachedReadIndex) < (unsigned int) numItems)
+            cachedReadIndex = readIndex.load (std::memory_order_acquire);
+
+        const int num = clampCount (numItems, capacity - (write - cachedReadIndex));
+
+        for (int i = 0; i < num; ++i)
+            buffer [(write + i) & mask] = items [i];
+
+        writeIndex.store (write + num, std::memory_order_release);
+        return num;
+    }
+
+    /** Adds a single item, returns false if the FIFO is full */
+    bool push (const ElementType& item) noexcept
+    {
+        return push (&item, 1) == 1;
+    }
+
+    //==============================================================================
+    /**
+        Copies up to numItems items out of the FIFO, reader thread only
+
+        Returns the number of items that were ready.
+    */
+    int pop (ElementType* items, const int numItems) noexcept
+    {
+        const unsigned int read = readIndex.load (std::memory_order_relaxed);
+
+        if (cachedWriteIndex - read < (unsigned int) numItems)
+            cachedWriteIndex = writeIndex.load (std::memory_order_acquire);
+
+        const int num = clampCount (numItems, cachedWriteIndex - read);
+
+        for (int i = 0; i < num; ++i)
+            items [i] = buffer [(read + i) & mask];
+
+        readIndex.store (read + num, std::memory_order_release);
+        return num;
+    }
+
+    /** Takes a single item, returns false if the FIFO is empty */
+    bool pop (ElementType& item) noexcept
     {
+        return pop (&item, 1) == 1;
     }
+
+    //==============================================================================
+    /** Returns the number of items the FIFO can hold */
+    int getCapacity () const noexcept
+    {
+        return (int) capacity;
+    }
+
+    /** Returns the number of items waiting to be read */
+    int getNumReady () const noexcept
+    {
+        const unsigned int read = readIndex.load (std::memory_order_acquire);
+        return (int) (writeIndex.load (std::memory_order_acquire) - read);
+    }
+
+    /** Returns the number of items that can be pushed */
+    int getFreeSpace () const noexcept
+    {
+        return getCapacity () - getNumReady ();
+    }
+
+    /** Returns true if the fifo is empty */
+    bool isEmpty () const noexcept
+    {
+        return getNumReady () == 0;
+    }
+
+    /** Returns true if the fifo is full */
+    bool isFull () const noexcept
+    {
+        return getFreeSpace () == 0;
+    }
+
+private:
+
+    static int clampCount (const int wanted, const unsigned int available) noexcept
+    {
+        if (wanted <= 0)
+            return 0;
+
+        return (unsigned int) wanted < available ? wanted : (int) available;
+    }
+
+    // shared, never written after construction
+    const unsigned int capacity, mask;
+    ElementType* const buffer;
+    char padding0 [LockFreeFifoHelpers::cacheLineSize];
+
+    // written by the writer
+    std::atomic<unsigned int> writeIndex;
+    unsigned int cachedReadIndex;
+    char padding1 [LockFreeFifoHelpers::cacheLineSize - sizeof (std::atomic<unsigned int>) - sizeof (unsigned int)];
+
+    // written by the reader
+    std::atomic<unsigned int> readIndex;
+    unsigned int cachedWriteIndex;
+    char padding2 [LockFreeFifoHelpers::cacheLineSize - sizeof (std::atomic<unsigned int>) - sizeof (unsigned int)];
+
+    LockFreeFifo (const LockFreeFifo&);
+    LockFreeFifo& operator= (const LockFreeFifo&);
 };
 
- 
 //==============================================================================
-/*
-    Implementation of a circular buffer
- 
-    - <typename T> specifies the samples type (i.e. use <float> for VST)
-    - The buffer is memory aligned for better performance
+/**
+    Multiple writer, single reader FIFO
+
+    push() can be called from any number of threads at once, pop() only from
+    one reader thread at a time. Writers claim their slots with a single
+    compare-and-swap and mark each slot once it has been written, so a slow
+    writer only holds back the reader, never the other writers.
 */
 template<class ElementType>
-class LockFreeFifo
+class LockFreeMPSCFifo
 {
 public:
 
     //==============================================================================
     /** Constructor */
-    LockFreeFifo (int32 bufferSize_)
-        : readIndex (0),
-          writeIndex (0),
-          bufferSize (bufferSize_),
-          buffer (0)
+    explicit LockFreeMPSCFifo (int minimumCapacity)
+        : capacity (LockFreeFifoHelpers::roundUpToPowerOfTwo (minimumCapacity)),
+          mask (capacity - 1),
+          buffer (new ElementType [capacity]),
+          sequences (new std::atomic<unsigned int> [capacity])
     {
-        buffer = new ElementType [bufferSize];
+        for (unsigned int i = 0; i < capacity; ++i)
+            sequences [i].store (0);
+
+        writeIndex.store (0);
+        readIndex.store (0);
     }
 
-    ~LockFreeFifo ()
+    ~LockFreeMPSCFifo ()
     {
+        delete[] sequences;
         delete[] buffer;
     }
 
     //==============================================================================
     /**
-        Get a value from the FIFO
+        Copies up to numItems items into the FIFO, from any thread
+
+        The items pushed by one call stay together and in order. Returns the
+        number of items that fitted.
     */
-    ElementType get ()
+    int push (const ElementType* items, const int numItems) noexcept
     {
-        if (readIndex == writeIndex)
+        if (numItems <= 0)
+            return 0;
+
+        unsigned int write = writeIndex.load (std::memory_order_relaxed);
+        unsigned int num;
+
+        for (;;)
         {
-            return (ElementType) 0;
+            const unsigned int used = write - readIndex.load (std::memory_order_acquire);
+
+            // another writer moved on since we loaded the write index
+            if (used > capacity)
+            {
+                write = writeIndex.load (std::memory_order_relaxed);
+                continue;
+            }
+
+            num = capacity - used;
+
+            if (num == 0)
+                return 0;
+
+            if ((unsigned int) numItems < num)
+                num = (unsigned int) numItems;
+
+            if (writeIndex.compare_exchange_weak (write, write + num, std::memory_order_relaxed))
+                break;
         }
 
-        ElementType data = buffer [readIndex];
+        // a slot is ready once its sequence holds its position plus one
+        for (unsigned int i = 0; i < num; ++i)
+        {
+            const unsigned int slot = (write + i) & mask;
+            buffer [slot] = items [i];
+            sequences [slot].store (write + i + 1, std::memory_order_release);
+        }
 
-        readIndex = (readIndex + 1) % bufferSize;
+        return (int) num;
+    }
 
-        return data;
+    /** Adds a single item, returns false if the FIFO is full */
+    bool push (const ElementType& item) noexcept
+    {
+        return push (&item, 1) == 1;
     }
 
     //==============================================================================
     /**
-        Feed in a new value to the FIFO
+        Copies up to numItems items out of the FIFO, reader thread only
+
+        Stops at the first slot a writer hasn't finished yet. Returns the
+        number of items that were ready.
     */
-    void put (ElementType data)
+    int pop (ElementType* items, const int numItems) noexcept
     {
-        int32 newIndex = (writeIndex + 1) % bufferSize;
+        const unsigned int read = readIndex.load (std::memory_order_relaxed);
+        int num = 0;
 
-        if (newIndex == readIndex)
+        while (num < numItems)
         {
-            return;
+            const unsigned int slot = (read + num) & mask;
+
+            if (sequences [slot].load (std::memory_order_acquire) != read + num + 1)
+                break;
+
+            items [num] = buffer [slot];
+            ++num;
         }
 
-        buffer [writeIndex] = data;
+        readIndex.store (read + num, std::memory_order_release);
+        return num;
+    }
 
-        writeIndex = newIndex;
+    /** Takes a single item, returns false if the FIFO is empty */
+    bool pop (ElementType& item) noexcept
+    {
+        return pop (&item, 1) == 1;
     }
 
     //==============================================================================
-    /**
-        Returns true if the fifo is empty
-    */
-    bool isEmpty () const 
+    /** Returns the number of items the FIFO can hold */
+    int getCapacity () const noexcept
     {
-        return readIndex == writeIndex;   
+        return (int) capacity;
     }
 
-    /**
-        Returns true if the fifo is full
-    */
-    bool isFull () const 
+    /** Returns true if there is nothing to read, reader thread only */
+    bool isEmpty () const noexcept
     {
-        return ((writeIndex + 1) % bufferSize) == readIndex;   
+        const unsigned int read = readIndex.load (std::memory_order_relaxed);
+        return sequences [read & mask].load (std::memory_order_acquire) != read + 1;
+    }
+
+    /** Returns true if no more items can be pushed right now */
+    bool isFull () const noexcept
+    {
+        const unsigned int read = readIndex.load (std::memory_order_acquire);
+        return writeIndex.load (std::memory_order_relaxed) - read >= capacity;
     }
 
 private:
 
-    volatile int32 readIndex, writeIndex, bufferSize;
-    ElementType* buffer;
+    // shared, never written after construction
+    const unsigned int capacity, mask;
+    ElementType* const buffer;
+    std::atomic<unsigned int>* const sequences;
+    char padding0 [LockFreeFifoHelpers::cacheLineSize];
+
+    // written by the writers
+    std::atomic<unsigned int> writeIndex;
+    char padding1 [LockFreeFifoHelpers::cacheLineSize - sizeof (std::atomic<unsigned int>)];
+
+    // written by the reader
+    std::atomic<unsigned int> readIndex;
+    char padding2 [LockFreeFifoHelpers::cacheLineSize - sizeof (std::atomic<unsigned int>)];
+
+    LockFreeMPSCFifo (const LockFreeMPSCFifo&);
+    LockFreeMPSCFifo& operator= (const LockFreeMPSCFifo&);
 };
 
 #endif
-
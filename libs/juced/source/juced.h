@@ -38,6 +38,8 @@
 #include "../../juce-legacy/source/modules/juce_gui_basics/juce_gui_basics.h"
 #include "../../juce-legacy/source/modules/juce_gui_extra/juce_gui_extra.h"
 
+#include <atomic>
+
 #define BEGIN_JUCE_NAMESPACE namespace juce {
 #define END_JUCE_NAMESPACE }
 
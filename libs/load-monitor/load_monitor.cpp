@@ -0,0 +1,140 @@
+/*
+ * DSP load monitor for plugins built with the 'load-telemetry' option
+ */
+
+#include "JucePluginLoadTelemetry.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace JucePluginLoadTelemetry;
+
+static void printUsage(const char* const name)
+{
+    printf("usage: %s [-1] [-i seconds]\n", name);
+    printf("  -1          print once and exit\n");
+    printf("  -i seconds  refresh interval, default 1\n");
+}
+
+static void printInstances(const SharedBlock& block)
+{
+    printf("%7s %5s %-5s %-24s %7s %6s %7s %7s %9s %9s %9s %9s\n",
+           "PID", "ID", "FMT", "PLUGIN", "RATE", "BLOCK", "MEAN%", "WORST%",
+           "MEAN us", "WORST us", "OVERRUNS", "NEAR");
+
+    int numInstances = 0;
+
+    for (uint32_t i = 0; i < block.numSlots && i < (uint32_t)maxInstances; ++i)
+    {
+        int32_t pid;
+        uint64_t pidNamespace;
+        uint32_t instanceId;
+        char pluginName[64];
+        char format[12];
+        InstanceStats stats;
+
+        if (! readSlot(block.slots[i], pid, pidNamespace, instanceId, pluginName, format, stats))
+            continue;
+
+        // slots of crashed hosts stay until another instance in their pid namespace reclaims them,
+        // the ones from other namespaces are shown with pids that don't mean anything here
+        if (! isOwnerAlive(pid, pidNamespace))
+            continue;
+
+        printf("%7d %5u %-5s %-24.24s %7.0f %6u %7.1f %7.1f %9.1f %9.1f %9llu %9llu\n",
+               (int)pid, instanceId, format, pluginName,
+               stats.sampleRate, stats.lastBlockSize,
+               stats.meanLoad * 100.0f, stats.worstLoad * 100.0f,
+               stats.meanMicros, stats.worstMicros,
+               (unsigned long long)stats.numOverruns, (unsigned long long)stats.numNearOverruns);
+
+        ++numInstances;
+    }
+
+    if (numInstances == 0)
+        printf("(no running plugin instances)\n");
+}
+
+int main(int argc, char* argv[])
+{
+    bool once = false;
+    double interval = 1.0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "-1") == 0)
+        {
+            once = true;
+        }
+        else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc)
+        {
+            interval = atof(argv[++i]);
+
+            if (interval <= 0.0)
+                interval = 1.0;
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    const int fd = shm_open(sharedMemoryName, O_RDONLY, 0);
+
+    if (fd < 0)
+    {
+        printf("No plugin has published its load yet (%s: %s)\n", sharedMemoryName, strerror(errno));
+        return 1;
+    }
+
+    struct stat st;
+
+    if (fstat(fd, &st) != 0 || st.st_size != (off_t)sizeof(SharedBlock))
+    {
+        printf("Shared memory %s has an unexpected size, plugins and monitor are from different builds\n", sharedMemoryName);
+        close(fd);
+        return 1;
+    }
+
+    void* const address = mmap(nullptr, sizeof(SharedBlock), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (address == MAP_FAILED)
+    {
+        printf("Failed to map %s: %s\n", sharedMemoryName, strerror(errno));
+        return 1;
+    }
+
+    const SharedBlock& block = *static_cast<const SharedBlock*>(address);
+
+    if (block.magic.load(std::memory_order_acquire) != sharedMemoryMagic || block.version != sharedMemoryVersion)
+    {
+        printf("Shared memory %s has an unknown format\n", sharedMemoryName);
+        munmap(address, sizeof(SharedBlock));
+        return 1;
+    }
+
+    for (;;)
+    {
+        if (! once)
+            printf("\033[H\033[2J");
+
+        printInstances(block);
+        fflush(stdout);
+
+        if (once)
+            break;
+
+        usleep((useconds_t)(interval * 1000000.0));
+    }
+
+    munmap(address, sizeof(SharedBlock));
+    return 0;
+}
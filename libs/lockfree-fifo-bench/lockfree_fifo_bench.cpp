@@ -0,0 +1,177 @@
+/*
+ * juced lock-free FIFO benchmark and stress test
+ *
+ * Runs LockFreeFifo with one writer and LockFreeMPSCFifo with several, at a
+ * few batch sizes, and prints the throughput. Every item is checked on the
+ * reader side, items from each writer must arrive complete and in order.
+ *
+ * Configure with -Db_sanitize=thread to run it under ThreadSanitizer.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "containers/jucetice_LockFreeFifo.h"
+
+static const int kFifoSize = 4096;
+static const int kMaxBatch = 256;
+
+// writer index in the top byte, per-writer counter below it
+static const unsigned int kCounterBits = 24;
+static const unsigned int kCounterMask = (1u << kCounterBits) - 1;
+
+struct Result {
+    unsigned long long numItems;
+    double seconds;
+    bool valid;
+};
+
+template<class Fifo>
+static Result run(const int numWriters, const int batchSize, const unsigned int itemsPerWriter)
+{
+    Fifo fifo(kFifoSize);
+    std::atomic<bool> start(false);
+    std::vector<std::thread> writers;
+
+    for (int w = 0; w < numWriters; ++w)
+    {
+        writers.push_back(std::thread([&fifo, &start, w, batchSize, itemsPerWriter]() {
+            unsigned int batch[kMaxBatch];
+            unsigned int counter = 0;
+
+            while (! start.load(std::memory_order_acquire))
+                std::this_thread::yield();
+
+            while (counter < itemsPerWriter)
+            {
+                int num = batchSize;
+                if ((unsigned int)num > itemsPerWriter - counter)
+                    num = (int)(itemsPerWriter - counter);
+
+                for (int i = 0; i < num; ++i)
+                    batch[i] = ((unsigned int)w << kCounterBits) | ((counter + i) & kCounterMask);
+
+                // a batch may go in over several calls when the FIFO is nearly full
+                for (int done = 0; done < num;)
+                {
+                    const int pushed = fifo.push(batch + done, num - done);
+                    done += pushed;
+                    if (pushed == 0)
+                        std::this_thread::yield();
+                }
+
+                counter += num;
+            }
+        }));
+    }
+
+    std::vector<unsigned int> expected(numWriters, 0);
+    const unsigned long long total = (unsigned long long)itemsPerWriter * numWriters;
+    unsigned long long received = 0;
+    unsigned int items[kMaxBatch];
+    bool valid = true;
+
+    const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+
+    while (received < total && valid)
+    {
+        const int num = fifo.pop(items, batchSize);
+
+        if (num == 0)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        for (int i = 0; i < num; ++i)
+        {
+            const unsigned int w = items[i] >> kCounterBits;
+
+            if (w >= (unsigned int)numWriters || (items[i] & kCounterMask) != (expected[w] & kCounterMask))
+            {
+                printf("bad item %08x after %llu items\n", items[i], received + i);
+                valid = false;
+                break;
+            }
+
+            ++expected[w];
+        }
+
+        received += num;
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    // let the writers finish if we stopped early
+    while (! valid && received < total)
+    {
+        const int num = fifo.pop(items, kMaxBatch);
+        if (num == 0)
+            std::this_thread::yield();
+        received += num;
+    }
+
+    for (size_t i = 0; i < writers.size(); ++i)
+        writers[i].join();
+
+    const Result result = { received, seconds, valid };
+    return result;
+}
+
+static void print(const char* const name, const int numWriters, const int batchSize, const Result& result)
+{
+    printf("%-6s %8d %8d %12.2f %s\n", name, numWriters, batchSize,
+           result.seconds > 0.0 ? result.numItems / result.seconds / 1e6 : 0.0,
+           result.valid ? "ok" : "FAILED");
+}
+
+int main(int argc, char* argv[])
+{
+    unsigned int numItems = 4000000;
+    int numWriters = 4;
+    bool validArgs = true;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+            numItems = (unsigned int)atoi(argv[++i]);
+        else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc)
+            numWriters = atoi(argv[++i]);
+        else
+            validArgs = false;
+    }
+
+    if (! validArgs || numItems < 1 || numWriters < 1 || numWriters > 255)
+    {
+        printf("usage: %s [-n items-per-writer] [-w mpsc-writers]\n", argv[0]);
+        return 1;
+    }
+
+    static const int batchSizes[] = { 1, 16, kMaxBatch };
+    bool valid = true;
+
+    printf("%-6s %8s %8s %12s\n", "FIFO", "WRITERS", "BATCH", "M ITEMS/S");
+
+    for (size_t i = 0; i < sizeof(batchSizes) / sizeof(batchSizes[0]); ++i)
+    {
+        const Result result = run<LockFreeFifo<unsigned int> >(1, batchSizes[i], numItems);
+        print("spsc", 1, batchSizes[i], result);
+        valid = valid && result.valid;
+    }
+
+    for (size_t i = 0; i < sizeof(batchSizes) / sizeof(batchSizes[0]); ++i)
+    {
+        const Result result = run<LockFreeMPSCFifo<unsigned int> >(numWriters, batchSizes[i], numItems);
+        print("mpsc", numWriters, batchSizes[i], result);
+        valid = valid && result.valid;
+    }
+
+    return valid ? 0 : 2;
+}
@@ -0,0 +1,229 @@
+/*
+ * JUCE LV2 instantiate-time benchmark
+ *
+ * Loads a plugin binary and times, for several instances in a row,
+ * instantiate, activate plus the first run, and optionally opening the
+ * external UI. Later instances show how much work is shared between them.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <dlfcn.h>
+
+#include "includes/lv2.h"
+#include "includes/atom.h"
+#include "includes/buf-size.h"
+#include "includes/instance-access.h"
+#include "includes/options.h"
+#include "includes/ui.h"
+#include "includes/urid.h"
+#include "includes/lv2_external_ui.h"
+
+// the JUCE wrappers ignore indices past their last port, so connecting this many is safe
+static const uint32_t kMaxPorts = 1024;
+static const uint32_t kPortBufferSize = 16384;
+
+typedef const LV2_Descriptor* (*LV2_Descriptor_Function)(uint32_t index);
+typedef const LV2UI_Descriptor* (*LV2UI_Descriptor_Function)(uint32_t index);
+
+static std::vector<std::string> sURIs;
+
+static LV2_URID mapURI(LV2_URID_Map_Handle, const char* uri)
+{
+    for (size_t i = 0; i < sURIs.size(); ++i)
+        if (sURIs[i] == uri)
+            return (LV2_URID)(i + 1);
+
+    sURIs.push_back(uri);
+    return (LV2_URID)sURIs.size();
+}
+
+static void uiClosed(LV2UI_Controller)
+{
+}
+
+static void uiWrite(LV2UI_Controller, uint32_t, uint32_t, uint32_t, const void*)
+{
+}
+
+static double millisecondsSince(const std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[])
+{
+    int numInstances = 4;
+    int blockSize = 512;
+    double sampleRate = 48000.0;
+    bool openUI = false;
+    const char* path = nullptr;
+    bool validArgs = true;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+            numInstances = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc)
+            blockSize = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+            sampleRate = atof(argv[++i]);
+        else if (strcmp(argv[i], "-u") == 0)
+            openUI = true;
+        else if (path == nullptr && argv[i][0] != '-')
+            path = argv[i];
+        else
+            validArgs = false;
+    }
+
+    if (! validArgs || path == nullptr || numInstances < 1 || blockSize < 1 || blockSize * sizeof(float) > kPortBufferSize || sampleRate <= 0.0)
+    {
+        printf("usage: %s [-n instances] [-b block-size] [-r sample-rate] [-u] /path/to/plugin-DLL\n", argv[0]);
+        printf("  -u  also open and close the external UI of every instance, needs a display\n");
+        return 1;
+    }
+
+    const std::chrono::steady_clock::time_point loadStart = std::chrono::steady_clock::now();
+    void* const handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+
+    if (! handle)
+    {
+        printf("Failed to open plugin DLL, error was:\n%s\n", dlerror());
+        return 2;
+    }
+
+    const double loadTime = millisecondsSince(loadStart);
+
+    const LV2_Descriptor_Function descFn = (LV2_Descriptor_Function)dlsym(handle, "lv2_descriptor");
+    const LV2_Descriptor* const desc = descFn != nullptr ? descFn(0) : nullptr;
+
+    if (desc == nullptr)
+    {
+        printf("Failed to find LV2 plugin descriptor\n");
+        dlclose(handle);
+        return 2;
+    }
+
+    const LV2UI_Descriptor* uiDesc = nullptr;
+
+    if (openUI)
+    {
+        if (const LV2UI_Descriptor_Function uiDescFn = (LV2UI_Descriptor_Function)dlsym(handle, "lv2ui_descriptor"))
+        {
+            for (uint32_t i = 0; const LV2UI_Descriptor* const d = uiDescFn(i); ++i)
+            {
+                const size_t len = strlen(d->URI);
+
+                if (len > 11 && strcmp(d->URI + len - 11, "#ExternalUI") == 0)
+                {
+                    uiDesc = d;
+                    break;
+                }
+            }
+        }
+
+        if (uiDesc == nullptr)
+            printf("Plugin has no external UI, skipping UI timing\n");
+    }
+
+    // host features
+    LV2_URID_Map uridMap = { nullptr, mapURI };
+    const LV2_Feature uridMapFeature = { LV2_URID__map, &uridMap };
+
+    const int32_t blockLength = blockSize;
+    const LV2_Options_Option options[] = {
+        { LV2_OPTIONS_INSTANCE, 0, mapURI(nullptr, LV2_BUF_SIZE__maxBlockLength),
+          sizeof(int32_t), mapURI(nullptr, LV2_ATOM__Int), &blockLength },
+        { LV2_OPTIONS_INSTANCE, 0, mapURI(nullptr, LV2_BUF_SIZE__nominalBlockLength),
+          sizeof(int32_t), mapURI(nullptr, LV2_ATOM__Int), &blockLength },
+        { LV2_OPTIONS_INSTANCE, 0, 0, 0, 0, nullptr }
+    };
+    const LV2_Feature optionsFeature = { LV2_OPTIONS__options, (void*)options };
+
+    const LV2_Feature* const features[] = { &uridMapFeature, &optionsFeature, nullptr };
+
+    // zeroed port buffers, an atom sequence of size 0 is a valid empty one
+    std::vector<char> portBuffers((size_t)kMaxPorts * kPortBufferSize, 0);
+
+    printf("%s\n", desc->URI);
+    printf("dlopen: %.2f ms\n", loadTime);
+    printf("%9s %14s %14s %14s\n", "INSTANCE", "INSTANTIATE", "FIRST RUN", uiDesc != nullptr ? "UI OPEN" : "");
+
+    std::vector<LV2_Handle> instances;
+
+    for (int n = 0; n < numInstances; ++n)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        const LV2_Handle instance = desc->instantiate(desc, sampleRate, "", features);
+        const double instantiateTime = millisecondsSince(start);
+
+        if (instance == nullptr)
+        {
+            printf("Failed to instantiate plugin\n");
+            break;
+        }
+
+        instances.push_back(instance);
+
+        for (uint32_t i = 0; i < kMaxPorts; ++i)
+            desc->connect_port(instance, i, &portBuffers[(size_t)i * kPortBufferSize]);
+
+        start = std::chrono::steady_clock::now();
+        if (desc->activate != nullptr)
+            desc->activate(instance);
+        desc->run(instance, (uint32_t)blockSize);
+        const double firstRunTime = millisecondsSince(start);
+
+        double uiTime = 0.0;
+
+        if (uiDesc != nullptr)
+        {
+            LV2_External_UI_Host uiHost = { uiClosed, desc->URI };
+            const LV2_Feature uiHostFeature = { LV2_EXTERNAL_UI__Host, &uiHost };
+            const LV2_Feature instanceAccessFeature = { LV2_INSTANCE_ACCESS_URI, instance };
+            const LV2_Feature* const uiFeatures[] = { &uridMapFeature, &uiHostFeature, &instanceAccessFeature, nullptr };
+
+            LV2UI_Widget widget = nullptr;
+
+            start = std::chrono::steady_clock::now();
+            const LV2UI_Handle ui = uiDesc->instantiate(uiDesc, desc->URI, "", uiWrite, nullptr, &widget, uiFeatures);
+
+            if (ui != nullptr && widget != nullptr)
+            {
+                LV2_EXTERNAL_UI_SHOW((LV2_External_UI_Widget*)widget);
+                LV2_EXTERNAL_UI_RUN((LV2_External_UI_Widget*)widget);
+            }
+
+            uiTime = millisecondsSince(start);
+
+            if (ui != nullptr)
+            {
+                if (widget != nullptr)
+                    LV2_EXTERNAL_UI_HIDE((LV2_External_UI_Widget*)widget);
+
+                uiDesc->cleanup(ui);
+            }
+        }
+
+        if (uiDesc != nullptr)
+            printf("%9d %11.2f ms %11.2f ms %11.2f ms\n", n + 1, instantiateTime, firstRunTime, uiTime);
+        else
+            printf("%9d %11.2f ms %11.2f ms\n", n + 1, instantiateTime, firstRunTime);
+    }
+
+    for (size_t i = 0; i < instances.size(); ++i)
+    {
+        if (desc->deactivate != nullptr)
+            desc->deactivate(instances[i]);
+        desc->cleanup(instances[i]);
+    }
+
+    dlclose(handle);
+    return 0;
+}
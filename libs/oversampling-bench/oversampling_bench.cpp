@@ -0,0 +1,189 @@
+/*
+ * juce::dsp::Oversampling benchmark
+ *
+ * Runs 2x to 16x up/down round trips of the legacy JUCE oversampling, with
+ * both filter types, on mono, stereo and 8-channel blocks. Every block is
+ * processed once by a multi-channel instance, which filters the channels
+ * together in SIMD lanes, and once by one mono instance per channel, which
+ * is the plain scalar code. Prints the time per input sample and channel of
+ * both, and checks that their outputs match.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+
+#include <juce_dsp/juce_dsp.h>
+
+using namespace juce;
+
+typedef dsp::Oversampling<float> Oversampling;
+
+static const int kNumChannels[] = { 1, 2, 8 };
+
+struct Measurement {
+    double nsMulti;
+    double nsMono;
+    float maxDifference;
+};
+
+// a few partials and some noise, different on each channel
+static void fillInput(AudioBuffer<float>& input, Random& random)
+{
+    for (int c = 0; c < input.getNumChannels(); ++c)
+    {
+        float* const data = input.getWritePointer(c);
+
+        for (int i = 0; i < input.getNumSamples(); ++i)
+            data[i] = 0.4f * std::sin(0.031f * (c + 1) * i)
+                    + 0.2f * std::sin(0.73f * i + c)
+                    + 0.1f * (random.nextFloat() * 2.0f - 1.0f);
+    }
+}
+
+// stands in for the oversampled processing, cheap enough not to hide the filters
+static void processOversampled(dsp::AudioBlock<float> block)
+{
+    for (size_t c = 0; c < block.getNumChannels(); ++c)
+    {
+        float* const data = block.getChannelPointer(c);
+
+        for (size_t i = 0; i < block.getNumSamples(); ++i)
+            data[i] = jlimit(-0.5f, 0.5f, data[i]);
+    }
+}
+
+static void roundTrip(Oversampling& oversampling, dsp::AudioBlock<float>& block)
+{
+    processOversampled(oversampling.processSamplesUp(block));
+    oversampling.processSamplesDown(block);
+}
+
+static Measurement run(const Oversampling::FilterType type, const int factor, const int numChannels,
+                  const int blockSize, const int numBlocks)
+{
+    Oversampling multi((size_t)numChannels, (size_t)factor, type, false);
+    OwnedArray<Oversampling> mono;
+
+    multi.initProcessing((size_t)blockSize);
+
+    for (int c = 0; c < numChannels; ++c)
+    {
+        mono.add(new Oversampling(1, (size_t)factor, type, false));
+        mono.getLast()->initProcessing((size_t)blockSize);
+    }
+
+    AudioBuffer<float> input(numChannels, blockSize * numBlocks);
+    AudioBuffer<float> outputMulti(numChannels, blockSize * numBlocks);
+    AudioBuffer<float> outputMono(numChannels, blockSize * numBlocks);
+
+    Random random(0x5eed);
+    fillInput(input, random);
+
+    outputMulti.makeCopyOf(input);
+    outputMono.makeCopyOf(input);
+
+    dsp::AudioBlock<float> blockMulti(outputMulti);
+    dsp::AudioBlock<float> blockMono(outputMono);
+
+    const std::chrono::steady_clock::time_point startMulti = std::chrono::steady_clock::now();
+
+    for (int b = 0; b < numBlocks; ++b)
+    {
+        dsp::AudioBlock<float> block(blockMulti.getSubBlock((size_t)(b * blockSize), (size_t)blockSize));
+        roundTrip(multi, block);
+    }
+
+    const std::chrono::steady_clock::time_point startMono = std::chrono::steady_clock::now();
+
+    for (int b = 0; b < numBlocks; ++b)
+    {
+        for (int c = 0; c < numChannels; ++c)
+        {
+            dsp::AudioBlock<float> block(blockMono.getSingleChannelBlock((size_t)c)
+                                             .getSubBlock((size_t)(b * blockSize), (size_t)blockSize));
+            roundTrip(*mono[c], block);
+        }
+    }
+
+    const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    float maxDifference = 0.0f;
+
+    for (int c = 0; c < numChannels; ++c)
+    {
+        const float* const a = outputMulti.getReadPointer(c);
+        const float* const b = outputMono.getReadPointer(c);
+
+        for (int i = 0; i < outputMulti.getNumSamples(); ++i)
+            maxDifference = jmax(maxDifference, std::abs(a[i] - b[i]));
+    }
+
+    const double numSamples = (double)blockSize * numBlocks * numChannels;
+
+    const Measurement result = {
+        std::chrono::duration<double, std::nano>(startMono - startMulti).count() / numSamples,
+        std::chrono::duration<double, std::nano>(end - startMono).count() / numSamples,
+        maxDifference,
+    };
+    return result;
+}
+
+int main(int argc, char* argv[])
+{
+    int blockSize = 256;
+    int numBlocks = 2000;
+    bool validArgs = true;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "-b") == 0 && i + 1 < argc)
+            blockSize = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+            numBlocks = atoi(argv[++i]);
+        else
+            validArgs = false;
+    }
+
+    if (! validArgs || blockSize < 1 || numBlocks < 1)
+    {
+        printf("usage: %s [-b block-size] [-n blocks]\n", argv[0]);
+        return 1;
+    }
+
+   #if JUCE_USE_SIMD
+    printf("SIMD lanes: %d\n", (int)dsp::SIMDRegister<float>::size());
+   #else
+    printf("SIMD lanes: none\n");
+   #endif
+    printf("%-4s %6s %8s %14s %14s %8s %12s\n",
+           "TYPE", "FACTOR", "CHANNELS", "MULTI NS/SMP", "MONO NS/SMP", "SPEEDUP", "MAX DIFF");
+
+    bool valid = true;
+
+    for (int t = 0; t < 2; ++t)
+    {
+        const Oversampling::FilterType type = t == 0 ? Oversampling::filterHalfBandPolyphaseIIR
+                                                     : Oversampling::filterHalfBandFIREquiripple;
+
+        for (int factor = 1; factor <= 4; ++factor)
+        {
+            for (size_t i = 0; i < sizeof(kNumChannels) / sizeof(kNumChannels[0]); ++i)
+            {
+                const Measurement result = run(type, factor, kNumChannels[i], blockSize, numBlocks);
+                const bool matches = result.maxDifference <= 1e-5f;
+
+                printf("%-4s %5dx %8d %14.2f %14.2f %7.2fx %12g %s\n",
+                       t == 0 ? "iir" : "fir", 1 << factor, kNumChannels[i],
+                       result.nsMulti, result.nsMono, result.nsMono / result.nsMulti,
+                       result.maxDifference, matches ? "ok" : "FAILED");
+
+                valid = valid && matches;
+            }
+        }
+    }
+
+    return valid ? 0 : 2;
+}
@@ -0,0 +1,332 @@
+/*
+ * VST3 sample-accurate automation test
+ *
+ * Feeds multi-point parameter queues through the IParameterChanges and
+ * IParamValueQueue interfaces into VST3AutomationSubBlocks, the splitter the
+ * VST3 wrapper uses with JUCE_VST3_SAMPLE_ACCURATE_AUTOMATION, like a host
+ * does in process(). Checks where the block is split, the parameter values
+ * each sub-block sees and the values left after the block, and that a block
+ * which isn't processed still leaves the same values behind.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <memory>
+#include <vector>
+
+#include <juce_core/juce_core.h>
+
+#include "pluginterfaces/vst/ivstparameterchanges.h"
+
+#include "juce_audio_plugin_client/utility/juce_VST3AutomationSubBlocks.h"
+
+using namespace juce;
+using namespace Steinberg;
+
+static const int kNumParams = 3;
+
+// not 0-based, so a mixed-up index and ID shows up
+static const Vst::ParamID kFirstParamID = 1000;
+
+//==============================================================================
+// What a host hands over, reference counting and interface queries are not used here
+
+class ParamValueQueue : public Vst::IParamValueQueue
+{
+public:
+    struct Point {
+        int32 sampleOffset;
+        double value;
+    };
+
+    explicit ParamValueQueue(Vst::ParamID id) : paramID(id) {}
+
+    tresult PLUGIN_API queryInterface(const TUID, void** obj) override { *obj = nullptr; return kNoInterface; }
+    uint32 PLUGIN_API addRef() override { return 1; }
+    uint32 PLUGIN_API release() override { return 1; }
+
+    Vst::ParamID PLUGIN_API getParameterId() override { return paramID; }
+    int32 PLUGIN_API getPointCount() override { return (int32) points.size(); }
+
+    tresult PLUGIN_API getPoint(int32 index, int32& sampleOffset, Vst::ParamValue& value) override
+    {
+        if (index < 0 || index >= (int32) points.size())
+            return kResultFalse;
+
+        sampleOffset = points[(size_t) index].sampleOffset;
+        value = points[(size_t) index].value;
+        return kResultTrue;
+    }
+
+    tresult PLUGIN_API addPoint(int32 sampleOffset, Vst::ParamValue value, int32& index) override
+    {
+        index = (int32) points.size();
+        points.push_back({ sampleOffset, value });
+        return kResultTrue;
+    }
+
+private:
+    Vst::ParamID paramID;
+    std::vector<Point> points;
+};
+
+class ParameterChanges : public Vst::IParameterChanges
+{
+public:
+    tresult PLUGIN_API queryInterface(const TUID, void** obj) override { *obj = nullptr; return kNoInterface; }
+    uint32 PLUGIN_API addRef() override { return 1; }
+    uint32 PLUGIN_API release() override { return 1; }
+
+    int32 PLUGIN_API getParameterCount() override { return (int32) queues.size(); }
+
+    Vst::IParamValueQueue* PLUGIN_API getParameterData(int32 index) override
+    {
+        return index >= 0 && index < (int32) queues.size() ? queues[(size_t) index].get() : nullptr;
+    }
+
+    Vst::IParamValueQueue* PLUGIN_API addParameterData(const Vst::ParamID& id, int32& index) override
+    {
+        for (size_t i = 0; i < queues.size(); ++i)
+        {
+            if (queues[i]->getParameterId() == id)
+            {
+                index = (int32) i;
+                return queues[i].get();
+            }
+        }
+
+        index = (int32) queues.size();
+        queues.push_back(std::unique_ptr<ParamValueQueue>(new ParamValueQueue(id)));
+        return queues.back().get();
+    }
+
+private:
+    std::vector<std::unique_ptr<ParamValueQueue>> queues;
+};
+
+//==============================================================================
+struct Point {
+    int param;
+    int32 sampleOffset;
+    double value;
+};
+
+struct SubBlock {
+    int start;
+    int numSamples;
+    double values[kNumParams];
+};
+
+struct TestCase {
+    const char* name;
+    int numSamples;
+    int minSubBlockSize;
+    std::vector<Point> points;       // queues are created in order of their first point
+    std::vector<SubBlock> expected;
+    double finalValues[kNumParams];
+};
+
+// a point on every sample of every queue, far more points than queues
+static std::vector<Point> densePoints(int numSamples)
+{
+    std::vector<Point> points;
+
+    for (int param = 0; param < kNumParams; ++param)
+        for (int32 offset = 1; offset < numSamples; ++offset)
+            points.push_back({ param, offset, offset / (double) numSamples });
+
+    return points;
+}
+
+static const std::vector<TestCase> kTestCases = {
+    { "no points", 256, 32,
+        {},
+        { { 0, 256, { 0.0, 0.0, 0.0 } } },
+        { 0.0, 0.0, 0.0 } },
+
+    { "point at 0", 256, 32,
+        { { 0, 0, 0.5 } },
+        { { 0, 256, { 0.5, 0.0, 0.0 } } },
+        { 0.5, 0.0, 0.0 } },
+
+    { "one queue", 256, 32,
+        { { 0, 64, 0.25 }, { 0, 128, 0.5 }, { 0, 192, 0.75 } },
+        { { 0, 64, { 0.0, 0.0, 0.0 } },
+          { 64, 64, { 0.25, 0.0, 0.0 } },
+          { 128, 64, { 0.5, 0.0, 0.0 } },
+          { 192, 64, { 0.75, 0.0, 0.0 } } },
+        { 0.75, 0.0, 0.0 } },
+
+    { "interleaved queues", 256, 32,
+        { { 0, 0, 0.1 }, { 0, 100, 0.2 }, { 0, 200, 0.3 },
+          { 1, 50, 0.6 }, { 1, 150, 0.7 },
+          { 2, 100, 0.9 } },
+        { { 0, 50, { 0.1, 0.0, 0.0 } },
+          { 50, 50, { 0.1, 0.6, 0.0 } },
+          { 100, 50, { 0.2, 0.6, 0.9 } },
+          { 150, 50, { 0.2, 0.7, 0.9 } },
+          { 200, 56, { 0.3, 0.7, 0.9 } } },
+        { 0.3, 0.7, 0.9 } },
+
+    { "closer than minimum", 256, 32,
+        { { 0, 40, 0.1 }, { 0, 50, 0.2 }, { 0, 60, 0.3 }, { 1, 70, 0.4 }, { 1, 110, 0.5 } },
+        { { 0, 40, { 0.0, 0.0, 0.0 } },
+          { 40, 32, { 0.1, 0.0, 0.0 } },
+          { 72, 38, { 0.3, 0.4, 0.0 } },
+          { 110, 146, { 0.3, 0.5, 0.0 } } },
+        { 0.3, 0.5, 0.0 } },
+
+    { "first point early", 256, 32,
+        { { 0, 10, 0.5 } },
+        { { 0, 32, { 0.0, 0.0, 0.0 } },
+          { 32, 224, { 0.5, 0.0, 0.0 } } },
+        { 0.5, 0.0, 0.0 } },
+
+    { "short remainder", 256, 32,
+        { { 0, 128, 0.5 }, { 1, 240, 0.8 } },
+        { { 0, 128, { 0.0, 0.0, 0.0 } },
+          { 128, 128, { 0.5, 0.0, 0.0 } } },
+        { 0.5, 0.8, 0.0 } },
+
+    { "equal offsets", 256, 32,
+        { { 2, 128, 0.1 }, { 0, 128, 0.2 }, { 2, 128, 0.3 } },
+        { { 0, 128, { 0.0, 0.0, 0.0 } },
+          { 128, 128, { 0.2, 0.0, 0.3 } } },
+        { 0.2, 0.0, 0.3 } },
+
+    { "point past the end", 64, 32,
+        { { 0, 32, 0.5 }, { 1, 100, 0.7 } },
+        { { 0, 32, { 0.0, 0.0, 0.0 } },
+          { 32, 32, { 0.5, 0.0, 0.0 } } },
+        { 0.5, 0.7, 0.0 } },
+
+    { "no minimum", 16, 0,
+        { { 0, 1, 0.1 }, { 0, 2, 0.2 }, { 1, 2, 0.3 }, { 0, 15, 0.4 } },
+        { { 0, 1, { 0.0, 0.0, 0.0 } },
+          { 1, 1, { 0.1, 0.0, 0.0 } },
+          { 2, 13, { 0.2, 0.3, 0.0 } },
+          { 15, 1, { 0.4, 0.3, 0.0 } } },
+        { 0.4, 0.3, 0.0 } },
+
+    { "point on every sample", 64, 16,
+        densePoints(64),
+        { { 0, 16, { 0.0, 0.0, 0.0 } },
+          { 16, 16, { 0.25, 0.25, 0.25 } },
+          { 32, 16, { 0.5, 0.5, 0.5 } },
+          { 48, 16, { 0.75, 0.75, 0.75 } } },
+        { 63 / 64.0, 63 / 64.0, 63 / 64.0 } },
+};
+
+//==============================================================================
+static bool run(const TestCase& test, VST3AutomationSubBlocks& automation)
+{
+    ParameterChanges changes;
+
+    for (size_t i = 0; i < test.points.size(); ++i)
+    {
+        int32 queueIndex, pointIndex;
+
+        if (auto* queue = changes.addParameterData(kFirstParamID + (Vst::ParamID) test.points[i].param, queueIndex))
+            queue->addPoint(test.points[i].sampleOffset, test.points[i].value, pointIndex);
+    }
+
+    double values[kNumParams] = { 0.0, 0.0, 0.0 };
+    bool valid = true;
+
+    const auto applyPoint = [&values, &valid] (Vst::ParamID paramID, double value)
+    {
+        if (paramID >= kFirstParamID && paramID < kFirstParamID + kNumParams)
+            values[paramID - kFirstParamID] = value;
+        else
+            valid = false;
+    };
+
+    // the same steps the wrapper takes in process()
+    automation.clear();
+
+    for (int32 i = 0; i < changes.getParameterCount(); ++i)
+        if (auto* queue = changes.getParameterData(i))
+            automation.addQueue(*queue, applyPoint);
+
+    automation.sortPoints();
+
+    double flushedValues[kNumParams];
+    std::vector<SubBlock> subBlocks;
+
+    automation.process(test.numSamples, test.minSubBlockSize, applyPoint,
+                       [&subBlocks, &values] (int start, int numSamples)
+    {
+        SubBlock subBlock = { start, numSamples, { 0.0, 0.0, 0.0 } };
+        memcpy(subBlock.values, values, sizeof(values));
+        subBlocks.push_back(subBlock);
+    });
+
+    valid = valid && subBlocks.size() == test.expected.size();
+
+    for (size_t i = 0; valid && i < subBlocks.size(); ++i)
+    {
+        valid = subBlocks[i].start == test.expected[i].start
+             && subBlocks[i].numSamples == test.expected[i].numSamples
+             && memcmp(subBlocks[i].values, test.expected[i].values, sizeof(values)) == 0;
+    }
+
+    valid = valid && memcmp(values, test.finalValues, sizeof(values)) == 0;
+
+    // a suspended plugin gets all points at once
+    memcpy(flushedValues, values, sizeof(values));
+    memset(values, 0, sizeof(values));
+    automation.clear();
+
+    for (int32 i = 0; i < changes.getParameterCount(); ++i)
+        if (auto* queue = changes.getParameterData(i))
+            automation.addQueue(*queue, applyPoint);
+
+    automation.sortPoints();
+    automation.flush(applyPoint);
+
+    valid = valid && automation.isEmpty() && memcmp(values, test.finalValues, sizeof(values)) == 0;
+
+    if (! valid)
+    {
+        for (size_t i = 0; i < subBlocks.size(); ++i)
+            printf("    got sub-block %d+%d: %g %g %g\n", subBlocks[i].start, subBlocks[i].numSamples,
+                   subBlocks[i].values[0], subBlocks[i].values[1], subBlocks[i].values[2]);
+
+        printf("    got final values: %g %g %g\n", flushedValues[0], flushedValues[1], flushedValues[2]);
+        printf("    got flushed values: %g %g %g\n", values[0], values[1], values[2]);
+    }
+
+    return valid;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1)
+    {
+        printf("usage: %s\n", argv[0]);
+        return 1;
+    }
+
+    VST3AutomationSubBlocks automation;
+    // one entry per queue, however many points the host sends
+    automation.reserve(kNumParams);
+
+    printf("%24s %8s %8s %10s\n", "CASE", "SAMPLES", "MINIMUM", "SUBBLOCKS");
+
+    bool valid = true;
+
+    for (size_t i = 0; i < kTestCases.size(); ++i)
+    {
+        const TestCase& test = kTestCases[i];
+        const bool passed = run(test, automation);
+
+        printf("%24s %8d %8d %10d %s\n", test.name, test.numSamples, test.minSubBlockSize,
+               (int) test.expected.size(), passed ? "ok" : "FAILED");
+
+        valid = valid && passed;
+    }
+
+    return valid ? 0 : 2;
+}
@@ -16,7 +16,7 @@
 SpectrumAnalyserAudioProcessor::SpectrumAnalyserAudioProcessor()
   : sampleRate {44100.0},
     renderThread("FFT Render Thread"),
-    spectrumProcessor(11) // FFT Size of 2^11 = 2048
+    spectrumProcessor(13, 4, 4) // FFT Sizes of 2^13 = 8192 down to 2^10 = 1024, 75% overlap
 {
     renderThread.addTimeSliceClient (&spectrumProcessor);
     renderThread.startThread (3);
@@ -0,0 +1,140 @@
+/*
+  ==============================================================================
+
+    SpectrumKernels.h
+    Created: 16 Oct 2026
+
+    Vectorised inner loops used by the SpectrumProcessor.
+
+  ==============================================================================
+*/
+
+#ifndef SPECTRUM_KERNELS_H_INCLUDED
+#define SPECTRUM_KERNELS_H_INCLUDED
+
+#include "SpectrumAnalyserHeader.h"
+
+#if defined (__SSE__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 1)
+ #define HIRESAM_USE_SSE 1
+ #include <xmmintrin.h>
+#else
+ #define HIRESAM_USE_SSE 0
+#endif
+
+namespace SpectrumKernels
+{
+
+//==============================================================================
+/** Calculates the scaled magnitudes of an FFT result in split complex format.
+
+    The layout is the one used by drow::FFT, i.e. realp[0] holds DC and imagp[0]
+    holds the Nyquist bin. The destination needs room for fftSizeHalved + 1 values.
+ */
+inline void calculateMagnitudes (float* dest, const float* realp, const float* imagp,
+                                 const int fftSizeHalved, const float scale) noexcept
+{
+    int i = 0;
+
+   #if HIRESAM_USE_SSE
+    const __m128 s = _mm_set1_ps (scale);
+
+    for (; i + 4 <= fftSizeHalved; i += 4)
+    {
+        const __m128 re = _mm_loadu_ps (realp + i);
+        const __m128 im = _mm_loadu_ps (imagp + i);
+        const __m128 sq = _mm_add_ps (_mm_mul_ps (re, re), _mm_mul_ps (im, im));
+        _mm_storeu_ps (dest + i, _mm_mul_ps (_mm_sqrt_ps (sq), s));
+    }
+   #endif
+
+    for (; i < fftSizeHalved; ++i)
+        dest[i] = std::sqrt (realp[i] * realp[i] + imagp[i] * imagp[i]) * scale;
+
+    // DC and Nyquist are purely real and share the first slot of each half.
+    dest[0] = std::abs (realp[0]) * scale;
+    dest[fftSizeHalved] = std::abs (imagp[0]) * scale;
+}
+
+//==============================================================================
+/** Returns the index of the first occurence of the largest value in data. */
+inline int findPeakIndex (const float* data, const int num) noexcept
+{
+    if (num <= 0)
+        return 0;
+
+    int i = 0;
+    float peakValue = data[0];
+
+   #if HIRESAM_USE_SSE
+    if (num >= 8)
+    {
+        __m128 mx = _mm_loadu_ps (data);
+
+        for (i = 4; i + 4 <= num; i += 4)
+            mx = _mm_max_ps (mx, _mm_loadu_ps (data + i));
+
+        mx = _mm_max_ps (mx, _mm_shuffle_ps (mx, mx, _MM_SHUFFLE (2, 3, 0, 1)));
+        mx = _mm_max_ps (mx, _mm_shuffle_ps (mx, mx, _MM_SHUFFLE (1, 0, 3, 2)));
+        peakValue = _mm_cvtss_f32 (mx);
+
+        for (int j = i; j < num; ++j)
+            peakValue = jmax (peakValue, data[j]);
+
+        // Second pass only has to locate the first lane holding the maximum.
+        const __m128 target = _mm_set1_ps (peakValue);
+
+        for (i = 0; i + 4 <= num; i += 4)
+        {
+            const int mask = _mm_movemask_ps (_mm_cmpeq_ps (_mm_loadu_ps (data + i), target));
+
+            if (mask != 0)
+                return i + ((mask & 1) ? 0 : (mask & 2) ? 1 : (mask & 4) ? 2 : 3);
+        }
+
+        for (; i < num; ++i)
+            if (data[i] == peakValue)
+                return i;
+
+        return 0;
+    }
+   #endif
+
+    int peakIndex = 0;
+
+    for (i = 1; i < num; ++i)
+    {
+        if (data[i] > peakValue)
+        {
+            peakIndex = i;
+            peakValue = data[i];
+        }
+    }
+
+    return peakIndex;
+}
+
+//==============================================================================
+/** Writes max (dest[i], source (i * step)) for numValues destination bins,
+    linearly interpolating the source spectrum.
+
+    This is used to stretch the bins of a shorter FFT onto the bin grid of the
+    longest one. Reads never go past source[lastSourceBin].
+ */
+inline void maxWithStretchedSpectrum (float* dest, const float* source, const int lastSourceBin,
+                                      const int firstDestBin, const int numValues,
+                                      const float step) noexcept
+{
+    for (int i = 0; i < numValues; ++i)
+    {
+        const float position = (firstDestBin + i) * step;
+        const int index = jmin ((int) position, lastSourceBin - 1);
+        const float frac = jmin (position - index, 1.0f);
+        const float value = source[index] + frac * (source[index + 1] - source[index]);
+
+        dest[i] = jmax (dest[i], value);
+    }
+}
+
+} // namespace SpectrumKernels
+
+#endif  // SPECTRUM_KERNELS_H_INCLUDED
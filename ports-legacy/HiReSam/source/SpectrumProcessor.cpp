@@ -11,18 +11,48 @@
 */
 
 #include "SpectrumProcessor.h"
+#include "SpectrumKernels.h"
 
-SpectrumProcessor::SpectrumProcessor (int fftSizeLog2)
-  : fftEngine         {fftSizeLog2},
-    tempBlock         (fftEngine.getFFTSize()),
-// TODO: Make the circularBuffer dependant of the buffer size of the incoming audio stream.
-    circularBuffer    (jmax (fftEngine.getMagnitudesBuffer().getSize() * 4, 2048)),
-    needToProcess     {false},
+namespace
+{
+    /** Bin of its own FFT from which on a shorter resolution takes over from
+        the next longer one. 64 bins gives roughly one bin per 1/64 octave at
+        the crossover, which is plenty for the display.
+     */
+    const int defaultCrossoverBin = 64;
+}
+
+//==============================================================================
+SpectrumProcessor::Resolution::Resolution (int fftSizeLog2)
+  : fft                   (fftSizeLog2),
+    window                (1 << fftSizeLog2, drow::Window::Hann),
+    samplesSinceLastFrame {0}
+{
+    frame.malloc (1 << fftSizeLog2);
+    magnitudes.calloc ((1 << fftSizeLog2) / 2 + 1);
+}
+
+//==============================================================================
+SpectrumProcessor::SpectrumProcessor (int fftSizeLog2, int numResolutions, int overlap)
+  : longestFFTSize    {1 << fftSizeLog2},
+    crossoverBin      {defaultCrossoverBin},
+    historyPosition   {0},
+    circularBuffer    (jmax (1 << fftSizeLog2, 8192) * 2),
+    magnitudes        ((1 << fftSizeLog2) / 2 + 1),
+    sampleRate        {44100.0},
     detectedFrequency {var(0)},
     repaintViewer     (var(false))
 {
-    fftEngine.setWindowType (drow::Window::Hann);
+    // The shortest FFT must still have some bins above its crossover.
+    numResolutions = jlimit (1, jmax (1, fftSizeLog2 - 7), numResolutions);
     
+    for (int i = 0; i < numResolutions; ++i)
+        resolutions.add (new Resolution (fftSizeLog2 - i));
+
+    setOverlapFactor (overlap);
+
+    history.calloc (longestFFTSize * 2);
+    incoming.malloc (resolutions.getLast()->fft.getProperties().fftSize);
     circularBuffer.reset();
 }
 
@@ -35,19 +65,22 @@ void SpectrumProcessor::setSampleRate (double newSampleRate)
     sampleRate = newSampleRate;
 }
 
+void SpectrumProcessor::setOverlapFactor (int newOverlapFactor)
+{
+    overlapFactor.set (jlimit (1, 16, newOverlapFactor));
+}
+
 void SpectrumProcessor::copySamples (const float* samples, int numSamples)
 {
+    // If the analysis thread falls behind, the fifo drops what doesn't fit
+    // rather than blocking the audio thread.
 	circularBuffer.writeSamples (samples, numSamples);
-	needToProcess = true;
 }
 
 int SpectrumProcessor::useTimeSlice()
 {
-    if (needToProcess)
-    {
+    if (circularBuffer.getNumAvailable() > 0)
         process();
-        needToProcess = false;
-    }
     
     const int sleepTime = 5; // [ms]
     return sleepTime;
@@ -55,37 +88,83 @@ int SpectrumProcessor::useTimeSlice()
 
 void SpectrumProcessor::process()
 {
-    jassert (circularBuffer.getNumFree() != 0); // buffer is too small!
+    const Resolution& shortest = *resolutions.getLast();
+    const int overlap = overlapFactor.get();
+    const int chunkSize = jmax (1, shortest.fft.getProperties().fftSize / overlap);
+    bool hasNewFrame = false;
     
-    while (circularBuffer.getNumAvailable() > fftEngine.getFFTSize())
+    while (circularBuffer.getNumAvailable() >= chunkSize)
 	{
-		circularBuffer.readSamples (tempBlock.getData(), fftEngine.getFFTSize());
-		fftEngine.performFFT (tempBlock);
-		fftEngine.updateMagnitudesIfBigger();
+        circularBuffer.readSamples (incoming, chunkSize);
         
-        // find the peak in the FFT.
-        const int nrOfBins = fftEngine.getMagnitudesBuffer().getSize();
-        if (nrOfBins > 0)
+        // Every sample is written twice so the last longestFFTSize samples are
+        // always contiguous, starting at history + historyPosition.
+        for (int done = 0; done < chunkSize;)
         {
-            float* magnitudeBuffer = fftEngine.getMagnitudesBuffer().getData();
+            const int num = jmin (chunkSize - done, longestFFTSize - historyPosition);
+            memcpy (history + historyPosition, incoming + done, (size_t) num * sizeof (float));
+            memcpy (history + historyPosition + longestFFTSize, incoming + done, (size_t) num * sizeof (float));
             
-            int peakIndex = 0;
-            float peakValue = magnitudeBuffer[0];
-        
-            for (int i = 1; i < nrOfBins; ++i)
+            historyPosition = (historyPosition + num) % longestFFTSize;
+            done += num;
+        }
+		
+        for (int i = 0; i < resolutions.size(); ++i)
+        {
+            Resolution& res = *resolutions.getUnchecked (i);
+            const int hopSize = jmax (1, res.fft.getProperties().fftSize / overlap);
+
+            res.samplesSinceLastFrame += chunkSize;
+
+            if (res.samplesSinceLastFrame >= hopSize)
             {
-                if (magnitudeBuffer[i] > peakValue)
-                {
-                    peakIndex = i;
-                    peakValue = magnitudeBuffer[i];
-                }
+                res.samplesSinceLastFrame -= hopSize;
+                analyseResolution (i, history + historyPosition + longestFFTSize);
+                hasNewFrame = true;
             }
-            
-            detectedFrequency = (float)peakIndex / nrOfBins * sampleRate / 2;
         }
-		
-		repaintViewer = true;
 	}
+
+    if (hasNewFrame)
+    {
+        // find the peak in the combined spectrum.
+        const int nrOfBins = magnitudes.getSize();
+        const int peakIndex = SpectrumKernels::findPeakIndex (magnitudes.getData(), nrOfBins);
+
+        detectedFrequency = (float)peakIndex / nrOfBins * sampleRate / 2;
+
+        magnitudes.updateListeners();
+		repaintViewer = true;
+    }
+}
+
+void SpectrumProcessor::analyseResolution (const int index, const float* lastSamples)
+{
+    Resolution& res = *resolutions.getUnchecked (index);
+    const drow::FFT::Properties properties (res.fft.getProperties());
+
+    memcpy (res.frame, lastSamples - properties.fftSize, (size_t) properties.fftSize * sizeof (float));
+    res.window.applyWindow (res.frame, properties.fftSize);
+    res.fft.performFFT (res.frame);
+
+    const drow::SplitComplex& fftSplit = res.fft.getFFTBuffer();
+    SpectrumKernels::calculateMagnitudes (res.magnitudes, fftSplit.realp, fftSplit.imagp,
+                                          properties.fftSizeHalved,
+                                          (float) properties.oneOverFFTSize * res.window.getOneOverWindowFactor());
+
+    // Each resolution owns one octave of the display, the shortest one
+    // everything above. Shorter FFTs get stretched onto the longest bin grid.
+    const int lastIndex = resolutions.size() - 1;
+    const int firstBin = index == 0 ? 0 : crossoverBin << index;
+    const int endBin = index == lastIndex ? magnitudes.getSize() : crossoverBin << (index + 1);
+    float* const displayData = magnitudes.getData();
+
+    if (index == 0)
+        FloatVectorOperations::max (displayData, displayData, res.magnitudes, endBin);
+    else
+        SpectrumKernels::maxWithStretchedSpectrum (displayData + firstBin, res.magnitudes,
+                                                   properties.fftSizeHalved, firstBin,
+                                                   endBin - firstBin, 1.0f / (1 << index));
 }
 
 Value& SpectrumProcessor::getRepaintViewerValue()
@@ -96,7 +175,7 @@ Value& SpectrumProcessor::getRepaintViewerValue()
 
 drow::Buffer& SpectrumProcessor::getMagnitudesBuffer()
 {
-    return fftEngine.getMagnitudesBuffer();
+    return magnitudes;
 }
 
 Value& SpectrumProcessor::getDetectedFrequency()
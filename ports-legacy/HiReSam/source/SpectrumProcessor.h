@@ -24,6 +24,12 @@
     Register it with a TimeSliceThread, make sure its running and then continually
     call the copySamples() method. The FFT itself will be performed on a background
     thread.
+
+    Several FFT sizes are run side by side on the same signal: the longest one
+    is used for the lowest frequencies and every halving of the FFT size takes
+    over the next octave band, so that the highs react quickly while the lows
+    keep their resolution. All of them are combined into one magnitude buffer
+    on the bin grid of the longest FFT.
  */
 class SpectrumProcessor : public TimeSliceClient
 {
@@ -31,19 +37,26 @@ public:
     //==============================================================================
     /** Creates a spectroscope with a given FFT size.
         Note that the fft size given here is log2 of the FFT size so for example,
-        a 1024 size fft use 10.
+        a 1024 size fft use 10. This is the size of the longest FFT, each further
+        resolution uses half the size of the previous one.
      */
-	SpectrumProcessor (int fftSizeLog2);
+	SpectrumProcessor (int fftSizeLog2, int numResolutions = 1, int overlapFactor = 1);
     
     /** Destructor. */
     ~SpectrumProcessor();
     
     void setSampleRate (double sampleRate);
     
+    /** Sets how many FFT frames overlap each other, e.g. 4 means a new frame
+        is analysed every quarter of the FFT size.
+        This is safe to call from any thread.
+     */
+    void setOverlapFactor (int newOverlapFactor);
+
 	/** Copy a set of samples, ready to be processed.
         Your audio callback should continually call this method to pass it its
-        audio data. When the scope has enough samples to perform an fft it will do
-        so on a background thread.
+        audio data. This only writes to a lock-free fifo, the analysis itself
+        is done on a background thread.
      */
 	void copySamples (const float* samples, int numSamples);
     
@@ -59,10 +72,31 @@ public:
     drow::Buffer& getMagnitudesBuffer();
     
 private:
-    drow::FFTEngine fftEngine;
-	HeapBlock<float> tempBlock;
+    //==============================================================================
+    struct Resolution
+    {
+        Resolution (int fftSizeLog2);
+
+        drow::FFT fft;
+        drow::Window window;
+        HeapBlock<float> frame;
+        HeapBlock<float> magnitudes;
+        int samplesSinceLastFrame;
+    };
+
+    void analyseResolution (int index, const float* lastSamples);
+
+    OwnedArray<Resolution> resolutions;
+    const int longestFFTSize;
+    const int crossoverBin;
+
+    HeapBlock<float> history, incoming;
+    int historyPosition;
+
     drow::FifoBuffer<float> circularBuffer;
-	bool needToProcess;
+    Atomic<int> overlapFactor;
+
+    drow::Buffer magnitudes;
     
     double sampleRate;
     Value detectedFrequency;
@@ -33,6 +33,8 @@ SpectrumViewer::SpectrumViewer (Value& repaintViewerValue,
     frequencyToDisplay        {var(0)},
     mouseMode                 {false},
     mouseXPosition            {0},
+    numBinPositions           {0},
+    binPositionsWidth         {0},
     heightForFrequencyCaption {20},
     gradientImage             (Image::RGB, 100, 100, false)
 {
@@ -124,14 +126,27 @@ void SpectrumViewer::paint(Graphics& g)
     jassert (x == x && y == y);
     spectrumPath.startNewSubPath(x, y);
     
+    updateBinPositions (numBins, w);
+    
+    // With the multi-resolution analysis there are many more bins than pixels
+    // in the upper octaves, so only the loudest bin of each pixel column is
+    // added to the path.
+    float columnMaximum = 0.0f;
+    
     for (int i = 1; i < numBins; ++i)
     {
-        x = logTransformInRange0to1 ((float)i / numBins) * w;
+        x = binXPositions[i];
+        columnMaximum = jmax (columnMaximum, data[i]);
+        
+        if (i < numBins - 1 && (int) binXPositions[i + 1] == (int) x)
+            continue;
+        
         // Only values > 0 are passed to drow::toDecibels().
-        const float yInPercent = data[i]>0 ? float (1 + (drow::toDecibels (data[i]) / 100.0f)) : -0.01;
+        const float yInPercent = columnMaximum>0 ? float (1 + (drow::toDecibels (columnMaximum) / 100.0f)) : -0.01;
         y = h - h * yInPercent;
         
         spectrumPath.lineTo(x, y);
+        columnMaximum = 0.0f;
     }
     
     g.setColour (Colours::green);
@@ -214,8 +229,23 @@ void SpectrumViewer::timerCallback()
     const int magnitudeBufferSize = fftMagnitudeBuffer.getSize();
 	float* magnitudeBuffer = fftMagnitudeBuffer.getData();
     
-	for (int i = 0; i < magnitudeBufferSize; i++)
-		magnitudeBuffer[i] *= JUCE_LIVE_CONSTANT (0.707f);
+	FloatVectorOperations::multiply (magnitudeBuffer, JUCE_LIVE_CONSTANT (0.707f), magnitudeBufferSize);
+}
+
+
+void SpectrumViewer::updateBinPositions (const int numBins, const int width)
+{
+    // The log transform is far too expensive to do for every bin on every repaint.
+    if (numBins == numBinPositions && width == binPositionsWidth)
+        return;
+    
+    binXPositions.malloc (numBins);
+    
+    for (int i = 0; i < numBins; ++i)
+        binXPositions[i] = logTransformInRange0to1 ((float)i / numBins) * width;
+    
+    numBinPositions = numBins;
+    binPositionsWidth = width;
 }
 
 
@@ -68,6 +68,8 @@ private:
     //==============================================================================
     void createGradientImage();
     
+    void updateBinPositions (int numBins, int width);
+    
     Path get571RecordingStudioPath();
     
     static const int frequenciesToPlot[];
@@ -82,6 +84,10 @@ private:
     bool mouseMode;
     int mouseXPosition;
     
+    HeapBlock<float> binXPositions;
+    int numBinPositions;
+    int binPositionsWidth;
+    
     //==============================================================================
     /*  The numbers below the graph, indication the frequency.
      */
@@ -28,7 +28,9 @@
 
 
 #include "LUFSMeterAudioProcessor.h"
+#if ! JUCE_AUDIOPROCESSOR_NO_GUI
 #include "LUFSMeterAudioProcessorEditor.h"
+#endif
 
 AudioProcessor* JUCE_CALLTYPE createPluginFilter();
 
@@ -217,6 +219,7 @@ void LUFSMeterAudioProcessor::processBlock (AudioSampleBuffer& buffer, MidiBuffe
 }
 
 //==============================================================================
+#if ! JUCE_AUDIOPROCESSOR_NO_GUI
 bool LUFSMeterAudioProcessor::hasEditor() const
 {
     return true; // (change this to false if you choose to not supply an editor)
@@ -226,6 +229,7 @@ AudioProcessorEditor* LUFSMeterAudioProcessor::createEditor()
 {
     return new LUFSMeterAudioProcessorEditor (this);
 }
+#endif
 
 //==============================================================================
 void LUFSMeterAudioProcessor::getStateInformation (MemoryBlock& destData)
@@ -57,8 +57,10 @@ public:
     void processBlock (AudioSampleBuffer& buffer, MidiBuffer& midiMessages);
 
     //==============================================================================
+#if ! JUCE_AUDIOPROCESSOR_NO_GUI
     AudioProcessorEditor* createEditor();
     bool hasEditor() const;
+#endif
 
     //==============================================================================
     const String getName() const;
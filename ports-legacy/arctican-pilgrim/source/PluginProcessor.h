@@ -15,6 +15,7 @@
 #include "JucePluginCharacteristics.h"
 
 #include "PluginParameter.h"
+#include "JucePluginFilters.h"
 
 //==============================================================================
 /**
@@ -81,10 +82,9 @@ public:
     PluginParameter filterParameter;
     PluginParameter mixParameter;
 
-    IIRFilterOld highFilterL;
-    IIRFilterOld highFilterR;
-    IIRFilterOld lowFilterL;
-    IIRFilterOld lowFilterR;
+    // Both channels, one in each lane
+    JucePluginSvf highFilter;
+    JucePluginSvf lowFilter;
 
     double globalSampleRate;
 
@@ -95,8 +95,6 @@ public:
         totalNumParams
     };
 
-    AudioSampleBuffer dryBuffer;
-
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ThePilgrimAudioProcessor);
 };
 
@@ -155,7 +155,7 @@ DXLookNFeel::DXLookNFeel() {
 }
 
 Typeface::Ptr DXLookNFeel::getTypefaceForFont(const Font &) {
-    return Typeface::createSystemTypefaceFor(BinaryData::NotoSansRegular_ttf, BinaryData::NotoSansRegular_ttfSize);
+    return resources->getTypeface(BinaryData::NotoSansRegular_ttf, BinaryData::NotoSansRegular_ttfSize);
 }
 
 void DXLookNFeel::drawRotarySlider( Graphics &g, int x, int y, int width, int height, float sliderPosProportional,
@@ -22,9 +22,11 @@
 #define DXLOOKNFEEL_H_INCLUDED
 
 #include "JuceHeader.h"
+#include "JucePluginResourceCache.h"
 
 class DXLookNFeel : public LookAndFeel_V3 {
     HashMap<String, int> colourMap;
+    SharedResourcePointer<JucePluginResourceCache> resources;
 
 public:
     DXLookNFeel();
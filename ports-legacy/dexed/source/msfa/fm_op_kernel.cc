@@ -26,6 +26,8 @@
 #include "sin.h"
 #include "fm_op_kernel.h"
 
+#include "JucePluginCpuDispatch.h"
+
 #ifdef HAVE_NEONx
 static bool hasNeon() {
   return true;
@@ -44,6 +46,7 @@ static bool hasNeon() {
 }
 #endif
 
+JUCE_PLUGIN_CPU_DISPATCH_CLONES
 void FmOpKernel::compute(int32_t *output, const int32_t *input,
                          int32_t phase0, int32_t freq,
                          int32_t gain1, int32_t gain2, bool add) {
@@ -76,6 +79,7 @@ void FmOpKernel::compute(int32_t *output, const int32_t *input,
   }
 }
 
+JUCE_PLUGIN_CPU_DISPATCH_CLONES
 void FmOpKernel::compute_pure(int32_t *output, int32_t phase0, int32_t freq,
                               int32_t gain1, int32_t gain2, bool add) {
   int32_t dgain = (gain2 - gain1 + (N >> 1)) >> LG_N;
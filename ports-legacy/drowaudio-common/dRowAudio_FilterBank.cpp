@@ -0,0 +1,371 @@
+/*
+ *  dRowAudio_FilterBank.cpp
+ *
+ *  Banks of the LBCF and AllpassFilter, processed side by side.
+ *
+ */
+
+#include "dRowAudio_FilterBank.h"
+
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+ #include <emmintrin.h>
+ #define DROWAUDIO_FILTERBANK_USE_SSE 1
+#else
+ #define DROWAUDIO_FILTERBANK_USE_SSE 0
+#endif
+
+// lanes are padded to whole SIMD registers
+static int getNumLanes(int numFilters)
+{
+	return (numFilters + 3) & ~3;
+}
+
+//==============================================================================
+LBCFBank::LBCFBank(int numFilters_) throw()
+	:	numFilters(numFilters_),
+		numLanes(getNumLanes(numFilters_)),
+		bufferWritePos(0)
+{
+	delayRegister = new float[registerSize * numLanes];
+	// zero register
+	for (int i = 0; i < registerSize * numLanes; i++)
+		delayRegister[i] = 0;
+
+	channels = new int[numLanes];
+	pendingFBCoeffs = new std::atomic<float>[numLanes];
+	pendingLowpassCoeffs = new std::atomic<float>[numLanes];
+	pendingDelaySamples = new std::atomic<int>[numLanes];
+	lastCutoffs = new float[numLanes];
+	lastSampleRates = new double[numLanes];
+
+	fbCoeffs = new float[numLanes];
+	b0s = new float[numLanes];
+	a1s = new float[numLanes];
+	y1s = new float[numLanes];
+	delaySamples = new int[numLanes];
+	sources = new const float*[numLanes];
+
+	for (int i = 0; i < numLanes; i++)
+	{
+		channels[i] = 0;
+
+		// the padding lanes have no feedback, they stay silent
+		pendingFBCoeffs[i].store(i < numFilters ? 0.5f : 0.0f);
+		pendingLowpassCoeffs[i].store(0.0f);
+		pendingDelaySamples[i].store(0);
+		lastCutoffs[i] = -1.0f;
+		lastSampleRates[i] = 0.0;
+
+		y1s[i] = 0.0f;
+	}
+}
+
+LBCFBank::~LBCFBank() throw()
+{
+	delete[] delayRegister;
+
+	delete[] channels;
+	delete[] pendingFBCoeffs;
+	delete[] pendingLowpassCoeffs;
+	delete[] pendingDelaySamples;
+	delete[] lastCutoffs;
+	delete[] lastSampleRates;
+
+	delete[] fbCoeffs;
+	delete[] b0s;
+	delete[] a1s;
+	delete[] y1s;
+	delete[] delaySamples;
+	delete[] sources;
+}
+
+void LBCFBank::setChannel(int filterIndex, int channel) throw()
+{
+	jassert(filterIndex >= 0 && filterIndex < numFilters);
+
+	channels[filterIndex] = channel;
+}
+
+void LBCFBank::setFBCoeff(int filterIndex, float newFBCoeff) throw()
+{
+	jassert(filterIndex >= 0 && filterIndex < numFilters);
+
+	pendingFBCoeffs[filterIndex].store(newFBCoeff, std::memory_order_relaxed);
+}
+
+void LBCFBank::setDelayTime(int filterIndex, double sampleRate, float newDelayTime) throw()
+{
+	jassert(filterIndex >= 0 && filterIndex < numFilters);
+
+	int newDelaySamples = (int)(newDelayTime * (sampleRate * 0.001));
+
+	if (newDelaySamples >= registerSize)
+		newDelaySamples = registerSize;
+
+	pendingDelaySamples[filterIndex].store(newDelaySamples, std::memory_order_relaxed);
+}
+
+void LBCFBank::setLowpassCutoff(int filterIndex, double sampleRate, float cutoffFrequency) throw()
+{
+	jassert(filterIndex >= 0 && filterIndex < numFilters);
+
+	if (cutoffFrequency == lastCutoffs[filterIndex] && sampleRate == lastSampleRates[filterIndex])
+		return;
+
+	lastCutoffs[filterIndex] = cutoffFrequency;
+	lastSampleRates[filterIndex] = sampleRate;
+
+	// same as OnePoleFilter::makeLowPass(), which sets b0 to 1 - a1
+	const double w0 = 2.0 * double_Pi * (cutoffFrequency / sampleRate);
+	const double cos_w0 = cos (w0);
+
+	const double alpha = (2.0f - cos_w0) - sqrt ((2.0 - cos_w0) * (2.0 - cos_w0) - 1.0);
+
+	pendingLowpassCoeffs[filterIndex].store((float) alpha, std::memory_order_relaxed);
+}
+
+void LBCFBank::processSamplesAdding (const float* const* sourceSamples, float* const* destSamples,
+									 const int numSamples) throw()
+{
+	for (int l = 0; l < numLanes; l++)
+	{
+		fbCoeffs[l] = pendingFBCoeffs[l].load(std::memory_order_relaxed);
+		a1s[l] = pendingLowpassCoeffs[l].load(std::memory_order_relaxed);
+		b0s[l] = 1.0f - a1s[l];
+		delaySamples[l] = pendingDelaySamples[l].load(std::memory_order_relaxed);
+		sources[l] = sourceSamples[channels[l]];
+	}
+
+	// Four filters at a time over the whole block, each group adds to the
+	// channels after the previous one, in the same order as separate LBCFs
+	for (int l = 0; l < numLanes; l += 4)
+	{
+		float* const lane0 = delayRegister + l * registerSize;
+		float* const lane1 = lane0 + registerSize;
+		float* const lane2 = lane1 + registerSize;
+		float* const lane3 = lane2 + registerSize;
+
+		const float* const source0 = sources[l];
+		const float* const source1 = sources[l + 1];
+		const float* const source2 = sources[l + 2];
+		const float* const source3 = sources[l + 3];
+
+		const int numAdding = jmin(4, numFilters - l);
+		float* const dest0 = destSamples[channels[l]];
+		float* const dest1 = numAdding > 1 ? destSamples[channels[l + 1]] : 0;
+		float* const dest2 = numAdding > 2 ? destSamples[channels[l + 2]] : 0;
+		float* const dest3 = numAdding > 3 ? destSamples[channels[l + 3]] : 0;
+
+		int writePos = bufferWritePos;
+
+#if DROWAUDIO_FILTERBANK_USE_SSE
+		const __m128 fbCoeff = _mm_loadu_ps(fbCoeffs + l);
+		const __m128 b0 = _mm_loadu_ps(b0s + l);
+		const __m128 a1 = _mm_loadu_ps(a1s + l);
+		__m128 y1 = _mm_loadu_ps(y1s + l);
+
+		for (int i = 0; i < numSamples; ++i)
+		{
+			writePos = (writePos+1) & registerSizeMask;
+
+			// the read positions wrap like in LBCF, the delay is at most registerSize
+			__m128 fDel = _mm_setr_ps(lane0[(writePos - delaySamples[l]) & registerSizeMask],
+									  lane1[(writePos - delaySamples[l + 1]) & registerSizeMask],
+									  lane2[(writePos - delaySamples[l + 2]) & registerSizeMask],
+									  lane3[(writePos - delaySamples[l + 3]) & registerSizeMask]);
+			__m128 fIn = _mm_setr_ps(source0[i], source1[i], source2[i], source3[i]);
+			__m128 fOut = _mm_add_ps(fIn, fDel);
+
+			// feedback and lowpass
+			y1 = _mm_add_ps(_mm_mul_ps(b0, _mm_mul_ps(fbCoeff, fOut)), _mm_mul_ps(a1, y1));
+
+			float y[4], out[4];
+			_mm_storeu_ps(y, y1);
+			_mm_storeu_ps(out, fOut);
+
+			lane0[writePos] = y[0];
+			lane1[writePos] = y[1];
+			lane2[writePos] = y[2];
+			lane3[writePos] = y[3];
+
+			dest0[i] += out[0];
+			if (numAdding > 1) dest1[i] += out[1];
+			if (numAdding > 2) dest2[i] += out[2];
+			if (numAdding > 3) dest3[i] += out[3];
+		}
+
+		_mm_storeu_ps(y1s + l, y1);
+#else
+		float* const lanes[4] = { lane0, lane1, lane2, lane3 };
+		const float* const laneSources[4] = { source0, source1, source2, source3 };
+		float* const dests[4] = { dest0, dest1, dest2, dest3 };
+
+		for (int i = 0; i < numSamples; ++i)
+		{
+			writePos = (writePos+1) & registerSizeMask;
+
+			for (int k = 0; k < 4; k++)
+			{
+				float fOut = laneSources[k][i] + lanes[k][(writePos - delaySamples[l + k]) & registerSizeMask];
+
+				// feedback and lowpass
+				y1s[l + k] = (b0s[l + k] * (fbCoeffs[l + k] * fOut)) + (a1s[l + k] * y1s[l + k]);
+				lanes[k][writePos] = y1s[l + k];
+
+				if (k < numAdding)
+					dests[k][i] += fOut;
+			}
+		}
+#endif
+	}
+
+	bufferWritePos = (bufferWritePos + numSamples) & registerSizeMask;
+}
+
+//==============================================================================
+AllpassFilterBank::AllpassFilterBank(int numChannels_, int numStages_) throw()
+	:	numChannels(numChannels_),
+		numStages(numStages_),
+		numLanes(getNumLanes(numChannels_)),
+		bufferWritePos(0)
+{
+	const int registerLength = numStages * registerSize * numLanes;
+
+	delayRegister = new float[registerLength];
+	// zero register
+	for (int i = 0; i < registerLength; i++)
+		delayRegister[i] = 0;
+
+	pendingGains = new std::atomic<float>[numStages * numLanes];
+	pendingDelaySamples = new std::atomic<int>[numStages * numLanes];
+
+	gains = new float[numStages * numLanes];
+	delaySamples = new int[numStages * numLanes];
+
+	for (int i = 0; i < numStages * numLanes; i++)
+	{
+		pendingGains[i].store(0.1f);
+		pendingDelaySamples[i].store(0);
+	}
+}
+
+AllpassFilterBank::~AllpassFilterBank() throw()
+{
+	delete[] delayRegister;
+
+	delete[] pendingGains;
+	delete[] pendingDelaySamples;
+
+	delete[] gains;
+	delete[] delaySamples;
+}
+
+void AllpassFilterBank::setGain(int channel, int stage, float newGain) throw()
+{
+	jassert(channel >= 0 && channel < numChannels && stage >= 0 && stage < numStages);
+
+	pendingGains[stage * numLanes + channel].store(newGain, std::memory_order_relaxed);
+}
+
+void AllpassFilterBank::setDelayTime(int channel, int stage, double sampleRate, float newDelayTime) throw()
+{
+	jassert(channel >= 0 && channel < numChannels && stage >= 0 && stage < numStages);
+
+	int newDelaySamples = (int)(newDelayTime * (sampleRate * 0.001));
+
+	if (newDelaySamples >= registerSize)
+	{
+		jassert(newDelaySamples < registerSize);
+		newDelaySamples = registerSize;
+	}
+
+	pendingDelaySamples[stage * numLanes + channel].store(newDelaySamples, std::memory_order_relaxed);
+}
+
+void AllpassFilterBank::processSamples (float* const* samples,
+										const int numSamples) throw()
+{
+	for (int i = 0; i < numStages * numLanes; i++)
+	{
+		gains[i] = pendingGains[i].load(std::memory_order_relaxed);
+		delaySamples[i] = pendingDelaySamples[i].load(std::memory_order_relaxed);
+	}
+
+	// the stages are in series, each one takes the whole block before the next
+	for (int s = 0; s < numStages; ++s)
+	{
+		float* const stageRegister = delayRegister + s * registerSize * numLanes;
+		const float* const stageGains = gains + s * numLanes;
+		const int* const stageDelaySamples = delaySamples + s * numLanes;
+
+		// four channels at a time, the padding lanes are fed silence
+		for (int c = 0; c < numChannels; c += 4)
+		{
+			float* const lane0 = stageRegister + c * registerSize;
+			float* const lane1 = lane0 + registerSize;
+			float* const lane2 = lane1 + registerSize;
+			float* const lane3 = lane2 + registerSize;
+
+			const int numActive = jmin(4, numChannels - c);
+			float* const channel0 = samples[c];
+			float* const channel1 = numActive > 1 ? samples[c + 1] : 0;
+			float* const channel2 = numActive > 2 ? samples[c + 2] : 0;
+			float* const channel3 = numActive > 3 ? samples[c + 3] : 0;
+
+			int writePos = bufferWritePos;
+
+#if DROWAUDIO_FILTERBANK_USE_SSE
+			const __m128 gain = _mm_loadu_ps(stageGains + c);
+
+			for (int i = 0; i < numSamples; ++i)
+			{
+				writePos = (writePos+1) & registerSizeMask;
+
+				__m128 fDel = _mm_setr_ps(lane0[(writePos - stageDelaySamples[c]) & registerSizeMask],
+										  lane1[(writePos - stageDelaySamples[c + 1]) & registerSizeMask],
+										  lane2[(writePos - stageDelaySamples[c + 2]) & registerSizeMask],
+										  lane3[(writePos - stageDelaySamples[c + 3]) & registerSizeMask]);
+				__m128 fIn = _mm_setr_ps(channel0[i],
+										 numActive > 1 ? channel1[i] : 0.0f,
+										 numActive > 2 ? channel2[i] : 0.0f,
+										 numActive > 3 ? channel3[i] : 0.0f);
+				fIn = _mm_add_ps(_mm_mul_ps(gain, fDel), fIn);
+
+				float in[4], out[4];
+				_mm_storeu_ps(in, fIn);
+				_mm_storeu_ps(out, _mm_sub_ps(fDel, _mm_mul_ps(gain, fIn)));
+
+				lane0[writePos] = in[0];
+				lane1[writePos] = in[1];
+				lane2[writePos] = in[2];
+				lane3[writePos] = in[3];
+
+				channel0[i] = out[0];
+				if (numActive > 1) channel1[i] = out[1];
+				if (numActive > 2) channel2[i] = out[2];
+				if (numActive > 3) channel3[i] = out[3];
+			}
+#else
+			float* const lanes[4] = { lane0, lane1, lane2, lane3 };
+			float* const channels[4] = { channel0, channel1, channel2, channel3 };
+
+			for (int i = 0; i < numSamples; ++i)
+			{
+				writePos = (writePos+1) & registerSizeMask;
+
+				for (int k = 0; k < numActive; k++)
+				{
+					float* const line = lanes[k];
+					const float gain = stageGains[c + k];
+					const float fDel = line[(writePos - stageDelaySamples[c + k]) & registerSizeMask];
+
+					line[writePos] = (gain * fDel) + channels[k][i];
+					channels[k][i] = fDel - (gain * line[writePos]);
+				}
+			}
+#endif
+		}
+	}
+
+	bufferWritePos = (bufferWritePos + numSamples) & registerSizeMask;
+}
@@ -0,0 +1,136 @@
+/*
+ *  dRowAudio_FilterBank.h
+ *
+ *  Banks of the LBCF and AllpassFilter, processed side by side.
+ *
+ */
+
+#ifndef _DROWAUDIO_FILTERBANK_H_
+#define _DROWAUDIO_FILTERBANK_H_
+
+#include "includes.h"
+
+#include <atomic>
+
+/**
+	A bank of Lowpassed Feedback Comb Filters.
+
+	Every filter of the bank works exactly like an LBCF, reading from and
+	adding to one of the channels given to processSamplesAdding(). The delay
+	registers of all filters share one block of memory, and the filters are
+	updated four at a time in SIMD lanes.
+
+	The set methods only store the new values, the processing picks them up
+	at the start of its next block. They can be called from a thread other
+	than the processing one, but only from one thread at a time.
+ */
+class LBCFBank
+{
+public:
+
+	/** Creates a bank of filters, all of them reading from and adding to channel 0.
+	 */
+	LBCFBank(int numFilters) throw();
+
+	/// Destructor
+	~LBCFBank() throw();
+
+	/// Returns the number of filters in the bank.
+	int getNumFilters() const throw()	{	return numFilters;	}
+
+	/** Sets the channel a filter reads from and adds to.
+		Call this before the processing starts.
+	 */
+	void setChannel(int filterIndex, int channel) throw();
+
+	/// Sets the feedback coefficient of a filter, see LBCF::setFBCoeff().
+	void setFBCoeff(int filterIndex, float newFBCoeff) throw();
+
+	///	Sets the time in ms the samples of a filter are delayed for, see LBCF::setDelayTime().
+	void setDelayTime(int filterIndex, double sampleRate, float newDelayTime) throw();
+
+	/// Sets the cutoff frequency of a filter's lowpass, see LBCF::setLowpassCutoff().
+	void setLowpassCutoff(int filterIndex, double sampleRate, float cutoffFrequency) throw();
+
+	/** Processes numSamples of every filter.
+		Each filter reads sourceSamples[channel] and adds its output to destSamples[channel].
+	 */
+	void processSamplesAdding (const float* const* sourceSamples, float* const* destSamples,
+							   const int numSamples) throw();
+
+private:
+
+	enum { registerSize = 4096, registerSizeMask = registerSize - 1 };
+
+	int numFilters, numLanes;
+
+	// one line of registerSize samples per lane
+	float* delayRegister;
+	int bufferWritePos;
+
+	int* channels;
+	std::atomic<float>* pendingFBCoeffs;
+	std::atomic<float>* pendingLowpassCoeffs;
+	std::atomic<int>* pendingDelaySamples;
+	float* lastCutoffs;
+	double* lastSampleRates;
+
+	// per lane, used by the processing only
+	float *fbCoeffs, *b0s, *a1s, *y1s;
+	int* delaySamples;
+	const float** sources;
+
+	JUCE_LEAK_DETECTOR (LBCFBank);
+};
+
+/**
+	A bank of Allpass Comb Filters in series, for several channels at once.
+
+	Every channel runs through numStages filters one after the other, each of
+	them working exactly like an AllpassFilter. The channels of a stage are
+	updated together in SIMD lanes, from one block of delay memory.
+
+	The set methods follow the same rules as the ones of LBCFBank.
+ */
+class AllpassFilterBank
+{
+public:
+
+	/** Creates numStages filters in series for each of numChannels channels.
+	 */
+	AllpassFilterBank(int numChannels, int numStages) throw();
+
+	/// Destructor
+	~AllpassFilterBank() throw();
+
+	/// Sets the gain of one filter, see AllpassFilter::setGain().
+	void setGain(int channel, int stage, float newGain) throw();
+
+	///	Sets the time in ms the samples of one filter are delayed for.
+	void setDelayTime(int channel, int stage, double sampleRate, float newDelayTime) throw();
+
+	/// Processes numSamples of every channel, which are modified.
+	void processSamples (float* const* samples,
+						 const int numSamples) throw();
+
+private:
+
+	enum { registerSize = 4096, registerSizeMask = registerSize - 1 };
+
+	int numChannels, numStages, numLanes;
+
+	// for every stage, one line of registerSize samples per lane
+	float* delayRegister;
+	int bufferWritePos;
+
+	std::atomic<float>* pendingGains;
+	std::atomic<int>* pendingDelaySamples;
+
+	// per stage and lane, used by the processing only
+	float* gains;
+	int* delaySamples;
+
+	JUCE_LEAK_DETECTOR (AllpassFilterBank);
+};
+
+#endif //_DROWAUDIO_FILTERBANK_H_
@@ -30,6 +30,21 @@ void TappedDelayLine::initialiseBuffer(int bufferSize_)
 	feedbackGain = 0.99f;
 	spacingCoefficient = 1.0f;
 	feedbackCoefficient = 1.0f;
+	pendingSpacingCoefficient.store(1.0f);
+	pendingFeedbackCoefficient.store(1.0f);
+	spacingForced.store(false);
+	
+	// enough room that adding taps from the audio thread doesn't allocate
+	taps.ensureStorageAllocated(16);
+	tapBuffers[0].ensureStorageAllocated(16);
+	tapBuffers[1].ensureStorageAllocated(16);
+	activeTaps.store(&tapBuffers[0]);
+	readingTaps.store(false);
+	blocksProcessed.store(0);
+	tapsVersion = 1;
+	tapBufferVersions[0] = 1;
+	tapBufferVersions[1] = 0;
+	processedVersion = 0;
 	
 	delete[] pfDelayBuffer;
 	
@@ -40,7 +55,6 @@ void TappedDelayLine::initialiseBuffer(int bufferSize_)
 
 TappedDelayLine::~TappedDelayLine()
 {
-	readTaps.clear();
 	delete[] pfDelayBuffer;
 	pfDelayBuffer = 0;
 }
@@ -49,19 +63,21 @@ void TappedDelayLine::addTap(int noDelaySamples, int sampleRate)
 {
 	jassert(noDelaySamples < bufferSize);
 	
+	const ScopedLock sl (tapLock);
+	
 	Tap newTap;
 	newTap.originalDelaySamples = noDelaySamples;
 	newTap.delaySamples = newTap.originalDelaySamples;
 	
-	newTap.originalTapFeedback = feedbackCoefficient;
+	newTap.originalTapFeedback = pendingFeedbackCoefficient.load(std::memory_order_relaxed);
 	newTap.tapFeedback = newTap.originalTapFeedback;
 	
 	newTap.sampleRateWhenCreated = sampleRate;
 	newTap.tapGain = 0.15f;
 	
-	readTaps.add(newTap);
+	taps.add(newTap);
 	
-	noTaps = readTaps.size();	
+	publishTaps();
 }
 
 void TappedDelayLine::addTapAtTime(int newTapPosMs, double sampleRate)
@@ -78,10 +94,14 @@ bool TappedDelayLine::setTapDelayTime(int tapIndex, int newTapPosMs, double samp
 
 bool TappedDelayLine::setTapDelaySamples(int tapIndex, int newDelaySamples)
 {
-	if ( tapIndex < readTaps.size() )
+	const ScopedLock sl (tapLock);
+	
+	if ( isPositiveAndBelow(tapIndex, taps.size()) )
 	{
-		readTaps.getReference(tapIndex).delaySamples = newDelaySamples;
+		taps.getReference(tapIndex).originalDelaySamples = newDelaySamples;
+		taps.getReference(tapIndex).delaySamples = newDelaySamples;
 		
+		publishTaps();
 		return true;
 	}
 	return false;
@@ -89,34 +109,68 @@ bool TappedDelayLine::setTapDelaySamples(int tapIndex, int newDelaySamples)
 
 void TappedDelayLine::setTapSpacing(float newSpacingCoefficient)
 {
-	if ( !almostEqual<float>(spacingCoefficient, newSpacingCoefficient) )
-	{
-		spacingCoefficient = fabsf(newSpacingCoefficient);
-
-		for (int i = 0; i < readTaps.size(); i++)
-		{
-			int newDelaySamples = (readTaps[i].originalDelaySamples * spacingCoefficient);
-			jlimit(0, bufferSize, newDelaySamples);
-			readTaps.getReference(i).delaySamples = newDelaySamples;
-		}
-	}
+	if ( !almostEqual<float>(pendingSpacingCoefficient.load(std::memory_order_relaxed), newSpacingCoefficient) )
+		pendingSpacingCoefficient.store(fabsf(newSpacingCoefficient), std::memory_order_relaxed);
 }
 
 void TappedDelayLine::setTapSpacingExplicitly(float newSpacingCoefficient)
 {
-	spacingCoefficient = fabsf(newSpacingCoefficient);
-	
-	for (int i = 0; i < readTaps.size(); i++)
-	{
-		int newDelaySamples = (readTaps[i].originalDelaySamples * spacingCoefficient);
-		jlimit(0, bufferSize, newDelaySamples);
-		readTaps.getReference(i).delaySamples = newDelaySamples;
-	}
+	pendingSpacingCoefficient.store(fabsf(newSpacingCoefficient), std::memory_order_relaxed);
+	spacingForced.store(true, std::memory_order_release);
 }
 
 void TappedDelayLine::scaleFeedbacks(float newFeedbackCoefficient)
 {
-	if ( !almostEqual<float>(feedbackCoefficient, newFeedbackCoefficient) )
+	if ( !almostEqual<float>(pendingFeedbackCoefficient.load(std::memory_order_relaxed), newFeedbackCoefficient) )
+		pendingFeedbackCoefficient.store(newFeedbackCoefficient, std::memory_order_relaxed);
+}
+
+void TappedDelayLine::publishTaps()
+{
+	Array<Tap>* const current = activeTaps.load();
+	Array<Tap>* const next = (current == &tapBuffers[0]) ? &tapBuffers[1] : &tapBuffers[0];
+	
+	// the last publish waited until the processing let go of next
+	next->clearQuick();
+	next->addArray(taps);
+	tapBufferVersions[next - tapBuffers] = ++tapsVersion;
+	activeTaps.store(next);
+	
+	// wait for a block that may still be reading current, so the next
+	// publish can reuse it. This is at most one block, and never when
+	// called from the audio thread between blocks.
+	const uint32 block = blocksProcessed.load();
+	while (readingTaps.load() && blocksProcessed.load() == block)
+		Thread::yield();
+}
+
+void TappedDelayLine::updateTaps(Array<Tap>& readTaps)
+{
+	const float newSpacingCoefficient = pendingSpacingCoefficient.load(std::memory_order_relaxed);
+	const float newFeedbackCoefficient = pendingFeedbackCoefficient.load(std::memory_order_relaxed);
+	
+	bool forced = spacingForced.load(std::memory_order_acquire);
+	if (forced)
+		spacingForced.store(false, std::memory_order_relaxed);
+	
+	// a newly published list still has its unscaled delays and feedbacks
+	const uint32 version = tapBufferVersions[&readTaps - tapBuffers];
+	const bool published = (version != processedVersion);
+	processedVersion = version;
+	
+	if (published || forced || newSpacingCoefficient != spacingCoefficient)
+	{
+		spacingCoefficient = newSpacingCoefficient;
+		
+		for (int i = 0; i < readTaps.size(); i++)
+		{
+			int newDelaySamples = (readTaps[i].originalDelaySamples * spacingCoefficient);
+			newDelaySamples = jlimit(0, bufferSize - 1, newDelaySamples);
+			readTaps.getReference(i).delaySamples = newDelaySamples;
+		}
+	}
+	
+	if (published || newFeedbackCoefficient != feedbackCoefficient)
 	{
 		feedbackCoefficient = newFeedbackCoefficient;
 		
@@ -127,19 +181,25 @@ void TappedDelayLine::scaleFeedbacks(float newFeedbackCoefficient)
 
 Array<int> TappedDelayLine::getTapSamplePositions()
 {
+	const ScopedLock sl (tapLock);
+	
 	Array<int> tapSamplePositions;
 	
-	for (int i = 0; i < readTaps.size(); i++)
-		tapSamplePositions.add(readTaps[i].delaySamples);
+	for (int i = 0; i < taps.size(); i++)
+		tapSamplePositions.add(taps[i].delaySamples);
 	
 	return tapSamplePositions;
 }
 
 bool TappedDelayLine::removeTapAtIndex(int tapIndex)
 {
-	readTaps.remove(tapIndex);
-	if (readTaps.size() < noTaps) {
-		noTaps = readTaps.size();
+	const ScopedLock sl (tapLock);
+	
+	if ( isPositiveAndBelow(tapIndex, taps.size()) )
+	{
+		taps.remove(tapIndex);
+		
+		publishTaps();
 		return true;
 	}
 	
@@ -148,10 +208,13 @@ bool TappedDelayLine::removeTapAtIndex(int tapIndex)
 
 bool TappedDelayLine::removeTapAtSample(int sampleForRemovedTap)
 {
-	for (int i = 0; i < readTaps.size(); i++)
-		if (readTaps[i].delaySamples == sampleForRemovedTap) {
-			readTaps.remove(i);
-			noTaps = readTaps.size();
+	const ScopedLock sl (tapLock);
+	
+	for (int i = 0; i < taps.size(); i++)
+		if (taps[i].delaySamples == sampleForRemovedTap) {
+			taps.remove(i);
+			
+			publishTaps();
 			return true;
 		}
 	
@@ -167,55 +230,59 @@ bool TappedDelayLine::removeTapAtMs(int timeMsForRemovedTap, int sampleRate)
 
 void TappedDelayLine::removeAllTaps()
 {
-	readTaps.clear();
-	noTaps = readTaps.size();
+	const ScopedLock sl (tapLock);
+	
+	taps.clearQuick();
+	
+	publishTaps();
 }
 
 void TappedDelayLine::updateDelayTimes(double newSampleRate)
 {
-	for (int i = 0; i < readTaps.size(); i++)
+	const ScopedLock sl (tapLock);
+	
+	for (int i = 0; i < taps.size(); i++)
 	{
-		if ( (int)readTaps[i].sampleRateWhenCreated != 0
-			 && !almostEqual<double>(newSampleRate, readTaps.getReference(i).sampleRateWhenCreated) )
+		Tap& tap = taps.getReference(i);
+		
+		if ( tap.sampleRateWhenCreated != 0
+			 && !almostEqual<double>(newSampleRate, tap.sampleRateWhenCreated) )
 		{
-			double scale = (newSampleRate / readTaps.getReference(i).sampleRateWhenCreated);
-			readTaps.getReference(i).delaySamples *= scale;
-			readTaps.getReference(i).sampleRateWhenCreated = newSampleRate;
+			double scale = (newSampleRate / tap.sampleRateWhenCreated);
+			tap.originalDelaySamples *= scale;
+			tap.delaySamples = tap.originalDelaySamples;
+			tap.sampleRateWhenCreated = newSampleRate;
 		}
 	}
+	
+	publishTaps();
 }
 
 float TappedDelayLine::processSingleSample(float newSample) throw()
 {
-	// incriment buffer position and store new sample
-	if(++bufferWritePos > bufferSize)
-		bufferWritePos = 0;
-	float *bufferInput = &pfDelayBuffer[bufferWritePos];
-	*bufferInput = 0;
-	
-	float fOut = (inputGain * newSample);
-	for (int i = 0; i < noTaps; ++i)
-	{
-		const Tap currentTap = readTaps.getReference(i);
-
-		int tapReadPos = bufferWritePos - currentTap.delaySamples;
-		if (tapReadPos < 0)
-			tapReadPos += bufferSize;
-		
-		float tapOutput = currentTap.tapGain * pfDelayBuffer[tapReadPos];
-		fOut += tapOutput;
-		*bufferInput += currentTap.tapFeedback * tapOutput;
-	}
+	processSamples(&newSample, 1);
 	
-	*bufferInput += newSample;
-
-	return fOut;
+	return newSample;
 }
 
 void TappedDelayLine::processSamples (float* const samples,
 									  const int numSamples) throw()
 {
-    const ScopedLock sl (processLock);
+	readingTaps.store(true);
+	
+	Array<Tap>& readTaps = *activeTaps.load();
+	updateTaps(readTaps);
+	processTaps(readTaps, samples, numSamples);
+	
+	blocksProcessed.fetch_add(1);
+	readingTaps.store(false);
+}
+
+void TappedDelayLine::processTaps (Array<Tap>& readTaps,
+								   float* const samples,
+								   const int numSamples) throw()
+{
+	const int numTaps = readTaps.size();
 	
 	for (int i = 0; i < numSamples; ++i)
 	{
@@ -228,7 +295,7 @@ void TappedDelayLine::processSamples (float* const samples,
 		*bufferInput = 0;
 		
 		float fOut = (inputGain * in);
-		for (int t = 0; t < noTaps; ++t)
+		for (int t = 0; t < numTaps; ++t)
 		{
 			const Tap currentTap = readTaps.getReference(t);
 			
@@ -11,6 +11,8 @@
 
 #include "includes.h"
 
+#include <atomic>
+
 // #include "../../utility/dRowAudio_Utility.h"
 // #include "../dRowAudio_AudioUtility.h"
 
@@ -70,6 +72,7 @@ public:
 		spacing creating a more sparse delay.
 		The value is used as a proportion of the explicitly set delay time.
 		This is simpler than manually setting all of the tap positions.
+		The new spacing is picked up at the start of the next processed block.
 	 */
 	void setTapSpacing(float newSpacingCoefficient);
 
@@ -82,11 +85,13 @@ public:
 		This should be between 0 and 1 to avoid blowing up the line.
 		The value is a proportion of the explicitly set feedback coefficient
 		for each tap so setting this to 1 will return them all to their default.
+		The new scale is picked up at the start of the next processed block.
 	 */
 	void scaleFeedbacks(float newFeedbackCoefficient);
 
 	/**	Returns an array of sample positions where there are taps.
-		This can then be used to remove a specific tap.
+		These are the positions the taps were set to, before any spacing
+		is applied. This can then be used to remove a specific tap.
 	 */
 	Array<int> getTapSamplePositions();
 	
@@ -134,29 +139,47 @@ public:
 	int getBufferLengthMs(double sampleRate)	{	return bufferSize * sampleRate;	}
 	
 	/// Returns the number of taps currently being used.
-	int getNumberOfTaps()	{	return readTaps.size();	}
+	int getNumberOfTaps()	{	const ScopedLock sl (tapLock);	return taps.size();	}
 	
 	/// Processes a single sample returning a new sample with summed delays.
 	float processSingleSample(float newSample) throw();
 	
-	/// Processes a number of samples in one go.
+	/** Processes a number of samples in one go.
+		This never waits for the methods changing the taps. Those edit their
+		own copy of the taps and publish it, the block always runs with the
+		last complete set of taps.
+	 */
 	void processSamples(float* const samples,
 						const int numSamples) throw();
 	
 private:
 	
-	CriticalSection processLock;
+	CriticalSection tapLock;
 	
 	float *pfDelayBuffer;
 	int bufferSize, bufferWritePos;
 	
 	float inputGain, feedbackGain;
-	int noTaps;
-	Array<Tap> readTaps;
+	// taps is the copy the tap methods edit under tapLock. It is published by
+	// copying it into whichever of tapBuffers the processing isn't using and
+	// swapping activeTaps, so the audio thread never sees a half edited list.
+	Array<Tap> taps;
+	Array<Tap> tapBuffers[2];
+	std::atomic<Array<Tap>*> activeTaps;
+	std::atomic<bool> readingTaps;
+	std::atomic<uint32> blocksProcessed;
+	// each buffer carries the version it was published with, so a block
+	// compares the version of the list it actually reads.
+	uint32 tapsVersion, tapBufferVersions[2], processedVersion;
 	
 	float spacingCoefficient, feedbackCoefficient;
+	std::atomic<float> pendingSpacingCoefficient, pendingFeedbackCoefficient;
+	std::atomic<bool> spacingForced;
 	
 	void initialiseBuffer(int bufferSize);
+	void publishTaps();
+	void updateTaps(Array<Tap>& readTaps);
+	void processTaps(Array<Tap>& readTaps, float* const samples, const int numSamples) throw();
 	
 	JUCE_LEAK_DETECTOR (TappedDelayLine);
 };
@@ -46,7 +46,13 @@ AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 
 //==============================================================================
 DRowAudioFilter::DRowAudioFilter()
+	:	combFilters(16),
+		allpassFilters(2, 4)
 {
+	// the first 8 comb filters are left, the others right
+	for (int i = 0; i < 8; ++i)
+		combFilters.setChannel(8 + i, 1);
+
 	// set up the parameters with the required limits and units
 
 	params[PREDELAY].init(parameterNames[PREDELAY], UnitMilliseconds, String(),
@@ -303,6 +309,8 @@ void DRowAudioFilter::prepareToPlay (double sampleRate, int samplesPerBlock)
 
         wetBuffer.setSize(2, samplesPerBlock);
         wetBuffer.clear();
+        earlyReflections.setSize(2, samplesPerBlock);
+        lateReverb.setSize(2, samplesPerBlock);
 }
 
 void DRowAudioFilter::releaseResources()
@@ -377,8 +385,8 @@ void DRowAudioFilter::processBlock (AudioSampleBuffer& buffer,
 			delayTime *= filterMultCoeffs[i];
 			delayTime += Random::getSystemRandom().nextInt(100)*0.0001;
 
-			setupFilter(combFilterL[i], fbCoeff, delayTime, filterCf);
-			setupFilter(combFilterR[i], fbCoeff, delayTime + width, filterCf);
+			setupFilter(i, fbCoeff, delayTime, filterCf);
+			setupFilter(8 + i, fbCoeff, delayTime + width, filterCf);
 		}
 
 		// allpass section
@@ -387,11 +395,11 @@ void DRowAudioFilter::processBlock (AudioSampleBuffer& buffer,
 			delayTime *= allpassMultCoeffs[i];
 			delayTime -= Random::getSystemRandom().nextInt(100)*0.0001;
 
-			allpassFilterL[i].setGain(allpassCoeff);
-			allpassFilterL[i].setDelayTime(currentSampleRate, delayTime);
+			allpassFilters.setGain(0, i, allpassCoeff);
+			allpassFilters.setDelayTime(0, i, currentSampleRate, delayTime);
 
-			allpassFilterR[i].setGain(allpassCoeff);
-			allpassFilterR[i].setDelayTime(currentSampleRate, delayTime + width);
+			allpassFilters.setGain(1, i, allpassCoeff);
+			allpassFilters.setDelayTime(1, i, currentSampleRate, delayTime + width);
 		}
 
 		// final EQ section
@@ -427,8 +435,8 @@ void DRowAudioFilter::processBlock (AudioSampleBuffer& buffer,
 		preDelayFilterR.processSamples(wetBuffer.getWritePointer(1), noSamples);
 
 
-		// create a buffer to hold the early reflections
-		AudioSampleBuffer earlyReflections(noChannels, noSamples);
+		// the buffer holding the early reflections
+		earlyReflections.setSize(noChannels, noSamples, false, false, true);
 		earlyReflections.copyFrom(0, 0, wetBuffer, 0, 0, noSamples);
 		earlyReflections.copyFrom(1, 0, wetBuffer, 1, 0, noSamples);
 
@@ -437,8 +445,8 @@ void DRowAudioFilter::processBlock (AudioSampleBuffer& buffer,
 		delayLineR.processSamples(earlyReflections.getWritePointer(1), noSamples);
 
 
-		// create a buffer to hold the late reverb
-		AudioSampleBuffer lateReverb(noChannels, noSamples);
+		// the buffer holding the late reverb
+		lateReverb.setSize(noChannels, noSamples, false, false, true);
 		lateReverb.clear();
 
 		float *pfLateL = lateReverb.getWritePointer(0);
@@ -447,18 +455,12 @@ void DRowAudioFilter::processBlock (AudioSampleBuffer& buffer,
 		pfWetR = wetBuffer.getWritePointer(1);
 
 		// comb filter section
-		for (int i = 0; i < 8; ++i)
-		{
-			combFilterL[i].processSamplesAdding(pfWetL, pfLateL, noSamples);
-			combFilterR[i].processSamplesAdding(pfWetR, pfLateR, noSamples);
-		}
+		const float* wetChannels[2] = { pfWetL, pfWetR };
+		float* lateChannels[2] = { pfLateL, pfLateR };
+		combFilters.processSamplesAdding(wetChannels, lateChannels, noSamples);
 
 		// allpass filter section
-		for (int i = 0; i < 4; ++i)
-		{
-			allpassFilterL[i].processSamples(lateReverb.getWritePointer(0), noSamples);
-			allpassFilterR[i].processSamples(lateReverb.getWritePointer(1), noSamples);
-		}
+		allpassFilters.processSamples(lateChannels, noSamples);
 
 
 		// clear wet buffer
@@ -510,11 +512,11 @@ void DRowAudioFilter::processBlock (AudioSampleBuffer& buffer,
     }
 }
 
-void DRowAudioFilter::setupFilter(LBCF &filter, float fbCoeff, float delayTime, float filterCf)
+void DRowAudioFilter::setupFilter(int filterIndex, float fbCoeff, float delayTime, float filterCf)
 {
-	filter.setFBCoeff(fbCoeff);
-	filter.setDelayTime(currentSampleRate, delayTime);
-	filter.setLowpassCutoff(currentSampleRate, filterCf);
+	combFilters.setFBCoeff(filterIndex, fbCoeff);
+	combFilters.setDelayTime(filterIndex, currentSampleRate, delayTime);
+	combFilters.setLowpassCutoff(filterIndex, currentSampleRate, filterCf);
 }
 
 //==============================================================================
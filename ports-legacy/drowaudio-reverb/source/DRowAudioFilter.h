@@ -35,9 +35,8 @@
 #include "Parameters.h"
 #include "includes.h"
 
-#include "dRowAudio_AllpassFilter.h"
 #include "dRowAudio_DelayRegister.h"
-#include "dRowAudio_LBCF.h"
+#include "dRowAudio_FilterBank.h"
 #include "dRowAudio_TappedDelayLine.h"
 
 static const int earlyReflectionCoeffs[5][5] = {
@@ -141,7 +140,7 @@ public:
 	PluginParameter* getParameterPointer(int index);
 
 private:
-        AudioSampleBuffer wetBuffer;
+        AudioSampleBuffer wetBuffer, earlyReflections, lateReverb;
 
 	PluginParameter params[noParams];
 
@@ -151,12 +150,12 @@ private:
 	// reverb filters
 	DelayRegister preDelayFilterL, preDelayFilterR;			// pre delay
 	TappedDelayLine delayLineL, delayLineR;					// early reflections
-	LBCF combFilterL[8], combFilterR[8];					// late reverb
-	AllpassFilter allpassFilterL[4], allpassFilterR[4];		// late reverb diffusion
+	LBCFBank combFilters;									// late reverb, 8 per channel
+	AllpassFilterBank allpassFilters;						// late reverb diffusion, 4 per channel
 	IIRFilterOld lowEQL, lowEQR, highEQL, highEQR;				// room EQ
 
-	// helper method to set up a LBCF filter
-	inline void setupFilter(LBCF &filter, float fbCoeff, float delayTime, float filterCf);
+	// helper method to set up one of the comb filters
+	inline void setupFilter(int filterIndex, float fbCoeff, float delayTime, float filterCf);
 };
 
 #endif //_DROWAUDIOFILTER_H_
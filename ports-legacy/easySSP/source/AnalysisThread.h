@@ -0,0 +1,159 @@
+#ifndef ANALYSISTHREAD_H_INCLUDED
+#define ANALYSISTHREAD_H_INCLUDED
+
+#include "JuceHeader.h"
+#include "dsp-utility.h"
+
+// Runs the metering away from the audio thread.
+// The audio callback copies its input into blocks from a pool allocated in prepare(), full blocks go to this
+// thread through one spsc_queue and come back empty through another. The audio side never allocates, locks or
+// signals anything, and when analysis falls behind, input is dropped, not waited for.
+// The thread sleeps until someone calls notify() - the editor does, once per frame - so it stays parked while
+// no editor is open.
+class AnalysisThread : public Thread
+{
+public:
+	class Client
+	{
+	public:
+		virtual ~Client() {}
+
+		// Called on the analysis thread with one full block
+		virtual void analyseBlock(const float* const* channels, int numChannels, int numSamples) = 0;
+	};
+
+	AnalysisThread(Client& client) : Thread("EasySSP analysis"), mClient(client), mCurrent(NULL)
+	{
+	}
+
+	~AnalysisThread()
+	{
+		release();
+	}
+
+	// Not realtime safe. Stops the thread, allocates numBlocks blocks of blockSize samples and starts again.
+	void prepare(int numChannels, int blockSize, int numBlocks)
+	{
+		release();
+
+		mFilled = new tomatl::dsp::spsc_queue<Block*>();
+		mFree = new tomatl::dsp::spsc_queue<Block*>();
+
+		for (int i = 0; i < numBlocks; ++i)
+		{
+			mBlocks.add(new Block(numChannels, blockSize));
+		}
+
+		// Send every block through the filled queue once, so that its node cache never has to grow
+		// on the audio thread, which is the only one enqueueing there
+		for (int i = 0; i < numBlocks; ++i)
+		{
+			mFilled->enqueue(mBlocks[i]);
+		}
+
+		Block* block;
+
+		while (mFilled->dequeue(block))
+		{
+			mFree->enqueue(block);
+		}
+
+		startThread();
+	}
+
+	void release()
+	{
+		signalThreadShouldExit();
+		notify();
+		stopThread(1000);
+
+		mCurrent = NULL;
+		mFilled = nullptr;
+		mFree = nullptr;
+		mBlocks.clear();
+	}
+
+	// Audio thread. Blocks are handed over once full, so the analysis always sees the same block size.
+	void push(const AudioSampleBuffer& buffer)
+	{
+		if (mFree == nullptr)
+		{
+			return;
+		}
+
+		const int numSamples = buffer.getNumSamples();
+
+		for (int position = 0; position < numSamples;)
+		{
+			if (mCurrent == NULL && !mFree->dequeue(mCurrent))
+			{
+				return;
+			}
+
+			AudioSampleBuffer& data = mCurrent->mData;
+			const int numChannels = data.getNumChannels();
+			const int length = std::min(numSamples - position, data.getNumSamples() - mCurrent->mLength);
+
+			for (int ch = 0; ch < numChannels; ++ch)
+			{
+				if (ch < buffer.getNumChannels())
+				{
+					FloatVectorOperations::copy(data.getWritePointer(ch, mCurrent->mLength), buffer.getReadPointer(ch, position), length);
+				}
+				else
+				{
+					FloatVectorOperations::clear(data.getWritePointer(ch, mCurrent->mLength), length);
+				}
+			}
+
+			mCurrent->mLength += length;
+			position += length;
+
+			if (mCurrent->mLength == data.getNumSamples())
+			{
+				mFilled->enqueue(mCurrent);
+				mCurrent = NULL;
+			}
+		}
+	}
+
+	virtual void run()
+	{
+		while (!threadShouldExit())
+		{
+			Block* block;
+
+			while (mFilled->dequeue(block))
+			{
+				mClient.analyseBlock(block->mData.getArrayOfReadPointers(), block->mData.getNumChannels(), block->mLength);
+
+				block->mLength = 0;
+				mFree->enqueue(block);
+			}
+
+			// The block pool holds far more audio than one editor frame, nothing is lost between wake-ups
+			wait(-1);
+		}
+	}
+
+private:
+	struct Block
+	{
+		Block(int numChannels, int numSamples) : mData(numChannels, numSamples), mLength(0)
+		{
+		}
+
+		AudioSampleBuffer mData;
+		int mLength;
+	};
+
+	Client& mClient;
+	OwnedArray<Block> mBlocks;
+	ScopedPointer<tomatl::dsp::spsc_queue<Block*>> mFilled;
+	ScopedPointer<tomatl::dsp::spsc_queue<Block*>> mFree;
+	Block* mCurrent;
+
+	JUCE_DECLARE_NON_COPYABLE(AnalysisThread)
+};
+
+#endif  // ANALYSISTHREAD_H_INCLUDED
@@ -97,6 +97,8 @@ public:
 
 	virtual void timerCallback()
 	{
+		mParentProcessor->requestAnalysis();
+
 		mGonio.repaint();
 		mSpectrometer.repaint();
 		
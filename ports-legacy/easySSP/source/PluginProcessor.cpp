@@ -13,14 +13,15 @@
 #include <functional>
 
 //==============================================================================
-AdmvAudioProcessor::AdmvAudioProcessor() : mSpectroSegments(NULL), mGonioSegments(NULL), mLastGonioScale(1.), mMaxStereoPairCount(0), mCurrentInputCount(0)
+AdmvAudioProcessor::AdmvAudioProcessor() : mSpectroSegments(NULL), mGonioSegments(NULL), mLastGonioScale(1.), mMaxStereoPairCount(0), mCurrentInputCount(0),
+	mAnalysisThread(*this), mAnalysisSampleRate(44100.)
 {
 	releaseResources();
 }
 
 AdmvAudioProcessor::~AdmvAudioProcessor()
 {
-	
+	releaseResources();
 }
 
 //==============================================================================
@@ -129,7 +130,10 @@ void AdmvAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
 	size_t fftSize = 2048;
 
+	releaseResources();
+
 	mMaxStereoPairCount = JucePlugin_MaxNumInputChannels / 2;
+	mAnalysisSampleRate = sampleRate;
 
 	for (size_t i = 0; i < mMaxStereoPairCount; ++i)
 	{
@@ -138,17 +142,23 @@ void AdmvAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 
 	for (size_t i = 0; i < mMaxStereoPairCount; ++i)
 	{
-		mSpectroCalcs.push_back(new tomatl::dsp::SpectroCalculator<double>(sampleRate, std::pair<double, double>(10, getState().mSpectrometerReleaseSpeed), i, fftSize));
+		mSpectroCalcs.push_back(new tomatl::dsp::SpectroCalculator<float>(sampleRate, std::pair<double, double>(10, getState().mSpectrometerReleaseSpeed), i, fftSize));
 	}
 
 	mSpectroSegments = new tomatl::dsp::SpectrumBlock[mMaxStereoPairCount];
 	mGonioSegments = new GonioPoints<double>[mMaxStereoPairCount];
 
 	makeCurrentStateEffective();
+
+	// 512 samples per analysis block, a bit over a third of a second of them in flight at 48 kHz
+	mAnalysisThread.prepare(mMaxStereoPairCount * 2, 512, 32);
 }
 
 void AdmvAudioProcessor::releaseResources()
 {
+	// Analysis uses everything below, stop it first
+	mAnalysisThread.release();
+
 	for (size_t i = 0; i < mMaxStereoPairCount; ++i)
 	{
 		TOMATL_DELETE(mGonioCalcs[i]);
@@ -168,74 +178,73 @@ void AdmvAudioProcessor::releaseResources()
 
 void AdmvAudioProcessor::processBlock(AudioSampleBuffer& buffer, MidiBuffer& midiMessages)
 {
-	double cp[2];
-	
-	int channelCount = 0;
-	size_t sampleRate = getSampleRate();
+	// No need to analyse signal if editor is closed. Everything else happens on the analysis thread,
+	// here the input only gets copied.
+	if (getActiveEditor() != NULL)
+	{
+		mAnalysisThread.push(buffer);
+	}
 
-	for (int channel = 0; channel < (getTotalNumInputChannels() - 1); channel += 2)
+	if (getState().mOutputMode == AdmvPluginState::outputMute)
+	{
+		buffer.clear();
+	}
+	else
 	{
-		// No need to process signal if editor is closed
-		if (getActiveEditor() == NULL)
+		// In case we have more outputs than inputs, we'll clear any output
+		// channels that didn't contain input data, (because these aren't
+		// guaranteed to be empty - they may contain garbage).
+		for (int i = getTotalNumInputChannels(); i < getTotalNumOutputChannels(); ++i)
 		{
-			break;
+			buffer.clear(i, 0, buffer.getNumSamples());
 		}
+	}
+}
+
+void AdmvAudioProcessor::analyseBlock(const float* const* channels, int numChannels, int numSamples)
+{
+	int channelCount = 0;
+	size_t sampleRate = mAnalysisSampleRate;
 
+	// All stereo pairs of the block in one pass
+	for (int channel = 0; channel < (numChannels - 1); channel += 2)
+	{
 		// TODO: investigate how to get number of input channels really connected to the plugin ATM.
 		// It seems that getTotalNumInputChannels() will always return max possible defined by JucePlugin_MaxNumInputChannels
 		// This solution is bad, because it iterates through all input buffers.
-		if (!isBlockInformative(buffer, channel / 2))
+		if (!isBlockInformative(channels, numSamples, channel / 2))
 		{
 			mGonioSegments[channel / 2] = GonioPoints<double>();
 			mSpectroSegments[channel / 2] = tomatl::dsp::SpectrumBlock();
 
 			continue;
 		}
-		
+
 		channelCount += 2;
 
-		float* l = buffer.getWritePointer(channel + 0);
-		float* r = buffer.getWritePointer(channel + 1);
+		const float* l = channels[channel + 0];
+		const float* r = channels[channel + 1];
 
-		for (int i = 0; i < buffer.getNumSamples(); ++i)
+		for (int i = 0; i < numSamples; ++i)
 		{
 			std::pair<double, double>* res = mGonioCalcs[channel / 2]->handlePoint(l[i], r[i], sampleRate);
 
-			cp[0] = l[i];
-			cp[1] = r[i];
-
-			mSpectroCalcs[channel / 2]->checkSampleRate(getSampleRate());
-			tomatl::dsp::SpectrumBlock spectroResult = mSpectroCalcs[channel / 2]->process((double*)&cp);
-
 			if (res != NULL)
 			{
 				mGonioSegments[channel / 2] = GonioPoints<double>(res, mGonioCalcs[channel / 2]->getSegmentLength(), channel / 2, sampleRate);
 				mLastGonioScale = mGonioCalcs[channel / 2]->getCurrentScaleValue();
 			}
-
-			if (spectroResult.mLength > 0)
-			{
-				mSpectroSegments[channel / 2] = spectroResult;
-			}
 		}
-	}
-	
-	mCurrentInputCount = channelCount;
 
-	if (getState().mOutputMode == AdmvPluginState::outputMute)
-	{
-		buffer.clear();
-	}
-	else
-	{
-		// In case we have more outputs than inputs, we'll clear any output
-		// channels that didn't contain input data, (because these aren't
-		// guaranteed to be empty - they may contain garbage).
-		for (int i = getTotalNumInputChannels(); i < getTotalNumOutputChannels(); ++i)
+		tomatl::dsp::SpectrumBlock spectroResult = mSpectroCalcs[channel / 2]->process(channels + channel, numSamples);
+
+		if (spectroResult.mLength > 0)
 		{
-			buffer.clear(i, 0, buffer.getNumSamples());
+			mSpectroSegments[channel / 2] = spectroResult;
 		}
 	}
+
+	mCurrentInputCount = channelCount;
 }
 
 //==============================================================================
@@ -15,6 +15,7 @@
 #include "dsp-utility.h"
 #include "GonioPoints.h"
 #include "PluginState.h"
+#include "AnalysisThread.h"
 #include <vector>
 #include <stack>
 //==============================================================================
@@ -23,7 +24,7 @@
 
 #define TOMATL_PLUGIN_SET_PROPERTY(name, value) mState. name = value; makeCurrentStateEffective()
 
-class AdmvAudioProcessor  : public AudioProcessor
+class AdmvAudioProcessor  : public AudioProcessor, public AnalysisThread::Client
 {
 public:
 	tomatl::dsp::SpectrumBlock* mSpectroSegments;
@@ -38,6 +39,11 @@ public:
 
 	void processBlock (AudioSampleBuffer& buffer, MidiBuffer& midiMessages);
 
+	// Called on the analysis thread, see AnalysisThread
+	void analyseBlock(const float* const* channels, int numChannels, int numSamples);
+	// Called by the editor once per frame, lets the analysis thread catch up on the queued input
+	void requestAnalysis() { mAnalysisThread.notify(); }
+
 	//==============================================================================
 	AudioProcessorEditor* createEditor();
 	bool hasEditor() const;
@@ -127,10 +133,12 @@ public:
 
 private:
 	std::vector<tomatl::dsp::GonioCalculator<double>*> mGonioCalcs;
-	std::vector<tomatl::dsp::SpectroCalculator<double>*> mSpectroCalcs;
+	std::vector<tomatl::dsp::SpectroCalculator<float>*> mSpectroCalcs;
 	size_t mMaxStereoPairCount;
 	size_t mCurrentInputCount;
 	AdmvPluginState mState;
+	AnalysisThread mAnalysisThread;
+	double mAnalysisSampleRate;
 	
 	void makeCurrentStateEffective();
 
@@ -139,16 +147,16 @@ private:
 		return 4;
 	}
 
-	bool isBlockInformative(AudioSampleBuffer& buffer, size_t pairIndex)
+	bool isBlockInformative(const float* const* channels, int numSamples, size_t pairIndex)
 	{
 		float magnitude = 0.;
 		//size_t checksum = 0;
 
 		for (int i = 0; i < 2; ++i)
 		{
-			float* channelData = buffer.getWritePointer(pairIndex * 2 + i);
+			const float* channelData = channels[pairIndex * 2 + i];
 
-			for (int s = 0; s < buffer.getNumSamples(); ++s)
+			for (int s = 0; s < numSamples; ++s)
 			{
 				magnitude = std::max(magnitude, std::abs(channelData[s]));
 
@@ -0,0 +1,161 @@
+#ifndef TOMATL_REAL_FFT_CALCULATOR
+#define TOMATL_REAL_FFT_CALCULATOR
+
+#include <cmath>
+#include <vector>
+
+namespace tomatl { namespace dsp {
+
+// Forward FFT of a real signal with all the twiddle factors computed up front, meant for analysis
+// in float. The N real samples are transformed as N/2 complex ones (even samples as real part,
+// odd ones as imaginary part) and then split into the N/2 + 1 bins of the real spectrum.
+// Real and imaginary parts live in separate arrays, so that the butterflies and whatever the caller
+// does with the bins are plain loops over contiguous memory the compiler can vectorize.
+// Output isn't scaled, same as FftCalculator::calculateFast.
+template <typename T> class RealFftCalculator
+{
+private:
+	TOMATL_DECLARE_NON_MOVABLE_COPYABLE(RealFftCalculator);
+
+	size_t mSize;
+	size_t mHalfSize;
+	std::vector<size_t> mBitReversed;
+	std::vector<T> mStageCos;
+	std::vector<T> mStageSin;
+	std::vector<T> mSplitCos;
+	std::vector<T> mSplitSin;
+	std::vector<T> mReal;
+	std::vector<T> mImag;
+
+	// The halves of a butterfly group never overlap, saying so lets the compiler vectorize this
+	static void butterflies(T* __restrict r1, T* __restrict i1, T* __restrict r2, T* __restrict i2,
+		const T* __restrict wr, const T* __restrict wi, size_t half)
+	{
+		for (size_t j = 0; j < half; ++j)
+		{
+			T tr = r2[j] * wr[j] - i2[j] * wi[j];
+			T ti = r2[j] * wi[j] + i2[j] * wr[j];
+
+			r2[j] = r1[j] - tr;
+			i2[j] = i1[j] - ti;
+			r1[j] += tr;
+			i1[j] += ti;
+		}
+	}
+
+public:
+	// fftSize must be a power of 2, at least 4
+	explicit RealFftCalculator(size_t fftSize) : mSize(fftSize), mHalfSize(fftSize / 2)
+	{
+		size_t bits = 0;
+
+		while (((size_t)1 << bits) < mHalfSize)
+		{
+			++bits;
+		}
+
+		mBitReversed.resize(mHalfSize);
+
+		for (size_t i = 0; i < mHalfSize; ++i)
+		{
+			size_t reversed = 0;
+
+			for (size_t b = 0; b < bits; ++b)
+			{
+				reversed |= ((i >> b) & 1) << (bits - 1 - b);
+			}
+
+			mBitReversed[i] = reversed;
+		}
+
+		// Twiddles of each butterfly stage one after another, so that every stage reads them sequentially
+		for (size_t half = 1; half < mHalfSize; half <<= 1)
+		{
+			for (size_t j = 0; j < half; ++j)
+			{
+				double arg = -TOMATL_PI * j / half;
+
+				mStageCos.push_back((T)std::cos(arg));
+				mStageSin.push_back((T)std::sin(arg));
+			}
+		}
+
+		for (size_t k = 0; k <= mHalfSize / 2; ++k)
+		{
+			double arg = -2. * TOMATL_PI * k / mSize;
+
+			mSplitCos.push_back((T)std::cos(arg));
+			mSplitSin.push_back((T)std::sin(arg));
+		}
+
+		mReal.resize(mHalfSize + 1);
+		mImag.resize(mHalfSize + 1);
+	}
+
+	// Transforms getSize() samples, the spectrum stays valid until the next call
+	void calculate(const T* signal)
+	{
+		T* re = &mReal[0];
+		T* im = &mImag[0];
+
+		for (size_t i = 0; i < mHalfSize; ++i)
+		{
+			size_t source = mBitReversed[i] * 2;
+
+			re[i] = signal[source];
+			im[i] = signal[source + 1];
+		}
+
+		const T* wr = &mStageCos[0];
+		const T* wi = &mStageSin[0];
+
+		for (size_t half = 1; half < mHalfSize; half <<= 1)
+		{
+			for (size_t start = 0; start < mHalfSize; start += half * 2)
+			{
+				butterflies(re + start, im + start, re + start + half, im + start + half, wr, wi, half);
+			}
+
+			wr += half;
+			wi += half;
+		}
+
+		// Z[k] holds the spectra of the even (E) and odd (O) samples mixed together,
+		// X[k] = E[k] + W^k * O[k] and X[N/2 - k] = conj(E[k] - W^k * O[k])
+		T dcReal = re[0];
+		T dcImag = im[0];
+
+		re[0] = dcReal + dcImag;
+		im[0] = 0.;
+		re[mHalfSize] = dcReal - dcImag;
+		im[mHalfSize] = 0.;
+
+		for (size_t k = 1; k <= mHalfSize / 2; ++k)
+		{
+			size_t mirror = mHalfSize - k;
+
+			T evenReal = (re[k] + re[mirror]) * (T)0.5;
+			T evenImag = (im[k] - im[mirror]) * (T)0.5;
+			T oddReal = (im[k] + im[mirror]) * (T)0.5;
+			T oddImag = (re[mirror] - re[k]) * (T)0.5;
+
+			T tr = mSplitCos[k] * oddReal - mSplitSin[k] * oddImag;
+			T ti = mSplitCos[k] * oddImag + mSplitSin[k] * oddReal;
+
+			re[k] = evenReal + tr;
+			im[k] = evenImag + ti;
+			re[mirror] = evenReal - tr;
+			im[mirror] = ti - evenImag;
+		}
+	}
+
+	size_t getSize() const { return mSize; }
+
+	// getSize() / 2 + 1 bins, from DC to Nyquist
+	const T* getReal() const { return &mReal[0]; }
+	const T* getImag() const { return &mImag[0]; }
+};
+
+}}
+
+#endif
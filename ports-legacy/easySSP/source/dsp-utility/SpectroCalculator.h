@@ -1,8 +1,9 @@
 #ifndef TOMATL_SPECTRO_CALCULATOR
 #define TOMATL_SPECTRO_CALCULATOR
 
+#include <algorithm>
 #include <limits>
-#include <memory>
+#include <vector>
 
 namespace tomatl { namespace dsp {
 
@@ -33,62 +34,52 @@ namespace tomatl { namespace dsp {
 		std::pair<double, double>* mData;
 	};
 
+	// Magnitude spectrum of a group of channels, with half-overlapping frames and attack/release smoothing.
+	// All channels are smoothed into one curve, each frame of each channel counts as one step of the envelope.
+	// Meant to run in float: the FFT is RealFftCalculator and the per-bin loops are branch-free, so that they vectorize.
 	template <typename T> class SpectroCalculator
 	{
 	public:
-		SpectroCalculator(double sampleRate, std::pair<double, double> attackRelease, size_t index, size_t fftSize = 1024, size_t channelCount = 2) : 
-			mWindowFunction(new WindowFunction<T>(fftSize, WindowFunctionFactory::getWindowCalculator<double>(WindowFunctionFactory::windowHann), true))
+		SpectroCalculator(double sampleRate, std::pair<double, double> attackRelease, size_t index, size_t fftSize = 1024, size_t channelCount = 2) :
+			mFft(fftSize)
 		{
-			mData = new std::pair<double, double>[fftSize];
-			memset(mData, 0x0, sizeof(std::pair<double, double>) * fftSize);
-			mChannelCount = channelCount;
 			mFftSize = fftSize;
+			mHopSize = fftSize / 2;
+			mBinCount = fftSize / 2;
+			mChannelCount = channelCount;
 			mIndex = index;
 			mSampleRate = sampleRate;
-			mChannelCount = 0;
-			checkChannelCount(channelCount);
-
-			setAttackSpeed(attackRelease.first);
-			setReleaseSpeed(attackRelease.second);
-		}
+			mFill = mHopSize;
 
-		~SpectroCalculator()
-		{
-			TOMATL_BRACE_DELETE(mData);
+			// Window, its power loss compensation and the 2 / N amplitude scaling (see below) in one table
+			WindowFunction<T> window(fftSize, WindowFunctionFactory::getWindowCalculator<double>(WindowFunctionFactory::windowHann), true);
+			mWindow.assign(fftSize, (T)1.);
 
-			for (int i = 0; i < (int)mChannelCount; ++i)
+			for (int s = 0; s < (int)mFftSize; ++s)
 			{
-				TOMATL_DELETE(mBuffers[i]);
+				window.applyFunction(&mWindow[s], s, 1, true);
+				mWindow[s] *= (T)(2. / mFftSize);
 			}
 
-			mBuffers.clear();
-		}
-
-		bool checkChannelCount(size_t channelCount)
-		{
-			if (channelCount != mChannelCount)
-			{
-				mChannelCount = channelCount;
-
-				for (int i = 0; i < (int)mBuffers.size(); ++i)
-				{
-					TOMATL_DELETE(mBuffers[i]);
-				}
-
-				mBuffers.clear();
-
-				for (int i = 0; i < (int)mChannelCount; ++i)
-				{
-					mBuffers.push_back(new OverlappingBufferSequence<T>(mFftSize * 2, mFftSize));
-				}
+			mFrames.assign(mChannelCount, std::vector<T>(mFftSize, (T)0.));
+			mWindowed.assign(mFftSize, (T)0.);
+			mMagnitudes.assign(mChannelCount, std::vector<T>(mBinCount, (T)0.));
+			mSmoothed.assign(mBinCount, (T)0.);
 
-				setReleaseSpeed(mReleaseMs);
-				setAttackSpeed(mAttackMs);
+			mData = new std::pair<double, double>[mBinCount];
 
-				return true;
+			for (size_t bin = 0; bin < mBinCount; ++bin)
+			{
+				mData[bin] = std::pair<double, double>(bin, 0.);
 			}
 
-			return false;
+			setAttackSpeed(attackRelease.first);
+			setReleaseSpeed(attackRelease.second);
+		}
+
+		~SpectroCalculator()
+		{
+			TOMATL_BRACE_DELETE(mData);
 		}
 
 		bool checkSampleRate(double sampleRate)
@@ -108,31 +99,51 @@ namespace tomatl { namespace dsp {
 		void setReleaseSpeed(double speed)
 		{
 			mReleaseMs = speed;
-			mAttackRelease.second = tomatl::dsp::EnvelopeWalker::calculateCoeff(speed, mSampleRate / mFftSize / mBuffers[0]->getOverlappingFactor() * mChannelCount);
+			mAttackRelease.second = tomatl::dsp::EnvelopeWalker::calculateCoeff(speed, getFrameRate());
 		}
 
 		void setAttackSpeed(double speed)
 		{
 			mAttackMs = speed;
-			mAttackRelease.first = tomatl::dsp::EnvelopeWalker::calculateCoeff(speed, mSampleRate / mFftSize / mBuffers[0]->getOverlappingFactor() * mChannelCount);
+			mAttackRelease.first = tomatl::dsp::EnvelopeWalker::calculateCoeff(speed, getFrameRate());
 		}
 
-		SpectrumBlock process(T* channels)
+		// Takes numSamples of every channel, returns the updated spectrum if at least one frame was completed
+		SpectrumBlock process(const T* const* channels, size_t numSamples)
 		{
 			bool processed = false;
+			size_t done = 0;
 
-			for (int i = 0; i < (int)mChannelCount; ++i)
+			while (done < numSamples)
 			{
-				// As our signal is built entirely from real numbers, imaginary part will always be zero
-				mBuffers[i]->putOne(channels[i]);
-				auto chData = mBuffers[i]->putOne(0.);
+				size_t length = std::min(numSamples - done, mFftSize - mFill);
 
-				processed = processed || calculateSpectrumFromChannelBufferIfReady(std::get<0>(chData));
+				for (size_t ch = 0; ch < mChannelCount; ++ch)
+				{
+					std::copy(channels[ch] + done, channels[ch] + done + length, mFrames[ch].begin() + mFill);
+				}
+
+				mFill += length;
+				done += length;
+
+				if (mFill == mFftSize)
+				{
+					calculateSpectrum();
+
+					// The second half of this frame is the first half of the next one
+					for (size_t ch = 0; ch < mChannelCount; ++ch)
+					{
+						std::copy(mFrames[ch].begin() + mHopSize, mFrames[ch].end(), mFrames[ch].begin());
+					}
+
+					mFill = mFftSize - mHopSize;
+					processed = true;
+				}
 			}
 
 			if (processed)
 			{
-				return SpectrumBlock(mFftSize / 2., mData, mIndex, mSampleRate);
+				return SpectrumBlock(mBinCount, mData, mIndex, mSampleRate);
 			}
 			else
 			{
@@ -142,69 +153,76 @@ namespace tomatl { namespace dsp {
 
 	private:
 
-		bool calculateSpectrumFromChannelBufferIfReady(T* chData)
+		// Envelope steps per second
+		double getFrameRate()
 		{
-			if (chData != NULL)
-			{
-				// Apply window function to buffer
-				for (int s = 0; s < (int)mFftSize; ++s)
-				{
-					mWindowFunction->applyFunction(chData + s * 2, s, 1, true);
-				}
+			return mSampleRate / mHopSize * mChannelCount;
+		}
 
-				// In-place calculate FFT
-				FftCalculator<T>::calculateFast(chData, mFftSize);
+		void calculateSpectrum()
+		{
+			for (size_t ch = 0; ch < mChannelCount; ++ch)
+			{
+				const T* frame = &mFrames[ch][0];
+				const T* window = &mWindow[0];
+				T* windowed = &mWindowed[0];
 
-				// Calculate frequency-magnitude pairs (omitting phase information, as we won't need it) for all frequency bins
-				for (int bin = 0; bin < (mFftSize / 2.); ++bin)
+				for (size_t s = 0; s < mFftSize; ++s)
 				{
-					T ampl = 0.;
+					windowed[s] = frame[s] * window[s];
+				}
 
-					T* ftResult = chData;
+				mFft.calculate(windowed);
 
-					// FFT bin in rectangle form
-					T mFftSin = ftResult[bin * 2];
-					T mFftCos = ftResult[bin * 2 + 1];
+				// Partial conversion to polar coordinates: we calculate radius vector length, but don't calculate angle (aka phase) as we won't need it
+				const T* re = mFft.getReal();
+				const T* im = mFft.getImag();
+				T* magnitude = &mMagnitudes[ch][0];
 
-					// http://www.dsprelated.com/showmessage/69952/1.php or see below
-					mFftSin *= 2;
-					mFftCos *= 2;
-					mFftSin /= mFftSize;
-					mFftCos /= mFftSize;
+				for (size_t bin = 0; bin < mBinCount; ++bin)
+				{
+					magnitude[bin] = std::sqrt(re[bin] * re[bin] + im[bin] * im[bin]);
+				}
+			}
 
-					// Partial conversion to polar coordinates: we calculate radius vector length, but don't calculate angle (aka phase) as we won't need it
-					T nw = std::sqrt(mFftSin * mFftSin + mFftCos * mFftCos);
+			T* smoothed = &mSmoothed[0];
 
-					ampl = std::max(nw, ampl);
+			// Time smoothing/averaging is being done here, same as EnvelopeWalker::staticProcess.
+			// Infinite release time gives a release coefficient of 1, which holds the spectrum.
+			const T attack = (T)mAttackRelease.first;
+			const T release = (T)mAttackRelease.second;
 
-					double prev = mData[bin].second;
+			for (size_t ch = 0; ch < mChannelCount; ++ch)
+			{
+				const T* magnitude = &mMagnitudes[ch][0];
 
-					// Special case - hold spectrum (aka infinite release time)
-					if (mAttackRelease.second == std::numeric_limits<double>::infinity())
-					{
-						prev = std::max(prev, ampl);
-					}
-					else // Time smoothing/averaging is being done here
-					{
-						EnvelopeWalker::staticProcess(ampl, &prev, mAttackRelease.first, mAttackRelease.second);
-					}
+				for (size_t bin = 0; bin < mBinCount; ++bin)
+				{
+					T coeff = magnitude[bin] > smoothed[bin] ? attack : release;
 
-					mData[bin].first = bin;
-					mData[bin].second = prev;
+					smoothed[bin] = coeff * (smoothed[bin] - magnitude[bin]) + magnitude[bin];
 				}
-
-				return true;
 			}
 
-			return false;
+			for (size_t bin = 0; bin < mBinCount; ++bin)
+			{
+				mData[bin].second = smoothed[bin];
+			}
 		}
 
-		std::vector<OverlappingBufferSequence<T>*> mBuffers;
+		RealFftCalculator<T> mFft;
+		std::vector<std::vector<T>> mFrames;
+		std::vector<std::vector<T>> mMagnitudes;
+		std::vector<T> mWindow;
+		std::vector<T> mWindowed;
+		std::vector<T> mSmoothed;
 		std::pair<double, double>* mData;
 		std::pair<double, double> mAttackRelease;
-		std::unique_ptr<WindowFunction<T>> mWindowFunction;
 		size_t mChannelCount;
 		size_t mFftSize;
+		size_t mHopSize;
+		size_t mBinCount;
+		size_t mFill;
 		size_t mIndex;
 		double mSampleRate;
 		double mAttackMs;
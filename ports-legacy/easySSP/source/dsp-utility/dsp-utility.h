@@ -64,6 +64,7 @@
 #include "EnvelopeWalker.h"
 #include "GonioCalculator.h"
 #include "FftCalculator.h"
+#include "RealFftCalculator.h"
 #include "SpectroCalculator.h"
 //#include "BiQuad.h"
 #include "FrequencyDomainGrid.h"
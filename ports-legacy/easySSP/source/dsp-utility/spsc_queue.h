@@ -2,16 +2,18 @@
 #define TOMATL_SPSC_QUEUE
 //#include <Windows.h>
 
-// TODO: memory fences
+#include <atomic>
+
+// The volatile accesses keep the compiler from caching the pointers, the fences order
+// them against the node contents on any CPU, not just x86
 namespace tomatl { namespace dsp {
 
 	// load with 'consume' (data-dependent) memory ordering
 template<typename T>
 T load_consume(T const* addr)
 {
-  // hardware fence is implicit on x86
   T v = *const_cast<T const volatile*>(addr);
-  //__memory_barrier(); // compiler fence
+  std::atomic_thread_fence(std::memory_order_acquire);
   return v;
 }
 
@@ -19,8 +21,7 @@ T load_consume(T const* addr)
 template<typename T>
 void store_release(T* addr, T v)
 {
-  // hardware fence is implicit on x86
- // __memory_barrier(); // compiler fence
+  std::atomic_thread_fence(std::memory_order_release);
   *const_cast<T volatile*>(addr) = v;
 }
 
@@ -35,76 +35,45 @@
 
 
 AnalogFilter::AnalogFilter (uint8 Ftype, float Ffreq, float Fq, uint8 Fstages)
-    : samplerate (44100),
-      blocksize (512)
+    : samplerate (44100)
 {
-    ismp = 0;
-    firsttime = 1;
-
     type = Ftype;
     freq = Ffreq;
     q = Fq;
     gain = 1.0;
     stages = jmin (Fstages, (uint8) MAX_ANALOG_FILTER_STAGES);
+
+    for (int i = 0; i < MAX_ANALOG_FILTER_STAGES + 1; i++)
+        svf[i].setSampleRate (samplerate);
 }
 
 AnalogFilter::~AnalogFilter()
 {
-    if (ismp) delete[] ismp;
 }
 
 void AnalogFilter::cleanup()
 {
     for (int i = 0; i < MAX_ANALOG_FILTER_STAGES + 1; i++)
-    {
-        x[i].c1 = 0.0;
-        x[i].c2 = 0.0;
-        y[i].c1 = 0.0;
-        y[i].c2 = 0.0;
-        oldx[i] = x[i];
-        oldy[i] = y[i];
-    }
-    needsinterpolation = 0;
+        svf[i].reset();
 }
 
 void AnalogFilter::prepareToPlay (float sampleRate, int samplesPerBlock)
 {
     samplerate = (int) sampleRate;
-    blocksize = samplesPerBlock;
-
-    if (ismp) delete[] ismp;
-    ismp = new float [blocksize * 2];
 
-    for (int i = 0; i < 3; i++)
-    {
-        oldc[i] = 0.0;
-        oldd[i] = 0.0;
-        c[i] = 0.0;
-        d[i] = 0.0;
-    }
+    for (int i = 0; i < MAX_ANALOG_FILTER_STAGES + 1; i++)
+        svf[i].setSampleRate (samplerate);
 
     cleanup();
-
-    firsttime = 0;
-    abovenq = 0;
-    oldabovenq = 0;
-    
-    setFreqAndQ (freq, q);
-    
-    firsttime = 1;
-    d[0] = 0; // this is not used
-    
     computeFilterCoefs();
 }
-
+
 void AnalogFilter::releaseResources()
 {
 }
 
 void AnalogFilter::computeFilterCoefs()
 {
-    float tmp;
-    float omega, sn, cs, alpha, beta;
     int zerocoefs = 0; // this is used if the freq is too high
 
     // do not allow frequencies bigger than samplerate/2
@@ -132,207 +101,86 @@ void AnalogFilter::computeFilterCoefs()
         tmpgain = pow (gain, 1.0f / (stages + 1));
     }
 
-    // most of theese are implementations of
-    // the "Cookbook formulae for audio EQ" by Robert Bristow-Johnson
+    // most of theese are the analog prototypes of
+    // the "Cookbook formulae for audio EQ" by Robert Bristow-Johnson:
+    // H(s) = (n2 s^2 + n1 s + n0) / (a s^2 + b s + 1), with s = j at freq
+    double a = 1.0, b = 1.0, n2 = 0.0, n1 = 0.0, n0 = 0.0;
+    double passGain = 0.0; // used instead if zerocoefs
+    double pole, g, poleFreq;
+
     switch (type)
     {
     case 0: // LPF 1 pole
-        if (zerocoefs == 0) tmp = exp (-2.0 * double_Pi * freq / samplerate);
-        else                tmp = 0.0;
-        c[0] = 1.0 - tmp;
-        c[1] = 0.0;
-        c[2] = 0.0;
-        d[1] = tmp;
-        d[2] = 0.0;
-        order = 1;
-        break;
     case 1: // HPF 1 pole
-        if (zerocoefs == 0) tmp = exp (-2.0 * double_Pi * freq / samplerate);
-        else                tmp = 0.0;
-        c[0] = (1.0 + tmp) / 2.0;
-        c[1] = -(1.0 + tmp) / 2.0;
-        c[2] = 0.0;
-        d[1] = tmp;
-        d[2] = 0.0;
-        order = 1;
-        break;
-    case 2: // LPF 2 poles
-        if (zerocoefs == 0)
-        {
-            omega = 2.0 * double_Pi * freq / samplerate;
-            sn = sin (omega);
-            cs = cos (omega);
-            alpha = sn / (2 * tmpq);
-            tmp = 1 + alpha;
-            c[0] = (1.0 - cs) / 2.0 / tmp;
-            c[1] = (1.0 - cs) / tmp;
-            c[2] = (1.0 - cs) / 2.0 / tmp;
-            d[1] = -2 * cs / tmp * (-1);
-            d[2] = (1 - alpha) / tmp * (-1);
-        }
-        else
+        // the pole is at exp (-2 pi freq / samplerate), the bilinear transform
+        // puts it there for a prototype pole at s = -1 at poleFreq
+        pole = zerocoefs == 0 ? exp (-2.0 * double_Pi * freq / samplerate) : 0.0;
+        g = (1.0 - pole) / (1.0 + pole);
+        poleFreq = atan (g) * samplerate / double_Pi;
+
+        for (int i = 0; i < stages + 1; i++)
         {
-            c[0] = 1.0;
-            c[1] = 0.0;
-            c[2] = 0.0;
-            d[1] = 0.0;
-            d[2] = 0.0;
+            if (type == 0) svf[i].setFirstOrder (poleFreq, g, 1.0);
+            else           svf[i].setFirstOrder (poleFreq, 1.0, 0.0);
         }
-        order = 2;
+        return;
+    case 2: // LPF 2 poles
+        b = 1.0 / tmpq;
+        n0 = 1.0;
+        passGain = 1.0;
         break;
     case 3: // HPF 2 poles
-        if (zerocoefs == 0)
-        {
-            omega = 2.0 * double_Pi * freq / samplerate;
-            sn = sin (omega);
-            cs = cos (omega);
-            alpha = sn / (2 * tmpq);
-            tmp = 1 + alpha;
-            c[0] = (1.0 + cs) / 2.0 / tmp;
-            c[1] = -(1.0 + cs) / tmp;
-            c[2] = (1.0 + cs) / 2.0 / tmp;
-            d[1] = -2 * cs / tmp * (-1);
-            d[2] = (1 - alpha) / tmp * (-1);
-        }
-        else
-        {
-            c[0] = 0.0;
-            c[1] = 0.0;
-            c[2] = 0.0;
-            d[1] = 0.0;
-            d[2] = 0.0;
-        }
-        order = 2;
+        b = 1.0 / tmpq;
+        n2 = 1.0;
+        passGain = 0.0;
         break;
     case 4: // BPF 2 poles
-        if (zerocoefs == 0)
-        {
-            omega = 2 * double_Pi * freq / samplerate;
-            sn = sin(omega);
-            cs = cos(omega);
-            alpha = sn / (2 * tmpq);
-            tmp = 1 + alpha;
-            c[0] = alpha / tmp * sqrt (tmpq + 1);
-            c[1] = 0;
-            c[2] = -alpha / tmp * sqrt (tmpq + 1);
-            d[1] = -2 * cs / tmp * (-1);
-            d[2] = (1 - alpha) / tmp * (-1);
-        }
-        else
-        {
-            c[0] = 0.0;
-            c[1] = 0.0;
-            c[2] = 0.0;
-            d[1] = 0.0;
-            d[2] = 0.0;
-        }
-        order = 2;
+        b = 1.0 / tmpq;
+        n1 = sqrt (tmpq + 1) / tmpq;
+        passGain = 0.0;
         break;
     case 5: // NOTCH 2 poles
-        if (zerocoefs == 0)
-        {
-            omega = 2.0 * double_Pi * freq / samplerate;
-            sn = sin(omega);
-            cs = cos(omega);
-            alpha = sn / (2 * sqrt (tmpq));
-            tmp = 1 + alpha;
-            c[0] = 1 / tmp;
-            c[1] = -2 * cs / tmp;
-            c[2] = 1 / tmp;
-            d[1] = -2 * cs / tmp * (-1);
-            d[2] = (1 - alpha) / tmp * (-1);
-        }
-        else
-        {
-            c[0] = 1.0;
-            c[1] = 0.0;
-            c[2] = 0.0;
-            d[1] = 0.0;
-            d[2] = 0.0;
-        }
-        order = 2;
+        b = 1.0 / sqrt (tmpq);
+        n2 = 1.0;
+        n0 = 1.0;
+        passGain = 1.0;
         break;
     case 6: // PEAK (2 poles)
-        if (zerocoefs == 0)
-        {
-            omega = 2.0 * double_Pi * freq / samplerate;
-            sn = sin(omega);
-            cs = cos(omega);
-            tmpq *= 3.0;
-            alpha = sn / (2 * tmpq);
-            tmp = 1 + alpha / tmpgain;
-            c[0] = (1.0 + alpha * tmpgain) / tmp;
-            c[1] = (-2.0 * cs) / tmp;
-            c[2] = (1.0 - alpha * tmpgain) / tmp;
-            d[1] = -2 * cs / tmp * (-1);
-            d[2] = (1 - alpha / tmpgain) / tmp * (-1);
-        }
-        else
-        {
-            c[0] = 1.0;
-            c[1] = 0.0;
-            c[2] = 0.0;
-            d[1] = 0.0;
-            d[2] = 0.0;
-        }
-        order = 2;
+        tmpq *= 3.0;
+        b = 1.0 / (tmpgain * tmpq);
+        n2 = 1.0;
+        n1 = tmpgain / tmpq;
+        n0 = 1.0;
+        passGain = 1.0;
         break;
     case 7: // Low Shelf - 2 poles
-        if (zerocoefs == 0)
-        {
-            omega = 2.0 * double_Pi * freq / samplerate;
-            sn = sin (omega);
-            cs = cos (omega);
-            tmpq = sqrt (tmpq);
-            alpha = sn / (2 * tmpq);
-            beta = sqrt (tmpgain) / tmpq;
-            tmp = (tmpgain + 1.0) + (tmpgain - 1.0) * cs + beta * sn;
-            c[0] = tmpgain * ((tmpgain + 1.0) - (tmpgain - 1.0) * cs + beta * sn) / tmp;
-            c[1] = 2.0 * tmpgain * ((tmpgain - 1.0) - (tmpgain + 1.0) * cs) / tmp;
-            c[2] = tmpgain * ((tmpgain + 1.0) - (tmpgain - 1.0) * cs - beta * sn) / tmp;
-            d[1] = -2.0 * ((tmpgain - 1.0) + (tmpgain + 1.0) * cs) / tmp * (-1);
-            d[2] = ((tmpgain + 1.0) + (tmpgain - 1.0) * cs - beta * sn) / tmp * (-1);
-        }
-        else
-        {
-            c[0] = tmpgain;
-            c[1] = 0.0;
-            c[2] = 0.0;
-            d[1] = 0.0;
-            d[2] = 0.0;
-        }
-        order = 2;
+        tmpq = sqrt (tmpq);
+        a = tmpgain;
+        b = sqrt (tmpgain) / tmpq;
+        n2 = tmpgain;
+        n1 = tmpgain * sqrt (tmpgain) / tmpq;
+        n0 = tmpgain * tmpgain;
+        passGain = tmpgain;
         break;
     case 8://High Shelf - 2 poles
-        if (zerocoefs==0)
-        {
-            omega = 2.0 * double_Pi * freq / samplerate;
-            sn = sin(omega);
-            cs = cos(omega);
-            tmpq = sqrt(tmpq);
-            alpha = sn / (2 * tmpq);
-            beta = sqrt (tmpgain) / tmpq;
-            tmp = (tmpgain + 1.0) - (tmpgain - 1.0) * cs + beta * sn;
-            c[0] = tmpgain * ((tmpgain + 1.0) + (tmpgain - 1.0) * cs + beta * sn) / tmp;
-            c[1] = -2.0 * tmpgain * ((tmpgain - 1.0) + (tmpgain + 1.0) * cs) / tmp;
-            c[2] = tmpgain * ((tmpgain + 1.0) + (tmpgain - 1.0) * cs - beta * sn) / tmp;
-            d[1] = 2.0 * ((tmpgain - 1.0) - (tmpgain + 1.0) * cs) / tmp * (-1);
-            d[2] = ((tmpgain + 1.0) - (tmpgain - 1.0) * cs - beta * sn) / tmp * (-1);
-        }
-        else
-        {
-            c[0] = 1.0;
-            c[1] = 0.0;
-            c[2] = 0.0;
-            d[1] = 0.0;
-            d[2] = 0.0;
-        }
-        order = 2;
+        tmpq = sqrt (tmpq);
+        a = 1.0 / tmpgain;
+        b = 1.0 / (sqrt (tmpgain) * tmpq);
+        n2 = tmpgain;
+        n1 = sqrt (tmpgain) / tmpq;
+        n0 = 1.0;
+        passGain = 1.0;
         break;
     default: // wrong type
         type = 0;
         computeFilterCoefs();
-        break;
+        return;
+    }
+
+    for (int i = 0; i < stages + 1; i++)
+    {
+        if (zerocoefs == 0) svf[i].setSecondOrder (freq, a, b, n2, n1, n0);
+        else                svf[i].setGain (passGain);
     }
 }
 
@@ -340,38 +188,10 @@ void AnalogFilter::setFreq (float frequency)
 {
     if (frequency < 0.1) frequency = 0.1;
 
-    float rap = freq / frequency;
-    if (rap < 1.0) rap = 1.0 / rap;
-
-    oldabovenq = abovenq;
-    abovenq = frequency > (samplerate / 2 - 500.0);
-
-    int nyquistthresh = (abovenq ^ oldabovenq);
-
-    if ((rap > 3.0) || (nyquistthresh != 0))
-    {
-        // if the frequency is changed fast, it needs interpolation
-        // (now, filter and coeficients backup)
-        for (int i = 0; i < 3; i++)
-        {
-            oldc[i] = c[i];
-            oldd[i] = d[i];
-        }
-
-        for (int i = 0; i < MAX_ANALOG_FILTER_STAGES + 1; i++)
-        {
-            oldx[i] = x[i];
-            oldy[i] = y[i];
-        }
-
-        if (firsttime == 0)
-            needsinterpolation = 1;
-    }
-
+    // the state variable filters need no crossfade when the frequency jumps
     freq = frequency;
     computeFilterCoefs();
-    firsttime = 0;
-    
+
 #if 0
     DBG ("AnalogFilter: " + String (freq));
 #endif
@@ -409,92 +229,7 @@ void AnalogFilter::setStages (int stages_)
     computeFilterCoefs();
 }
 
-void AnalogFilter::singleFilterOut (float *smp,
-                                    AnalogFilterStage &x,
-                                    AnalogFilterStage &y,
-                                    float *c,
-                                    float *d,
-                                    int numSamples)
-{
-    float y0;
-
-    if (order == 1)
-    {
-        // First order filter
-        for (int i = 0; i < numSamples; i++)
-        {
-            y0 = smp[i] * c[0] + x.c1 * c[1] + y.c1 * d[1];
-            y.c1 = y0;
-            x.c1 = smp[i];
-            // output
-            smp[i] = y0;
-        }
-    }
-    else if (order == 2)
-    {
-        // Second order filter
-        for (int i = 0; i < numSamples; i++)
-        {
-            y0 = smp[i] * c[0] + x.c1 * c[1] + x.c2 * c[2] + y.c1 * d[1] + y.c2 * d[2];
-            y.c2 = y.c1;
-            y.c1 = y0;
-            x.c2 = x.c1;
-            x.c1 = smp[i];
-            // output
-            smp[i] = y0;
-        }
-    }
-}
-
-void AnalogFilter::filterOut (float *smp, int numSamples)
-{
-    if (needsinterpolation != 0)
-    {
-        for (int i = 0; i < numSamples; i++)
-            ismp[i] = smp[i];
-        for (int i = 0; i < stages + 1; i++)
-            singleFilterOut (ismp, oldx[i], oldy[i], oldc, oldd, numSamples);
-    }
-
-    for (int i = 0; i < stages + 1; i++)
-        singleFilterOut (smp, x[i], y[i], c, d, numSamples);
-
-    if (needsinterpolation != 0)
-    {
-        float samplesInv = 1.0f / (float) numSamples;
-        
-        for (int i = 0; i < numSamples; i++)
-        {
-            float x = i * samplesInv;
-            smp[i] = ismp[i] * (1.0 - x) + smp[i] * x;
-        }
-
-        needsinterpolation = 0;
-    }
-}
-
 float AnalogFilter::H (float freq)
 {
-    float fr = freq / samplerate * double_Pi * 2.0;
-
-    float x = c[0], y = 0.0;
-    for (int n = 1; n < 3; n++)
-    {
-        x += cos (n * fr) * c[n];
-        y -= sin (n * fr) * c[n];
-    }
-
-    float h = x * x + y * y;
-    x = 1.0;
-    y = 0.0;
-    for (int n = 1; n < 3; n++)
-    {
-        x -= cos (n * fr) * d[n];
-        y += sin (n * fr) * d[n];
-    }
-    
-    h = h / (x * x + y * y);
-
-    return pow (h, (stages + 1.0f) / 2.0f);
+    return pow (svf[0].getMagnitudeResponse (freq), stages + 1.0f);
 }
-
@@ -35,9 +35,15 @@
 #define __JUCETICE_ANALOGFILTER_HEADER__
 
 #include "../StandardHeader.h"
+#include "JucePluginFilters.h"
 
 #define MAX_ANALOG_FILTER_STAGES  2
 
+/**
+    State variable filters with the responses of the cookbook biquads, for
+    both channels at once. They stay smooth while their parameters change,
+    and their coefficients are only computed again when a parameter does.
+*/
 class AnalogFilter
 {
 public:
@@ -48,7 +54,13 @@ public:
     void prepareToPlay (float sampleRate, int samplesPerBlock);
     void releaseResources();
     
-    void filterOut (float *smp, int numSamples);
+    // Filters one sample of both channels, the left one in lane 0, the right one in lane 1
+    JucePluginFilterLanes filterSample (JucePluginFilterLanes smp)
+    {
+        for (int i = 0; i < stages + 1; i++)
+            smp = svf[i].processSample (smp);
+        return smp;
+    }
 
     void setFreq (float frequency);
     void setFreqAndQ (float frequency, float q);
@@ -64,37 +76,16 @@ public:
 
 private:
 
-    struct AnalogFilterStage {
-      float c1, c2;
-    } x[MAX_ANALOG_FILTER_STAGES + 1],
-      y[MAX_ANALOG_FILTER_STAGES + 1],
-      oldx[MAX_ANALOG_FILTER_STAGES + 1],
-      oldy[MAX_ANALOG_FILTER_STAGES + 1];
-
-    void singleFilterOut (float *smp,
-                          AnalogFilterStage &x,
-                          AnalogFilterStage &y,
-                          float *c,
-                          float *d,
-                          int numSamples);
-
     void computeFilterCoefs ();
 
+    JucePluginSvf svf [MAX_ANALOG_FILTER_STAGES + 1]; // one per stage, the same response in all
+
     int type;                         // The type of the filter (LPF1,HPF1,LPF2,HPF2...)
     int stages;                       // how many times the filter is applied (0->1,1->2,etc.)
-    int order;                        // the order of the filter (number of poles)
     float freq;                       // Frequency given in Hz
     float q;                          // Q factor (resonance or Q factor)
     float gain;                       // the gain of the filter (if are shelf/peak) filters
-    float c[3],d[3];                  // coefficients
-    float oldc[3],oldd[3];            // old coefficients(used only if some filter paremeters changes very fast, and it needs interpolation)
-    float xd[3],yd[3];                // used if the filter is applied more times
-    float *ismp;                      // used if it needs interpolation
-    //float outgain;
-    int samplerate, blocksize;
-    int needsinterpolation, firsttime;
-    int abovenq;                      // this is 1 if the frequency is above the nyquist
-    int oldabovenq;                   // if the last time was above nyquist (used to see if it needs interpolation)
+    int samplerate;
 };
 
 
@@ -47,8 +47,7 @@ Equalizer::Equalizer (int insertion_)
         filter[i].Pgain = 64;
         filter[i].Pq = 64;
         filter[i].Pstages = 0;
-        filter[i].l = new AnalogFilter (6, 1000.0, 1.0, 0);
-        filter[i].r = new AnalogFilter (6, 1000.0, 1.0, 0);
+        filter[i].lr = new AnalogFilter (6, 1000.0, 1.0, 0);
     }
 
     //default values
@@ -64,8 +63,7 @@ Equalizer::~Equalizer()
 {
     for (int i = 0; i < MAX_EQ_BANDS; i++)
     {
-        delete filter[i].l;
-        delete filter[i].r;
+        delete filter[i].lr;
     }
 }
 
@@ -73,10 +71,7 @@ Equalizer::~Equalizer()
 void Equalizer::clean()
 {
     for (int i = 0; i < MAX_EQ_BANDS; i++)
-    {
-        filter[i].l->cleanup();
-        filter[i].r->cleanup();
-    }
+        filter[i].lr->cleanup();
 }
 
 //==============================================================================
@@ -85,19 +80,13 @@ void Equalizer::prepareToPlay (float sampleRate_, int samplesPerBlock_)
     sampleRate = sampleRate_;
 
     for (int i = 0; i < MAX_EQ_BANDS; i++)
-    {
-        filter[i].l->prepareToPlay (sampleRate_, samplesPerBlock_);
-        filter[i].r->prepareToPlay (sampleRate_, samplesPerBlock_);
-    }
+        filter[i].lr->prepareToPlay (sampleRate_, samplesPerBlock_);
 }
 
 void Equalizer::releaseResources ()
 {
     for (int i = 0; i < MAX_EQ_BANDS; i++)
-    {
-        filter[i].l->releaseResources ();
-        filter[i].r->releaseResources ();
-    }
+        filter[i].lr->releaseResources ();
 }
 
 //==============================================================================
@@ -115,11 +104,27 @@ void Equalizer::out (const float *insmpsl,
         smpsr[i] = insmpsr[i] * volume;
     }
 
+    AnalogFilter* bands [MAX_EQ_BANDS];
+    int numBands = 0;
+
     for (int i = 0; i < MAX_EQ_BANDS; i++)
     {
         if (filter[i].Ptype == 0) continue;
-        filter[i].l->filterOut (smpsl, numSamples);
-        filter[i].r->filterOut (smpsr, numSamples);
+        bands [numBands++] = filter[i].lr;
+    }
+
+    // each sample goes through all bands before the next one, so the CPU
+    // can work on several bands at once instead of waiting on one
+    float* const smps[2] = { smpsl, smpsr };
+
+    for (int i = 0; i < numSamples; i++)
+    {
+        JucePluginFilterLanes smp = JucePluginFilterLanes::fromChannels (smps, 2, i);
+
+        for (int n = 0; n < numBands; n++)
+            smp = bands[n]->filterSample (smp);
+
+        smp.toChannels (smps, 2, i);
     }
 
     for (int i = 0; i < numSamples; i++)
@@ -149,30 +154,23 @@ void Equalizer::setParameter (int npar, uint8 value)
     case 0: if (value > 9) value = 0; // has to be changed if more filters will be added
             filter[nb].Ptype = value;
             if (value != 0)
-            {
-                filter[nb].l->setType (value - 1);
-                filter[nb].r->setType (value - 1);
-            }
+                filter[nb].lr->setType (value - 1);
             break;
     case 1: filter[nb].Pfreq = value;
             tmp = 600.0 * pow (30.0,(value - 64.0) / 64.0);
-            filter[nb].l->setFreq (tmp);
-            filter[nb].r->setFreq (tmp);
+            filter[nb].lr->setFreq (tmp);
             break;
     case 2: filter[nb].Pgain = value;
             tmp = 30.0 * (value - 64.0) / 82.0; // original was: - 64.0) / 64.0
-            filter[nb].l->setGain (tmp);
-            filter[nb].r->setGain (tmp);
+            filter[nb].lr->setGain (tmp);
             break;
     case 3: filter[nb].Pq = value;
             tmp = pow (30.0, (value - 64.0) / 64.0);
-            filter[nb].l->setQ (tmp);
-            filter[nb].r->setQ (tmp);
+            filter[nb].lr->setQ (tmp);
             break;
     case 4: value = jmin (value, (uint8) MAX_ANALOG_FILTER_STAGES);
             filter[nb].Pstages = value;
-            filter[nb].l->setStages (value);
-            filter[nb].r->setStages (value);
+            filter[nb].lr->setStages (value);
             break;
     }
 }
@@ -284,7 +282,7 @@ float Equalizer::getFrequencyResponse (float freq)
     for (int i = 0; i < MAX_EQ_BANDS; i++)
     {
         if (filter[i].Ptype == 0) continue;
-        resp *= filter[i].l->H (freq);
+        resp *= filter[i].lr->H (freq);
     }
     return 20 * log (resp * outvolume) / double_Log10;
 }
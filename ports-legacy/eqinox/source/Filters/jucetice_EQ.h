@@ -85,7 +85,7 @@ private:
 
     struct {
         uint8 Ptype, Pfreq, Pgain, Pq, Pstages;
-        AnalogFilter *l, *r;
+        AnalogFilter *lr; // both channels
     }filter [MAX_EQ_BANDS];
 };
 
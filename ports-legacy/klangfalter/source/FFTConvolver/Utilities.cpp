@@ -17,6 +17,8 @@
 
 #include "Utilities.h"
 
+#include "JucePluginCpuDispatch.h"
+
 
 namespace fftconvolver
 {
@@ -31,6 +33,7 @@ bool SSEEnabled()
 }
 
 
+JUCE_PLUGIN_CPU_DISPATCH_CLONES
 void Sum(Sample* FFTCONVOLVER_RESTRICT result,
          const Sample* FFTCONVOLVER_RESTRICT a,
          const Sample* FFTCONVOLVER_RESTRICT b,
@@ -59,6 +62,7 @@ void ComplexMultiplyAccumulate(SplitComplex& result, const SplitComplex& a, cons
 }
 
 
+JUCE_PLUGIN_CPU_DISPATCH_CLONES
 void ComplexMultiplyAccumulate(Sample* FFTCONVOLVER_RESTRICT re, 
                                Sample* FFTCONVOLVER_RESTRICT im,
                                const Sample* FFTCONVOLVER_RESTRICT reA,
@@ -67,7 +71,8 @@ void ComplexMultiplyAccumulate(Sample* FFTCONVOLVER_RESTRICT re,
                                const Sample* FFTCONVOLVER_RESTRICT imB,
                                const size_t len)
 {
-#if defined(FFTCONVOLVER_USE_SSE)
+  // with cpu-dispatch the plain loop below is vectorised for each CPU level instead
+#if defined(FFTCONVOLVER_USE_SSE) && ! JUCE_PLUGIN_CPU_DISPATCH
   const size_t end4 = 4 * (len / 4);
   for (size_t i=0; i<end4; i+=4)
   {
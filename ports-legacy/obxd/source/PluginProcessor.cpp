@@ -640,7 +640,6 @@ void ObxdAudioProcessor::processBlock (AudioSampleBuffer& buffer, MidiBuffer& mi
 	MidiBuffer::Iterator ppp(midiMessages);
 	hasMidiMessage = ppp.getNextEvent(nextMidi,midiEventPos);
 
-	int samplePos = 0;
 	int numSamples = buffer.getNumSamples();
 	float* channelData1 = buffer.getWritePointer(0);
 	float* channelData2 = buffer.getWritePointer(1);
@@ -651,11 +650,20 @@ void ObxdAudioProcessor::processBlock (AudioSampleBuffer& buffer, MidiBuffer& mi
 		synth.setPlayHead(pos.bpm,pos.ppqPosition);
     }
 
+	processSamples(&ppp,channelData1,channelData2,numSamples);
+}
+
+// the whole engine is inlined here, compiled once per CPU level with cpu-dispatch
+JUCE_PLUGIN_CPU_DISPATCH_CLONES
+void ObxdAudioProcessor::processSamples(MidiBuffer::Iterator* iter,float* left,float* right,const int numSamples)
+{
+	int samplePos = 0;
+
 	while (samplePos < numSamples)
 	{
-		processMidiPerSample(&ppp,samplePos);
+		processMidiPerSample(iter,samplePos);
 
-		synth.processSample(channelData1+samplePos,channelData2+samplePos);
+		synth.processSample(left+samplePos,right+samplePos);
 
 		samplePos++;
 	}
@@ -26,6 +26,7 @@
 #define PLUGINPROCESSOR_H_INCLUDED
 
 #include "JuceHeader.h"
+#include "JucePluginCpuDispatch.h"
 #include "Engine/SynthEngine.h"
 //#include <stack>
 #include "Engine/midiMap.h"
@@ -136,6 +137,7 @@ public:
 	//==============================================================================
 	void processMidiPerSample(MidiBuffer::Iterator* iter,const int samplePos);
 	bool getNextEvent(MidiBuffer::Iterator* iter,const int samplePos);
+	void processSamples(MidiBuffer::Iterator* iter,float* left,float* right,const int numSamples);
 
 	//==============================================================================
 	void initAllParams();
@@ -316,6 +316,8 @@ void PitchedDelayAudioProcessor::prepareToPlay (double sampleRate, int samplesPe
 		dsp->prepareToPlay((double) dspSR, samplesPerBlock);
 	}
 
+	tapFilters.prepareToPlay(2 * NUMDELAYTABS, samplesPerBlock);
+
 
 	const int latency = delays[0]->getLatencySamples() / underSampling;
 	setLatencySamples(latency);
@@ -357,17 +359,23 @@ void PitchedDelayAudioProcessor::processBlock (AudioSampleBuffer& buffer, MidiBu
 			dspProcR = osBufferR[i+1];
 		}
 
+		// the tabs run up to their EQ one by one, then all EQs together, then the rest
+		tapFilters.clear();
+
 		for (int i=0; i<NUMDELAYTABS; ++i)
 		{
 			DelayTabDsp* dsp = delays[i];
-			dsp->processBlock(dspProcL, dspProcR, blockSize);
+			dsp->processBlockBeforeFilter(dspProcL, dspProcR, blockSize);
+			dsp->addFilters(tapFilters);
 		}
 
-		for (int n=0; n<blockSize; ++n)
-		{
-			dspProcL[n] = 0;
-			dspProcR[n] = 0;
-		}
+		tapFilters.processBlock(blockSize);
+
+		for (int i=0; i<NUMDELAYTABS; ++i)
+			delays.getUnchecked(i)->processBlockAfterFilter(blockSize);
+
+		FloatVectorOperations::clear(dspProcL, blockSize);
+		FloatVectorOperations::clear(dspProcR, blockSize);
 
 		for (int i=0; i<NUMDELAYTABS; ++i)
 		{
@@ -376,14 +384,8 @@ void PitchedDelayAudioProcessor::processBlock (AudioSampleBuffer& buffer, MidiBu
 			if (! dsp->isEnabled())
 				continue;
 
-			const float* procL = dsp->getLeftData();
-			const float* procR = dsp->getRightData();
-
-			for (int n=0; n<blockSize; ++n)
-			{
-				dspProcL[n] += procL[n];
-				dspProcR[n] += procR[n];
-			}
+			FloatVectorOperations::add(dspProcL, dsp->getLeftData(), blockSize);
+			FloatVectorOperations::add(dspProcR, dsp->getRightData(), blockSize);
 		}
 
 		for (int i=upSamplers.size()-1; i >= 0; --i)
@@ -122,6 +122,7 @@ private:
 	SampleDelay latencyCompensation;
 
 	OwnedArray<DelayTabDsp> delays;
+	TapFilterBank tapFilters;
 
 	OwnedArray<DownSampler2x> downSamplers;
 	OwnedArray<UpSampler2x> upSamplers;
@@ -3,6 +3,8 @@
 
 #include "JuceHeader.h"
 
+#include <atomic>
+
 class PitchBase 
 {
 public:
@@ -25,11 +27,14 @@ protected:
 };
 
 
+// The active pitch algorithm is swapped RCU style: processBlock only loads
+// the pointer and never waits, setPitchProc publishes the new one and then
+// waits for a running processBlock to finish before it clears the old one.
 class PitchProcessor
 {
 public:
 	PitchProcessor() 
-		: currentPitch(-1), pitch(1.f)
+		: currentPitch(-1), pitch(1.f), activePitch(nullptr), processCount(0)
 	{
 	}
 
@@ -47,9 +52,8 @@ public:
 
 	void processBlock(float* chL, float* chR, int numSamples)
 	{
-		PitchBase* p = pitchProcs[currentPitch];
-
-		ScopedLock lock(processLock);
+		const ProcessScope scope(processCount);
+		PitchBase* p = activePitch.load();
 
 		if (p != 0)
 			p->processBlock(chL, chR, numSamples);
@@ -57,9 +61,8 @@ public:
 
 	void processBlock(float* ch, int numSamples)
 	{
-		PitchBase* p = pitchProcs[currentPitch];
-
-		ScopedLock lock(processLock);
+		const ProcessScope scope(processCount);
+		PitchBase* p = activePitch.load();
 
 		if (p != 0)
 			p->processBlock(ch, numSamples);
@@ -68,7 +71,7 @@ public:
 
 	int getLatency()
 	{
-		PitchBase* p = pitchProcs[currentPitch];
+		PitchBase* p = activePitch.load();
 
 		if (p != 0)
 			return p->getLatency();
@@ -107,16 +110,26 @@ public:
 	{
 		jassert(index >= -1 && index < pitchProcs.size());
 
-		PitchBase* p = pitchProcs[currentPitch];
+		// only other callers of setPitchProc wait here, never the audio thread
+		const ScopedLock lock(switchLock);
 
 		if (index != currentPitch)
 		{
-			ScopedLock lock(processLock);
+			PitchBase* p = activePitch.exchange(pitchProcs[index]);
+			currentPitch = index;
+
+			// grace period: a processBlock that may still use the old one is done
+			// once the count has moved on from an odd value
+			const unsigned int count = processCount.load();
+
+			if ((count & 1) != 0)
+			{
+				while (processCount.load() == count)
+					Thread::yield();
+			}
 
 			if (p != nullptr)
 				p->clear();
-
-			currentPitch = index;
 		}
 	}
 
@@ -152,12 +165,24 @@ public:
 	}
 
 private:
+	// makes processCount odd while processBlock runs
+	struct ProcessScope
+	{
+		ProcessScope(std::atomic<unsigned int>& c) : count(c) { count.fetch_add(1); }
+		~ProcessScope() { count.fetch_add(1, std::memory_order_release); }
+
+		std::atomic<unsigned int>& count;
+	};
+
 	OwnedArray<PitchBase> pitchProcs;
 	int currentPitch;
 
 	float pitch;
 
-	CriticalSection processLock;
+	std::atomic<PitchBase*> activePitch;
+	std::atomic<unsigned int> processCount;
+
+	CriticalSection switchLock;
 
 };
 
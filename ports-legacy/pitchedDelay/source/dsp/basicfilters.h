@@ -347,6 +347,8 @@ public:
 
 protected:
 
+	friend class TapFilterBank;
+
 	double sampleRate;
 	double a1, a2, b0, b1, b2;
 	double x1, x2, y1, y2;
@@ -12,6 +12,8 @@ DelayTabDsp::DelayTabDsp(const String& id)
 	preVolume(0),
 	enabled(false),
 	mode(kMono),
+	blockEnabled(false),
+	blockMode(kMono),
 	sync(0),
 	dataSize(0)
 {
@@ -210,25 +212,42 @@ void DelayTabDsp::clearData()
 	}
 }
 
-void DelayTabDsp::processBlock(const float* inL, const float* inR, int numSamples)
+void DelayTabDsp::processBlockBeforeFilter(const float* inL, const float* inR, int numSamples)
 {
 
 	checkDataSize(numSamples);
 
-	if (! enabled)
+	blockEnabled = enabled;
+	blockMode = mode;
+
+	if (! blockEnabled)
 		return;
 
-	if (mode != kMono)
-		processStereo(inL, inR, numSamples);
+	if (blockMode != kMono)
+		processStereoBeforeFilter(inL, inR, numSamples);
 	else
-		processMono(inL, inR, numSamples);
+		processMonoBeforeFilter(inL, inR, numSamples);
 }
 
-void DelayTabDsp::processMono(const float* inL, const float* inR, int numSamples)
+void DelayTabDsp::addFilters(TapFilterBank& bank)
 {
-	const float gainLeft = cos(float_Pi * (panning + 100.f)/400.f) * sqrt(2.f);
-	const float gainRight = sin(float_Pi * (panning + 100.f)/400.f) * sqrt(2.f);
+	if (blockEnabled)
+		delay.addFilters(bank, dataL, blockMode != kMono ? dataR.getData() : nullptr);
+}
+
+void DelayTabDsp::processBlockAfterFilter(int numSamples)
+{
+	if (! blockEnabled)
+		return;
 
+	if (blockMode != kMono)
+		processStereoAfterFilter(numSamples);
+	else
+		processMonoAfterFilter(numSamples);
+}
+
+void DelayTabDsp::processMonoBeforeFilter(const float* inL, const float* inR, int numSamples)
+{
 	for (int i=0; i<numSamples; ++i)
 		dataL[i] = 0.5f * (inL[i] + inR[i]);
 
@@ -240,7 +259,15 @@ void DelayTabDsp::processMono(const float* inL, const float* inR, int numSamples
 			dataPreL[i] = dataL[i];
 	}
 
-	delay.processBlock(dataL, numSamples);
+	delay.processBlockBeforeFilter(dataL, numSamples);
+}
+
+void DelayTabDsp::processMonoAfterFilter(int numSamples)
+{
+	const float gainLeft = cos(float_Pi * (panning + 100.f)/400.f) * sqrt(2.f);
+	const float gainRight = sin(float_Pi * (panning + 100.f)/400.f) * sqrt(2.f);
+
+	delay.processBlockAfterFilter(dataL, numSamples);
 
 	if (preDelayL.getDelayLengthSeconds() > 0)
 	{
@@ -265,15 +292,12 @@ void DelayTabDsp::processMono(const float* inL, const float* inR, int numSamples
 	}
 }
 
-void DelayTabDsp::processStereo(const float* inL, const float* inR, int numSamples)
+void DelayTabDsp::processStereoBeforeFilter(const float* inL, const float* inR, int numSamples)
 {
-	const bool pingPong = delay.getPingPong();
+	const bool pingPong = blockMode == kPingpong;
 	const float inGainL = pingPong && panning > 0 ? 1.f - panning/ 100.f : 1.f;
 	const float inGainR = pingPong && panning < 0 ? 1.f - (-panning)/ 100.f : 1.f;
 
-	const float outGainL = ! pingPong && panning > 0 ? 1.f - panning/ 100.f : 1.f;
-	const float outGainR = ! pingPong && panning < 0 ? 1.f - (-panning)/ 100.f : 1.f;
-
 	for (int i=0; i<numSamples; ++i)
 	{
 		dataL[i] = inL[i] * inGainL;
@@ -292,7 +316,16 @@ void DelayTabDsp::processStereo(const float* inL, const float* inR, int numSampl
 		}
 	}
 
-	delay.processBlock(dataL, dataR, numSamples);
+	delay.processBlockBeforeFilter(dataL, dataR, numSamples);
+}
+
+void DelayTabDsp::processStereoAfterFilter(int numSamples)
+{
+	const bool pingPong = blockMode == kPingpong;
+	const float outGainL = ! pingPong && panning > 0 ? 1.f - panning/ 100.f : 1.f;
+	const float outGainR = ! pingPong && panning < 0 ? 1.f - (-panning)/ 100.f : 1.f;
+
+	delay.processBlockAfterFilter(dataL, dataR, numSamples);
 
 	if (preDelayL.getDelayLengthSeconds() > 0 && preVolume > -60)
 	{
@@ -60,7 +60,11 @@ public:
 
 	void prepareToPlay(double sampleRate, int numSamples);
 
-	void processBlock(const float* inL, const float* inR, int numSamples);
+	// split around the EQ like PitchedDelay, the processor runs the EQs of
+	// all tabs in one TapFilterBank
+	void processBlockBeforeFilter(const float* inL, const float* inR, int numSamples);
+	void addFilters(TapFilterBank& bank);
+	void processBlockAfterFilter(int numSamples);
 
 	Range<double> getCurrentDelayRange()
 	{
@@ -82,8 +86,10 @@ private:
 
 	void clearData();
 	void checkDataSize(int numSamples);
-	void processMono(const float* inL, const float* inR, int numSamples);
-	void processStereo(const float* inL, const float* inR, int numSamples);
+	void processMonoBeforeFilter(const float* inL, const float* inR, int numSamples);
+	void processMonoAfterFilter(int numSamples);
+	void processStereoBeforeFilter(const float* inL, const float* inR, int numSamples);
+	void processStereoAfterFilter(int numSamples);
 
 	SimpleDelay preDelayL;
 	SimpleDelay preDelayR;
@@ -99,6 +105,10 @@ private:
 
 	Mode mode;
 
+	// enabled and mode as of processBlockBeforeFilter, for the rest of the block
+	bool blockEnabled;
+	Mode blockMode;
+
 	double sync;
 
 	HeapBlock<float> dataL;
@@ -14,7 +14,8 @@ PitchedDelay::PitchedDelay(float samplerate)
 		currentTime(2),
 		delayL(MAXDELAYSECONDS),
 		delayR(MAXDELAYSECONDS),
-		sizeLastData(0)
+		sizeLastData(0),
+		blockPingPong(false)
 {
 #if 0
 	pitcher.addPitchProc(new PitchDiracLE(PitchDiracLE::kPreview));
@@ -137,7 +138,7 @@ int PitchedDelay::getLatencyWhenPrePitched()
 	return pitcher.getLatency();
 }
 
-void PitchedDelay::processBlock(float* data, int numSamples)
+void PitchedDelay::processBlockBeforeFilter(float* data, int numSamples)
 {
 	if (preDelayPitch)
 	{
@@ -155,17 +156,6 @@ void PitchedDelay::processBlock(float* data, int numSamples)
 			data[i] = data[i] + lastDataL[i]*feedback;
 
 		delayL.processBlock(data, numSamples);
-
-		filterL.processBlock(data, numSamples);
-
-		for (int i=0; i<numSamples; ++i)
-		{
-			if (data[i] < 1e-8 && data[i] > -1e-8)
-				data[i] = 0;
-
-			lastDataL[i] = data[i];
-		}
-		dcBlock.processBlock(lastDataL, numSamples);
 	}
 	else
 	{
@@ -185,23 +175,13 @@ void PitchedDelay::processBlock(float* data, int numSamples)
 		}
 
 		delayL.processBlock(data, numSamples);
-
-		filterL.processBlock(data, numSamples);
-
-		for (int i=0; i<numSamples; ++i)
-		{
-			if (data[i] < 1e-8 && data[i] > -1e-8)
-				data[i] = 0;
-
-			lastDataL[i] = data[i];
-			jassert(fabs(data[i]) < 1e3);
-		}
-		dcBlock.processBlock(lastDataL, numSamples);
 	}
 }
 
-void PitchedDelay::processBlock(float* dataL, float* dataR, int numSamples)
+void PitchedDelay::processBlockBeforeFilter(float* dataL, float* dataR, int numSamples)
 {
+	blockPingPong = pingpong;
+
 	if (preDelayPitch)
 	{
 		if (enablePitch)
@@ -214,7 +194,7 @@ void PitchedDelay::processBlock(float* dataL, float* dataR, int numSamples)
 			unpitchedDelay.processBlock(dataL, dataR, numSamples);
 		}
 
-		if (pingpong)		
+		if (blockPingPong)		
 		{
 			for (int i=0; i<numSamples; ++i)
 			{
@@ -235,46 +215,13 @@ void PitchedDelay::processBlock(float* dataL, float* dataR, int numSamples)
 
 		delayL.processBlock(dataL, numSamples);
 		delayR.processBlock(dataR, numSamples);
-
-		filterL.processBlock(dataL, numSamples);
-		filterR.processBlock(dataR, numSamples);
-
-		if (pingpong)
-		{
-			for (int i=0; i<numSamples; ++i)
-			{
-				if (dataL[i] < 1e-8 && dataL[i] > -1e-8)
-					dataL[i] = 0;
-
-				if (dataR[i] < 1e-8 && dataR[i] > -1e-8)
-					dataR[i] = 0;
-
-				lastDataL[i] = dataR[i];
-				lastDataR[i] = dataL[i];
-			}
-		}
-		else
-		{
-			for (int i=0; i<numSamples; ++i)
-			{
-				if (dataL[i] < 1e-8 && dataL[i] > -1e-8)
-					dataL[i] = 0;
-
-				if (dataR[i] < 1e-8 && dataR[i] > -1e-8)
-					dataR[i] = 0;
-
-				lastDataL[i] = dataL[i];
-				lastDataR[i] = dataR[i];
-			}
-		}
-		dcBlock.processBlock(lastDataL, lastDataR, numSamples);
 	}
 	else // ! preDelayPitch
 	{
 		latencyCompensation.processBlock(dataL, dataR, numSamples);
 
 
-		if (pingpong)
+		if (blockPingPong)
 		{
 			for (int i=0; i<numSamples; ++i)
 			{
@@ -307,40 +254,61 @@ void PitchedDelay::processBlock(float* dataL, float* dataR, int numSamples)
 
 		delayL.processBlock(dataL, numSamples);
 		delayR.processBlock(dataR, numSamples);
+	}
+}
+
+void PitchedDelay::addFilters(TapFilterBank& bank, float* dataL, float* dataR)
+{
+	bank.add(filterL, dataL);
+
+	if (dataR != nullptr)
+		bank.add(filterR, dataR);
+}
 
-		filterL.processBlock(dataL, numSamples);
-		filterR.processBlock(dataR, numSamples);
+void PitchedDelay::processBlockAfterFilter(float* data, int numSamples)
+{
+	for (int i=0; i<numSamples; ++i)
+	{
+		if (data[i] < 1e-8 && data[i] > -1e-8)
+			data[i] = 0;
 
-		if (pingpong)
+		lastDataL[i] = data[i];
+		jassert(fabs(data[i]) < 1e3);
+	}
+	dcBlock.processBlock(lastDataL, numSamples);
+}
+
+void PitchedDelay::processBlockAfterFilter(float* dataL, float* dataR, int numSamples)
+{
+	if (blockPingPong)
+	{
+		for (int i=0; i<numSamples; ++i)
 		{
-			for (int i=0; i<numSamples; ++i)
-			{
-				if (dataL[i] < 1e-8 && dataL[i] > -1e-8)
-					dataL[i] = 0;
+			if (dataL[i] < 1e-8 && dataL[i] > -1e-8)
+				dataL[i] = 0;
 
-				if (dataR[i] < 1e-8 && dataR[i] > -1e-8)
-					dataR[i] = 0;
+			if (dataR[i] < 1e-8 && dataR[i] > -1e-8)
+				dataR[i] = 0;
 
-				lastDataL[i] = dataR[i];
-				lastDataR[i] = dataL[i];
-			}
+			lastDataL[i] = dataR[i];
+			lastDataR[i] = dataL[i];
 		}
-		else
+	}
+	else
+	{
+		for (int i=0; i<numSamples; ++i)
 		{
-			for (int i=0; i<numSamples; ++i)
-			{
-				if (dataL[i] < 1e-8 && dataL[i] > -1e-8)
-					dataL[i] = 0;
+			if (dataL[i] < 1e-8 && dataL[i] > -1e-8)
+				dataL[i] = 0;
 
-				if (dataR[i] < 1e-8 && dataR[i] > -1e-8)
-					dataR[i] = 0;
+			if (dataR[i] < 1e-8 && dataR[i] > -1e-8)
+				dataR[i] = 0;
 
-				lastDataL[i] = dataL[i];
-				lastDataR[i] = dataR[i];
-			}
+			lastDataL[i] = dataL[i];
+			lastDataR[i] = dataR[i];
 		}
-		dcBlock.processBlock(lastDataL, lastDataR, numSamples);
 	}
+	dcBlock.processBlock(lastDataL, lastDataR, numSamples);
 }
 
 void PitchedDelay::setFeedback(float newFeedback)
@@ -3,6 +3,7 @@
 
 #include "simpledelay.h"
 #include "basicfilters.h"
+#include "tapfilterbank.h"
 #include "../parameters.h"
 //#include "pitchsoundtouch.h"
 #include "PitchBase.h"
@@ -30,8 +31,15 @@ public:
 	Range<double> getDelayRangePrePitch();
 	Range<double> getCurrentDelayRange();
 	int getLatencyWhenPrePitched();
-	void processBlock(float* data, int numSamples);
-	void processBlock(float* dataL, float* dataR, int numSamples);
+
+	// a block is processed in two halves, with the filters in between, so
+	// that the filters of several delays can run together (see TapFilterBank)
+	void processBlockBeforeFilter(float* data, int numSamples);
+	void processBlockBeforeFilter(float* dataL, float* dataR, int numSamples);
+	void addFilters(TapFilterBank& bank, float* dataL, float* dataR);
+	void processBlockAfterFilter(float* data, int numSamples);
+	void processBlockAfterFilter(float* dataL, float* dataR, int numSamples);
+
 	void setFeedback(float newFeedback);
 	float getFeedback();
 	void setGain(double gain);
@@ -84,6 +92,8 @@ private:
 	SampleDelay latencyCompensation;
 	SampleDelay unpitchedDelay;
 
+	bool blockPingPong;
+
 };
 
 
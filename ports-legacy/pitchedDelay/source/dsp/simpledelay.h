@@ -37,18 +37,29 @@ public:
 	}
 
 
+	// swaps runs of samples with the buffer, up to the wrap point each
 	void processBlock(float* proc, int numSamples)
 	{
 		if (length == 0)
 			return;
 
-		for (int i=0; i<numSamples; ++i)
+		while (numSamples > 0)
 		{
-			const float x = proc[i];
-			proc[i] = dataL[position];
-			dataL[position] = x;
+			const int num = jmin(numSamples, length - position);
+			float* const d = dataL + position;
 
-			if (++position >= length)
+			for (int i=0; i<num; ++i)
+			{
+				const float x = proc[i];
+				proc[i] = d[i];
+				d[i] = x;
+			}
+
+			proc += num;
+			numSamples -= num;
+			position += num;
+
+			if (position >= length)
 				position = 0;
 		}
 
@@ -59,16 +70,28 @@ public:
 		if (length == 0)
 			return;
 
-		for (int i=0; i<numSamples; ++i)
+		while (numSamples > 0)
 		{
-			const float l = procL[i];
-			const float r = procR[i];
-			procL[i] = dataL[position];
-			procR[i] = dataR[position];
-			dataL[position] = l;
-			dataR[position] = r;
-
-			if (++position >= length)
+			const int num = jmin(numSamples, length - position);
+			float* const dL = dataL + position;
+			float* const dR = dataR + position;
+
+			for (int i=0; i<num; ++i)
+			{
+				const float l = procL[i];
+				const float r = procR[i];
+				procL[i] = dL[i];
+				procR[i] = dR[i];
+				dL[i] = l;
+				dR[i] = r;
+			}
+
+			procL += num;
+			procR += num;
+			numSamples -= num;
+			position += num;
+
+			if (position >= length)
 				position = 0;
 		}
 
@@ -127,23 +150,43 @@ public:
 
 	void processBlock(float* in, int numSamples)
 	{
-		for (int i=0; i<numSamples; ++i)
+		const int d = delay;
+
+		if (d == 0)
 		{
-			data[currentPos] = in[i];
+			// the output is the input, only keep it in the buffer
+			write(in, numSamples);
+			return;
+		}
 
-			{
-				int outPos = currentPos - delay;
-				while (outPos < 0)
-					outPos += dataLength;
+		int outPos = currentPos - d;
+		if (outPos < 0)
+			outPos += dataLength;
 
-				in[i] = data[outPos];
+		while (numSamples > 0)
+		{
+			// runs that don't wrap and are at most the delay long, so that the loop vectorises
+			const int num = jmin(numSamples, jmin(dataLength - currentPos, dataLength - outPos, d));
+			float* const w = data + currentPos;
+			const float* const r = data + outPos;
 
+			for (int i=0; i<num; ++i)
+			{
+				const float x = in[i];
+				in[i] = r[i];
+				w[i] = x;
 			}
 
-			++currentPos;
+			in += num;
+			numSamples -= num;
+			currentPos += num;
+			outPos += num;
 
-			while (currentPos >= dataLength)
-				currentPos -= dataLength;
+			if (currentPos >= dataLength)
+				currentPos = 0;
+
+			if (outPos >= dataLength)
+				outPos = 0;
 		}
 	}
 
@@ -183,6 +226,22 @@ public:
 
 private:
 
+	void write(const float* in, int numSamples)
+	{
+		while (numSamples > 0)
+		{
+			const int num = jmin(numSamples, dataLength - currentPos);
+			memcpy(data + currentPos, in, sizeof(float) * (size_t) num);
+
+			in += num;
+			numSamples -= num;
+			currentPos += num;
+
+			if (currentPos >= dataLength)
+				currentPos = 0;
+		}
+	}
+
 	double maxDelay;
 	double sampleRate;
 
@@ -0,0 +1,176 @@
+#ifndef __TAPFILTERBANK__
+#define __TAPFILTERBANK__
+
+#include "JuceHeader.h"
+#include "basicfilters.h"
+
+// Runs the EQs of all delay tabs together. The filters are recursive, so one
+// filter per sample is a chain of dependent multiplies; here several filters
+// share a SIMD register, one per lane, and the registers are independent of
+// each other as well.
+// The samples of the block are interleaved to one double per filter for this,
+// and the state is taken from and given back to the BasicFilters, so that the
+// result is the same as calling their processBlock one after another.
+class TapFilterBank
+{
+public:
+	TapFilterBank()
+		: maxFilters(0),
+			maxSamples(0),
+			numFilters(0)
+	{
+	}
+
+	void prepareToPlay(int maxNumFilters, int maxBlockSize)
+	{
+		maxFilters = maxNumFilters;
+		maxSamples = maxBlockSize;
+		numFilters = 0;
+
+		filters.allocate(maxFilters, true);
+		channels.allocate(maxFilters, true);
+
+#if JUCE_USE_SIMD
+		const int numRegisters = getNumRegisters(maxFilters);
+
+		// one register more, for the alignment
+		registerData.allocate((size_t) (maxSamples * numRegisters + 1) * sizeof(Register) + (size_t) numRegisters * sizeof(FilterLanes), true);
+		samples = reinterpret_cast<Register*> (Register::getNextSIMDAlignedPtr(reinterpret_cast<double*> (registerData.getData())));
+		state = reinterpret_cast<FilterLanes*> (samples + maxSamples * numRegisters);
+#endif
+	}
+
+	void clear()
+	{
+		numFilters = 0;
+	}
+
+	// filters that are disabled or bypassed are left out, like in BasicFilters::processBlock
+	void add(BasicFilters& filter, float* data)
+	{
+		jassert(numFilters < maxFilters);
+
+		if (numFilters < maxFilters && filter.enabled && filter.type != BasicFilters::kNone)
+		{
+			filters[numFilters] = &filter;
+			channels[numFilters] = data;
+			++numFilters;
+		}
+	}
+
+	void processBlock(int numSamples)
+	{
+#if JUCE_USE_SIMD
+		if (numFilters > 1 && numSamples <= maxSamples)
+		{
+			processInterleaved(numSamples);
+			return;
+		}
+#endif
+
+		for (int f=0; f<numFilters; ++f)
+			filters[f]->processBlock(channels[f], numSamples);
+	}
+
+private:
+
+#if JUCE_USE_SIMD
+	typedef dsp::SIMDRegister<double> Register;
+
+	// coefficients and state of Register::size() filters
+	struct FilterLanes
+	{
+		Register b0, b1, b2, a1, a2;
+		Register x1, x2, y1, y2;
+	};
+
+	static int getNumRegisters(int num)
+	{
+		return (num + (int) Register::size() - 1) / (int) Register::size();
+	}
+
+	static double& lane(Register& r, int filter)
+	{
+		return reinterpret_cast<double*> (&r)[filter % (int) Register::size()];
+	}
+
+	void processInterleaved(int numSamples)
+	{
+		const int numRegisters = getNumRegisters(numFilters);
+		const int stride = numRegisters * (int) Register::size();
+
+		// unused lanes stay at zero and filter silence
+		zeromem(state, (size_t) numRegisters * sizeof(FilterLanes));
+		zeromem(samples, (size_t) (numSamples * numRegisters) * sizeof(Register));
+
+		for (int f=0; f<numFilters; ++f)
+		{
+			const BasicFilters& filter = *filters[f];
+			FilterLanes& l = state[f / (int) Register::size()];
+
+			lane(l.b0, f) = filter.b0; lane(l.b1, f) = filter.b1; lane(l.b2, f) = filter.b2;
+			lane(l.a1, f) = filter.a1; lane(l.a2, f) = filter.a2;
+			lane(l.x1, f) = filter.x1; lane(l.x2, f) = filter.x2;
+			lane(l.y1, f) = filter.y1; lane(l.y2, f) = filter.y2;
+
+			const float* const data = channels[f];
+			double* const dst = reinterpret_cast<double*> (samples) + f;
+
+			for (int i=0; i<numSamples; ++i)
+				dst[i * stride] = data[i];
+		}
+
+		const Register tiny = Register::expand(1e-10);
+		const Register zero = Register::expand(0.);
+
+		for (int i=0; i<numSamples; ++i)
+		{
+			Register* const x = samples + i * numRegisters;
+
+			// the registers don't depend on each other, this keeps several filters in flight
+			for (int r=0; r<numRegisters; ++r)
+			{
+				FilterLanes& l = state[r];
+				const Register x0 = x[r];
+				Register y0 = x0*l.b0 + l.x1*l.b1 + l.x2*l.b2 - l.a1*l.y1 - l.a2*l.y2;
+
+				// zero where -1e-10 < y0 < 1e-10
+				y0 = y0 & Register::greaterThanOrEqual(Register::max(y0, zero - y0), tiny);
+
+				l.y2 = l.y1; l.y1 = y0;
+				l.x2 = l.x1; l.x1 = x0;
+
+				x[r] = y0;
+			}
+		}
+
+		for (int f=0; f<numFilters; ++f)
+		{
+			BasicFilters& filter = *filters[f];
+			FilterLanes& l = state[f / (int) Register::size()];
+
+			filter.x1 = lane(l.x1, f); filter.x2 = lane(l.x2, f);
+			filter.y1 = lane(l.y1, f); filter.y2 = lane(l.y2, f);
+
+			float* const data = channels[f];
+			const double* const src = reinterpret_cast<const double*> (samples) + f;
+
+			for (int i=0; i<numSamples; ++i)
+				data[i] = (float) src[i * stride];
+		}
+	}
+
+	HeapBlock<char> registerData;
+	Register* samples;
+	FilterLanes* state;
+#endif
+
+	int maxFilters;
+	int maxSamples;
+	int numFilters;
+
+	HeapBlock<BasicFilters*> filters;
+	HeapBlock<float*> channels;
+};
+
+#endif // __TAPFILTERBANK__
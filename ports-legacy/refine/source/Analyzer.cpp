@@ -6,49 +6,40 @@ struct Analyzer::Data
     Data(int size_);
     void clear();
     void copyFrom (const Data& other);
-    const juce::CriticalSection& getLock() const;
 
     const int size;
-    juce::HeapBlock<float> mags;
-    juce::HeapBlock<float> angles;
+    juce::HeapBlock<float> values;
+    float* const mags;
+    float* const angles;
 
 private:
 
-    juce::CriticalSection lock;
     JUCE_DECLARE_NON_COPYABLE(Data)
 };
 
 Analyzer::Data::Data (int size_)
     : size (size_),
-      mags (size),
-      angles (size)
+      values (2 * size),
+      mags (values),
+      angles (values + size)
 {
     clear();
 }
 
 void Analyzer::Data::clear()
 {
-    juce::zeromem(mags, sizeof(float) * size);
-    juce::zeromem(angles, sizeof(float) * size);
+    juce::zeromem(values, sizeof(float) * 2 * size);
 }
 
 void Analyzer::Data::copyFrom (const Data& other)
 {
     if (other.size == size)
-    {
-        memcpy(mags, other.mags, sizeof(float) * size);
-        memcpy(angles, other.angles, sizeof(float) * size);
-    }
-}
-
-const juce::CriticalSection& Analyzer::Data::getLock() const
-{
-    return lock;
+        memcpy(values, other.values, sizeof(float) * 2 * size);
 }
 
 
 RmsEnvelope::RmsEnvelope (int envsize, double rmsLength, double updatetime)
-: rms (rmsLength), rmsVals (envsize+1), updateTime (updatetime), sampleRate (44100)
+: rms (rmsLength), rmsVals (envsize+1), snapshot (envsize), updateTime (updatetime), sampleRate (44100)
 {
 	clear();
 }
@@ -64,6 +55,7 @@ void RmsEnvelope::clear()
 {
 	rms.clear();
 	rmsVals.clear();
+	snapshot.clear();
 	updateIndex = 0;
 }
 
@@ -77,23 +69,20 @@ bool RmsEnvelope::process (const float inL, const float inR)
 	if (++updateIndex >= ovSize)
 	{
 		updateIndex = 0;
-		const float rmsVal = rms.getRms();
-
-		rmsVals.push(rmsVal);
+		pushValue(rms.getRms());
 		return true;
 	}
 
 	return false;
 }
 
-void RmsEnvelope::processBlock (const float* inL, const float* inR, int numSamples)
+bool RmsEnvelope::processBlock (const float* inL, const float* inR, int numSamples)
 {
-	ScopedLock lock(processLock);
-
 	const int ovSize = int(updateTime * sampleRate);
 
 	jassert(ovSize > 100);
 
+	bool updated = false;
 	int idx = 0;
 
 	while (numSamples > 0)
@@ -109,11 +98,30 @@ void RmsEnvelope::processBlock (const float* inL, const float* inR, int numSampl
 		if (updateIndex >= ovSize)
 		{
 			updateIndex = 0;
-			const float rmsVal = rms.getRms();
-
-			rmsVals.push(rmsVal);
+			pushValue(rms.getRms());
+			updated = true;
 		}
 	}
+
+	return updated;
+}
+
+int RmsEnvelope::getNumSamplesToUpdate() const
+{
+	return jmax(1, int(updateTime * sampleRate) - updateIndex);
+}
+
+void RmsEnvelope::pushValue (float rmsVal)
+{
+	rmsVals.push(rmsVal);
+
+	// newest first, the way getData() hands it out
+	float* const dest = snapshot.getWritePointer();
+
+	for (int i=0; i<snapshot.getSize(); ++i)
+		dest[i] = rmsVals[i];
+
+	snapshot.publish();
 }
 
 bool RmsEnvelope::getData (Array<float>& data) const
@@ -122,14 +130,7 @@ bool RmsEnvelope::getData (Array<float>& data) const
 
 	if (data.size() < dataLength)
 	{
-		ScopedTryLock lock(processLock);
-
-		if (! lock.isLocked())
-			return false;
-
-		for (int i=0; i<data.size(); ++i)
-			data.getReference(i) = rmsVals[i];
-
+		snapshot.read(data.getRawDataPointer(), data.size());
 		return true;
 	}
 
@@ -141,28 +142,57 @@ int RmsEnvelope::getDataLength() const
 	return rmsVals.getSize() - 1;
 }
 
+Analyzer::Worker::Worker (Analyzer& owner)
+: Thread ("ReFine analyzer"), analyzer (owner)
+{
+}
+
+void Analyzer::Worker::run()
+{
+	while (! threadShouldExit())
+	{
+		analyzer.processFFT();
+
+		// a frame takes over 10 ms to fill, polling keeps the audio thread from ever signalling
+		wait(5);
+	}
+}
+
 Analyzer::Analyzer()
-: sampleRate (0)
+: worker (*this), sampleRate (0)
 {
 	setSampleRate(44100);
 }
 
+Analyzer::~Analyzer()
+{
+	worker.stopThread(1000);
+}
+
 void Analyzer::clear()
 {
 	fftIndex = 0;
-	data->clear();
 }
 
 void Analyzer::processBlock (const float* inL, const float* inR, int numSamples)
 {
-	for (int i=0; i<numSamples; ++i)
+	while (numSamples > 0)
 	{
-		x[fftIndex] = 0.5f * (inL[i] + inR[i]) * window[fftIndex];
-		++fftIndex;
+		// the frame is windowed straight into the buffer the worker picks up
+		const int num = jmin(numSamples, fftBlockSize - fftIndex);
+		float* const dest = frames->getWritePointer() + fftIndex;
+		const float* const w = window + fftIndex;
 
-		if (fftIndex >= fftBlockSize)
+		for (int i=0; i<num; ++i)
+			dest[i] = 0.5f * (inL[i] + inR[i]) * w[i];
+
+		inL += num;
+		inR += num;
+		numSamples -= num;
+
+		if ((fftIndex += num) >= fftBlockSize)
 		{
-			processFFT();
+			frames->publish();
 			fftIndex = 0;
 		}
 	}
@@ -180,21 +210,19 @@ int Analyzer::getNumBins() const
 
 bool Analyzer::getData (Data& d) const
 {
-	ScopedTryLock lock(data->getLock());
+	if (d.size != numBins)
+		return false;
 
-	if (lock.isLocked())
-	{
-		d.copyFrom(*data);
-		return true;
-	}
-
-	return false;
+	results->read(d.values, 2 * numBins);
+	return true;
 }
 
 void Analyzer::setSampleRate (double newSampleRate)
 {
 	if (sampleRate != newSampleRate)
 	{
+		worker.stopThread(1000);
+
 		sampleRate = newSampleRate;
 
 		fftBlockSize = 512 * jmax(1, int(sampleRate / 44100));
@@ -204,7 +232,8 @@ void Analyzer::setSampleRate (double newSampleRate)
 		x.realloc(fftBlockSize);
 		f.realloc(fftBlockSize);
 		window.realloc(fftBlockSize);
-		data = new Data(numBins);
+		frames = new SnapshotBuffer<float> (fftBlockSize);
+		results = new SnapshotBuffer<float> (2 * numBins);
 
 		{
 			const float alpha = 0.16f;
@@ -217,6 +246,7 @@ void Analyzer::setSampleRate (double newSampleRate)
 		}
 
 		clear();
+		worker.startThread();
 	}
 }
 
@@ -227,25 +257,29 @@ double Analyzer::getSampleRate() const
 
 void Analyzer::processFFT()
 {
+	if (! frames->read(x, fftBlockSize))
+		return;
+
 	fft->do_fft(f, x);
 
 	const int imagOffset = fftBlockSize / 2;
 	const float weight = 1.f / fftBlockSize;
 
-	{
-		ScopedLock lock(data->getLock());
+	float* const mags = results->getWritePointer();
+	float* const angles = mags + numBins;
 
-		data->mags[0] = f[0]*f[0] * weight;
-		data->mags[imagOffset] = f[imagOffset]*f[imagOffset] * weight;
-		data->angles[0] = 0;
-		data->angles[numBins-1] = 0;
+	mags[0] = f[0]*f[0] * weight;
+	mags[imagOffset] = f[imagOffset]*f[imagOffset] * weight;
+	angles[0] = 0;
+	angles[numBins-1] = 0;
 
-		for (int i=1; i<numBins-1; ++i)
-		{
-			const float re = f[i];
-			const float im = f[imagOffset + i];
-			data->mags[i] = (re*re + im*im) * weight;
-			data->angles[i] = atan2(im, re);
-		}
+	for (int i=1; i<numBins-1; ++i)
+	{
+		const float re = f[i];
+		const float im = f[imagOffset + i];
+		mags[i] = (re*re + im*im) * weight;
+		angles[i] = atan2(im, re);
 	}
+
+	results->publish();
 }
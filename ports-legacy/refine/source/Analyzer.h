@@ -13,22 +13,27 @@ public:
 	void setSampleRate (double newSampleRate);
 	void clear();
 
+	// Both return true if a new value was added to the envelope
 	bool process (const float inL, const float inR);
-	void processBlock (const float* inL, const float* inR, int numSamples);
+	bool processBlock (const float* inL, const float* inR, int numSamples);
+
+	int getNumSamplesToUpdate() const;
 
+	// GUI thread, doesn't lock
 	bool getData (Array<float>& data) const;
 	int getDataLength() const;
 
 private:
 
+	void pushValue (float rmsVal);
+
 	RmsLevel rms;
 	CircularBuffer<float> rmsVals;
+	SnapshotBuffer<float> snapshot;
 	double updateTime;
 	double sampleRate;
 	int updateIndex;
 
-	juce::CriticalSection processLock;
-
 	JUCE_DECLARE_NON_COPYABLE (RmsEnvelope)
 };
 
@@ -40,6 +45,7 @@ public:
 	struct Data;
 
 	Analyzer();
+	~Analyzer();
 
 	void clear();
 	void processBlock (const float* inL, const float* inR, int numSamples);
@@ -53,13 +59,26 @@ public:
 
 private:
 
+	// Runs the FFTs, processBlock() only collects the windowed frames
+	class Worker : public juce::Thread
+	{
+	public:
+		Worker (Analyzer& owner);
+		void run() override;
+
+	private:
+		Analyzer& analyzer;
+	};
+
 	void processFFT();
 
 	juce::ScopedPointer<ffft::FFTReal<float> > fft;
 	juce::HeapBlock<float> x;
 	juce::HeapBlock<float> f;
 	juce::HeapBlock<float> window;
-	juce::ScopedPointer<Data> data;
+	juce::ScopedPointer<SnapshotBuffer<float> > frames;
+	juce::ScopedPointer<SnapshotBuffer<float> > results;
+	Worker worker;
 
 	int fftIndex;
 
@@ -21,10 +21,40 @@ double RmsBuffer::process (double in)
     return rms / buffer.getSize();
 }
 
-void RmsBuffer::processBlock (const double* in, int numSamples)
+void RmsBuffer::processBlock (const double* squares, double* out, int numSamples, double clearBelow)
 {
-    for (int i = 0; i<numSamples; ++i)
-        process(in[i]);
+    const double length = buffer.getSize();
+
+    while (numSamples > 0)
+    {
+        // out gets the squares leaving the window first
+        buffer.pushAndGetBlock(squares, out, numSamples);
+
+        int i = 0;
+
+        for (; i<numSamples; ++i)
+        {
+            rms = rms + squares[i] - out[i];
+
+            const double r = rms / length;
+
+            if (r != 0. && r < clearBelow)
+                break;
+
+            out[i] = r;
+        }
+
+        if (i == numSamples)
+            return;
+
+        // cleared in the middle of the block, what was pushed after this sample is gone too
+        clear();
+        out[i] = 0;
+
+        squares += i + 1;
+        out += i + 1;
+        numSamples -= i + 1;
+    }
 }
 
 void RmsBuffer::setSize (int newSize)
@@ -98,37 +128,46 @@ void RmsLevel::process (float inL, float inR)
 
 void RmsLevel::processBlock (const float* inL, const float* inR, int numSamples)
 {
-    if (inR == nullptr)
-    {
-        for (int i = 0; i<numSamples; ++i)
-        {
-            const double x = inL[i] * inL[i];
-            rms += x - data[index];
-
-            if (rms < 1e-8)
-                rms = 0;
+    const int chunkSize = 256;
+    double x[chunkSize];
+    double old[chunkSize];
 
-            data[index] = x;
+    while (numSamples > 0)
+    {
+        // up to the wrap point, so that the squares and the buffer exchange vectorize
+        const int num = jmin(numSamples, size - index, chunkSize);
+        double* d = data + index;
 
-            if (++index >= size)
-                index = 0;
+        if (inR == nullptr)
+        {
+            for (int i = 0; i<num; ++i)
+                x[i] = inL[i] * inL[i];
         }
-    }
-    else
-    {
-        for (int i = 0; i<numSamples; ++i)
+        else
         {
-            const double x = 0.5f * (inL[i] * inL[i] + inR[i] * inR[i]);
-            rms += x - data[index];
-
-            if (rms < 1e-8)
-                rms = 0;
+            for (int i = 0; i<num; ++i)
+                x[i] = 0.5f * (inL[i] * inL[i] + inR[i] * inR[i]);
+        }
 
-            data[index] = x;
+        for (int i = 0; i<num; ++i)
+        {
+            old[i] = d[i];
+            d[i] = x[i];
+        }
 
-            if (++index >= size)
-                index = 0;
+        // the running sum itself is serial, but without branches
+        for (int i = 0; i<num; ++i)
+        {
+            rms += x[i] - old[i];
+            rms = rms < 1e-8 ? 0 : rms;
         }
+
+        if ((index += num) >= size)
+            index = 0;
+
+        inL += num;
+        inR = inR != nullptr ? inR + num : nullptr;
+        numSamples -= num;
     }
 }
 
@@ -74,6 +74,29 @@ public:
             proc[i] = pushAndGet(proc[i]);
     }
 
+    // pushAndGet for a block, in contiguous runs up to the wrap point so that the copies vectorize
+    void pushAndGetBlock (const DataType* in, DataType* out, int numSamples)
+    {
+        while (numSamples > 0)
+        {
+            const int num = jmin(numSamples, size - index);
+            DataType* d = data + index;
+
+            for (int i = 0; i<num; ++i)
+            {
+                out[i] = d[i];
+                d[i] = in[i];
+            }
+
+            in += num;
+            out += num;
+            numSamples -= num;
+
+            if ((index += num) >= size)
+                index = 0;
+        }
+    }
+
 private:
 
     int size;
@@ -81,6 +104,72 @@ private:
     int index;
 };
 
+// Hands an array from the audio thread to the GUI without locks.
+// There are three copies: the writer fills one, the reader holds one and the newest complete one
+// waits in between. Publishing and picking up are one atomic exchange each, so neither side ever
+// waits for the other. One writer and one reader only.
+template <class DataType>
+class SnapshotBuffer
+{
+public:
+    SnapshotBuffer (int initSize)
+        : size (initSize), data (3 * initSize, true), writeIndex (0), readIndex (1)
+    {
+        middle.set(2);
+    }
+
+    int getSize() const
+    {
+        return size;
+    }
+
+    // Writer. Fill getWritePointer()[0...getSize()-1] completely, then publish().
+    DataType* getWritePointer()
+    {
+        return data + writeIndex * size;
+    }
+
+    void publish()
+    {
+        writeIndex = middle.exchange(writeIndex | newDataFlag) & indexMask;
+    }
+
+    void clear()
+    {
+        juce::zeromem(getWritePointer(), sizeof(DataType) * size);
+        publish();
+    }
+
+    // Reader. Copies the newest published data, or the same as last time if nothing new came in,
+    // and returns whether it is new.
+    bool read (DataType* dest, int numValues) const
+    {
+        const bool isNew = (middle.get() & newDataFlag) != 0;
+
+        if (isNew)
+            readIndex = middle.exchange(readIndex) & indexMask;
+
+        memcpy(dest, data + readIndex * size, sizeof(DataType) * jmin(numValues, size));
+        return isNew;
+    }
+
+private:
+
+    enum
+    {
+        indexMask = 3,
+        newDataFlag = 4
+    };
+
+    const int size;
+    juce::HeapBlock<DataType> data;
+    int writeIndex;
+    mutable int readIndex;
+    mutable juce::Atomic<int> middle;
+
+    JUCE_DECLARE_NON_COPYABLE(SnapshotBuffer)
+};
+
 class RmsBuffer
 {
 public:
@@ -90,7 +179,9 @@ public:
 
     double process (double in);
 
-    void processBlock (const double* in, int numSamples);
+    // Writes the running mean square after each of the squared inputs to out. Whenever it drops
+    // to below clearBelow without being 0, the buffer is cleared and the result is 0.
+    void processBlock (const double* squares, double* out, int numSamples, double clearBelow);
 
     void setSize (int newSize);
 
@@ -15,6 +15,14 @@ RefineDsp::RefineDsp()
   rms5 (static_cast<int> (44100*0.005)),
   rms (400, 100, 0.025),
   colors (1),
+  colorSnapshot (rms.getDataLength()),
+  meterSquares (meterChunkSize),
+  meterR300 (meterChunkSize),
+  meterR5 (meterChunkSize),
+  meterTrans (meterChunkSize),
+  meterNonTrans (meterChunkSize),
+  meterLevel (meterChunkSize),
+  meterWeight (meterChunkSize),
   delayL (512),
   delayR (512)
 {
@@ -38,6 +46,9 @@ void RefineDsp::clear()
 	transient = 0;
 	nonTransient = 0;
 	level = 0;
+	transientOut.set(0);
+	nonTransientOut.set(0);
+	levelOut.set(0);
 }
 
 void RefineDsp::setBlockSize (int newBlockSize)
@@ -114,71 +125,48 @@ void RefineDsp::processBlock (float* dataL, float* dataR, int numSamples)
 	if (dataR != nullptr)
 		delayR.processBlock(dataR, numSamples);
 
-	{
-		ScopedLock lock(processLock);
-
-		if (dataR != nullptr)
-			levelHold.processBlock(dataL, dataR, numSamples);
-		else
-			levelHold.processBlock(dataL, dataL, numSamples);
-
-		const float release = 1.f - 1.f / float(sampleRate * 0.001 * 100);
-
-		if (dataR == nullptr)
-			dataR = dataL; 
-
-		for (int i=0; i<numSamples; ++i)
-		{
-			if (std::abs(dataL[i]) < 1e-8f)
-				dataL[i] = 0;
+	if (dataR != nullptr)
+		levelHold.processBlock(dataL, dataR, numSamples);
+	else
+		levelHold.processBlock(dataL, dataL, numSamples);
 
-			if (std::abs(dataR[i]) < 1e-8f)
-				dataR[i] = 0;
+	if (dataR == nullptr)
+		dataR = dataL; 
 
-			float x = 0.5f * (dataL[i] + dataR[i]);
+	for (int i=0; i<numSamples; ++i)
+		dataL[i] = std::abs(dataL[i]) < 1e-8f ? 0 : dataL[i];
 
-			if (x > -1e-4f && x < 1e-4f)
-				x = 0;
+	for (int i=0; i<numSamples; ++i)
+		dataR[i] = std::abs(dataR[i]) < 1e-8f ? 0 : dataR[i];
 
-			double r300 = rms300.process(x);	
+	{
+		const float lHold = levelHold.getValue();
 
-			if (r300 != 0. && r300 < 1e-8f)
-			{
-				rms300.clear();
-				r300 = 0;
-			}
+		// in chunks that end where the rms envelope takes its next value, that's when a colour is due
+		for (int start=0; start<numSamples;)
+		{
+			const int num = jmin(numSamples - start, (int) meterChunkSize, rms.getNumSamplesToUpdate());
 
-			double r5 = rms5.process(x);
+			processMeters(dataL + start, dataR + start, num, lHold);
 
-			if (r5 != 0. && r5 < 1e-8f)
+			if (rms.processBlock(dataL + start, dataR + start, num))
 			{
-				r5 = 0;
-				rms5.clear();
-			}
-
-			const float y = r300 > 0 ? (float) jlimit(0., 1., (r5 / r300 - 1.)) : 0.f;
-
-			trSmooth.processAttack(y*y);
-		
-			const float lHold = levelHold.getValue();			
-			const float r300s = (float) sqrt(jmax(0., r300));
-			level = lHold > 0 ? jlimit(0.f, 1.f, 1.4142f * r300s / lHold) : 0;
-		
-			jassert(level >= 0 && level < 1e8);
-
-			const float newTrans = jmin(1.f, trSmooth.getValue()) * jmin<float>(1.f, sqrt(level) * 20.f);
-			transient = newTrans > transient ? newTrans : transient * release;
+				colors.push(colorProc.getColor());
 
-			const float newNonTransient = (1 - pow(newTrans, 0.2f)) * jmin<float>(1.f, sqrt(level) * 20.f);
-			nonTransient = newNonTransient > nonTransient ? newNonTransient : nonTransient * release;
+				juce::uint32* const dest = colorSnapshot.getWritePointer();
 
-			colorProc.add(transient, nonTransient, level);
+				for (int i=0; i<colorSnapshot.getSize(); ++i)
+					dest[i] = colors[i];
 
-			if (rms.process(dataL[i], dataR[i]))
-			{
-				colors.push(colorProc.getColor());
+				colorSnapshot.publish();
 			}
+
+			start += num;
 		}
+
+		transientOut.set(transient);
+		nonTransientOut.set(nonTransient);
+		levelOut.set(level);
 	}
 
 	if (gainLow > 0)
@@ -263,33 +251,87 @@ void RefineDsp::processBlock (float* dataL, float* dataR, int numSamples)
 	}
 }
 
+void RefineDsp::processMeters (const float* dataL, const float* dataR, int numSamples, float lHold)
+{
+	const float release = 1.f - 1.f / float(sampleRate * 0.001 * 100);
+
+	// Everything that only depends on the input is done a chunk at a time in loops that vectorize,
+	// only the envelopes themselves are left to go sample by sample.
+	for (int i=0; i<numSamples; ++i)
+	{
+		float x = 0.5f * (dataL[i] + dataR[i]);
+
+		x = (x > -1e-4f && x < 1e-4f) ? 0 : x;
+
+		const double xd = x;
+		meterSquares[i] = xd * xd;
+	}
+
+	rms300.processBlock(meterSquares, meterR300, numSamples, 1e-8f);
+	rms5.processBlock(meterSquares, meterR5, numSamples, 1e-8f);
+
+	for (int i=0; i<numSamples; ++i)
+	{
+		const double r300 = meterR300[i];
+		const double r5 = meterR5[i];
+
+		const float y = r300 > 0 ? (float) jlimit(0., 1., (r5 / (r300 > 0 ? r300 : 1.) - 1.)) : 0.f;
+		meterTrans[i] = y * y;
+
+		const float r300s = (float) sqrt(jmax(0., r300));
+		const float l = lHold > 0 ? jlimit(0.f, 1.f, 1.4142f * r300s / lHold) : 0;
+
+		meterLevel[i] = l;
+		meterWeight[i] = jmin<float>(1.f, sqrt(l) * 20.f);
+	}
+
+	trSmooth.processAttackBlock(meterTrans, meterTrans, numSamples);
+
+	for (int i=0; i<numSamples; ++i)
+		meterTrans[i] = jmin(1.f, meterTrans[i]) * meterWeight[i];
+
+	for (int i=0; i<numSamples; ++i)
+		meterNonTrans[i] = (1 - pow(meterTrans[i], 0.2f)) * meterWeight[i];
+
+	for (int i=0; i<numSamples; ++i)
+	{
+		const float newTrans = meterTrans[i];
+		transient = newTrans > transient ? newTrans : transient * release;
+
+		const float newNonTransient = meterNonTrans[i];
+		nonTransient = newNonTransient > nonTransient ? newNonTransient : nonTransient * release;
+
+		colorProc.add(transient, nonTransient, meterLevel[i]);
+	}
+
+	if (numSamples > 0)
+		level = meterLevel[numSamples - 1];
+
+	jassert(level >= 0 && level < 1e8);
+}
+
 float RefineDsp::getTransient() const
 {
-	return transient;
+	return transientOut.get();
 }
 
 float RefineDsp::getNonTransient() const
 {
-	return nonTransient;
+	return nonTransientOut.get();
 }
 
 float RefineDsp::getLevel() const
 {
-	return level;
+	return levelOut.get();
 }
 
 
 bool RefineDsp::getRmsData (Array<float>& d, Array<uint32>& c) const
 {
-	{
-		ScopedTryLock lock(processLock);
-
-		if (! lock.isLocked() || c.size() >= colors.getSize())
-			return false;
+	if (c.size() > colorSnapshot.getSize())
+		return false;
 
-		for (int i=0; i<c.size(); ++i)
-			c.getReference(i) = colors[i];
-	}
+	colorSnapshot.read(c.getRawDataPointer(), c.size());
 
 	return rms.getData(d);
 }
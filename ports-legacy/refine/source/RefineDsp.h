@@ -48,13 +48,40 @@ public:
 			value = value + (x - value) * attack;
 	}
 
+	// process() for a block, written without branches
 	void processBlock (const float* inL, const float* inR, int numSamples)
 	{
+		double v = value;
+
 		for (int i=0; i<numSamples; ++i)
 		{
 			const double x = 0.5 * (inL[i] + inR[i]);
-			process(x);
+
+			v *= release;
+			v = v < 1e-8 ? 0 : v;
+			v = x > v ? x : v;
+		}
+
+		value = v;
+	}
+
+	// processAttack() for a block, out gets getValue() after each sample
+	void processAttackBlock (const float* in, float* out, int numSamples)
+	{
+		double v = value;
+
+		for (int i=0; i<numSamples; ++i)
+		{
+			const double x = in[i];
+
+			v *= release;
+			v = v < 1e-8 ? 0 : v;
+			v = x > v ? v + (x - v) * attack : v;
+
+			out[i] = (float) v;
 		}
+
+		value = v;
 	}
 
 	float getValue()
@@ -88,6 +115,7 @@ public:
 
 	void processBlock(float* dataL, float* dataR, int numSamples);
 
+	// GUI thread, none of these lock
 	float getTransient() const;
 	float getNonTransient() const;
 	float getLevel() const;
@@ -96,6 +124,13 @@ public:
 
 private:
 
+	enum
+	{
+		meterChunkSize = 256
+	};
+
+	void processMeters(const float* dataL, const float* dataR, int numSamples, float lHold);
+
 	struct ColorProc
 	{
 		ColorProc() 
@@ -174,12 +209,24 @@ private:
 
 	RmsEnvelope rms;
 	CircularBuffer<juce::uint32> colors;
+	SnapshotBuffer<juce::uint32> colorSnapshot;
 	ColorProc colorProc;
 
+	// per chunk meter values, see processMeters()
+	juce::HeapBlock<double> meterSquares;
+	juce::HeapBlock<double> meterR300;
+	juce::HeapBlock<double> meterR5;
+	juce::HeapBlock<float> meterTrans;
+	juce::HeapBlock<float> meterNonTrans;
+	juce::HeapBlock<float> meterLevel;
+	juce::HeapBlock<float> meterWeight;
+
+	juce::Atomic<float> transientOut;
+	juce::Atomic<float> nonTransientOut;
+	juce::Atomic<float> levelOut;
+
 	CircularBuffer<float> delayL;
 	CircularBuffer<float> delayR;
-
-	juce::CriticalSection processLock;
 };
 
 #endif  // SEPDSP_H_INCLUDED
@@ -0,0 +1,508 @@
+/*
+	==============================================================================
+	Delay lines of the TAL reverbs, processed side by side.
+
+	All lines of a reverb share one aligned block of memory (ReverbArena), and the
+	lane classes keep the state of their lines as arrays with one element per line.
+	A sample of all lines is then a few short loops over the lanes: the arithmetic
+	runs four lanes per SSE register, only the reads and writes of the delay
+	memory at each line's own position stay scalar.
+	Every lane computes exactly what CombFilter and AllPassFilter do for one line,
+	the SSE code does the same operations in the same order.
+	==============================================================================
+ */
+
+#if !defined(__ReverbLanes_h)
+#define __ReverbLanes_h
+
+#include "math.h"
+#include <string.h>
+
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+ #define TAL_REVERB_USE_SSE 1
+ #include <emmintrin.h>
+#else
+ #define TAL_REVERB_USE_SSE 0
+#endif
+
+class ReverbArena
+{
+private:
+	// lines start on whole SIMD registers
+	static const int ALIGNMENT = 4;
+
+	float* memory;
+	float* data;
+	int size;
+	int used;
+
+	static int roundUp(int length)
+	{
+		return (length + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+	}
+
+public:
+	ReverbArena()
+	{
+		this->memory = 0;
+		this->data = 0;
+		this->size = 0;
+		this->used = 0;
+	}
+
+	~ReverbArena()
+	{
+		delete[] memory;
+	}
+
+	// All lines are reserved first, then the memory is allocated once and handed out in the same order
+	void reserve(int length)
+	{
+		this->size += roundUp(length);
+	}
+
+	void allocate()
+	{
+		delete[] memory;
+		this->memory = new float[size + ALIGNMENT];
+
+		size_t misalignment = ((size_t)memory / sizeof(float)) % ALIGNMENT;
+		this->data = memory + (misalignment > 0 ? ALIGNMENT - misalignment : 0);
+		this->used = 0;
+
+		memset(data, 0, size * sizeof(float));
+	}
+
+	// Offset of a line in getData()
+	int take(int length)
+	{
+		int start = used;
+		this->used += roundUp(length);
+		return start;
+	}
+
+	float* getData() const
+	{
+		return data;
+	}
+
+	// Same length rounding as CombFilter and AllPassFilter
+	static int getLineLength(float delayTime, long sampleRate)
+	{
+		int length = (int)(delayTime * sampleRate / 1000.0f);
+		while (!isPrime(length)) length++;
+		return length;
+	}
+
+	static bool isPrime(int value)
+	{
+		bool answer = true;
+		if (value == 0) value = 1;
+		for (int i = 2; i <= sqrtf((float)value) ; i++)
+		{
+			if (value % i == 0)
+			{
+				answer = false;
+				break;
+			}
+		}
+		return answer;
+	}
+};
+
+// Read positions of interpolating lines, like CombFilter::processInterpolated and
+// AllPassFilter::processInterpolated: index1/index2 into the arena and the fraction
+// between them. The offset is at least 1, so the cast is floorf.
+inline void getInterpolatedReads(const float* offsetScale, const float* delay, const int* position,
+	const int* length, const int* start, int numLanes, int* index1, int* index2, float* frac)
+{
+	int i = 0;
+
+#if TAL_REVERB_USE_SSE
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i oneInt = _mm_set1_epi32(1);
+
+	for (; i + 4 <= numLanes; i += 4)
+	{
+		__m128 offset = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(offsetScale + i), _mm_loadu_ps(delay + i)), one);
+		__m128i offsetInt = _mm_cvttps_epi32(offset);
+		__m128i lineLength = _mm_loadu_si128((const __m128i*)(length + i));
+		__m128i lineStart = _mm_loadu_si128((const __m128i*)(start + i));
+
+		__m128i readPtr1 = _mm_sub_epi32(_mm_loadu_si128((const __m128i*)(position + i)), offsetInt);
+		readPtr1 = _mm_add_epi32(readPtr1, _mm_and_si128(_mm_cmplt_epi32(readPtr1, zero), lineLength));
+		__m128i readPtr2 = _mm_sub_epi32(readPtr1, oneInt);
+		readPtr2 = _mm_add_epi32(readPtr2, _mm_and_si128(_mm_cmplt_epi32(readPtr2, zero), lineLength));
+
+		_mm_storeu_si128((__m128i*)(index1 + i), _mm_add_epi32(lineStart, readPtr1));
+		_mm_storeu_si128((__m128i*)(index2 + i), _mm_add_epi32(lineStart, readPtr2));
+		_mm_storeu_ps(frac + i, _mm_sub_ps(offset, _mm_cvtepi32_ps(offsetInt)));
+	}
+#endif
+
+	for (; i < numLanes; i++)
+	{
+		float offset = offsetScale[i] * delay[i] + 1.0f;
+		int offsetInt = (int)offset;
+
+		int readPtr1 = position[i] - offsetInt;
+		if (readPtr1 < 0)
+			readPtr1 += length[i];
+
+		int readPtr2 = readPtr1 - 1;
+		if (readPtr2 < 0)
+			readPtr2 += length[i];
+
+		index1[i] = start[i] + readPtr1;
+		index2[i] = start[i] + readPtr2;
+		frac[i] = offset - (float)offsetInt;
+	}
+}
+
+// NUM_LANES comb filters, each one like CombFilter::processInterpolated
+template <int NUM_LANES> class CombLanes
+{
+private:
+	float* memory;
+	int start[NUM_LANES];
+	int length[NUM_LANES];
+	int writePtr[NUM_LANES];
+	float offsetScale[NUM_LANES];
+	float minDamp[NUM_LANES];
+	float z1[NUM_LANES];
+	float filterStore[NUM_LANES];
+	float sampleRateFactor;
+
+public:
+	CombLanes()
+	{
+		this->memory = 0;
+		this->sampleRateFactor = 1.0f;
+
+		for (int i = 0; i < NUM_LANES; i++)
+		{
+			start[i] = 0;
+			length[i] = 2;
+			writePtr[i] = 0;
+			offsetScale[i] = 0.0f;
+			minDamp[i] = 0.0f;
+			z1[i] = filterStore[i] = 0.0f;
+		}
+	}
+
+	// delay times in milliseconds
+	void setLine(int lane, float delayTime, float minDamp, long sampleRate)
+	{
+		length[lane] = ReverbArena::getLineLength(delayTime, sampleRate);
+		offsetScale[lane] = (float)(length[lane] - 2);
+		this->minDamp[lane] = minDamp;
+	}
+
+	// damp is scaled by this before use, 1 unless set
+	void setSampleRateFactor(float sampleRateFactor)
+	{
+		this->sampleRateFactor = sampleRateFactor;
+	}
+
+	void reserve(ReverbArena& arena)
+	{
+		for (int i = 0; i < NUM_LANES; i++) arena.reserve(length[i]);
+	}
+
+	void assign(ReverbArena& arena)
+	{
+		for (int i = 0; i < NUM_LANES; i++) start[i] = arena.take(length[i]);
+		this->memory = arena.getData();
+	}
+
+	// One sample of every lane, delay [0..1]
+	inline void process(const float* input, const float* damp, float feedback, const float* delay, float* output)
+	{
+		int index1[NUM_LANES];
+		int index2[NUM_LANES];
+		float frac[NUM_LANES];
+		float value1[NUM_LANES];
+		float value2[NUM_LANES];
+		float write[NUM_LANES];
+
+		getInterpolatedReads(offsetScale, delay, writePtr, length, start, NUM_LANES, index1, index2, frac);
+
+		for (int i = 0; i < NUM_LANES; i++)
+		{
+			value1[i] = memory[index1[i]];
+			value2[i] = memory[index2[i]];
+		}
+
+		int i = 0;
+
+#if TAL_REVERB_USE_SSE
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 dampFactor = _mm_set1_ps(sampleRateFactor);
+		const __m128 feedbackGain = _mm_set1_ps(feedback);
+
+		for (; i + 4 <= NUM_LANES; i += 4)
+		{
+			__m128 inverseFrac = _mm_sub_ps(one, _mm_loadu_ps(frac + i));
+			__m128 out = _mm_sub_ps(_mm_add_ps(_mm_loadu_ps(value2 + i), _mm_mul_ps(_mm_loadu_ps(value1 + i), inverseFrac)),
+				_mm_mul_ps(inverseFrac, _mm_loadu_ps(z1 + i)));
+			_mm_storeu_ps(z1 + i, out);
+
+			__m128 laneDamp = _mm_mul_ps(_mm_loadu_ps(minDamp + i), _mm_mul_ps(_mm_loadu_ps(damp + i), dampFactor));
+			__m128 store = _mm_add_ps(_mm_mul_ps(out, _mm_sub_ps(one, laneDamp)), _mm_mul_ps(_mm_loadu_ps(filterStore + i), laneDamp));
+			_mm_storeu_ps(filterStore + i, store);
+			_mm_storeu_ps(write + i, _mm_add_ps(_mm_loadu_ps(input + i), _mm_mul_ps(store, feedbackGain)));
+			_mm_storeu_ps(output + i, out);
+		}
+#endif
+
+		for (; i < NUM_LANES; i++)
+		{
+			float out = value2[i] + value1[i] * (1.0f - frac[i]) - (1.0f - frac[i]) * z1[i];
+			z1[i] = out;
+
+			float laneDamp = minDamp[i] * (damp[i] * sampleRateFactor);
+			filterStore[i] = out * (1.0f - laneDamp) + filterStore[i] * laneDamp;
+			write[i] = input[i] + (filterStore[i] * feedback);
+			output[i] = out;
+		}
+
+		for (int i = 0; i < NUM_LANES; i++)
+		{
+			memory[start[i] + writePtr[i]] = write[i];
+
+			if (++writePtr[i] >= length[i])
+				writePtr[i] = 0;
+		}
+	}
+};
+
+// NUM_LANES allpass filters, each one like AllPassFilter. A lane is used either
+// modulated (processInterpolated) or fixed (process), never both.
+template <int NUM_LANES> class AllPassLanes
+{
+private:
+	float* memory;
+	int start[NUM_LANES];
+	int length[NUM_LANES];
+	int position[NUM_LANES];
+	float offsetScale[NUM_LANES];
+	float gain[NUM_LANES];
+	float z1[NUM_LANES];
+
+	// The halves of a fixed allpass never overlap in a run that doesn't wrap
+	static void processRun(float* __restrict buffer, float* __restrict data, float gain, int numSamples)
+	{
+		for (int i = 0; i < numSamples; i++)
+		{
+			float temp = buffer[i];
+			buffer[i] = gain * temp + data[i];
+			data[i] = temp - gain * buffer[i];
+		}
+	}
+
+public:
+	AllPassLanes()
+	{
+		this->memory = 0;
+
+		for (int i = 0; i < NUM_LANES; i++)
+		{
+			start[i] = 0;
+			length[i] = 2;
+			position[i] = 0;
+			offsetScale[i] = 0.0f;
+			gain[i] = 0.0f;
+			z1[i] = 0.0f;
+		}
+	}
+
+	// delay times in milliseconds
+	void setLine(int lane, float delayTime, float feedbackGain, long sampleRate)
+	{
+		length[lane] = ReverbArena::getLineLength(delayTime, sampleRate);
+		offsetScale[lane] = length[lane] - 2.0f;
+		gain[lane] = feedbackGain;
+	}
+
+	void reserve(ReverbArena& arena)
+	{
+		for (int i = 0; i < NUM_LANES; i++) arena.reserve(length[i]);
+	}
+
+	void assign(ReverbArena& arena)
+	{
+		for (int i = 0; i < NUM_LANES; i++) start[i] = arena.take(length[i]);
+		this->memory = arena.getData();
+	}
+
+	// One sample of every lane, delayLength [0..1]. Negative inverts the input like in
+	// AllPassFilter::processInterpolated, the sign flips are exact.
+	inline void processInterpolated(const float* input, const float* delayLength, float diffuse, bool negative, float* output)
+	{
+		const float sign = negative ? -1.0f : 1.0f;
+
+		int index1[NUM_LANES];
+		int index2[NUM_LANES];
+		float frac[NUM_LANES];
+		float value1[NUM_LANES];
+		float value2[NUM_LANES];
+		float write[NUM_LANES];
+
+		getInterpolatedReads(offsetScale, delayLength, position, length, start, NUM_LANES, index1, index2, frac);
+
+		for (int i = 0; i < NUM_LANES; i++)
+		{
+			value1[i] = memory[index1[i]];
+			value2[i] = memory[index2[i]];
+		}
+
+		int i = 0;
+
+#if TAL_REVERB_USE_SSE
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 diffuseFactor = _mm_set1_ps(diffuse);
+		const __m128 signFactor = _mm_set1_ps(sign);
+
+		for (; i + 4 <= NUM_LANES; i += 4)
+		{
+			__m128 inverseFrac = _mm_sub_ps(one, _mm_loadu_ps(frac + i));
+			__m128 temp = _mm_sub_ps(_mm_add_ps(_mm_loadu_ps(value2 + i), _mm_mul_ps(_mm_loadu_ps(value1 + i), inverseFrac)),
+				_mm_mul_ps(inverseFrac, _mm_loadu_ps(z1 + i)));
+			_mm_storeu_ps(z1 + i, temp);
+
+			__m128 diffuseGain = _mm_mul_ps(diffuseFactor, _mm_loadu_ps(gain + i));
+			__m128 written = _mm_add_ps(_mm_mul_ps(diffuseGain, temp), _mm_mul_ps(signFactor, _mm_loadu_ps(input + i)));
+			_mm_storeu_ps(write + i, written);
+			_mm_storeu_ps(output + i, _mm_sub_ps(temp, _mm_mul_ps(signFactor, _mm_mul_ps(diffuseGain, written))));
+		}
+#endif
+
+		for (; i < NUM_LANES; i++)
+		{
+			float temp = value2[i] + value1[i] * (1.0f - frac[i]) - (1.0f - frac[i]) * z1[i];
+			z1[i] = temp;
+
+			float diffuseGain = diffuse * gain[i];
+			write[i] = diffuseGain * temp + sign * input[i];
+			output[i] = temp - sign * (diffuseGain * write[i]);
+		}
+
+		for (int i = 0; i < NUM_LANES; i++)
+		{
+			memory[start[i] + position[i]] = write[i];
+
+			if (++position[i] >= length[i])
+				position[i] = 0;
+		}
+	}
+
+	// One sample of every lane, in place
+	inline void process(float* values)
+	{
+		for (int i = 0; i < NUM_LANES; i++)
+		{
+			float* buffer = memory + start[i] + position[i];
+			float temp = *buffer;
+			*buffer = gain[i] * temp + values[i];
+			values[i] = temp - gain[i] * *buffer;
+
+			if (++position[i] >= length[i])
+				position[i] = 0;
+		}
+	}
+
+	// A block of one lane, in place. Only for lanes that aren't in a feedback loop with themselves:
+	// the block runs up to the end of the line at once.
+	inline void processBlock(int lane, float* data, int numSamples)
+	{
+		while (numSamples > 0)
+		{
+			int run = length[lane] - position[lane];
+			if (run > numSamples) run = numSamples;
+
+			processRun(memory + start[lane] + position[lane], data, gain[lane], run);
+
+			position[lane] += run;
+			if (position[lane] >= length[lane])
+				position[lane] = 0;
+
+			data += run;
+			numSamples -= run;
+		}
+	}
+};
+
+// A plain delay line, like CombFilter::process with neither damping nor feedback
+class DelayLine
+{
+private:
+	float* memory;
+	int start;
+	int length;
+	int writePtr;
+
+public:
+	DelayLine()
+	{
+		this->memory = 0;
+		this->start = 0;
+		this->length = 2;
+		this->writePtr = 0;
+	}
+
+	// delay times in milliseconds
+	void setLine(float delayTime, long sampleRate)
+	{
+		this->length = ReverbArena::getLineLength(delayTime, sampleRate);
+	}
+
+	void reserve(ReverbArena& arena)
+	{
+		arena.reserve(length);
+	}
+
+	void assign(ReverbArena& arena)
+	{
+		this->start = arena.take(length);
+		this->memory = arena.getData();
+	}
+
+	// delay [0..1] for the whole block, input and output may be the same
+	inline void process(const float* input, float* output, int numSamples, float delay)
+	{
+		float offset = (length - 2) * delay + 1.0f;
+		int delaySamples = (int)offset;
+		float* buffer = memory + start;
+
+		while (numSamples > 0)
+		{
+			int readPtr = writePtr - delaySamples;
+			if (readPtr < 0)
+				readPtr += length;
+
+			// The read and the written part of a run mustn't overlap or wrap
+			int run = numSamples;
+			if (run > delaySamples) run = delaySamples;
+			if (run > length - delaySamples) run = length - delaySamples;
+			if (run > length - writePtr) run = length - writePtr;
+			if (run > length - readPtr) run = length - readPtr;
+
+			for (int i = 0; i < run; i++)
+			{
+				float value = buffer[readPtr + i];
+				buffer[writePtr + i] = input[i];
+				output[i] = value;
+			}
+
+			writePtr += run;
+			if (writePtr >= length)
+				writePtr = 0;
+
+			input += run;
+			output += run;
+			numSamples -= run;
+		}
+	}
+};
+#endif
@@ -26,59 +26,71 @@
 
 #include "Decimator.h"
 #include "interpolatorlinear.h"
-#include "Delay.h"
-#include "AudioUtils.h"
+#include "DelayLanes.h"
 #include "TapeSlider.h"
 
+// Both channels of the delay, twice oversampled and processed in blocks
 class DelayHandler
 {
+public:
+	// Samples per call of processBlock(), twice as many are delayed
+	static const int BLOCK_SIZE = DelayLanes::MAX_BLOCK_SIZE / 2;
+
 private:
-	Decimator9 *decimator;
-	InterpolatorLinear *interpolatorLinear;
-	TapeSlider* tapeSlider;
-	DelayFx* delay;
+	Decimator9 *decimatorL, *decimatorR;
+	InterpolatorLinear *interpolatorLinearL, *interpolatorLinearR;
+	TapeSlider *tapeSliderL, *tapeSliderR;
+	DelayLanes *delay;
 
-	float *upsampledValues;
-	float delayTime;
+	float delayTimeL, delayTimeR;
 
 	bool liveMode;
 
-	AudioUtils audioUtils;
+	float upsampledValuesL[2 * BLOCK_SIZE];
+	float upsampledValuesR[2 * BLOCK_SIZE];
+	float delayValuesL[BLOCK_SIZE];
+	float delayValuesR[BLOCK_SIZE];
+
+	JucePluginFilterLanes samples[2 * BLOCK_SIZE];
+	JucePluginFilterLanes delays[2 * BLOCK_SIZE];
 
 public:
 	DelayHandler(float sampleRate) 
 	{
-		decimator = new Decimator9();
-		interpolatorLinear = new InterpolatorLinear();
-		upsampledValues = new float[2];
+		decimatorL = new Decimator9();
+		decimatorR = new Decimator9();
+		interpolatorLinearL = new InterpolatorLinear();
+		interpolatorLinearR = new InterpolatorLinear();
 
 		// twice oversampled
-		delay = new DelayFx(sampleRate * 2);
-		tapeSlider = new TapeSlider(sampleRate * 2);
+		delay = new DelayLanes(sampleRate * 2);
+		tapeSliderL = new TapeSlider(sampleRate * 2);
+		tapeSliderR = new TapeSlider(sampleRate * 2);
 
-		delayTime = 0.0f;
+		delayTimeL = 0.0f;
+		delayTimeR = 0.0f;
+		liveMode = false;
 	}
 
 	~DelayHandler()
 	{
-		delete decimator;
-		delete interpolatorLinear;
+		delete decimatorL;
+		delete decimatorR;
+		delete interpolatorLinearL;
+		delete interpolatorLinearR;
+		delete tapeSliderL;
+		delete tapeSliderR;
 		delete delay;
 	}
 
-	void setDelay(float delayValue, bool liveMode)
+	void setDelay(float delayValueL, float delayValueR, bool liveMode)
 	{
 		this->liveMode = liveMode;
-		this->delayTime = delayValue;
+		this->delayTimeL = delayValueL;
+		this->delayTimeR = delayValueR;
 		delay->setLiveModeDelayTimeChange();
 	}
 
-
-	float getDelay()
-	{
-		return delay->getDelay();
-	}
-
 	void setFeedback(float feedback)
 	{
 		delay->setFeedback(feedback);
@@ -89,10 +101,9 @@ public:
 		delay->setCutoff(cutoff);
 	}
 
-	void setResonance(float resonance)
+	void setResonance(float)
 	{
-
-		delay->setResonance(resonance);
+		// the 6dB filter of the delay runs without resonance
 	}
 
 	void setHighCut(float highCut)
@@ -105,29 +116,60 @@ public:
 		delay->clearBuffer();
 	}
 
-	float getPeakReductionValue()
+	float getPeakReductionValue(int channel)
 	{
-		return delay->getPeakReductionValue();
+		return delay->getPeakReductionValue(channel);
 	}
 
-	inline void process(float *input) 
+	// numSamples is at most BLOCK_SIZE
+	void processBlock(float *sampleL, float *sampleR, int numSamples)
 	{
+		int numUpsampled = 2 * numSamples;
+		float *upsampledValues[2] = { upsampledValuesL, upsampledValuesR };
+		float *delayValues[2] = { delayValuesL, delayValuesR };
+
+		// the delay time changes once per input sample
 		if (!liveMode)
 		{
-			delay->setDelay(tapeSlider->tick(this->delayTime));
+			tapeSliderL->tickBlock(delayTimeL, delayValuesL, numSamples);
+			tapeSliderR->tickBlock(delayTimeR, delayValuesR, numSamples);
 		}
 		else
 		{
-			delay->setDelay(this->delayTime);
+			for (int n = 0; n < numSamples; n++)
+			{
+				delayValuesL[n] = delayTimeL;
+				delayValuesR[n] = delayTimeR;
+			}
 		}
-		interpolatorLinear->process2x(*input, upsampledValues);
-	
-		// limit signal
-		upsampledValues[0] = delay->process(&upsampledValues[0]);
-		upsampledValues[1] = delay->process(&upsampledValues[1]);
 
-		*input = decimator->Calc(upsampledValues[0], upsampledValues[1]);
+		for (int n = 0; n < numSamples; n++)
+		{
+			interpolatorLinearL->process2x(sampleL[n], upsampledValuesL + 2 * n);
+			interpolatorLinearR->process2x(sampleR[n], upsampledValuesR + 2 * n);
+
+			delays[2 * n] = JucePluginFilterLanes::fromChannels(delayValues, 2, n);
+			delays[2 * n + 1] = delays[2 * n];
+		}
+
+		for (int n = 0; n < numUpsampled; n++)
+		{
+			samples[n] = JucePluginFilterLanes::fromChannels(upsampledValues, 2, n);
+		}
+
+		// delays out of [0..1] are clamped by the delay lines
+		delay->processBlock(samples, delays, numUpsampled);
+
+		for (int n = 0; n < numUpsampled; n++)
+		{
+			samples[n].toChannels(upsampledValues, 2, n);
+		}
+
+		for (int n = 0; n < numSamples; n++)
+		{
+			sampleL[n] = decimatorL->Calc(upsampledValuesL[2 * n], upsampledValuesL[2 * n + 1]);
+			sampleR[n] = decimatorR->Calc(upsampledValuesR[2 * n], upsampledValuesR[2 * n + 1]);
+		}
 	}
 };
 #endif
-
@@ -0,0 +1,415 @@
+/*
+	==============================================================================
+	Block-processed delay line of TAL-Dub-3, both channels at once.
+
+	DelayLanes does for a block what one DelayFx per channel does per sample. The
+	fractional reads of the whole block are made first, with 4-point Lagrange
+	interpolation, four samples of a channel at a time in the lanes of a
+	JucePluginFilterLanes. While the delay stays the same, the taps of those four
+	samples are consecutive in the line and are loaded at once. Then the feedback
+	path (DCBlock, Filter6dB, saturation) runs per sample with the left and right
+	channel in two lanes.
+	A block never reads what it writes itself, it is cut short when the delay gets
+	shorter than the block, and where the live mode fade ends.
+	DelayFx interpolates with a first order allpass instead, which needs the previous
+	output for every read, it is kept as the per-sample reference for TalDelayBench.
+	==============================================================================
+ */
+
+#if !defined(__DelayLanes_h)
+#define __DelayLanes_h
+
+#include "math.h"
+#include <string.h>
+#include "JucePluginFilters.h"
+
+class DelayLanes
+{
+public:
+	// Samples per call of processBlock()
+	static const int MAX_BLOCK_SIZE = 128;
+
+private:
+	static const int NUM_CHANNELS = 2;
+
+	// Delay time in seconds
+	static const int MAX_DELAY_TIME = 4;
+
+	// The newest of the four Lagrange taps is one sample older than the offset
+	static const int MIN_OFFSET = 2;
+
+	// Copies of the first samples of a line after its end, so the taps of a read never wrap
+	static const int NUM_GUARD_SAMPLES = 3;
+
+	static const int NUM_LANES = JucePluginFilterLanes::size;
+
+	float *memory;
+	float *lines[NUM_CHANNELS];
+
+	// delayLineLength is the offset of delay 1.0, like in DelayFx. The lines are one
+	// block longer, so the oldest taps of a block are never overwritten by the same block.
+	int delayLineLength;
+	int lineLength;
+	int writePosition;
+
+	float currentDelay[NUM_CHANNELS];
+	float feedback;
+	float highCut;
+
+	float liveModeFadeValue;
+	float liveModeFadeOffset;
+
+	// Samples of a live mode fade, and how many of the current one are left
+	int liveModeFadeLength;
+	int fadeSamplesLeft;
+
+	// DCBlock state
+	JucePluginFilterLanes dcInputs, dcOutputs;
+
+	// Filter6dB state and coefficients
+	JucePluginFilterLanes ay1, az1, az2, at1;
+	float sampleRateFactor, iv2, k2vg;
+
+	JucePluginFilterLanes peakReductionValue;
+
+	// The offsets are filled in up to a multiple of NUM_LANES samples
+	float reads[NUM_CHANNELS][MAX_BLOCK_SIZE];
+	float fadeOutValues[MAX_BLOCK_SIZE];
+	int offsetsInt[NUM_CHANNELS][MAX_BLOCK_SIZE];
+	float offsetsFrac[NUM_CHANNELS][MAX_BLOCK_SIZE];
+
+	inline JucePluginFilterLanes tanhApp(JucePluginFilterLanes x)
+	{
+		// Same approximation as AudioUtils::tanhApp
+		x *= 2.0f;
+		JucePluginFilterLanes a = JucePluginFilterLanes::abs(x);
+		JucePluginFilterLanes b = 6.0f + a * (3.0f + a);
+		return (x * b) / (a * b + 12.0f);
+	}
+
+	inline float getOffset(float delay)
+	{
+		float offset = (float)delayLineLength * delay;
+		if (offset > (float)delayLineLength) offset = (float)delayLineLength;
+		if (offset < (float)MIN_OFFSET) offset = (float)MIN_OFFSET;
+		return offset;
+	}
+
+	static inline int getNumLaneSamples(int numSamples)
+	{
+		return (numSamples + NUM_LANES - 1) / NUM_LANES * NUM_LANES;
+	}
+
+	// Fills in the offsets of numSamples samples and returns the smallest integer one
+	int setOffsets(const JucePluginFilterLanes *delays, int numSamples)
+	{
+		int minOffset = delayLineLength;
+
+		for (int c = 0; c < NUM_CHANNELS; c++)
+		{
+			for (int n = 0; n < numSamples; n++)
+			{
+				float offset = getOffset(delays[n].get(c));
+				int offsetInt = (int)offset;
+
+				offsetsInt[c][n] = offsetInt;
+				offsetsFrac[c][n] = offset - (float)offsetInt;
+				minOffset = offsetInt < minOffset ? offsetInt : minOffset;
+			}
+			for (int n = numSamples; n < getNumLaneSamples(numSamples); n++)
+			{
+				offsetsInt[c][n] = offsetsInt[c][numSamples - 1];
+				offsetsFrac[c][n] = offsetsFrac[c][numSamples - 1];
+			}
+		}
+		return minOffset;
+	}
+
+	void setOffsets(int numSamples)
+	{
+		for (int c = 0; c < NUM_CHANNELS; c++)
+		{
+			float offset = getOffset(currentDelay[c]);
+			int offsetInt = (int)offset;
+
+			for (int n = 0; n < getNumLaneSamples(numSamples); n++)
+			{
+				offsetsInt[c][n] = offsetInt;
+				offsetsFrac[c][n] = offset - (float)offsetInt;
+			}
+		}
+	}
+
+	void readBlock(int numSamples)
+	{
+		for (int c = 0; c < NUM_CHANNELS; c++)
+		{
+			const float *line = lines[c];
+
+			for (int n = 0; n < numSamples; n += NUM_LANES)
+			{
+				const int *offsetInt = offsetsInt[c] + n;
+
+				// Lagrange weights of the four taps, the oldest one first
+				JucePluginFilterLanes t = 2.0f - JucePluginFilterLanes::fromArray(offsetsFrac[c] + n);
+				JucePluginFilterLanes t1 = t - 1.0f;
+				JucePluginFilterLanes t2 = t - 2.0f;
+				JucePluginFilterLanes t3 = t - 3.0f;
+				JucePluginFilterLanes weights[4] = {
+					t1 * t2 * t3 * (-1.0f / 6.0f),
+					t * t2 * t3 * 0.5f,
+					t * t1 * t3 * -0.5f,
+					t * t1 * t2 * (1.0f / 6.0f)
+				};
+
+				// oldest tap, offset + 2 samples back
+				int position = writePosition + n - offsetInt[0] - 2;
+				JucePluginFilterLanes taps[4];
+
+				if (offsetInt[1] == offsetInt[0] && offsetInt[2] == offsetInt[0] && offsetInt[3] == offsetInt[0]
+					&& (position >= 0 || position + NUM_LANES - 1 < 0))
+				{
+					position += lineLength & (position >> 31);
+					for (int k = 0; k < 4; k++)
+					{
+						taps[k] = JucePluginFilterLanes::fromArray(line + position + k);
+					}
+				}
+				else
+				{
+					for (int i = 0; i < NUM_LANES; i++)
+					{
+						position = writePosition + n + i - offsetInt[i] - 2;
+						position += lineLength & (position >> 31);
+						for (int k = 0; k < 4; k++)
+						{
+							taps[k].set(i, line[position + k]);
+						}
+					}
+				}
+
+				JucePluginFilterLanes output = taps[0] * weights[0] + taps[1] * weights[1] + taps[2] * weights[2] + taps[3] * weights[3];
+				output.toArray(reads[c] + n);
+			}
+		}
+	}
+
+public:
+	DelayLanes(float sampleRate)
+	{
+		if (sampleRate == 0) sampleRate = 4100.0f;
+
+		float maxDelayInSeconds = MAX_DELAY_TIME;
+		this->delayLineLength = (int)floorf(sampleRate * maxDelayInSeconds);
+		this->lineLength = delayLineLength + MAX_BLOCK_SIZE + MIN_OFFSET;
+
+		this->memory = new float[NUM_CHANNELS * (lineLength + NUM_GUARD_SAMPLES)];
+		for (int c = 0; c < NUM_CHANNELS; c++)
+		{
+			lines[c] = memory + c * (lineLength + NUM_GUARD_SAMPLES);
+			currentDelay[c] = 1.0f;
+		}
+
+		this->liveModeFadeValue = 0.0f;
+		this->liveModeFadeOffset = 1.0f / sampleRate * 4.0f;
+
+		// DelayFx::getFadeOutValue() steps the fade down until it drops below zero, the
+		// rounding of those steps decides on which sample it ends
+		this->liveModeFadeLength = 0;
+		for (float value = 1.0f; value > 0.0f; value -= liveModeFadeOffset)
+		{
+			liveModeFadeLength++;
+		}
+		this->fadeSamplesLeft = 0;
+
+		this->feedback = 0.5f;
+		this->highCut = 0.0f;
+
+		this->sampleRateFactor = 44100.0f / sampleRate;
+		if (sampleRateFactor > 1.0f)
+		{
+			sampleRateFactor = 1.0f;
+		}
+		this->iv2 = 1.0f / 2.0f;
+		setCutoff(0.0f);
+
+		clearBuffer();
+	}
+
+	~DelayLanes()
+	{
+		delete[] memory;
+	}
+
+	float getPeakReductionValue(int channel)
+	{
+		float value = peakReductionValue.get(channel);
+		peakReductionValue.set(channel, 0.0f);
+		return value;
+	}
+
+	void setFeedback(float feedback)
+	{
+		feedback *= 2.0f;
+		this->feedback = 1.0f + (feedback - 1.0f) * (feedback - 1.0f) * (feedback - 1.0f);
+	}
+
+	// Filter6dB::setCoefficients()
+	void setCutoff(float cutoff)
+	{
+		cutoff = cutoff * cutoff;
+
+		float pi = 3.1415926535f;
+		float kfc = cutoff * sampleRateFactor * 0.38f;
+		float kfcr = 1.8730f * (kfc*kfc*kfc) + 0.4955f * (kfc * kfc) - 0.6490f * kfc + 0.9988f;
+		float tmp = -pi * kfcr * kfc;
+		this->k2vg = 2.0f*(1.0f-(1.0f+tmp+tmp*tmp*0.5f+tmp*tmp*tmp*0.16666667f+tmp*tmp*tmp*tmp*0.0416666667f+tmp*tmp*tmp*tmp*tmp*0.00833333333f));
+	}
+
+	void setHighCut(float highCut)
+	{
+		this->highCut = 0.01f + highCut * highCut * highCut * 0.99f;
+	}
+
+	void clearBuffer()
+	{
+		memset(memory, 0, NUM_CHANNELS * (lineLength + NUM_GUARD_SAMPLES) * sizeof(float));
+		writePosition = 0;
+	}
+
+	void setLiveModeDelayTimeChange()
+	{
+		liveModeFadeValue = 1.0f;
+		fadeSamplesLeft = liveModeFadeLength;
+	}
+
+	// Delays [0..1] of both channels for every sample. The output of the delay lines
+	// replaces the samples, numSamples is at most MAX_BLOCK_SIZE.
+	void processBlock(JucePluginFilterLanes *samples, const JucePluginFilterLanes *delays, int numSamples)
+	{
+		while (numSamples > 0)
+		{
+			// the writes of a block don't wrap around
+			int blockSize = numSamples < lineLength - writePosition ? numSamples : lineLength - writePosition;
+			bool fadeEnds = false;
+
+			if (fadeSamplesLeft > 0)
+			{
+				// suppress delay changes while fading out
+				if (fadeSamplesLeft <= blockSize)
+				{
+					blockSize = fadeSamplesLeft;
+					fadeEnds = true;
+				}
+
+				setOffsets(blockSize);
+				int maxBlockSize = (int)getOffset(currentDelay[0] < currentDelay[1] ? currentDelay[0] : currentDelay[1]) - 1;
+				if (maxBlockSize < blockSize)
+				{
+					blockSize = maxBlockSize;
+					fadeEnds = false;
+				}
+
+				// the same steps as DelayFx, so the values match it exactly
+				for (int n = 0; n < blockSize; n++)
+				{
+					liveModeFadeValue -= liveModeFadeOffset;
+					fadeOutValues[n] = liveModeFadeValue > 0.0f ? liveModeFadeValue : 0.0f;
+				}
+				fadeSamplesLeft -= blockSize;
+			}
+			else
+			{
+				int maxBlockSize = setOffsets(delays, blockSize) - 1;
+				blockSize = maxBlockSize < blockSize ? maxBlockSize : blockSize;
+
+				for (int n = 0; n < blockSize; n++)
+				{
+					fadeOutValues[n] = 1.0f;
+				}
+				for (int c = 0; c < NUM_CHANNELS; c++)
+				{
+					currentDelay[c] = delays[blockSize - 1].get(c);
+				}
+			}
+
+			readBlock(blockSize);
+
+			float dcCoefficient = 0.9999f - highCut * 0.4f;
+			float *lineL = lines[0] + writePosition;
+			float *lineR = lines[1] + writePosition;
+			const float *readChannels[NUM_CHANNELS] = { reads[0], reads[1] };
+
+			// the state stays in registers, the writes to the lines could alias the members
+			JucePluginFilterLanes dcInputs = this->dcInputs, dcOutputs = this->dcOutputs;
+			JucePluginFilterLanes ay1 = this->ay1, az1 = this->az1, az2 = this->az2, at1 = this->at1;
+			JucePluginFilterLanes peakReductionValue = this->peakReductionValue;
+			float feedback = this->feedback, iv2 = this->iv2, k2vg = this->k2vg;
+
+			for (int n = 0; n < blockSize; n++)
+			{
+				JucePluginFilterLanes delayLineOutput = JucePluginFilterLanes::fromChannels(readChannels, NUM_CHANNELS, n) * fadeOutValues[n];
+
+				// Filters
+				JucePluginFilterLanes valueWithFeedback = samples[n] + delayLineOutput * feedback;
+
+				// DCBlock::tick()
+				dcOutputs = valueWithFeedback - dcInputs + dcCoefficient * dcOutputs;
+				dcInputs = valueWithFeedback;
+
+				// Filter6dB::process(), without resonance its tanhApp() is linear
+				ay1 = az1 + k2vg * (dcOutputs * iv2 - at1);
+				at1 = ay1 * iv2;
+				az1 = ay1;
+
+				JucePluginFilterLanes amf = ay1 * 0.875f + az2 * 0.125f;
+				az2 = amf;
+				valueWithFeedback = JucePluginFilterLanes::select(JucePluginFilterLanes::greaterThan(amf, 0.0f), amf * 0.999f, amf);
+
+				// Saturation
+				JucePluginFilterLanes valueWithFeedbackShaped = tanhApp(valueWithFeedback);
+				JucePluginFilterLanes reduction = JucePluginFilterLanes::abs(valueWithFeedback - valueWithFeedbackShaped);
+				peakReductionValue = JucePluginFilterLanes::select(JucePluginFilterLanes::greaterThan(reduction, peakReductionValue), reduction, peakReductionValue);
+
+				//write the input sample and any feedback to delayline
+				valueWithFeedbackShaped *= fadeOutValues[n];
+				lineL[n] = valueWithFeedbackShaped.get(0);
+				lineR[n] = valueWithFeedbackShaped.get(1);
+
+				samples[n] = delayLineOutput;
+			}
+
+			this->dcInputs = dcInputs;
+			this->dcOutputs = dcOutputs;
+			this->ay1 = ay1;
+			this->az1 = az1;
+			this->az2 = az2;
+			this->at1 = at1;
+
+			this->peakReductionValue = JucePluginFilterLanes::select(JucePluginFilterLanes::greaterThan(peakReductionValue, 1.0f), 1.0f, peakReductionValue);
+
+			writePosition += blockSize;
+			if (writePosition >= lineLength)
+			{
+				writePosition = 0;
+			}
+
+			for (int c = 0; c < NUM_CHANNELS; c++)
+			{
+				memcpy(lines[c] + lineLength, lines[c], NUM_GUARD_SAMPLES * sizeof(float));
+			}
+
+			if (fadeEnds)
+			{
+				liveModeFadeValue = 0.0f;
+				clearBuffer();
+			}
+
+			samples += blockSize;
+			delays += blockSize;
+			numSamples -= blockSize;
+		}
+	}
+};
+
+#endif
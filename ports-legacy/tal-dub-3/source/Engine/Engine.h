@@ -33,9 +33,17 @@
 class Engine 
 {
 private:
+	static const int BLOCK_SIZE = DelayHandler::BLOCK_SIZE;
+
 	float bpm;
 	float peakReductionValue[2];
 
+	float drysampleL[BLOCK_SIZE];
+	float drysampleR[BLOCK_SIZE];
+
+	// the right channel of a mono input
+	float monoSampleR[BLOCK_SIZE];
+
 	void initDelayTimes()
 	{
 		syncTimes= new float[18];
@@ -60,8 +68,7 @@ private:
 	}
 
 public:
-	DelayHandler *delayHandlerL;
-	DelayHandler *delayHandlerR;
+	DelayHandler *delayHandler;
 
 	float *syncTimes;
 
@@ -77,8 +84,7 @@ public:
 		Params *params= new Params();
 		this->param= params->parameters;
 
-		delayHandlerL = NULL;
-		delayHandlerR = NULL;
+		delayHandler = NULL;
 
 		initialize(sampleRate);
 		initDelayTimes();
@@ -96,11 +102,8 @@ public:
 
 	void clearMemory()
 	{
-		if (delayHandlerL)
-			delete delayHandlerL;
-
-		if (delayHandlerR)
-			delete delayHandlerR;
+		if (delayHandler)
+			delete delayHandler;
 
 		if (syncTimes) 
 			delete[] syncTimes;
@@ -113,8 +116,7 @@ public:
 
 	void clearBuffer()
 	{
-		delayHandlerL->clearBuffer();
-		delayHandlerR->clearBuffer();
+		delayHandler->clearBuffer();
 	}
 
 	void setBpm(float bpm, float delayTime, int sync, bool twiceL, bool twiceR)
@@ -161,81 +163,90 @@ public:
 		{
 			delayR /= 2.0f;
 		}
-		delayHandlerL->setDelay(delayL, liveMode);
-		delayHandlerR->setDelay(delayR, liveMode);
+		delayHandler->setDelay(delayL, delayR, liveMode);
 	}
 
 	void setFeedback(float feedback)
 	{
-		delayHandlerL->setFeedback(feedback);
-		delayHandlerR->setFeedback(feedback);
+		delayHandler->setFeedback(feedback);
 	}
 
 	void setCutoff(float cutoff)
 	{
-		delayHandlerL->setCutoff(cutoff);
-		delayHandlerR->setCutoff(cutoff);
+		delayHandler->setCutoff(cutoff);
 	}
 
 	void setResonance(float resonance)
 	{
-		delayHandlerL->setResonance(resonance);
-		delayHandlerR->setResonance(resonance);
+		delayHandler->setResonance(resonance);
 	}
 
 	void setHighCut(float highCut)
 	{
-		delayHandlerL->setHighCut(highCut);
-		delayHandlerR->setHighCut(highCut);
+		delayHandler->setHighCut(highCut);
 	}
 
 	float getPeakReductionValueL()
 	{
-		return delayHandlerL->getPeakReductionValue();
+		return delayHandler->getPeakReductionValue(0);
 	}
 
 	float getPeakReductionValueR()
 	{
-		return delayHandlerR->getPeakReductionValue();
+		return delayHandler->getPeakReductionValue(1);
 	}
 
 	void initialize(float sampleRate)
 	{
-		DelayHandler *delayHandlerTmpL = delayHandlerL;
-		DelayHandler *delayHandlerTmpR = delayHandlerR;
+		DelayHandler *delayHandlerTmp = delayHandler;
 
-		delayHandlerL = new DelayHandler(sampleRate);
-		delayHandlerR = new DelayHandler(sampleRate);
+		delayHandler = new DelayHandler(sampleRate);
 		cutoffParamChange = new ParamChangeUtil(sampleRate, 1000.0f);
 
-		if (delayHandlerTmpL != NULL)
-			delete delayHandlerTmpL;
-
-		if (delayHandlerTmpR != NULL)
-			delete delayHandlerTmpR;
+		if (delayHandlerTmp != NULL)
+			delete delayHandlerTmp;
 	}
 
-	void process(float *sampleL, float *sampleR) 
+	// sampleL and sampleR may be the same mono channel
+	void processBlock(float *sampleL, float *sampleR, int numSamples) 
 	{
-		float random = (float)rand()/RAND_MAX * 0.00000002f;
-		float inputL = *sampleL + random;
-		float inputR = *sampleR + random;
+		bool isMono = sampleL == sampleR;
 
-		//float cutoff = cutoffParamChange->tick(param[CUTOFF]);
+		while (numSamples > 0)
+		{
+			int blockSize = numSamples < BLOCK_SIZE ? numSamples : BLOCK_SIZE;
+			float *blockR = sampleR;
 
-		*sampleL *= inputDrive;
-		*sampleR *= inputDrive;
+			if (isMono)
+			{
+				memcpy(monoSampleR, sampleR, blockSize * sizeof(float));
+				blockR = monoSampleR;
+			}
 
-		// process filter
-		delayHandlerL->process(sampleL);
-		delayHandlerR->process(sampleR);
+			for (int n = 0; n < blockSize; n++)
+			{
+				float random = (float)rand()/RAND_MAX * 0.00000002f;
+				drysampleL[n] = sampleL[n] + random;
+				drysampleR[n] = blockR[n] + random;
+
+				sampleL[n] *= inputDrive;
+				blockR[n] *= inputDrive;
+			}
 
-		// dry / wet mix
-		*sampleL = *sampleL * wet;
-		*sampleR = *sampleR * wet;
+			// process filter
+			delayHandler->processBlock(sampleL, blockR, blockSize);
 
-		*sampleL += inputL * dry;
-		*sampleR += inputR * dry;
+			// dry / wet mix
+			for (int n = 0; n < blockSize; n++)
+			{
+				sampleL[n] = sampleL[n] * wet + drysampleL[n] * dry;
+				blockR[n] = blockR[n] * wet + drysampleR[n] * dry;
+			}
+
+			sampleL += blockSize;
+			sampleR += blockSize;
+			numSamples -= blockSize;
+		}
 	}
 };
 #endif
@@ -50,5 +50,22 @@ public:
 		}
 		return value;
 	}
+
+	// The same values as numValues calls of tick(), without a branch per value
+	inline void tickBlock(float inValue, float *values, int numValues)
+	{
+		// slides up in the direction of inValue, where the limit is a min()
+		float direction = inValue < value ? -1.0f : 1.0f;
+		float directedValue = direction * value;
+		float directedInValue = direction * inValue;
+
+		for (int i = 0; i < numValues; i++)
+		{
+			directedValue += speed;
+			directedValue = directedValue < directedInValue ? directedValue : directedInValue;
+			values[i] = direction * directedValue;
+		}
+		value = direction * directedValue;
+	}
 };
 #endif
@@ -274,30 +274,14 @@ void TalCore::processBlock (AudioSampleBuffer& buffer,
 		float *samples0 = buffer.getWritePointer(0, 0);
 		float *samples1 = buffer.getWritePointer(1, 0);
 
-		int samplePos = 0;
-		int numSamples = buffer.getNumSamples();
-		while (numSamples > 0)
-		{
-			engine->process(samples0++, samples1++);
-
-			numSamples--;
-			samplePos++;
-		}
+		engine->processBlock(samples0, samples1, buffer.getNumSamples());
 	}
 	if (numberOfChannels == 1)
 	{
 		float *samples0 = buffer.getWritePointer(0, 0);
 		float *samples1 = buffer.getWritePointer(0, 0);
 
-		int samplePos = 0;
-		int numSamples = buffer.getNumSamples();
-		while (numSamples > 0)
-		{
-			engine->process(samples0++, samples1++);
-
-			numSamples--;
-			samplePos++;
-		}
+		engine->processBlock(samples0, samples1, buffer.getNumSamples());
 	}
 	// update peak level
 	peakReductionValue[0] = engine->getPeakReductionValueL();
@@ -0,0 +1,440 @@
+/*
+	==============================================================================
+	TAL-Dub-3 delay benchmark
+
+	Runs the oversampled delay of both channels over the same input: per sample
+	through one DelayFx per channel, like the plugin did before, and through the
+	block-processed DelayHandler. Prints the time per frame of both and the
+	largest difference of their outputs.
+
+	DelayFx reads between samples with an allpass, DelayLanes with Lagrange
+	interpolation, they only give the same output when the delay is a whole
+	number of samples. So every case is also run per sample through LagrangeDelay,
+	which reads like DelayLanes, and the block output has to match that one.
+	==============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+
+#include "Engine/Delay.h"
+#include "Engine/DelayHandler.h"
+
+static const float kSampleRate = 44100.0f;
+
+// DelayFx fades out and clears its line for the first delay change, the input
+// stays silent until then
+static const int kSilentSamples = 13230;
+
+// Delay 1.0 in seconds, like MAX_DELAY_TIME of the delay lines
+static const float kMaxDelayTime = 4.0f;
+
+// The block output may differ from LagrangeDelay by rounding, and from DelayFx by
+// a little more where both read whole samples
+static const float kLagrangeTolerance = 1e-5f;
+static const float kDelayFxTolerance = 1e-3f;
+
+struct Setting
+{
+	const char *name;
+	float delayL, delayR;
+	bool liveMode;
+	bool wholeSamples;
+};
+
+static const Setting kSettings[] = {
+	{ "1/4 1/8 live", 0.25f, 0.125f, true, true },
+	{ "1/2 1/16 live", 0.5f, 0.0625f, true, true },
+	{ "fractional live", 0.33331f, 0.11113f, true, false },
+	{ "tape slide", 0.25f, 0.125f, false, false },
+};
+
+struct Measurement
+{
+	double nsReference;
+	double nsBlock;
+	float maxDifference;
+	float maxLagrangeDifference;
+};
+
+// DelayFx with the 4-point Lagrange read of DelayLanes instead of the allpass, one
+// sample at a time
+class LagrangeDelay
+{
+private:
+	float *line;
+	int delayLineLength;
+	int lineLength;
+	int writePosition;
+
+	float delay;
+	float currentDelay;
+	float feedback;
+	float highCut;
+
+	float liveModeFadeValue;
+	float liveModeFadeOffset;
+
+	AudioUtils audioUtils;
+	Filter6dB filter6dB;
+	DCBlock dcBlock;
+
+	void clearBuffer()
+	{
+		memset(line, 0, lineLength * sizeof(float));
+		writePosition = 0;
+	}
+
+public:
+	LagrangeDelay(float sampleRate)
+		: filter6dB(sampleRate)
+	{
+		delayLineLength = (int)floorf(sampleRate * kMaxDelayTime);
+
+		// the oldest tap is two samples behind the longest offset
+		lineLength = delayLineLength + 3;
+		line = new float[lineLength];
+		clearBuffer();
+
+		delay = 1.0f;
+		currentDelay = 1.0f;
+		feedback = 0.5f;
+		highCut = 0.0f;
+
+		liveModeFadeValue = 0.0f;
+		liveModeFadeOffset = 1.0f / sampleRate * 4.0f;
+	}
+
+	~LagrangeDelay()
+	{
+		delete[] line;
+	}
+
+	void setDelay(float delay)
+	{
+		this->delay = delay;
+	}
+
+	void setFeedback(float feedback)
+	{
+		feedback *= 2.0f;
+		this->feedback = 1.0f + (feedback - 1.0f) * (feedback - 1.0f) * (feedback - 1.0f);
+	}
+
+	void setCutoff(float cutoff)
+	{
+		filter6dB.setCoefficients(cutoff * cutoff);
+	}
+
+	void setHighCut(float highCut)
+	{
+		this->highCut = 0.01f + highCut * highCut * highCut * 0.99f;
+	}
+
+	void setLiveModeDelayTimeChange()
+	{
+		liveModeFadeValue = 1.0f;
+	}
+
+	inline float process(float *sample)
+	{
+		// supress delay changes while fading out
+		if (liveModeFadeValue <= 0.0f)
+		{
+			currentDelay = delay;
+		}
+
+		float offset = (float)delayLineLength * currentDelay;
+		if (offset > (float)delayLineLength) offset = (float)delayLineLength;
+		if (offset < 2.0f) offset = 2.0f;
+		int offsetInt = (int)offset;
+
+		// weights of the taps offset + 2 to offset - 1 samples back
+		float t = 2.0f - (offset - (float)offsetInt);
+		float weights[4] = {
+			(t - 1.0f) * (t - 2.0f) * (t - 3.0f) * (-1.0f / 6.0f),
+			t * (t - 2.0f) * (t - 3.0f) * 0.5f,
+			t * (t - 1.0f) * (t - 3.0f) * -0.5f,
+			t * (t - 1.0f) * (t - 2.0f) * (1.0f / 6.0f)
+		};
+
+		float delayLineOutput = 0.0f;
+		for (int k = 0; k < 4; k++)
+		{
+			int position = writePosition - offsetInt - 2 + k;
+			if (position < 0) position += lineLength;
+			delayLineOutput += line[position] * weights[k];
+		}
+
+		// DelayFx::getFadeOutValue()
+		float fadeOutValue = 1.0f;
+		bool fadeEnds = false;
+		if (liveModeFadeValue > 0.0f)
+		{
+			liveModeFadeValue -= liveModeFadeOffset;
+			fadeOutValue = liveModeFadeValue > 0.0f ? liveModeFadeValue : 0.0f;
+			fadeEnds = liveModeFadeValue <= 0.0f;
+		}
+		delayLineOutput *= fadeOutValue;
+
+		float valueWithFeedback = *sample + delayLineOutput * feedback;
+		dcBlock.tick(&valueWithFeedback, highCut);
+		filter6dB.process(&valueWithFeedback);
+		valueWithFeedback = audioUtils.tanhApp(valueWithFeedback);
+
+		line[writePosition] = valueWithFeedback * fadeOutValue;
+		if (++writePosition >= lineLength)
+		{
+			writePosition = 0;
+		}
+
+		if (fadeEnds)
+		{
+			liveModeFadeValue = 0.0f;
+			clearBuffer();
+		}
+		return delayLineOutput;
+	}
+};
+
+// The per-sample path of one channel, DelayHandler::process() before it worked in blocks
+template <class Delay>
+class ReferenceChannel
+{
+public:
+	Decimator9 decimator;
+	InterpolatorLinear interpolatorLinear;
+	TapeSlider tapeSlider;
+	Delay delay;
+
+	float delayTime;
+	bool liveMode;
+
+	ReferenceChannel(float sampleRate)
+		: tapeSlider(sampleRate * 2), delay(sampleRate * 2)
+	{
+		delayTime = 0.0f;
+		liveMode = false;
+	}
+
+	void setDelay(float delayValue, bool liveMode)
+	{
+		this->liveMode = liveMode;
+		this->delayTime = delayValue;
+		delay.setLiveModeDelayTimeChange();
+	}
+
+	inline void process(float *input)
+	{
+		float upsampledValues[2];
+
+		if (!liveMode)
+		{
+			delay.setDelay(tapeSlider.tick(delayTime));
+		}
+		else
+		{
+			delay.setDelay(delayTime);
+		}
+		interpolatorLinear.process2x(*input, upsampledValues);
+
+		upsampledValues[0] = delay.process(&upsampledValues[0]);
+		upsampledValues[1] = delay.process(&upsampledValues[1]);
+
+		*input = decimator.Calc(upsampledValues[0], upsampledValues[1]);
+	}
+};
+
+// a few partials and some noise, different on each channel
+static void fillInput(float *inputL, float *inputR, int numSamples)
+{
+	unsigned int seed = 0x5eed;
+
+	for (int n = 0; n < numSamples; n++)
+	{
+		seed = seed * 1664525u + 1013904223u;
+		float noise = (float)(seed >> 8) / 8388608.0f - 1.0f;
+
+		if (n < kSilentSamples)
+		{
+			inputL[n] = 0.0f;
+			inputR[n] = 0.0f;
+		}
+		else
+		{
+			inputL[n] = 0.4f * sinf(0.031f * n) + 0.2f * sinf(0.73f * n) + 0.1f * noise;
+			inputR[n] = 0.4f * sinf(0.062f * n) + 0.2f * sinf(0.73f * n + 1.0f) - 0.1f * noise;
+		}
+	}
+}
+
+template <class Delay>
+static void setUp(ReferenceChannel<Delay> &channel, float delay, bool liveMode)
+{
+	channel.delay.setFeedback(0.6f);
+	channel.delay.setCutoff(0.8f);
+	channel.delay.setHighCut(0.2f);
+	channel.setDelay(delay, liveMode);
+}
+
+static float getMaxDifference(const float *a, const float *b, int numSamples)
+{
+	float maxDifference = 0.0f;
+	for (int n = 0; n < numSamples; n++)
+	{
+		float difference = fabsf(a[n] - b[n]);
+		maxDifference = difference > maxDifference ? difference : maxDifference;
+	}
+	return maxDifference;
+}
+
+static Measurement run(const Setting &setting, int blockSize, int numBlocks)
+{
+	int numSamples = blockSize * numBlocks + kSilentSamples;
+
+	float *referenceL = new float[numSamples];
+	float *referenceR = new float[numSamples];
+	float *lagrangeL = new float[numSamples];
+	float *lagrangeR = new float[numSamples];
+	float *blockL = new float[numSamples];
+	float *blockR = new float[numSamples];
+
+	fillInput(referenceL, referenceR, numSamples);
+	memcpy(lagrangeL, referenceL, numSamples * sizeof(float));
+	memcpy(lagrangeR, referenceR, numSamples * sizeof(float));
+	memcpy(blockL, referenceL, numSamples * sizeof(float));
+	memcpy(blockR, referenceR, numSamples * sizeof(float));
+
+	ReferenceChannel<DelayFx> *referenceChannelL = new ReferenceChannel<DelayFx>(kSampleRate);
+	ReferenceChannel<DelayFx> *referenceChannelR = new ReferenceChannel<DelayFx>(kSampleRate);
+	ReferenceChannel<LagrangeDelay> *lagrangeChannelL = new ReferenceChannel<LagrangeDelay>(kSampleRate);
+	ReferenceChannel<LagrangeDelay> *lagrangeChannelR = new ReferenceChannel<LagrangeDelay>(kSampleRate);
+	DelayHandler *delayHandler = new DelayHandler(kSampleRate);
+
+	setUp(*referenceChannelL, setting.delayL, setting.liveMode);
+	setUp(*referenceChannelR, setting.delayR, setting.liveMode);
+	setUp(*lagrangeChannelL, setting.delayL, setting.liveMode);
+	setUp(*lagrangeChannelR, setting.delayR, setting.liveMode);
+
+	delayHandler->setFeedback(0.6f);
+	delayHandler->setCutoff(0.8f);
+	delayHandler->setHighCut(0.2f);
+	delayHandler->setDelay(setting.delayL, setting.delayR, setting.liveMode);
+
+	std::chrono::steady_clock::time_point startReference = std::chrono::steady_clock::now();
+
+	for (int n = 0; n < numSamples; n++)
+	{
+		referenceChannelL->process(referenceL + n);
+		referenceChannelR->process(referenceR + n);
+	}
+
+	std::chrono::steady_clock::time_point startBlock = std::chrono::steady_clock::now();
+
+	for (int n = 0; n < numSamples; n += blockSize)
+	{
+		int numBlockSamples = numSamples - n < blockSize ? numSamples - n : blockSize;
+
+		// the engine splits the host blocks in the same way
+		for (int i = 0; i < numBlockSamples; i += DelayHandler::BLOCK_SIZE)
+		{
+			int num = numBlockSamples - i < DelayHandler::BLOCK_SIZE ? numBlockSamples - i : DelayHandler::BLOCK_SIZE;
+			delayHandler->processBlock(blockL + n + i, blockR + n + i, num);
+		}
+	}
+
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+	for (int n = 0; n < numSamples; n++)
+	{
+		lagrangeChannelL->process(lagrangeL + n);
+		lagrangeChannelR->process(lagrangeR + n);
+	}
+
+	float maxDifferenceL = getMaxDifference(referenceL, blockL, numSamples);
+	float maxDifferenceR = getMaxDifference(referenceR, blockR, numSamples);
+	float maxLagrangeDifferenceL = getMaxDifference(lagrangeL, blockL, numSamples);
+	float maxLagrangeDifferenceR = getMaxDifference(lagrangeR, blockR, numSamples);
+
+	Measurement result;
+	result.nsReference = std::chrono::duration<double, std::nano>(startBlock - startReference).count() / numSamples;
+	result.nsBlock = std::chrono::duration<double, std::nano>(end - startBlock).count() / numSamples;
+	result.maxDifference = maxDifferenceL > maxDifferenceR ? maxDifferenceL : maxDifferenceR;
+	result.maxLagrangeDifference = maxLagrangeDifferenceL > maxLagrangeDifferenceR ? maxLagrangeDifferenceL : maxLagrangeDifferenceR;
+
+	delete referenceChannelL;
+	delete referenceChannelR;
+	delete lagrangeChannelL;
+	delete lagrangeChannelR;
+	delete delayHandler;
+	delete[] referenceL;
+	delete[] referenceR;
+	delete[] lagrangeL;
+	delete[] lagrangeR;
+	delete[] blockL;
+	delete[] blockR;
+
+	return result;
+}
+
+int main(int argc, char *argv[])
+{
+	int blockSize = 256;
+	int numBlocks = 1000;
+	bool validArgs = true;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-b") == 0 && i + 1 < argc)
+			blockSize = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+			numBlocks = atoi(argv[++i]);
+		else
+			validArgs = false;
+	}
+
+	if (!validArgs || blockSize < 1 || numBlocks < 1)
+	{
+		printf("usage: %s [-b block-size] [-n blocks]\n", argv[0]);
+		return 1;
+	}
+
+	// without two echoes of the longest delay after the silence there is nothing to compare
+	float maxDelay = 0.0f;
+	for (size_t i = 0; i < sizeof(kSettings) / sizeof(kSettings[0]); i++)
+	{
+		maxDelay = kSettings[i].delayL > maxDelay ? kSettings[i].delayL : maxDelay;
+		maxDelay = kSettings[i].delayR > maxDelay ? kSettings[i].delayR : maxDelay;
+	}
+	int minSamples = (int)(2.0f * maxDelay * kMaxDelayTime * kSampleRate);
+	if (blockSize * numBlocks < minSamples)
+	{
+		numBlocks = (minSamples + blockSize - 1) / blockSize;
+		printf("running %d blocks to hear the longest delay\n", numBlocks);
+	}
+
+	printf("SIMD lanes: %s\n", JUCE_PLUGIN_FILTERS_VECTOR ? "4" : "none");
+	printf("%16s %16s %14s %8s %12s %14s\n",
+		"DELAY", "DELAYFX NS/FRM", "BLOCK NS/FRM", "SPEEDUP", "MAX DIFF", "LAGRANGE DIFF");
+
+	bool valid = true;
+
+	for (size_t i = 0; i < sizeof(kSettings) / sizeof(kSettings[0]); i++)
+	{
+		Measurement result = run(kSettings[i], blockSize, numBlocks);
+		bool matches = result.maxLagrangeDifference <= kLagrangeTolerance
+			&& (!kSettings[i].wholeSamples || result.maxDifference <= kDelayFxTolerance);
+
+		printf("%16s %16.2f %14.2f %7.2fx %12g %14g %s\n",
+			kSettings[i].name, result.nsReference, result.nsBlock,
+			result.nsReference / result.nsBlock, result.maxDifference,
+			result.maxLagrangeDifference, matches ? "ok" : "FAILED");
+
+		valid = valid && matches;
+	}
+
+	return valid ? 0 : 2;
+}
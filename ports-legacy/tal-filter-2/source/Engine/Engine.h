@@ -34,8 +34,7 @@ class Engine
 {
 private:
     EnvelopeEditor* envelopeEditor;
-    FilterHandler* filterHandlerL;
-    FilterHandler* filterHandlerR;
+    FilterHandler* filterHandler;
     OscNoise* oscNoise;
 
     float resonance;
@@ -85,11 +84,9 @@ public:
 	void initialize(float sampleRate)
 	{
         envelopeEditor = new EnvelopeEditor(sampleRate);
-        this->filterHandlerL = new FilterHandler(sampleRate);
-        this->filterHandlerR = new FilterHandler(sampleRate);
+        this->filterHandler = new FilterHandler(sampleRate);
 
-        this->filterHandlerL->reset();
-        this->filterHandlerR->reset();
+        this->filterHandler->reset();
 
         this->oscNoise = new OscNoise(sampleRate);
 	}
@@ -115,8 +112,7 @@ public:
 
         if (this->filterType <= 7)
         {
-            this->filterHandlerL->setFiltertype((float)index);
-            this->filterHandlerR->setFiltertype((float)index);
+            this->filterHandler->setFiltertype((float)index);
         }
     }
 
@@ -171,8 +167,7 @@ public:
         case 5:
         case 6:
         case 7:
-            this->filterHandlerL->process(sampleL, value, resonance);
-            this->filterHandlerR->process(sampleR, value, resonance);
+            this->filterHandler->process(sampleL, sampleR, value, resonance);
             break;
         case 8:
             *sampleL *= value;
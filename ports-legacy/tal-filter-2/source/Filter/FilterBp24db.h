@@ -25,6 +25,7 @@
 #define __FilterBp24db_h_
 
 #include "OscNoise.h"
+#include "JucePluginFilters.h"
 
 class FilterBp24db 
 {
@@ -32,9 +33,9 @@ public:
 private:
 	float pi;
 	float v2, iv2;
-	float ay1, ay2, ay3, ay4, amf;
-	float az1, az2, az3, az4;
-	float at1, at2, at3, at4;
+	JucePluginFilterLanes ay1, ay2, ay3, ay4, amf;
+	JucePluginFilterLanes az1, az2, az3, az4;
+	JucePluginFilterLanes at1, at2, at3, at4;
 
 	float kfc, kfcr, kacr, k2vg, k2vgNoisy;
 
@@ -79,7 +80,7 @@ public:
 		at1= at2= at3 = at4 = 0.0f;
     }
 
-	inline void process(float *input, const float cutoffIn, const float resonance, const bool calcCeff) 
+	inline void process(JucePluginFilterLanes *input, const float cutoffIn, const float resonance, const bool calcCeff) 
 	{
 		// Filter based on the text "Non linear digital implementation of the moog ladder filter" by Antti Houvilainen
 		// Adopted from Csound code at http://www.kunstmusik.com/udo/cache/moogladder.udo
@@ -115,7 +116,7 @@ public:
 
         k2vgNoisy = k2vg + rnd1 * cutoffIn;
 
-		float inWithRes = *input - 4.2f * resonance * amf * kacr; 
+		JucePluginFilterLanes inWithRes = *input - 4.2f * resonance * amf * kacr; 
 
 		ay1 = az1 + k2vgNoisy * (rnd1 + inWithRes - at1);
 		at1 = tanhApp(ay1);
@@ -139,10 +140,7 @@ public:
 
 		amf = tanhClipper(amf);
 
-		if (amf > 0.0f)
-		{
-			amf *= 0.99f;
-		}
+		amf = JucePluginFilterLanes::select(JucePluginFilterLanes::greaterThan(amf, 0.0f), amf * 0.99f, amf);
 
 		// See Oberheim xpander manual http://www.synthi.se/oberheim/
 		float ci = 0.f; // R = 100 Ohm, thus ci = 1.f
@@ -151,22 +149,22 @@ public:
 		float c3 = 4.0f; // Pole 3 is not connected
 		float c4 = 2.0f; // Pole 4 isn't connected either
 
-		float output = ci * inWithRes - c1 * at1 + c2 * at2 - c3 * at3 + c4 * at4; 
+		JucePluginFilterLanes output = ci * inWithRes - c1 * at1 + c2 * at2 - c3 * at3 + c4 * at4; 
 
 		*input = output * (resonanceCorrPost + cutoffIn * resonance * 1.0f);
 	}
 
-	inline float tanhApp(const float x) 
+	inline JucePluginFilterLanes tanhApp(const JucePluginFilterLanes x) 
 	{
 		return x;
 	}
 
-	inline float tanhClipper(float x) 
+	inline JucePluginFilterLanes tanhClipper(JucePluginFilterLanes x) 
 	{
 		// return tanh(x);
 		x *= 2.0f;
-		float a = fabs(x);
-		float b = 6.0f+a*(3.0f+a);
+		JucePluginFilterLanes a = JucePluginFilterLanes::abs(x);
+		JucePluginFilterLanes b = 6.0f+a*(3.0f+a);
 		return (x*b)/(a*b+12.0f);
 	}
  };
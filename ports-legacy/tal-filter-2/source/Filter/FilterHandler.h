@@ -37,11 +37,12 @@
 class FilterHandler
 {
 private:
-	Decimator9 *decimator;
-	Decimator9 *decimator2;
+	Decimator9 *decimatorL, *decimatorR;
+	Decimator9 *decimator2L, *decimator2R;
 	Upsample *upsample;
-	InterpolatorLinear *interpolatorLinear;
+	InterpolatorLinear *interpolatorLinearL, *interpolatorLinearR;
 
+	// Both channels, one in each lane
 	FilterLp24db *filterLp24db;
 	FilterLp18db *filterLp18db;
 	FilterLp12db *filterLp12db;
@@ -52,17 +53,22 @@ private:
 	FilterN24db *filterN24db;
 
 	int filtertype;
-    float *upsampledValues;
+    float *upsampledValuesL, *upsampledValuesR;
+	JucePluginFilterLanes upsampledValues[4];
     
 
 public:
 	FilterHandler(float sampleRate) 
 	{
 		upsample = new Upsample();
-		decimator = new Decimator9();
-		decimator2 = new Decimator9();
-		interpolatorLinear = new InterpolatorLinear();
-        upsampledValues = new float[4];
+		decimatorL = new Decimator9();
+		decimatorR = new Decimator9();
+		decimator2L = new Decimator9();
+		decimator2R = new Decimator9();
+		interpolatorLinearL = new InterpolatorLinear();
+		interpolatorLinearR = new InterpolatorLinear();
+        upsampledValuesL = new float[4];
+        upsampledValuesR = new float[4];
 
 		filterLp24db = new FilterLp24db(sampleRate * 4.0f);
 		filterLp18db = new FilterLp18db(sampleRate * 4.0f);
@@ -78,9 +84,12 @@ public:
 	~FilterHandler()
 	{
 		delete upsample;
-		delete decimator;
-		delete decimator2;
-		delete interpolatorLinear;
+		delete decimatorL;
+		delete decimatorR;
+		delete decimator2L;
+		delete decimator2R;
+		delete interpolatorLinearL;
+		delete interpolatorLinearR;
 		delete filterLp24db;
 		delete filterLp18db;
 		delete filterLp12db;
@@ -88,7 +97,8 @@ public:
 		delete filterHp24db;
 		delete filterBp24db;
 		delete filterN24db;
-		delete upsampledValues;
+		delete[] upsampledValuesL;
+		delete[] upsampledValuesR;
 	}
 
 	void setFiltertype(float value)
@@ -98,8 +108,10 @@ public:
 
     void reset()
     {
-        decimator->Initialize();
-        decimator2->Initialize();
+        decimatorL->Initialize();
+        decimatorR->Initialize();
+        decimator2L->Initialize();
+        decimator2R->Initialize();
         filterLp24db->reset();
 		filterLp18db->reset();
 		filterLp12db->reset();
@@ -109,9 +121,16 @@ public:
 		filterN24db->reset();
     }
 
-	inline void process(float *input, float cutoff, float resonance) 
+	inline void process(float *inputL, float *inputR, float cutoff, float resonance) 
 	{
-		interpolatorLinear->process4x(*input, upsampledValues);
+		interpolatorLinearL->process4x(*inputL, upsampledValuesL);
+		interpolatorLinearR->process4x(*inputR, upsampledValuesR);
+
+		for (int i = 0; i < 4; i++)
+		{
+			upsampledValues[i].set(0, upsampledValuesL[i]);
+			upsampledValues[i].set(1, upsampledValuesR[i]);
+		}
 
 		// Do oversampled stuff here
 		switch (filtertype)
@@ -160,9 +179,13 @@ public:
 			break;
 		}
 
-		float decimated1 = decimator->Calc(upsampledValues[0], upsampledValues[1]);
-		float decimated2 = decimator->Calc(upsampledValues[2], upsampledValues[3]);
-		*input = decimator2->Calc(decimated1, decimated2);
+		float decimated1 = decimatorL->Calc(upsampledValues[0].get(0), upsampledValues[1].get(0));
+		float decimated2 = decimatorL->Calc(upsampledValues[2].get(0), upsampledValues[3].get(0));
+		*inputL = decimator2L->Calc(decimated1, decimated2);
+
+		decimated1 = decimatorR->Calc(upsampledValues[0].get(1), upsampledValues[1].get(1));
+		decimated2 = decimatorR->Calc(upsampledValues[2].get(1), upsampledValues[3].get(1));
+		*inputR = decimator2R->Calc(decimated1, decimated2);
 	}
 };
 #endif
@@ -25,6 +25,7 @@
 #define __FilterLp12db_h_
 
 #include "OscNoise.h"
+#include "JucePluginFilters.h"
 
 class FilterLp12db 
 {
@@ -32,9 +33,9 @@ public:
 private:
 	float pi;
 	float v2, iv2;
-	float ay1, ay2, ay3, ay4, amf;
-	float az1, az2, az3, az4;
-	float at1, at2, at3, at4;
+	JucePluginFilterLanes ay1, ay2, ay3, ay4, amf;
+	JucePluginFilterLanes az1, az2, az3, az4;
+	JucePluginFilterLanes at1, at2, at3, at4;
 
 	float kfc, kfcr, kacr, k2vg, k2vgNoisy;
 
@@ -79,7 +80,7 @@ public:
 		at1= at2= at3 = at4 = 0.0f;
     }
 
-	inline void process(float *input, const float cutoffIn, const float resonance, const bool calcCeff) 
+	inline void process(JucePluginFilterLanes *input, const float cutoffIn, const float resonance, const bool calcCeff) 
 	{
 		// Filter based on the text "Non linear digital implementation of the moog ladder filter" by Antti Houvilainen
 		// Adopted from Csound code at http://www.kunstmusik.com/udo/cache/moogladder.udo
@@ -114,7 +115,7 @@ public:
 
         k2vgNoisy = k2vg + rnd1 * cutoffIn;
 
-		float inWithRes = *input - 4.2f * resonance * amf * kacr; 
+		JucePluginFilterLanes inWithRes = *input - 4.2f * resonance * amf * kacr; 
 
 		ay1 = az1 + k2vgNoisy * (rnd1 + inWithRes - at1);
 		at1 = ay1;
@@ -138,25 +139,22 @@ public:
 
 		amf = tanhClipper(amf);
 
-		if (amf > 0.0f)
-		{
-			amf *= 0.99f;
-		}
+		amf = JucePluginFilterLanes::select(JucePluginFilterLanes::greaterThan(amf, 0.0f), amf * 0.99f, amf);
 
         *input = tanhClipper(at2) * (resonanceCorrPost + cutoffIn * resonance * 1.5f);
 	}
 
-	inline float tanhApp(const float x) 
+	inline JucePluginFilterLanes tanhApp(const JucePluginFilterLanes x) 
 	{
 		return x;
 	}
 
-	inline float tanhClipper(float x) 
+	inline JucePluginFilterLanes tanhClipper(JucePluginFilterLanes x) 
 	{
 		// return tanh(x);
 		x *= 2.0f;
-		float a = fabs(x);
-		float b = 6.0f+a*(3.0f+a);
+		JucePluginFilterLanes a = JucePluginFilterLanes::abs(x);
+		JucePluginFilterLanes b = 6.0f+a*(3.0f+a);
 		return (x*b)/(a*b+12.0f);
 	}
  };
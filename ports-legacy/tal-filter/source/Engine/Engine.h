@@ -37,8 +37,7 @@ private:
 	float bpm;
 
 public:
-	FilterHandler *filterHandlerL;
-	FilterHandler *filterHandlerR;
+	FilterHandler *filterHandler;
 	float *param;
 	Lfo *lfoL;
 	Lfo *lfoR;
@@ -54,8 +53,7 @@ public:
 		Params *params= new Params();
 		this->param= params->parameters;
 
-		filterHandlerL = NULL;
-		filterHandlerR = NULL;
+		filterHandler = NULL;
 		cutoffParamChange = NULL;
 		lfoL = NULL;
 		lfoR = NULL;
@@ -69,8 +67,7 @@ public:
 
 	~Engine()
 	{
-		delete filterHandlerL;
-		delete filterHandlerR;
+		delete filterHandler;
 		delete envelope;
 
 		delete lfoL;
@@ -140,8 +137,7 @@ public:
 
 	void initialize(float sampleRate)
 	{
-		filterHandlerL = new FilterHandler(sampleRate);
-		filterHandlerR = new FilterHandler(sampleRate);
+		filterHandler = new FilterHandler(sampleRate);
 		cutoffParamChange = new ParamChangeUtil(sampleRate, 1000.0f);
 		lfoL = new Lfo(sampleRate);
 		lfoR = new Lfo(sampleRate);
@@ -214,8 +210,7 @@ public:
 		*sampleR *= 0.3f + inputDrive * 8.0f;
 
 		// process filter
-		filterHandlerL->process(sampleL, cutoff, param[RESONANCE], cutoffModulationL, param[FILTERTYPE]);
-		filterHandlerR->process(sampleR, cutoff, param[RESONANCE], cutoffModulationR, param[FILTERTYPE]);
+		filterHandler->process(sampleL, sampleR, cutoff, param[RESONANCE], cutoffModulationL, cutoffModulationR, param[FILTERTYPE]);
 
 		*sampleL *= volume;
 		*sampleR *= volume;
@@ -24,19 +24,22 @@
 #ifndef __FilterBp12dB_h_
 #define __FilterBp12dB_h_
 
+#include "JucePluginFilters.h"
+
 class FilterBp12dB 
 {
 private:
 	float pi;
 	float v2, iv2;
-	float ay1, ay2, ay3, ay4, amf;
-	float az1, az2, az3, az4, az5;
-	float at1, at2, at3, at4;
+	JucePluginFilterLanes ay1, ay2, ay3, ay4, amf;
+	JucePluginFilterLanes az1, az2, az3, az4, az5;
+	JucePluginFilterLanes at1, at2, at3, at4;
 
-	float kfc, kfcr, kacr, k2vg;
+	JucePluginFilterLanes kfc, kfcr, kacr, k2vg;
+	JucePluginFilterLanes cutoffInOld;
 
 	// temporary variables
-	float tmp, a, b;
+	JucePluginFilterLanes tmp, a, b;
 	float cutoff, sampleRateFactor;
 
 
@@ -45,6 +48,7 @@ public:
 	{
 		az1= az2= az3= az4= az5= ay1= ay2= ay3= ay4= amf= 0.0f;
 		at1= at2= at3= at4 = 0.0f;
+		cutoffInOld= -1.0f;
 
 		pi= 3.1415926535f;
 		v2= 1.0f;   // twice the 'thermal voltage of a transistor'
@@ -57,14 +61,15 @@ public:
 		}
 	}
 
-	inline void process(float *input, float cutoffIn, float resonance, bool calcCeff) 
+	inline void process(JucePluginFilterLanes *input, const JucePluginFilterLanes& cutoffIn, float resonance, bool calcCeff) 
 	{
 		// Filter based on the text "Non linear digital implementation of the moog ladder filter" by Antti Houvilainen
 		// Adopted from Csound code at http://www.kunstmusik.com/udo/cache/moogladder.udo
 
 		// Resonance [0..1]
 		// Cutoff from 0 (0Hz) to 1 (nyquist)
-		if (calcCeff) {
+		if (calcCeff && !JucePluginFilterLanes::allEqual(cutoffIn, cutoffInOld)) {
+			cutoffInOld= cutoffIn;
 			kfc  = cutoffIn * sampleRateFactor * 0.5f; // ~sr/2 + tanh approximation correction
 
 			// Frequency & amplitude correction
@@ -76,7 +81,7 @@ public:
 			//k2vg= v2*(1.0f-(1.0f+tmp+tmp*tmp*0.5f+tmp*tmp*tmp*0.16666667f+tmp*tmp*tmp*tmp*0.0416666667f+tmp*tmp*tmp*tmp*tmp*0.00833333333f));
 			k2vg= (1.0f-(1.0f+tmp+tmp*tmp*0.5f+tmp*tmp*tmp*0.16666667f+tmp*tmp*tmp*tmp*0.0416666667f+tmp*tmp*tmp*tmp*tmp*0.00833333333f));
 		}
-		float inWithRes = tanhApp( (*input - 4.1f * resonance * amf * kacr)*iv2 ); 
+		JucePluginFilterLanes inWithRes = tanhApp( (*input - 4.1f * resonance * amf * kacr)*iv2 ); 
 
 		ay1= az1 + k2vg * (inWithRes-at1);
 		//at1 = tanhApp(ay1*iv2);
@@ -103,35 +108,32 @@ public:
 		float c3 = 4.f; // Pole 3 is not connected
 		float c4 = 2.0f; // Pole 4 isn't connected either
 
-		float output = ci * inWithRes - c1 * at1 + c2 * at2 - c3 * at3 + c4 * at4; 
+		JucePluginFilterLanes output = ci * inWithRes - c1 * at1 + c2 * at2 - c3 * at3 + c4 * at4; 
 
 		// 1/2-sample delay for phase compensation
 		amf = ay4 * 0.5f + az5 * 0.5f;
 		az5 = ay4;
 
-		if (amf > 0.0f)
-		{
-			amf *= 0.99f;
-		}
+		amf= JucePluginFilterLanes::select(JucePluginFilterLanes::greaterThan(amf, 0.0f), amf * 0.99f, amf);
 		*input = output; 
 	}
 
-	inline float tanhApp(float x) 
+	inline JucePluginFilterLanes tanhApp(JucePluginFilterLanes x) 
 	{
 		// Original
 		//return tanh(x);
 
 		// Approx
 		x*= 2.0f;
-		a= fabs(x);
+		a= JucePluginFilterLanes::abs(x);
 		b= 6.0f+a*(3.0f+a); // 6, 3
 		return (x*b)/(a*b+12.0f);
 	}
 
-	inline float tanhClipper(float x) 
+	inline JucePluginFilterLanes tanhClipper(JucePluginFilterLanes x) 
 	{
 		x*= 4.0f;
-		a= fabs(x);
+		a= JucePluginFilterLanes::abs(x);
 		b= 6.0f+a*(3.0f+a);
 		return (x*b)/(a*b+12.0f);
 	}
@@ -33,20 +33,35 @@
 class FilterHandler
 {
 private:
-	Decimator9 *decimator;
-	InterpolatorLinear *interpolatorLinear;
+	Decimator9 *decimatorL, *decimatorR;
+	InterpolatorLinear *interpolatorLinearL, *interpolatorLinearR;
+
+	// Both channels, one in each lane
 	FilterLp12dB *filterLp12dB;
 	FilterHp12dB *filterHp12dB;
 	FilterBp12dB *filterBp12dB;
 
-	float *upsampledValues;
+	float *upsampledValuesL, *upsampledValuesR;
+	JucePluginFilterLanes upsampledValues[2];
+
+	inline float scaleCutoff(float cutoff)
+	{
+		cutoff = cutoff * cutoff * cutoff * cutoff;
+
+		if (cutoff > 1.0f) cutoff = 1.0f;
+		if (cutoff < 0.0f) cutoff = 0.0f;
+		return cutoff;
+	}
 
 public:
 	FilterHandler(float sampleRate) 
 	{
-		decimator = new Decimator9();
-		interpolatorLinear = new InterpolatorLinear();
-		upsampledValues = new float[2];
+		decimatorL = new Decimator9();
+		decimatorR = new Decimator9();
+		interpolatorLinearL = new InterpolatorLinear();
+		interpolatorLinearR = new InterpolatorLinear();
+		upsampledValuesL = new float[2];
+		upsampledValuesR = new float[2];
 
 		filterLp12dB = new FilterLp12dB(sampleRate);
 		filterHp12dB = new FilterHp12dB(sampleRate);
@@ -55,46 +70,55 @@ public:
 
 	~FilterHandler()
 	{
-		delete decimator;
-		delete interpolatorLinear;
+		delete decimatorL;
+		delete decimatorR;
+		delete interpolatorLinearL;
+		delete interpolatorLinearR;
+		delete[] upsampledValuesL;
+		delete[] upsampledValuesR;
 		delete filterLp12dB;
 		delete filterHp12dB;
 		delete filterBp12dB;
 	}
 
-	inline void process(float *input, float cutoff, float resonance, float modulation, int filterType) 
+	inline void process(float *inputL, float *inputR, float cutoff, float resonance, float modulationL, float modulationR, int filterType) 
 	{
-		cutoff += modulation;
-
-		interpolatorLinear->process2x(*input, upsampledValues);
+		interpolatorLinearL->process2x(*inputL, upsampledValuesL);
+		interpolatorLinearR->process2x(*inputR, upsampledValuesR);
 		float rndFactor = 1.0f; // - cutoff * (float)rand()/RAND_MAX * 0.02f;
 
-		// Scale cutoff
-		cutoff = cutoff * cutoff * cutoff * cutoff;
+		for (int i = 0; i < 2; i++)
+		{
+			upsampledValues[i].set(0, upsampledValuesL[i]);
+			upsampledValues[i].set(1, upsampledValuesR[i]);
+		}
+
+		// Scale cutoff, the channels only differ by their modulation
+		JucePluginFilterLanes cutoffLanes;
+		cutoffLanes.set(0, scaleCutoff(cutoff + modulationL));
+		cutoffLanes.set(1, scaleCutoff(cutoff + modulationR));
 		resonance = 1.0f - resonance;
 		resonance = resonance * resonance;
 		resonance = 1.0f - resonance;
 
-		if (cutoff > 1.0f) cutoff = 1.0f;
-		if (cutoff < 0.0f) cutoff = 0.0f;
-
 		////// Do oversampled stuff here
 		switch (filterType)
 		{
 		case 1: 
-			filterLp12dB->process(&upsampledValues[0], cutoff * rndFactor, resonance, true);
-			filterLp12dB->process(&upsampledValues[1], cutoff, resonance, false);
+			filterLp12dB->process(&upsampledValues[0], cutoffLanes * rndFactor, resonance, true);
+			filterLp12dB->process(&upsampledValues[1], cutoffLanes, resonance, false);
 			break;
 		case 2: 
-			filterHp12dB->process(&upsampledValues[0], cutoff * rndFactor, resonance, true);
-			filterHp12dB->process(&upsampledValues[1], cutoff, resonance, false);
+			filterHp12dB->process(&upsampledValues[0], cutoffLanes * rndFactor, resonance, true);
+			filterHp12dB->process(&upsampledValues[1], cutoffLanes, resonance, false);
 			break;
 		case 3: 
-			filterBp12dB->process(&upsampledValues[0], cutoff * rndFactor, resonance, true);
-			filterBp12dB->process(&upsampledValues[1], cutoff, resonance, false);
+			filterBp12dB->process(&upsampledValues[0], cutoffLanes * rndFactor, resonance, true);
+			filterBp12dB->process(&upsampledValues[1], cutoffLanes, resonance, false);
 			break;
 		}
-		*input = decimator->Calc(upsampledValues[0], upsampledValues[1]);
+		*inputL = decimatorL->Calc(upsampledValues[0].get(0), upsampledValues[1].get(0));
+		*inputR = decimatorR->Calc(upsampledValues[0].get(1), upsampledValues[1].get(1));
 	}
 };
 #endif
@@ -27,6 +27,13 @@
 
 #include <cstdlib>
 
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+ #include <emmintrin.h>
+ #define TAL_NOISE_USE_SSE 1
+#else
+ #define TAL_NOISE_USE_SSE 0
+#endif
+
 class NoiseGenerator 
 {
 public:
@@ -50,6 +57,8 @@ public:
 		actualValueFiltered = 0.0f;
 		deltaValue = 0.0f;
 
+		// the first tick starts a new period anyway, the seed just has to be defined
+		randSeed = 0;
 		getNextRandomPeriod(1.0f);
 
         randSeed = rand();
@@ -96,4 +105,144 @@ public:
 		return actualValueFiltered;
 	}
 };
+
+// NUM_LANES NoiseGenerators side by side, four lanes per SSE register. Every lane
+// gives exactly the values of the NoiseGenerator it was set from: the period change
+// of tickFilteredNoise is computed on every tick and only kept where it's due.
+template <int NUM_LANES> class NoiseGeneratorLanes
+{
+private:
+	int randSeed[NUM_LANES];
+	float actualValue[NUM_LANES];
+	float deltaValue[NUM_LANES];
+	float actualValueFiltered[NUM_LANES];
+
+	float filterFactor;
+	float filterFactorInversePlusOne;
+
+#if TAL_NOISE_USE_SSE
+	// 32 bit multiply, low half, like the int multiply of tickNoise
+	static inline __m128i multiply(__m128i a, __m128i b)
+	{
+		__m128i even = _mm_mul_epu32(a, b);
+		__m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+		return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+	}
+
+	static inline __m128 tickNoise(__m128i& seed)
+	{
+		seed = multiply(seed, _mm_set1_epi32(16807));
+		return _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(seed, _mm_set1_epi32(0x7FFFFFFF))), _mm_set1_ps(4.6566129e-010f));
+	}
+#endif
+
+public:
+	NoiseGeneratorLanes()
+	{
+		filterFactor = 5000.0f;
+		filterFactorInversePlusOne = 1.0f / (filterFactor + 1.0f);
+
+		for (int i = 0; i < NUM_LANES; i++)
+		{
+			randSeed[i] = 0;
+			actualValue[i] = 0.0f;
+			deltaValue[i] = 0.0f;
+			actualValueFiltered[i] = 0.0f;
+		}
+	}
+
+	// Continues from the state of the given generator
+	void setLane(int lane, const NoiseGenerator& generator)
+	{
+		randSeed[lane] = generator.randSeed;
+		actualValue[lane] = generator.actualValue;
+		deltaValue[lane] = generator.deltaValue;
+		actualValueFiltered[lane] = generator.actualValueFiltered;
+	}
+
+	// NoiseGenerator::tickFilteredNoise of every lane
+	inline void tickFilteredNoise(float* output)
+	{
+		int i = 0;
+
+#if TAL_NOISE_USE_SSE
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 zero = _mm_setzero_ps();
+
+		for (; i + 4 <= NUM_LANES; i += 4)
+		{
+			__m128i seed = _mm_loadu_si128((const __m128i*)(randSeed + i));
+			__m128 actual = _mm_loadu_ps(actualValue + i);
+			__m128 delta = _mm_loadu_ps(deltaValue + i);
+
+			__m128 down = _mm_cmpge_ps(actual, one);
+			__m128 change = _mm_or_ps(down, _mm_cmple_ps(actual, zero));
+
+			__m128i nextSeed = seed;
+			__m128 noise = tickNoise(nextSeed);
+			__m128i randomPeriod = _mm_add_epi32(_mm_cvttps_epi32(_mm_mul_ps(noise, _mm_set1_ps(22768.0f))), _mm_set1_epi32(22188));
+			__m128 sign = _mm_or_ps(_mm_and_ps(down, _mm_set1_ps(-1.0f)), _mm_andnot_ps(down, one));
+			__m128 nextDelta = _mm_mul_ps(_mm_div_ps(one, _mm_cvtepi32_ps(randomPeriod)), sign);
+
+			__m128i changeInt = _mm_castps_si128(change);
+			seed = _mm_or_si128(_mm_and_si128(changeInt, nextSeed), _mm_andnot_si128(changeInt, seed));
+			delta = _mm_or_ps(_mm_and_ps(change, nextDelta), _mm_andnot_ps(change, delta));
+			actual = _mm_add_ps(actual, delta);
+
+			__m128 filtered = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(actualValueFiltered + i), _mm_set1_ps(filterFactor)), actual),
+				_mm_set1_ps(filterFactorInversePlusOne));
+
+			_mm_storeu_si128((__m128i*)(randSeed + i), seed);
+			_mm_storeu_ps(actualValue + i, actual);
+			_mm_storeu_ps(deltaValue + i, delta);
+			_mm_storeu_ps(actualValueFiltered + i, filtered);
+			_mm_storeu_ps(output + i, filtered);
+		}
+#endif
+
+		for (; i < NUM_LANES; i++)
+		{
+			if (actualValue[i] >= 1.0f || actualValue[i] <= 0.0f)
+			{
+				randSeed[i] *= 16807;
+				float noise = (float)(randSeed[i] & 0x7FFFFFFF) * 4.6566129e-010f;
+				int randomPeriod = (int)(noise * 22768.0f) + 22188;
+				deltaValue[i] = 1.0f / (float)randomPeriod;
+				deltaValue[i] *= actualValue[i] >= 1.0f ? -1.0f : 1.0f;
+			}
+			actualValue[i] += deltaValue[i];
+
+			actualValueFiltered[i] = (actualValueFiltered[i] * filterFactor + actualValue[i]) * filterFactorInversePlusOne;
+			output[i] = actualValueFiltered[i];
+		}
+	}
+
+	// NoiseGenerator::tickFilteredNoiseFast of every lane
+	inline void tickFilteredNoiseFast(float* output)
+	{
+		int i = 0;
+
+#if TAL_NOISE_USE_SSE
+		for (; i + 4 <= NUM_LANES; i += 4)
+		{
+			__m128i seed = _mm_loadu_si128((const __m128i*)(randSeed + i));
+			__m128 noise = tickNoise(seed);
+			__m128 filtered = _mm_div_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(actualValueFiltered + i), _mm_set1_ps(1000.0f)), noise), _mm_set1_ps(1001.0f));
+
+			_mm_storeu_si128((__m128i*)(randSeed + i), seed);
+			_mm_storeu_ps(actualValueFiltered + i, filtered);
+			_mm_storeu_ps(output + i, filtered);
+		}
+#endif
+
+		for (; i < NUM_LANES; i++)
+		{
+			randSeed[i] *= 16807;
+			float noise = (float)(randSeed[i] & 0x7FFFFFFF) * 4.6566129e-010f;
+
+			actualValueFiltered[i] = (actualValueFiltered[i] * 1000.0f + noise) / 1001.0f;
+			output[i] = actualValueFiltered[i];
+		}
+	}
+};
 #endif
@@ -25,8 +25,7 @@
 #if !defined(__TalReverb_h)
 #define __TalReverb_h
 
-#include "AllPassFilter.h"
-#include "CombFilter.h"
+#include "ReverbLanes.h"
 #include "NoiseGenerator.h"
 #include "Filter.h"
 #include "math.h"
@@ -39,30 +38,29 @@ private:
 	static const int DELAY_LINES_COMB = 4;
 	static const int DELAY_LINES_ALLPASS = 5;
 
+	// one lane per line and channel, left channel first
+	static const int COMB_LANES = DELAY_LINES_COMB * 2;
+
 	static const int MAX_PRE_DELAY_MS = 1000;
+	static const int BLOCK_SIZE = 256;
+
 	float* reflectionGains;
 	float* reflectionDelays;
 
-	CombFilter *combFiltersPreDelayL;
-	CombFilter *combFiltersPreDelayR;
+	ReverbArena arena;
 
-	CombFilter **combFiltersL;
-	CombFilter **combFiltersR;
-	NoiseGenerator **noiseGeneratorAllPassL;
-	NoiseGenerator **noiseGeneratorAllPassR;
-	NoiseGenerator **noiseGeneratorDelayL;
-	NoiseGenerator **noiseGeneratorDelayR;
-	NoiseGenerator **diffusionL;
-	NoiseGenerator **diffusionR;
+	DelayLine preDelay;
 
-	AllPassFilter **allPassFiltersL;
-	AllPassFilter **allPassFiltersR;
+	CombLanes<COMB_LANES> combFilters;
+	AllPassLanes<2> preAllPassFilters;
+	AllPassLanes<2> postAllPassFilters;
+	AllPassLanes<2> allPassFilters[DELAY_LINES_ALLPASS];
 
-	AllPassFilter *preAllPassFilterL;
-	AllPassFilter *preAllPassFilterR;
+	NoiseGeneratorLanes<COMB_LANES> diffusion;
+	NoiseGeneratorLanes<COMB_LANES> noiseGeneratorDelay;
 
-	AllPassFilter *postAllPassFilterL;
-	AllPassFilter *postAllPassFilterR;
+	// pre left, pre right, post left, post right
+	NoiseGeneratorLanes<4> noiseGeneratorAllPass;
 
 	TalEq* talEqL;
 	TalEq* talEqR;
@@ -72,8 +70,11 @@ private:
 	bool stereoMode;
 	float modulationIntensity;
 
-	float outL;
-	float outR;
+	float revL[BLOCK_SIZE];
+	float revR[BLOCK_SIZE];
+	float interleaved[BLOCK_SIZE * 2];
+	float outL[BLOCK_SIZE];
+	float outR[BLOCK_SIZE];
 
 	AudioUtils audioUtils;
 
@@ -82,17 +83,7 @@ public:
 	{
 		createDelaysAndCoefficients(DELAY_LINES_COMB + DELAY_LINES_ALLPASS, 82.0f);
 
-		combFiltersPreDelayL = new CombFilter((float)MAX_PRE_DELAY_MS, 0.0f, sampleRate);
-		combFiltersPreDelayR = new CombFilter((float)MAX_PRE_DELAY_MS, 0.0f, sampleRate);
-
-		combFiltersL = new CombFilter *[DELAY_LINES_COMB];
-		combFiltersR = new CombFilter *[DELAY_LINES_COMB];
-		noiseGeneratorAllPassL = new NoiseGenerator *[DELAY_LINES_COMB];
-		noiseGeneratorAllPassR = new NoiseGenerator *[DELAY_LINES_COMB];
-		noiseGeneratorDelayL = new NoiseGenerator *[DELAY_LINES_COMB];
-		noiseGeneratorDelayR = new NoiseGenerator *[DELAY_LINES_COMB];
-	    diffusionL = new NoiseGenerator *[DELAY_LINES_COMB];
-	    diffusionR = new NoiseGenerator *[DELAY_LINES_COMB];
+		preDelay.setLine((float)MAX_PRE_DELAY_MS, sampleRate);
 
 		float stereoSpreadValue = 0.008f;
 		float stereoSpreadSign = 1.0f;
@@ -101,37 +92,61 @@ public:
 			float stereoSpreadFactor = 1.0f + stereoSpreadValue;
 			if (stereoSpreadSign > 0.0f)
 			{
-				combFiltersL[i] = new CombFilter(reflectionDelays[i] * stereoSpreadFactor, reflectionGains[i], sampleRate);
-				combFiltersR[i] = new CombFilter(reflectionDelays[i], reflectionGains[i], sampleRate);
+				combFilters.setLine(i, reflectionDelays[i] * stereoSpreadFactor, reflectionGains[i], sampleRate);
+				combFilters.setLine(DELAY_LINES_COMB + i, reflectionDelays[i], reflectionGains[i], sampleRate);
 			}
 			else
 			{
-				combFiltersL[i] = new CombFilter(reflectionDelays[i], reflectionGains[i], sampleRate);
-				combFiltersR[i] = new CombFilter(reflectionDelays[i] * stereoSpreadFactor, reflectionGains[i], sampleRate);
+				combFilters.setLine(i, reflectionDelays[i], reflectionGains[i], sampleRate);
+				combFilters.setLine(DELAY_LINES_COMB + i, reflectionDelays[i] * stereoSpreadFactor, reflectionGains[i], sampleRate);
 			}
 			stereoSpreadSign *= -1.0f;
-			noiseGeneratorAllPassL[i] = new NoiseGenerator(sampleRate);
-			noiseGeneratorAllPassR[i] = new NoiseGenerator(sampleRate);
-			noiseGeneratorDelayL[i] = new NoiseGenerator(sampleRate);
-			noiseGeneratorDelayR[i] = new NoiseGenerator(sampleRate);
-			diffusionL[i] = new NoiseGenerator(sampleRate);
-			diffusionR[i] = new NoiseGenerator(sampleRate);
+
+			// Seeded by rand(), created in the same order as always
+			NoiseGenerator allPassL(sampleRate);
+			NoiseGenerator allPassR(sampleRate);
+			NoiseGenerator delayL(sampleRate);
+			NoiseGenerator delayR(sampleRate);
+			NoiseGenerator diffusionL(sampleRate);
+			NoiseGenerator diffusionR(sampleRate);
+
+			if (i < 2)
+			{
+				noiseGeneratorAllPass.setLane(i * 2, allPassL);
+				noiseGeneratorAllPass.setLane(i * 2 + 1, allPassR);
+			}
+			noiseGeneratorDelay.setLane(i, delayL);
+			noiseGeneratorDelay.setLane(DELAY_LINES_COMB + i, delayR);
+			diffusion.setLane(i, diffusionL);
+			diffusion.setLane(DELAY_LINES_COMB + i, diffusionR);
 		}
 
-		preAllPassFilterL = new AllPassFilter(20.0f,  0.68f, sampleRate);
-		preAllPassFilterR = new AllPassFilter(20.0f,  0.68f, sampleRate);
+		preAllPassFilters.setLine(0, 20.0f,  0.68f, sampleRate);
+		preAllPassFilters.setLine(1, 20.0f,  0.68f, sampleRate);
+
+		postAllPassFilters.setLine(0, 200.0f,  0.68f, sampleRate);
+		postAllPassFilters.setLine(1, 200.0f,  0.68f, sampleRate);
 
-		postAllPassFilterL = new AllPassFilter(200.0f,  0.68f, sampleRate);
-		postAllPassFilterR = new AllPassFilter(200.0f,  0.68f, sampleRate);
- 
-		allPassFiltersL = new AllPassFilter *[DELAY_LINES_ALLPASS];
-		allPassFiltersR = new AllPassFilter *[DELAY_LINES_ALLPASS];
 		for (int i = 0; i < DELAY_LINES_ALLPASS; i++)
 		{
-			allPassFiltersL[i] = new AllPassFilter(reflectionDelays[i + DELAY_LINES_COMB - 1] * 0.105f,  0.68f, sampleRate);
-			allPassFiltersR[i] = new AllPassFilter(reflectionDelays[i + DELAY_LINES_COMB - 1] * 0.1f,  0.68f, sampleRate);
+			allPassFilters[i].setLine(0, reflectionDelays[i + DELAY_LINES_COMB - 1] * 0.105f,  0.68f, sampleRate);
+			allPassFilters[i].setLine(1, reflectionDelays[i + DELAY_LINES_COMB - 1] * 0.1f,  0.68f, sampleRate);
         }
 
+		preDelay.reserve(arena);
+		combFilters.reserve(arena);
+		preAllPassFilters.reserve(arena);
+		postAllPassFilters.reserve(arena);
+		for (int i = 0; i < DELAY_LINES_ALLPASS; i++) allPassFilters[i].reserve(arena);
+
+		arena.allocate();
+
+		preDelay.assign(arena);
+		combFilters.assign(arena);
+		preAllPassFilters.assign(arena);
+		postAllPassFilters.assign(arena);
+		for (int i = 0; i < DELAY_LINES_ALLPASS; i++) allPassFilters[i].assign(arena);
+
 		talEqL = new TalEq(sampleRate);
 		talEqR = new TalEq(sampleRate);
 
@@ -139,9 +154,6 @@ public:
 		preDelayTime = 0.0f;
 		modulationIntensity = 0.12f;
 		stereoMode = false;
-
-		outL = 0.0f;
-		outR = 0.0f;
 	}
 
 	~TalReverb()
@@ -149,39 +161,6 @@ public:
 		delete[] reflectionGains;
 		delete[] reflectionDelays;
 
-		delete combFiltersPreDelayL;
-		delete combFiltersPreDelayR;
-
-        for (int i = 0; i < DELAY_LINES_COMB; i++) delete combFiltersL[i];
-		delete[] combFiltersL;
-        for (int i = 0; i < DELAY_LINES_COMB; i++) delete combFiltersR[i];
-		delete[] combFiltersR;
-
-        for (int i = 0; i < DELAY_LINES_ALLPASS; i++) delete allPassFiltersL[i];
-		delete[] allPassFiltersL;
-        for (int i = 0; i < DELAY_LINES_ALLPASS; i++) delete allPassFiltersR[i];
-		delete[] allPassFiltersR;
-
-        for (int i = 0; i < DELAY_LINES_COMB; i++) delete noiseGeneratorAllPassL[i];
-		delete[] noiseGeneratorAllPassL;
-        for (int i = 0; i < DELAY_LINES_COMB; i++) delete noiseGeneratorAllPassR[i];
-		delete[] noiseGeneratorAllPassR;
-        for (int i = 0; i < DELAY_LINES_COMB; i++) delete noiseGeneratorDelayL[i];
-		delete[] noiseGeneratorDelayL;
-        for (int i = 0; i < DELAY_LINES_COMB; i++) delete noiseGeneratorDelayR[i];
-		delete[] noiseGeneratorDelayR;
-
-        for (int i = 0; i < DELAY_LINES_COMB; i++) delete diffusionL[i];
-	    delete[] diffusionL;
-        for (int i = 0; i < DELAY_LINES_COMB; i++) delete diffusionR[i];
-	    delete[] diffusionR;
-
-		delete preAllPassFilterL;
-		delete preAllPassFilterR;
-
-		delete postAllPassFilterL;
-		delete postAllPassFilterR;
-
 		delete talEqL;
 		delete talEqR;
 	}
@@ -244,59 +223,129 @@ public:
 	}
 
 	// All input values [0..1]
-	inline void process(float* sampleL, float* sampleR)
+	inline void processBlock(float* sampleL, float* sampleR, int numSamples)
 	{
-		float revR;
-		float revL;
+		while (numSamples > 0)
+		{
+			int blockSize = numSamples < BLOCK_SIZE ? numSamples : BLOCK_SIZE;
+
+			processChunk(sampleL, sampleR, blockSize);
+
+			sampleL += blockSize;
+			sampleR += blockSize;
+			numSamples -= blockSize;
+		}
+	}
 
+private:
+	inline void processChunk(float* sampleL, float* sampleR, int numSamples)
+	{
 		if (!stereoMode)
 		{
-			revL = (*sampleL + *sampleR) * 0.25f; 
-			revL = combFiltersPreDelayL->process(revL, 0.0f, 0.0f, preDelayTime);
-			talEqL->process(&revL);
-			revR = revL;
+			for (int n = 0; n < numSamples; n++)
+			{
+				revL[n] = (sampleL[n] + sampleR[n]) * 0.25f;
+			}
+
+			preDelay.process(revL, revL, numSamples, preDelayTime);
+
+			for (int n = 0; n < numSamples; n++)
+			{
+				talEqL->process(&revL[n]);
+				revR[n] = revL[n];
+			}
 		}
 		else
 		{
-			revL = combFiltersPreDelayL->process(*sampleL * 0.5f, 0.0f, 0.0f, preDelayTime);
-			revR = combFiltersPreDelayL->process(*sampleR * 0.5f, 0.0f, 0.0f, preDelayTime);
-			talEqL->process(&revL);
-			talEqR->process(&revR);
-		}
+			// Both channels share the one pre delay line, a left and a right sample per tick
+			for (int n = 0; n < numSamples; n++)
+			{
+				interleaved[n * 2] = sampleL[n] * 0.5f;
+				interleaved[n * 2 + 1] = sampleR[n] * 0.5f;
+			}
 
-		// ----------------- Comb Filter --------------------
-		outL = 0.0f;
-		outR = 0.0f;
+			preDelay.process(interleaved, interleaved, numSamples * 2, preDelayTime);
 
-		float scaledRoomSize = decayTime * 0.998f;
-		float sign = 1.0f;
-		for (int i = 0; i < DELAY_LINES_COMB; i++)
-		{ 
-            outL += sign * combFiltersL[i]->processInterpolated(revL, diffusionL[i]->tickFilteredNoiseFast() * 0.2f, scaledRoomSize, scaledRoomSize + 0.012f * noiseGeneratorDelayL[i]->tickFilteredNoise());
-			outR += sign * combFiltersR[i]->processInterpolated(revR, diffusionR[i]->tickFilteredNoiseFast() * 0.2f, scaledRoomSize, scaledRoomSize + 0.012f * noiseGeneratorDelayR[i]->tickFilteredNoise());
-			sign *= -1.0f;
+			for (int n = 0; n < numSamples; n++)
+			{
+				revL[n] = interleaved[n * 2];
+				revR[n] = interleaved[n * 2 + 1];
+				talEqL->process(&revL[n]);
+				talEqR->process(&revR[n]);
+			}
 		}
 
-		// ----------------- Pre AllPass --------------------
-		outL += 0.5f * preAllPassFilterL->processInterpolated(revR, 0.8f + 0.2f * noiseGeneratorAllPassL[0]->tickFilteredNoise(), 0.69f, true);
-		outR += 0.5f * preAllPassFilterR->processInterpolated(revL, 0.8f + 0.2f * noiseGeneratorAllPassR[0]->tickFilteredNoise(), 0.69f, true);
+		float scaledRoomSize = decayTime * 0.998f;
+		for (int n = 0; n < numSamples; n++)
+		{
+			// ----------------- Comb Filter --------------------
+			float input[COMB_LANES];
+			float damp[COMB_LANES];
+			float delay[COMB_LANES];
+			float comb[COMB_LANES];
+
+			diffusion.tickFilteredNoiseFast(damp);
+			noiseGeneratorDelay.tickFilteredNoise(delay);
+
+			for (int i = 0; i < COMB_LANES; i++)
+			{
+				input[i] = i < DELAY_LINES_COMB ? revL[n] : revR[n];
+				damp[i] = damp[i] * 0.2f;
+				delay[i] = scaledRoomSize + 0.012f * delay[i];
+			}
+
+			combFilters.process(input, damp, scaledRoomSize, delay, comb);
+
+			outL[n] = 0.0f;
+			outR[n] = 0.0f;
+
+			float sign = 1.0f;
+			for (int i = 0; i < DELAY_LINES_COMB; i++)
+			{
+				outL[n] += sign * comb[i];
+				outR[n] += sign * comb[DELAY_LINES_COMB + i];
+				sign *= -1.0f;
+			}
 
-		//// ----------------- Post AllPass --------------------
-		outL += 0.45f * postAllPassFilterL->processInterpolated(revL, 0.8f + 0.2f * noiseGeneratorAllPassL[1]->tickFilteredNoise(), 0.69f, false);
-		outR += 0.45f * postAllPassFilterR->processInterpolated(revR, 0.8f + 0.2f * noiseGeneratorAllPassR[1]->tickFilteredNoise(), 0.69f, false);
+			float modulation[4];
+			noiseGeneratorAllPass.tickFilteredNoise(modulation);
+			for (int i = 0; i < 4; i++)
+			{
+				modulation[i] = 0.8f + 0.2f * modulation[i];
+			}
+
+			// ----------------- Pre AllPass --------------------
+			float crossed[2] = { revR[n], revL[n] };
+			float pre[2];
+			preAllPassFilters.processInterpolated(crossed, modulation, 0.69f, true, pre);
+			outL[n] += 0.5f * pre[0];
+			outR[n] += 0.5f * pre[1];
+
+			//// ----------------- Post AllPass --------------------
+			float straight[2] = { revL[n], revR[n] };
+			float post[2];
+			postAllPassFilters.processInterpolated(straight, modulation + 2, 0.69f, false, post);
+			outL[n] += 0.45f * post[0];
+			outR[n] += 0.45f * post[1];
+		}
 
 		// ----------------- AllPass Filter ------------------
+		// Nothing feeds back, every stage takes the whole block
 		for (int i = 0; i < DELAY_LINES_ALLPASS; i++)
 		{
-			outL = allPassFiltersL[i]->process(outL);
-			outR = allPassFiltersR[i]->process(outR);
+			allPassFilters[i].processBlock(0, outL, numSamples);
+			allPassFilters[i].processBlock(1, outR, numSamples);
 		}
 
 		// ----------------- Write to output / Stereo --------
-		*sampleL = outL;
-		*sampleR = outR;
+		for (int n = 0; n < numSamples; n++)
+		{
+			sampleL[n] = outL[n];
+			sampleR[n] = outR[n];
+		}
 	}
 
+public:
 	void createDelaysAndCoefficients(int numlines, float delayLength)
 	{
 		reflectionDelays = new float[numlines];
@@ -33,6 +33,12 @@
 
 class ReverbEngine
 {
+private:
+	static const int BLOCK_SIZE = 256;
+
+	float drysampleL[BLOCK_SIZE];
+	float drysampleR[BLOCK_SIZE];
+
 public:
 	float *param;
 	TalReverb* reverb;
@@ -158,27 +164,42 @@ public:
 		stereoWidth = 1.0f;
 	}
 
-	void process(float *sampleL, float *sampleR) 
+	void processBlock(float *sampleL, float *sampleR, int numSamples)
 	{
-		// avoid cpu spikes
-		float noise = noiseGenerator->tickNoise() * 0.000000001f;
+		while (numSamples > 0)
+		{
+			int blockSize = numSamples < BLOCK_SIZE ? numSamples : BLOCK_SIZE;
+
+			for (int n = 0; n < blockSize; n++)
+			{
+				// avoid cpu spikes
+				float noise = noiseGenerator->tickNoise() * 0.000000001f;
+
+				sampleL[n] += noise;
+				sampleR[n] += noise;
 
-		*sampleL += noise;
-		*sampleR += noise;
+				drysampleL[n] = sampleL[n];
+				drysampleR[n] = sampleR[n];
+			}
 
-		float drysampleL = *sampleL;
-		float drysampleR = *sampleR;
+			reverb->processBlock(sampleL, sampleR, blockSize);
 
-		reverb->process(sampleL, sampleR);
+			for (int n = 0; n < blockSize; n++)
+			{
+				// Process Stereo
+				float actualDryValue = dryParamChange->tick(dry);
+				float wet1 = wet * (stereoWidth * 0.5f + 0.5f);
+				float wet2 = wet * ((1.0f - stereoWidth) * 0.5f);
+				float resultL = sampleL[n] * wet1 + sampleR[n] * wet2 + drysampleL[n] * actualDryValue;
+				float resultR = sampleR[n] * wet1 + sampleL[n] * wet2 + drysampleR[n] * actualDryValue;
+				sampleL[n] = resultL;
+				sampleR[n] = resultR;
+			}
 
-		// Process Stereo
-		float actualDryValue = dryParamChange->tick(dry);
-		float wet1 = wet * (stereoWidth * 0.5f + 0.5f);
-		float wet2 = wet * ((1.0f - stereoWidth) * 0.5f);
-		float resultL = *sampleL * wet1 + *sampleR * wet2 + drysampleL * actualDryValue;
-		float resultR = *sampleR * wet1 + *sampleL * wet2 + drysampleR * actualDryValue;
-		*sampleL = resultL;
-		*sampleR = resultR;
+			sampleL += blockSize;
+			sampleR += blockSize;
+			numSamples -= blockSize;
+		}
 	}
 };
 #endif
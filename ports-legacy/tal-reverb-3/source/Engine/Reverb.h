@@ -24,10 +24,8 @@
 #if !defined(__TalReverb_h)
 #define __TalReverb_h
 
-#include "AllPassFilter.h"
-#include "CombFilter.h"
+#include "ReverbLanes.h"
 #include "NoiseGenerator.h"
-#include "Filter.h"
 #include "math.h"
 #include "AudioUtils.h"
 #include "TalEq.h"
@@ -38,30 +36,28 @@ private:
 	static const int DELAY_LINES_COMB = 4;
 	static const int DELAY_LINES_ALLPASS = 5;
 
+	// one lane per line and channel, left channel first
+	static const int COMB_LANES = DELAY_LINES_COMB * 2;
+
 	static const int MAX_PRE_DELAY_MS = 1000;
+	static const int BLOCK_SIZE = 256;
+
 	float* reflectionGains;
 	float* reflectionDelays;
 
-	CombFilter *combFiltersPreDelayL;
-	CombFilter *combFiltersPreDelayR;
+	ReverbArena arena;
 
-	CombFilter **combFiltersL;
-	CombFilter **combFiltersR;
-	NoiseGenerator **noiseGeneratorAllPassL;
-	NoiseGenerator **noiseGeneratorAllPassR;
-	NoiseGenerator **noiseGeneratorDelayL;
-	NoiseGenerator **noiseGeneratorDelayR;
-	NoiseGenerator **diffusionL;
-	NoiseGenerator **diffusionR;
+	DelayLine preDelayL;
+	DelayLine preDelayR;
 
-	AllPassFilter **allPassFiltersL;
-	AllPassFilter **allPassFiltersR;
+	CombLanes<COMB_LANES> combFilters;
+	AllPassLanes<2> preAllPassFilters;
+	AllPassLanes<2> postAllPassFilters;
+	AllPassLanes<2> allPassFilters[DELAY_LINES_ALLPASS];
 
-	AllPassFilter *preAllPassFilterL;
-	AllPassFilter *preAllPassFilterR;
-
-	AllPassFilter *postAllPassFilterL;
-	AllPassFilter *postAllPassFilterR;
+	NoiseGeneratorLanes<COMB_LANES>* diffusion;
+	NoiseGeneratorLanes<COMB_LANES>* noiseGeneratorDelay;
+	NoiseGeneratorLanes<2>* noiseGeneratorAllPass;
 
 	TalEq* talEqL;
 	TalEq* talEqR;
@@ -79,6 +75,11 @@ private:
 
     float feedbackSampleRateFactor;
 
+	float revL[BLOCK_SIZE];
+	float revR[BLOCK_SIZE];
+	float delayedL[BLOCK_SIZE];
+	float combOutput[BLOCK_SIZE][COMB_LANES];
+
 	AudioUtils audioUtils;
 
 public:
@@ -90,17 +91,12 @@ public:
 
 		this->createDelaysAndCoefficients(DELAY_LINES_ALLPASS, 100.0f);
 
-		this->combFiltersPreDelayL = new CombFilter((float)MAX_PRE_DELAY_MS, 0.0f, sampleRate);
-		this->combFiltersPreDelayR = new CombFilter((float)MAX_PRE_DELAY_MS, 0.0f, sampleRate);
+		this->preDelayL.setLine((float)MAX_PRE_DELAY_MS, sampleRate);
+		this->preDelayR.setLine((float)MAX_PRE_DELAY_MS, sampleRate);
 
-		this->combFiltersL = new CombFilter *[DELAY_LINES_COMB];
-		this->combFiltersR = new CombFilter *[DELAY_LINES_COMB];
-		this->noiseGeneratorAllPassL = new NoiseGenerator *[DELAY_LINES_COMB];
-		this->noiseGeneratorAllPassR = new NoiseGenerator *[DELAY_LINES_COMB];
-		this->noiseGeneratorDelayL = new NoiseGenerator *[DELAY_LINES_COMB];
-		this->noiseGeneratorDelayR = new NoiseGenerator *[DELAY_LINES_COMB];
-	    this->diffusionL = new NoiseGenerator *[DELAY_LINES_COMB];
-	    this->diffusionR = new NoiseGenerator *[DELAY_LINES_COMB];
+		float combSampleRateFactor = 44100.0f / sampleRate;
+		if (combSampleRateFactor > 1.0f) combSampleRateFactor = 1.0f;
+		this->combFilters.setSampleRateFactor(combSampleRateFactor);
 
 		float stereoSpreadValue = 0.008f;
 		float stereoSpreadSign = 1.0f;
@@ -109,38 +105,59 @@ public:
 			float stereoSpreadFactor = 1.0f + stereoSpreadValue;
 			if (stereoSpreadSign > 0.0f)
 			{
-				combFiltersL[i] = new CombFilter(reflectionDelays[i] * stereoSpreadFactor, 1.0f, sampleRate);
-				combFiltersR[i] = new CombFilter(reflectionDelays[i], 1.0f, sampleRate);
+				combFilters.setLine(i, reflectionDelays[i] * stereoSpreadFactor, 1.0f, sampleRate);
+				combFilters.setLine(DELAY_LINES_COMB + i, reflectionDelays[i], 1.0f, sampleRate);
 			}
 			else
 			{
-				combFiltersL[i] = new CombFilter(reflectionDelays[i], 1.0f, sampleRate);
-				combFiltersR[i] = new CombFilter(reflectionDelays[i] * stereoSpreadFactor, 1.0f, sampleRate);
+				combFilters.setLine(i, reflectionDelays[i], 1.0f, sampleRate);
+				combFilters.setLine(DELAY_LINES_COMB + i, reflectionDelays[i] * stereoSpreadFactor, 1.0f, sampleRate);
 			}
 			stereoSpreadSign *= -1.0f;
+		}
+
+		this->diffusion = new NoiseGeneratorLanes<COMB_LANES>((float)sampleRate);
+		this->noiseGeneratorDelay = new NoiseGeneratorLanes<COMB_LANES>((float)sampleRate);
+		this->noiseGeneratorAllPass = new NoiseGeneratorLanes<2>((float)sampleRate);
 
-			this->noiseGeneratorAllPassL[i] = new NoiseGenerator((float)sampleRate, (float)i);
-			this->noiseGeneratorAllPassR[i] = new NoiseGenerator((float)sampleRate, i + 163.0f);
-			this->noiseGeneratorDelayL[i] = new NoiseGenerator((float)sampleRate, i + 257.0f);
-			this->noiseGeneratorDelayR[i] = new NoiseGenerator((float)sampleRate, i + 353.0f);
-			this->diffusionL[i] = new NoiseGenerator((float)sampleRate, i + 455.0f);
-			this->diffusionR[i] = new NoiseGenerator((float)sampleRate, i + 633.0f);
+		for (int i = 0; i < DELAY_LINES_COMB; i++)
+		{
+			this->diffusion->setLane(i, NoiseGenerator((float)sampleRate, i + 455.0f));
+			this->diffusion->setLane(DELAY_LINES_COMB + i, NoiseGenerator((float)sampleRate, i + 633.0f));
+			this->noiseGeneratorDelay->setLane(i, NoiseGenerator((float)sampleRate, i + 257.0f));
+			this->noiseGeneratorDelay->setLane(DELAY_LINES_COMB + i, NoiseGenerator((float)sampleRate, i + 353.0f));
 		}
+		this->noiseGeneratorAllPass->setLane(0, NoiseGenerator((float)sampleRate, 0.0f));
+		this->noiseGeneratorAllPass->setLane(1, NoiseGenerator((float)sampleRate, 163.0f));
+
+		this->preAllPassFilters.setLine(0, 90.0f,  0.68f, sampleRate);
+		this->preAllPassFilters.setLine(1, 90.0f,  0.68f, sampleRate);
 
-		this->preAllPassFilterL = new AllPassFilter(90.0f,  0.68f, sampleRate);
-		this->preAllPassFilterR = new AllPassFilter(90.0f,  0.68f, sampleRate);
+		this->postAllPassFilters.setLine(0, 91.0f,  0.68f, sampleRate);
+		this->postAllPassFilters.setLine(1, 91.0f,  0.68f, sampleRate);
 
-		this->postAllPassFilterL = new AllPassFilter(91.0f,  0.68f, sampleRate);
-		this->postAllPassFilterR = new AllPassFilter(91.0f,  0.68f, sampleRate);
- 
-		this->allPassFiltersL = new AllPassFilter *[DELAY_LINES_ALLPASS];
-		this->allPassFiltersR = new AllPassFilter *[DELAY_LINES_ALLPASS];
 		for (int i = 0; i < DELAY_LINES_ALLPASS; i++)
 		{
-			this->allPassFiltersL[i] = new AllPassFilter(reflectionDelays[i] * 0.2f,  0.68f, sampleRate);
-			this->allPassFiltersR[i] = new AllPassFilter(reflectionDelays[i] * 0.2f,  0.68f, sampleRate);
+			this->allPassFilters[i].setLine(0, reflectionDelays[i] * 0.2f,  0.68f, sampleRate);
+			this->allPassFilters[i].setLine(1, reflectionDelays[i] * 0.2f,  0.68f, sampleRate);
         }
 
+		preDelayL.reserve(arena);
+		preDelayR.reserve(arena);
+		combFilters.reserve(arena);
+		preAllPassFilters.reserve(arena);
+		postAllPassFilters.reserve(arena);
+		for (int i = 0; i < DELAY_LINES_ALLPASS; i++) allPassFilters[i].reserve(arena);
+
+		arena.allocate();
+
+		preDelayL.assign(arena);
+		preDelayR.assign(arena);
+		combFilters.assign(arena);
+		preAllPassFilters.assign(arena);
+		postAllPassFilters.assign(arena);
+		for (int i = 0; i < DELAY_LINES_ALLPASS; i++) allPassFilters[i].assign(arena);
+
 		this->talEqL = new TalEq((float)sampleRate);
 		this->talEqR = new TalEq((float)sampleRate);
 
@@ -161,38 +178,9 @@ public:
 		delete[] reflectionGains;
 		delete[] reflectionDelays;
 
-		delete combFiltersPreDelayL;
-		delete combFiltersPreDelayR;
-
-        for (int i = 0; i < DELAY_LINES_COMB; i++) delete combFiltersL[i];
-		delete[] combFiltersL;
-        for (int i = 0; i < DELAY_LINES_COMB; i++) delete combFiltersR[i];
-		delete[] combFiltersR;
-
-        for (int i = 0; i < DELAY_LINES_ALLPASS; i++) delete allPassFiltersL[i];
-		delete[] allPassFiltersL;
-        for (int i = 0; i < DELAY_LINES_ALLPASS; i++) delete allPassFiltersR[i];
-		delete[] allPassFiltersR;
-
-        for (int i = 0; i < DELAY_LINES_COMB; i++) delete noiseGeneratorAllPassL[i];
-		delete[] noiseGeneratorAllPassL;
-        for (int i = 0; i < DELAY_LINES_COMB; i++) delete noiseGeneratorAllPassR[i];
-		delete[] noiseGeneratorAllPassR;
-        for (int i = 0; i < DELAY_LINES_COMB; i++) delete noiseGeneratorDelayL[i];
-		delete[] noiseGeneratorDelayL;
-        for (int i = 0; i < DELAY_LINES_COMB; i++) delete noiseGeneratorDelayR[i];
-		delete[] noiseGeneratorDelayR;
-
-        for (int i = 0; i < DELAY_LINES_COMB; i++) delete diffusionL[i];
-	    delete[] diffusionL;
-        for (int i = 0; i < DELAY_LINES_COMB; i++) delete diffusionR[i];
-	    delete[] diffusionR;
-
-		delete preAllPassFilterL;
-		delete preAllPassFilterR;
-
-		delete postAllPassFilterL;
-		delete postAllPassFilterR;
+		delete diffusion;
+		delete noiseGeneratorDelay;
+		delete noiseGeneratorAllPass;
 
 		delete talEqL;
 		delete talEqR;
@@ -238,68 +226,129 @@ public:
 	}
 
 	// All input values [0..1]
-	inline void process(float* sampleL, float* sampleR)
+	inline void processBlock(float* sampleL, float* sampleR, int numSamples)
 	{
-		float revL = 0.0f;
-		float revR = 0.0f;
+		while (numSamples > 0)
+		{
+			int blockSize = numSamples < BLOCK_SIZE ? numSamples : BLOCK_SIZE;
+
+			this->processChunk(sampleL, sampleR, blockSize);
 
+			sampleL += blockSize;
+			sampleR += blockSize;
+			numSamples -= blockSize;
+		}
+	}
+
+private:
+	inline void processChunk(float* sampleL, float* sampleR, int numSamples)
+	{
 		if (!stereoMode)
 		{
-			revL += (*sampleL + *sampleR) * 0.125f; 
-			revL += combFiltersPreDelayL->process(revL, 0.0f, 0.0f, preDelayTime);
-			talEqL->process(&revL);
-			revR = revL;
+			for (int n = 0; n < numSamples; n++)
+			{
+				revL[n] = (sampleL[n] + sampleR[n]) * 0.125f;
+			}
+
+			preDelayL.process(revL, delayedL, numSamples, preDelayTime);
+
+			for (int n = 0; n < numSamples; n++)
+			{
+				revL[n] += delayedL[n];
+				talEqL->process(&revL[n]);
+				revR[n] = revL[n];
+			}
 		}
 		else
 		{
-			revL += combFiltersPreDelayL->process(*sampleL * 0.5f, 0.0f, 0.0f, preDelayTime);
-			revR += combFiltersPreDelayR->process(*sampleR * 0.5f, 0.0f, 0.0f, preDelayTime);
-			talEqL->process(&revL);
-			talEqR->process(&revR);
+			for (int n = 0; n < numSamples; n++)
+			{
+				revL[n] = sampleL[n] * 0.5f;
+				revR[n] = sampleR[n] * 0.5f;
+			}
+
+			preDelayL.process(revL, revL, numSamples, preDelayTime);
+			preDelayR.process(revR, revR, numSamples, preDelayTime);
+
+			for (int n = 0; n < numSamples; n++)
+			{
+				talEqL->process(&revL[n]);
+				talEqR->process(&revR[n]);
+			}
 		}
 
 		// ----------------- Comb Filter --------------------
-        float feedbackFactor = 0.15f;
-		outL = feedbackValueL * feedbackFactor;
-		outR = feedbackValueR * feedbackFactor;
-
+		// They don't depend on the output, the whole block goes first
 		float scaledRoomSizeDelay = this->decayTime * 0.972f;
 		float scaledRoomSizeDamp = this->decayTime * 0.99f;
         float invDecayTime = 0.9f * (1.0f - this->decayTime);
-		for (int i = 0; i < DELAY_LINES_COMB; i++)
-		{ 
-            outL += combFiltersL[i]->processInterpolated(revL, diffusionL[i]->tickFilteredNoiseFast() * invDecayTime, scaledRoomSizeDamp, scaledRoomSizeDelay + 0.028f * noiseGeneratorDelayL[i]->tickFilteredNoise());
-			outR += combFiltersR[i]->processInterpolated(revR, diffusionR[i]->tickFilteredNoiseFast() * invDecayTime, scaledRoomSizeDamp, scaledRoomSizeDelay + 0.028f * noiseGeneratorDelayR[i]->tickFilteredNoise());
-		}
+		for (int n = 0; n < numSamples; n++)
+		{
+			float input[COMB_LANES];
+			float damp[COMB_LANES];
+			float delay[COMB_LANES];
 
-		// ----------------- Pre AllPass --------------------
-		float modL = preAllPassFilterL->processInterpolated(revL, 0.995f + 0.005f * noiseGeneratorAllPassL[0]->tickFilteredNoise(), 0.68f, true);
-		float modR = preAllPassFilterR->processInterpolated(revR, 0.995f + 0.005f * noiseGeneratorAllPassR[0]->tickFilteredNoise(), 0.68f, true);
+			diffusion->tickFilteredNoiseFast(damp);
+			noiseGeneratorDelay->tickFilteredNoise(delay);
 
-		// ----------------- Post AllPass --------------------
-	    outL += 0.4f * postAllPassFilterL->processInterpolated(modL, decayTime, 0.68f, false);
-		outR += 0.4f * postAllPassFilterR->processInterpolated(modR, decayTime, 0.68f, false);
+			for (int i = 0; i < COMB_LANES; i++)
+			{
+				input[i] = i < DELAY_LINES_COMB ? revL[n] : revR[n];
+				damp[i] = damp[i] * invDecayTime;
+				delay[i] = scaledRoomSizeDelay + 0.028f * delay[i];
+			}
 
-		// ----------------- AllPass Filter ------------------
-		for (int i = 0; i < DELAY_LINES_ALLPASS; i++)
-		{
-			outL = allPassFiltersL[i]->process(outL);
-			outR = allPassFiltersR[i]->process(outR);
+			combFilters.process(input, damp, scaledRoomSizeDamp, delay, combOutput[n]);
 		}
 
-		// ----------------- Write to output / Stereo --------
-        //if (outL > 2.0f)  outL = 2.0f;
-        //if (outR > 2.0f)  outR = 2.0f;
-        //if (outL < -2.0f)  outL = -2.0f;
-        //if (outR < -2.0f)  outR = -2.0f;
+		for (int n = 0; n < numSamples; n++)
+		{
+	        float feedbackFactor = 0.15f;
+			outL = feedbackValueL * feedbackFactor;
+			outR = feedbackValueR * feedbackFactor;
 
-		*sampleL = outL;
-		*sampleR = outR;
+			for (int i = 0; i < DELAY_LINES_COMB; i++)
+			{
+				outL += combOutput[n][i];
+				outR += combOutput[n][DELAY_LINES_COMB + i];
+			}
 
-        feedbackValueL = outL;
-        feedbackValueR = outR;
+			// ----------------- Pre AllPass --------------------
+			float input[2] = { revL[n], revR[n] };
+			float modulation[2];
+			noiseGeneratorAllPass->tickFilteredNoise(modulation);
+			modulation[0] = 0.995f + 0.005f * modulation[0];
+			modulation[1] = 0.995f + 0.005f * modulation[1];
+			float mod[2];
+			preAllPassFilters.processInterpolated(input, modulation, 0.68f, true, mod);
+
+			// ----------------- Post AllPass --------------------
+			float decay[2] = { decayTime, decayTime };
+			float post[2];
+			postAllPassFilters.processInterpolated(mod, decay, 0.68f, false, post);
+		    outL += 0.4f * post[0];
+			outR += 0.4f * post[1];
+
+			// ----------------- AllPass Filter ------------------
+			// In the feedback loop, one sample at a time
+			float values[2] = { outL, outR };
+			for (int i = 0; i < DELAY_LINES_ALLPASS; i++)
+			{
+				allPassFilters[i].process(values);
+			}
+			outL = values[0];
+			outR = values[1];
+
+			// ----------------- Write to output / Stereo --------
+			sampleL[n] = outL;
+			sampleR[n] = outR;
+
+	        feedbackValueL = outL;
+	        feedbackValueR = outR;
+		}
 	}
 
+public:
 	void createDelaysAndCoefficients(int numlines, float delayLength)
 	{
 		this->reflectionDelays = new float[numlines];
@@ -32,6 +32,12 @@
 
 class ReverbEngine 
 {
+private:
+	static const int BLOCK_SIZE = 256;
+
+	float drysampleL[BLOCK_SIZE];
+	float drysampleR[BLOCK_SIZE];
+
 public:
 	float *param;
 	TalReverb* reverb;
@@ -171,35 +177,50 @@ public:
 		power = 1.0f;
 	}
 
-	void process(float *sampleL, float *sampleR) 
+	void processBlock(float *sampleL, float *sampleR, int numSamples)
 	{
         if (power > 0)
         {
-		    // avoid cpu spikes
-		    float noise = noiseGenerator->tickNoise() * 0.000000001f;
-
-		    *sampleL += noise;
-		    *sampleR += noise;
-
-		    float drysampleL = *sampleL;
-		    float drysampleR = *sampleR;
-
-		    reverb->process(sampleL, sampleR);
-
-		    // Process Stereo
-		    float actualDryValue = dryParamChange->tick(dry);
-		    float wet1 = wet * (stereoWidth * 0.5f + 0.5f);
-		    float wet2 = wet * ((1.0f - stereoWidth) * 0.5f);
-
-            float wetSignalL = *sampleL * wet1 + *sampleR * wet2;
-            float wetSignalR = *sampleR * wet1 + *sampleL * wet2;
-            
-            this->setMeterValue(wetSignalL, wetSignalR);
-
-		    float resultL = wetSignalL + drysampleL * actualDryValue;
-		    float resultR = wetSignalR + drysampleR * actualDryValue;
-		    *sampleL = resultL;
-		    *sampleR = resultR;
+            while (numSamples > 0)
+            {
+                int blockSize = numSamples < BLOCK_SIZE ? numSamples : BLOCK_SIZE;
+
+                for (int n = 0; n < blockSize; n++)
+                {
+		            // avoid cpu spikes
+		            float noise = noiseGenerator->tickNoise() * 0.000000001f;
+
+		            sampleL[n] += noise;
+		            sampleR[n] += noise;
+
+		            drysampleL[n] = sampleL[n];
+		            drysampleR[n] = sampleR[n];
+                }
+
+		        reverb->processBlock(sampleL, sampleR, blockSize);
+
+                for (int n = 0; n < blockSize; n++)
+                {
+		            // Process Stereo
+		            float actualDryValue = dryParamChange->tick(dry);
+		            float wet1 = wet * (stereoWidth * 0.5f + 0.5f);
+		            float wet2 = wet * ((1.0f - stereoWidth) * 0.5f);
+
+                    float wetSignalL = sampleL[n] * wet1 + sampleR[n] * wet2;
+                    float wetSignalR = sampleR[n] * wet1 + sampleL[n] * wet2;
+
+                    this->setMeterValue(wetSignalL, wetSignalR);
+
+		            float resultL = wetSignalL + drysampleL[n] * actualDryValue;
+		            float resultR = wetSignalR + drysampleR[n] * actualDryValue;
+		            sampleL[n] = resultL;
+		            sampleR[n] = resultR;
+                }
+
+                sampleL += blockSize;
+                sampleR += blockSize;
+                numSamples -= blockSize;
+            }
         }
         else
         {
@@ -25,8 +25,7 @@
 #if !defined(__TalReverb_h)
 #define __TalReverb_h
 
-#include "AllPassFilter.h"
-#include "CombFilter.h"
+#include "ReverbLanes.h"
 #include "NoiseGenerator.h"
 #include "Filter.h"
 #include "math.h"
@@ -37,36 +36,47 @@ private:
 	static const int DELAY_LINES_COMB = 5;
 	static const int DELAY_LINES_ALLPASS = 6;
 
+	// one lane per line and channel, left channel first
+	static const int COMB_LANES = DELAY_LINES_COMB * 2;
+
 	static const int MAX_PRE_DELAY_MS = 1000;
+	static const int BLOCK_SIZE = 256;
+
 	float* reflectionGains;
 	float* reflectionDelays;
 
-	CombFilter *combFiltersPreDelay;
+	ReverbArena arena;
+
+	DelayLine preDelay;
+
+	CombLanes<COMB_LANES> combFilters;
+	AllPassLanes<2> allPassFilters[DELAY_LINES_ALLPASS];
+
+	AllPassLanes<1> preAllPassFilter;
 
-	CombFilter **combFiltersL;
-	CombFilter **combFiltersR;
+	// All of them share rand(), they stay one at a time in the order they always ticked
 	NoiseGenerator **noiseGeneratorDampL;
 	NoiseGenerator **noiseGeneratorDampR;
 	NoiseGenerator **noiseGeneratorDelayL;
 	NoiseGenerator **noiseGeneratorDelayR;
-	AllPassFilter **allPassFiltersL;
-	AllPassFilter **allPassFiltersR;
-
-	AllPassFilter *preAllPassFilter;
 
 	Filter *lpFilter;
 	Filter *hpFilter;
 
+	float revL[BLOCK_SIZE];
+	float diffuse[BLOCK_SIZE];
+	float dampNoise[BLOCK_SIZE][COMB_LANES];
+	float delayNoise[BLOCK_SIZE][COMB_LANES];
+	float outL[BLOCK_SIZE];
+	float outR[BLOCK_SIZE];
 
 public:
 	TalReverb(int sampleRate)
 	{
 		createDelaysAndCoefficients(DELAY_LINES_COMB + DELAY_LINES_ALLPASS, 80.0f);
 
-		combFiltersPreDelay = new CombFilter((float)MAX_PRE_DELAY_MS, 0.0f, sampleRate);
+		preDelay.setLine((float)MAX_PRE_DELAY_MS, sampleRate);
 
-		combFiltersL = new CombFilter *[DELAY_LINES_COMB];
-		combFiltersR = new CombFilter *[DELAY_LINES_COMB];
 		noiseGeneratorDampL = new NoiseGenerator *[DELAY_LINES_COMB];
 		noiseGeneratorDampR = new NoiseGenerator *[DELAY_LINES_COMB];
 		noiseGeneratorDelayL = new NoiseGenerator *[DELAY_LINES_COMB];
@@ -78,13 +88,13 @@ public:
 			float stereoSpreadFactor = 1.0f + stereoSpreadValue;
 			if (stereoSpreadSign > 0.0f)
 			{
-				combFiltersL[i] = new CombFilter(reflectionDelays[i] * stereoSpreadFactor, reflectionGains[i], sampleRate);
-				combFiltersR[i] = new CombFilter(reflectionDelays[i], reflectionGains[i], sampleRate);
+				combFilters.setLine(i, reflectionDelays[i] * stereoSpreadFactor, reflectionGains[i], sampleRate);
+				combFilters.setLine(DELAY_LINES_COMB + i, reflectionDelays[i], reflectionGains[i], sampleRate);
 			}
 			else
 			{
-				combFiltersL[i] = new CombFilter(reflectionDelays[i], reflectionGains[i], sampleRate);
-				combFiltersR[i] = new CombFilter(reflectionDelays[i] * stereoSpreadFactor, reflectionGains[i], sampleRate);
+				combFilters.setLine(i, reflectionDelays[i], reflectionGains[i], sampleRate);
+				combFilters.setLine(DELAY_LINES_COMB + i, reflectionDelays[i] * stereoSpreadFactor, reflectionGains[i], sampleRate);
 			}
 			stereoSpreadSign *= -1.0f;
 			noiseGeneratorDampL[i] = new NoiseGenerator(sampleRate);
@@ -92,89 +102,160 @@ public:
 			noiseGeneratorDelayL[i] = new NoiseGenerator(sampleRate);
 			noiseGeneratorDelayR[i] = new NoiseGenerator(sampleRate);
 		}
-		preAllPassFilter = new AllPassFilter(15.0f,  0.68f, sampleRate);
+		preAllPassFilter.setLine(0, 15.0f,  0.68f, sampleRate);
 
-		allPassFiltersL = new AllPassFilter *[DELAY_LINES_ALLPASS];
-		allPassFiltersR = new AllPassFilter *[DELAY_LINES_ALLPASS];
 		for (int i = 0; i < DELAY_LINES_ALLPASS; i++)
 		{
-			allPassFiltersL[i] = new AllPassFilter(reflectionDelays[i + DELAY_LINES_COMB - 1] * 0.21f,  0.68f, sampleRate);
-			allPassFiltersR[i] = new AllPassFilter(reflectionDelays[i + DELAY_LINES_COMB - 1] * 0.22f,  0.68f, sampleRate);
+			allPassFilters[i].setLine(0, reflectionDelays[i + DELAY_LINES_COMB - 1] * 0.21f,  0.68f, sampleRate);
+			allPassFilters[i].setLine(1, reflectionDelays[i + DELAY_LINES_COMB - 1] * 0.22f,  0.68f, sampleRate);
 		}
+
+		preDelay.reserve(arena);
+		combFilters.reserve(arena);
+		preAllPassFilter.reserve(arena);
+		for (int i = 0; i < DELAY_LINES_ALLPASS; i++) allPassFilters[i].reserve(arena);
+
+		arena.allocate();
+
+		preDelay.assign(arena);
+		combFilters.assign(arena);
+		preAllPassFilter.assign(arena);
+		for (int i = 0; i < DELAY_LINES_ALLPASS; i++) allPassFilters[i].assign(arena);
+
 		lpFilter = new Filter(sampleRate);
 		hpFilter = new Filter(sampleRate);
 	}
 
 	~TalReverb()
 	{
-		delete reflectionGains;
-		delete reflectionDelays;
-
-		delete combFiltersL;
-		delete combFiltersR;
-		delete noiseGeneratorDampL;
-		delete noiseGeneratorDampR;
-		delete noiseGeneratorDelayL;
-		delete noiseGeneratorDelayR;
-		delete allPassFiltersL;
-		delete allPassFiltersR;
+		delete[] reflectionGains;
+		delete[] reflectionDelays;
+
+		for (int i = 0; i < DELAY_LINES_COMB; i++) delete noiseGeneratorDampL[i];
+		delete[] noiseGeneratorDampL;
+		for (int i = 0; i < DELAY_LINES_COMB; i++) delete noiseGeneratorDampR[i];
+		delete[] noiseGeneratorDampR;
+		for (int i = 0; i < DELAY_LINES_COMB; i++) delete noiseGeneratorDelayL[i];
+		delete[] noiseGeneratorDelayL;
+		for (int i = 0; i < DELAY_LINES_COMB; i++) delete noiseGeneratorDelayR[i];
+		delete[] noiseGeneratorDelayR;
 
 		delete lpFilter;
 		delete hpFilter;
-		delete preAllPassFilter;
 	}
 
-	// All input values [0..1]
-	inline void process(float* sampleL, float* sampleR, float gain, float roomSize, const float preDelay, const float lowCut, const float damp, const float highCut, const float stereoWidth)
+	// All input values [0..1], gain and roomSize per sample
+	inline void processBlock(float* sampleL, float* sampleR, const float* gain, const float* roomSize, int numSamples,
+		const float preDelay, const float lowCut, const float damp, const float highCut, const float stereoWidth)
 	{
-		// Very diffuse verb
-		// --------------------------------------------------
-		roomSize = (1.0f - roomSize);
-		roomSize *= roomSize * roomSize;
-		roomSize = (1.0f - roomSize);
+		while (numSamples > 0)
+		{
+			int blockSize = numSamples < BLOCK_SIZE ? numSamples : BLOCK_SIZE;
 
-		float revL = (*sampleL + *sampleR);
+			processChunk(sampleL, sampleR, gain, roomSize, blockSize, preDelay, lowCut, damp, highCut, stereoWidth);
 
-		// Add small noise -> avoid cpu spikes
-		float noise = noiseGeneratorDampL[0]->tickNoise();
-		revL += noise * 0.000000001f;
+			sampleL += blockSize;
+			sampleR += blockSize;
+			gain += blockSize;
+			roomSize += blockSize;
+			numSamples -= blockSize;
+		}
+	}
 
-		// ----------------- Pre Delay ----------------------
-		revL = combFiltersPreDelay->process(revL, 0.0f, 0.0f, preDelay * preDelay);
+private:
+	inline void processChunk(float* sampleL, float* sampleR, const float* gain, const float* roomSize, int numSamples,
+		const float preDelay, const float lowCut, const float damp, const float highCut, const float stereoWidth)
+	{
+		for (int n = 0; n < numSamples; n++)
+		{
+			revL[n] = (sampleL[n] + sampleR[n]);
 
-		// ----------------- Pre AllPass --------------------
-		revL += preAllPassFilter->processInterpolated(revL, 0.01f + roomSize * 0.99f, 0.97f + noise * 0.03f) * 0.2f;
+			// Add small noise -> avoid cpu spikes
+			float noise = noiseGeneratorDampL[0]->tickNoise();
+			revL[n] += noise * 0.000000001f;
+			diffuse[n] = 0.97f + noise * 0.03f;
+
+			// The delay noise went first, as the arguments of the comb filter calls used to be evaluated by GCC
+			for (int i = 0; i < DELAY_LINES_COMB; i++)
+			{
+				delayNoise[n][i] = noiseGeneratorDelayL[i]->tickFilteredNoise();
+				dampNoise[n][i] = noiseGeneratorDampL[i]->tickFilteredNoiseFast();
+				delayNoise[n][DELAY_LINES_COMB + i] = noiseGeneratorDelayR[i]->tickFilteredNoise();
+				dampNoise[n][DELAY_LINES_COMB + i] = noiseGeneratorDampR[i]->tickFilteredNoiseFast();
+			}
+		}
 
-		// ----------------- Filters ------------------------
-		revL *= 0.2f;
-		revL = lpFilter->process(revL, highCut, 0.0f, false);
-		revL = hpFilter->process(revL, 0.95f * lowCut + 0.05f, 0.0f, true);
-		float revR = revL;
+		// ----------------- Pre Delay ----------------------
+		this->preDelay.process(revL, revL, numSamples, preDelay * preDelay);
 
-		// ----------------- Comb Filter --------------------
-		float outL = 0.0f;
-		float outR = 0.0f;
 		float scaledDamp = 0.95f * damp * damp;
-		float scaledRoomSize = roomSize * 0.97f;
-		for (int i = 0; i < DELAY_LINES_COMB; i++)
-		{ 
-			outL += combFiltersL[i]->processInterpolated(revL, scaledDamp + 0.05f * noiseGeneratorDampL[i]->tickFilteredNoiseFast(), scaledRoomSize, 0.6f * scaledRoomSize + 0.395f + 0.012f * noiseGeneratorDelayL[i]->tickFilteredNoise() * roomSize);
-			outR += combFiltersR[i]->processInterpolated(revR, scaledDamp + 0.05f * noiseGeneratorDampR[i]->tickFilteredNoiseFast(), scaledRoomSize, 0.6f * scaledRoomSize + 0.398f + 0.012f * noiseGeneratorDelayR[i]->tickFilteredNoise() * roomSize);
+		for (int n = 0; n < numSamples; n++)
+		{
+			// Very diffuse verb
+			// --------------------------------------------------
+			float room = (1.0f - roomSize[n]);
+			room *= room * room;
+			room = (1.0f - room);
+
+			// ----------------- Pre AllPass --------------------
+			float delayLength = 0.01f + room * 0.99f;
+			float allPass;
+			preAllPassFilter.processInterpolated(&revL[n], &delayLength, diffuse[n], false, &allPass);
+			float rev = revL[n] + allPass * 0.2f;
+
+			// ----------------- Filters ------------------------
+			rev *= 0.2f;
+			rev = lpFilter->process(rev, highCut, 0.0f, false);
+			rev = hpFilter->process(rev, 0.95f * lowCut + 0.05f, 0.0f, true);
+
+			// ----------------- Comb Filter --------------------
+			float input[COMB_LANES];
+			float dampLanes[COMB_LANES];
+			float delay[COMB_LANES];
+			float comb[COMB_LANES];
+
+			float scaledRoomSize = room * 0.97f;
+			for (int i = 0; i < DELAY_LINES_COMB; i++)
+			{
+				input[i] = rev;
+				input[DELAY_LINES_COMB + i] = rev;
+				dampLanes[i] = scaledDamp + 0.05f * dampNoise[n][i];
+				dampLanes[DELAY_LINES_COMB + i] = scaledDamp + 0.05f * dampNoise[n][DELAY_LINES_COMB + i];
+				delay[i] = 0.6f * scaledRoomSize + 0.395f + 0.012f * delayNoise[n][i] * room;
+				delay[DELAY_LINES_COMB + i] = 0.6f * scaledRoomSize + 0.398f + 0.012f * delayNoise[n][DELAY_LINES_COMB + i] * room;
+			}
+
+			combFilters.process(input, dampLanes, scaledRoomSize, delay, comb);
+
+			outL[n] = 0.0f;
+			outR[n] = 0.0f;
+			for (int i = 0; i < DELAY_LINES_COMB; i++)
+			{
+				outL[n] += comb[i];
+				outR[n] += comb[DELAY_LINES_COMB + i];
+			}
 		}
+
 		// ----------------- AllPass Filter ------------------
+		// Nothing feeds back, every stage takes the whole block
 		for (int i = 0; i < DELAY_LINES_ALLPASS; i++)
 		{
-			outL = allPassFiltersL[i]->process(outL);
-			outR = allPassFiltersR[i]->process(outR);
+			allPassFilters[i].processBlock(0, outL, numSamples);
+			allPassFilters[i].processBlock(1, outR, numSamples);
 		}
+
 		// ----------------- Write to output / Stereo --------
-		gain *= gain;
-		float wet1 = gain * (stereoWidth * 0.5f + 0.5f);
-		float wet2 = gain * ((1.0f - stereoWidth) * 0.5f);
-		*sampleL = outL * wet1 + outR * wet2;
-		*sampleR = outR * wet1 + outL * wet2;
+		for (int n = 0; n < numSamples; n++)
+		{
+			float gainValue = gain[n] * gain[n];
+			float wet1 = gainValue * (stereoWidth * 0.5f + 0.5f);
+			float wet2 = gainValue * ((1.0f - stereoWidth) * 0.5f);
+			sampleL[n] = outL[n] * wet1 + outR[n] * wet2;
+			sampleR[n] = outR[n] * wet1 + outL[n] * wet2;
+		}
 	}
 
+public:
 	void createDelaysAndCoefficients(int numlines, float delayLength)
 	{
 		reflectionDelays = new float[numlines];
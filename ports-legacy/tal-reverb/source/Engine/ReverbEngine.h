@@ -31,13 +31,19 @@
 
 class ReverbEngine 
 {
+private:
+	static const int BLOCK_SIZE = 256;
+
+	float wetValues[BLOCK_SIZE];
+	float roomSizeValues[BLOCK_SIZE];
+
 public:
 	float *param;
 	TalReverb* reverbL;
 	TalReverb* reverbR;
 
-	float drysampleL;
-	float drysampleR;
+	float drysampleL[BLOCK_SIZE];
+	float drysampleR[BLOCK_SIZE];
 
 	ParamChangeUtil* roomSizeParamChange;
 	ParamChangeUtil* wetParamChange;
@@ -69,17 +75,34 @@ public:
 		wetParamChange = new ParamChangeUtil(sampleRate, 300.0f);
 	}
 
-	void process(float *sampleL, float *sampleR) 
+	void processBlock(float *sampleL, float *sampleR, int numSamples) 
 	{
-		drysampleL = *sampleL;
-		drysampleR = *sampleR;
-		reverbL->process(sampleL, sampleR, 
-			wetParamChange->tick(param[WET]), 
-			roomSizeParamChange->tick(param[ROOMSIZE]), 
-			param[PREDELAY], param[LOWCUT], param[DAMP], param[HIGHCUT], param[STEREO]);
-		float gainValue = param[DRY] * param[DRY] * 1.5f;
-		*sampleL += drysampleL * gainValue;
-		*sampleR += drysampleR * gainValue;
+		while (numSamples > 0)
+		{
+			int blockSize = numSamples < BLOCK_SIZE ? numSamples : BLOCK_SIZE;
+
+			for (int n = 0; n < blockSize; n++)
+			{
+				drysampleL[n] = sampleL[n];
+				drysampleR[n] = sampleR[n];
+				wetValues[n] = wetParamChange->tick(param[WET]);
+				roomSizeValues[n] = roomSizeParamChange->tick(param[ROOMSIZE]);
+			}
+
+			reverbL->processBlock(sampleL, sampleR, wetValues, roomSizeValues, blockSize,
+				param[PREDELAY], param[LOWCUT], param[DAMP], param[HIGHCUT], param[STEREO]);
+
+			float gainValue = param[DRY] * param[DRY] * 1.5f;
+			for (int n = 0; n < blockSize; n++)
+			{
+				sampleL[n] += drysampleL[n] * gainValue;
+				sampleR[n] += drysampleR[n] * gainValue;
+			}
+
+			sampleL += blockSize;
+			sampleR += blockSize;
+			numSamples -= blockSize;
+		}
 	}
 };
 #endif
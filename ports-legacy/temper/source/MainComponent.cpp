@@ -132,7 +132,7 @@ MainComponent::MainComponent (AudioProcessorValueTreeState& vts)
     m_gainLabel->setColour (TextEditor::textColourId, Colours::black);
     m_gainLabel->setColour (TextEditor::backgroundColourId, Colour (0x00000000));
 
-    drawable1 = Drawable::createFromImageData (BinaryData::Background_png, BinaryData::Background_pngSize);
+    drawable1 = resources->createDrawable (BinaryData::Background_png, BinaryData::Background_pngSize);
 
     //[UserPreSize]
     //[/UserPreSize]
@@ -22,6 +22,7 @@
 
 //[Headers]     -- You can add your own extra header files here --
 #include "JuceHeader.h"
+#include "JucePluginResourceCache.h"
 //[/Headers]
 
 
@@ -60,6 +61,7 @@ private:
     ScopedPointer<AudioProcessorValueTreeState::SliderAttachment> curveAttachment;
     ScopedPointer<AudioProcessorValueTreeState::SliderAttachment> feedbackAttachment;
     ScopedPointer<AudioProcessorValueTreeState::SliderAttachment> levelAttachment;
+    SharedResourcePointer<JucePluginResourceCache> resources;
     //[/UserVariables]
 
     //==============================================================================
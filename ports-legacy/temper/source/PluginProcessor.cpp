@@ -13,9 +13,18 @@
 #include "PluginEditor.h"
 #endif
 #include "TemperDsp.hpp"
+#include "JucePluginCpuDispatch.h"
 
 const int kOversampleFactor = 3;
 
+// Calls the generated code directly instead of through the dsp base class,
+// so that it is inlined here and compiled once per CPU level with cpu-dispatch.
+JUCE_PLUGIN_CPU_DISPATCH_CLONES
+static void computeTemperDsp (TemperDsp* dsp, int len, float** data)
+{
+    dsp->TemperDsp::compute (len, data, data);
+}
+
 //==============================================================================
 TemperAudioProcessor::TemperAudioProcessor()
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -233,12 +242,12 @@ void TemperAudioProcessor::processBlock (AudioSampleBuffer& buffer, MidiBuffer&
     // Run the faust processors on each channel of the oversampled block.
     for (int i = 0; i < numInputChannels; ++i)
     {
-        auto* processor = m_dsps.getUnchecked(i);
+        auto* processor = static_cast<TemperDsp*>(m_dsps.getUnchecked(i));
         auto* data = oversampledBlock.getChannelPointer(i);
 
         int len = static_cast<int>(oversampledBlock.getNumSamples());
 
-        processor->compute(len, &data, &data);
+        computeTemperDsp(processor, len, &data);
     }
 
     m_oversampler->processSamplesDown(block);
@@ -17,8 +17,8 @@ TemperLookAndFeel::TemperLookAndFeel()
 
 Font TemperLookAndFeel::getBaseFont()
 {
-    return Font(Typeface::createSystemTypefaceFor(BinaryData::MontserratLight_otf,
-                                                  BinaryData::MontserratLight_otfSize));
+    return Font(resources->getTypeface(BinaryData::MontserratLight_otf,
+                                       BinaryData::MontserratLight_otfSize));
 }
 
 
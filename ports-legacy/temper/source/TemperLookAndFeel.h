@@ -12,6 +12,7 @@
 #define TEMPERLOOKANDFEEL_H_INCLUDED
 
 #include "JuceHeader.h"
+#include "JucePluginResourceCache.h"
 
 class TemperLookAndFeel : public LookAndFeel_V2
 {
@@ -26,6 +27,9 @@ public:
     void drawRotarySlider (Graphics&, int x, int y, int width, int height,
                            float sliderPosProportional, float rotaryStartAngle, float rotaryEndAngle,
                            Slider&) override;
+
+private:
+    SharedResourcePointer<JucePluginResourceCache> resources;
 };
 
 #endif  // TEMPERLOOKANDFEEL_H_INCLUDED
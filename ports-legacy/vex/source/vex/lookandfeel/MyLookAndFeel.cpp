@@ -35,10 +35,7 @@
 
 MyLookAndFeel::MyLookAndFeel()
 {
-    MemoryInputStream fontStream (Resources::t_bin, Resources::t_binSize, false);
-    CustomTypeface* tf = new CustomTypeface (fontStream);
-    Topaz = new Font (tf);
-//  delete tf;
+    Topaz = new Font (resources->getCustomTypeface (Resources::t_bin, Resources::t_binSize));
 
     Topaz->setHeight (9.0f);
     Topaz->setHorizontalScale (1.0f);
@@ -41,6 +41,7 @@
 #endif
 
 #include "../resources/Resources.h"
+#include "JucePluginResourceCache.h"
 
 class MyLookAndFeel : public LookAndFeel_V2
 {
@@ -71,6 +72,9 @@ public:
 
 public:
     juce::Font* Topaz;
+
+private:
+    SharedResourcePointer<JucePluginResourceCache> resources;
 };
 
 #endif
@@ -641,6 +641,7 @@ editor::editor (AudioProcessor *const ownerFilter)
     oversmplComboBox->addItem (T("None"), 1);
     oversmplComboBox->addItem (T("8x"), 2);
     oversmplComboBox->addItem (T("16x"), 3);
+    oversmplComboBox->addItem (T("BLEP"), 4);
     oversmplComboBox->addListener (this);
 
     addAndMakeVisible (label25 = new Label (T("new label"),
@@ -1019,9 +1020,10 @@ void editor::comboBoxChanged (ComboBox* comboBoxThatHasChanged)
     if (comboBoxThatHasChanged == oversmplComboBox)
     {
         //[UserComboBoxCode_oversmplComboBox] -- add your combo box handling code here..
+        static const double values[]= { 0.0, 0.5, 1.0, 31.0/32 };
         int idx= oversmplComboBox->getSelectedItemIndex();
         wolp *synth= (wolp*)getAudioProcessor();
-        synth->setParameterNotifyingHost(wolp::oversampling, double(idx)/2.0);
+        if(idx>=0) synth->setParameterNotifyingHost(wolp::oversampling, values[idx]);
         //[/UserComboBoxCode_oversmplComboBox]
     }
 
@@ -1077,7 +1079,8 @@ void editor::changeListenerCallback(ChangeBroadcaster *objectThatHasChanged)
 
                 case wolp::oversampling:
                 {
-                    int idx= int(synth->getParameter(wolp::oversampling)*2);
+                    int factor= int(synth->getparam(wolp::oversampling));
+                    int idx= (factor==1? 0: factor==8? 1: factor==16? 2: 3);
                     oversmplComboBox->setSelectedItemIndex( idx, sendNotification );
                     break;
                 }
@@ -1356,7 +1359,7 @@ BEGIN_JUCER_METADATA
          fontsize="15" bold="0" italic="0" justification="34"/>
   <COMBOBOX name="new combo box" id="cf1a54db9ee6988d" memberName="oversmplComboBox"
             virtualName="" explicitFocusOrder="0" pos="128 116 56 18" editable="0"
-            layout="33" items="None&#10;8x&#10;16x" textWhenNonSelected="None"
+            layout="33" items="None&#10;8x&#10;16x&#10;BLEP" textWhenNonSelected="None"
             textWhenNoItems="(no choices)"/>
   <LABEL name="new label" id="2bbccba2db676bcc" memberName="label25" virtualName=""
          explicitFocusOrder="0" pos="22 116 102 18" textCol="ffffffff"
@@ -2,5 +2,19 @@
 #define SIMD_H
 
 typedef float v4sf	__attribute__ ((vector_size (16)));
+typedef double v2df	__attribute__ ((vector_size (16)));
+typedef long long v2di	__attribute__ ((vector_size (16)));
+
+// whether a condition holds, on a scalar or on any of the lanes of a vector comparison
+inline bool anyLane(bool c) { return c; }
+inline bool anyLane(v2di c) { return (c[0] | c[1]) != 0; }
+
+// ifTrue where a condition holds, else ifFalse, on a scalar or on each lane of a vector comparison.
+// the vector version uses explicit masks, not all compilers accept a vector condition in ?:
+inline double selectLanes(bool c, double ifTrue, double ifFalse) { return c? ifTrue: ifFalse; }
+inline v2df selectLanes(v2di c, v2df ifTrue, v2df ifFalse)
+{
+	return (v2df) (((v2di) ifTrue & c) | ((v2di) ifFalse & ~c));
+}
 
 #endif // SIMD_H
@@ -33,7 +33,7 @@ AudioProcessor* JUCE_CALLTYPE createPluginFilter(const String& commandLine)
 // ------------------------- SynthVoice -------------------------
 
 template <int oversampling>
-wolpVoice<oversampling>::wolpVoice(wolp *s): synth(s)
+wolpVoice<oversampling>::wolpVoice(wolp *s): samples_generated(false), synth(s)
 {
 	setCurrentPlaybackSampleRate(((AudioProcessor*)s)->getSampleRate());
 }
@@ -74,9 +74,11 @@ void wolpVoice<oversampling>::process(float* p1, float* p2, int samples)
 	int nfilters= int(synth->getparam(wolp::nfilters));
 	float *waveSamples;
 
-	generator.setFrequency(getSampleRate(), freq);
-	generator.setMultipliers(synth->getparam(wolp::gsaw), synth->getparam(wolp::grect), synth->getparam(wolp::gtri));
-	waveSamples= generator.generateSamples(samples);
+	if(samples_generated)
+		waveSamples= generator.getSamples();
+	else
+		waveSamples= prepareGenerator()->generateSamples(samples);
+	samples_generated= false;
 
 	double sampleStep= 1.0/getSampleRate();
 
@@ -119,6 +121,15 @@ void wolpVoice<oversampling>::process(float* p1, float* p2, int samples)
 	}
 }
 
+template <int oversampling>
+WaveGenerator<oversampling> *wolpVoice<oversampling>::prepareGenerator()
+{
+	generator.setFrequency(getSampleRate(), freq);
+	generator.setMultipliers(synth->getparam(wolp::gsaw), synth->getparam(wolp::grect), synth->getparam(wolp::gtri));
+	samples_generated= true;
+	return &generator;
+}
+
 template <int oversampling>
 void wolpVoice<oversampling>::renderNextBlock (AudioSampleBuffer& outputBuffer, int startSample, int numSamples)
 {
@@ -229,7 +240,10 @@ float wolp::getparam(int idx)
 			break;
 
 		case oversampling:
-			v= (params[idx] < 1.0/3+1.0/6? 1.0/16: params[idx] < 2.0/3+1.0/6? 8.0/16: 16.0/16);
+			// BLEP came after the other modes and takes the values just below 1.0,
+			// which the editor never stored, so older None, 8x and 16x values keep their meaning
+			v= (params[idx] < 1.0/3+1.0/6? 1.0/16: params[idx] < 2.0/3+1.0/6? 8.0/16:
+				params[idx] < 15.0/16 || params[idx] >= 1.0? 16.0/16: 2.0/16);
 			break;
 
 		default:
@@ -271,7 +285,6 @@ void wolp::setParameter (int idx, float value)
 
 		case oversampling:
 		{
-			int nVoicesMax= 16;
 			int oldVal= (int)getparam(oversampling);
 			params[idx]= value;
 			int val= (int)getparam(oversampling);
@@ -287,6 +300,11 @@ void wolp::setParameter (int idx, float value)
 					printf("Off\n");
 					params[idx]= 1.0/16;
 					break;
+				case blepOversampling:
+					for(int i= 0; i<nVoicesMax ; i++)
+						addVoice(new wolpVoice<blepOversampling>(this));
+					params[idx]= 31.0/32;
+					break;
 				case 8:
 					for(int i= 0; i<nVoicesMax ; i++)
 						addVoice(new wolpVoice<8>(this));
@@ -446,6 +464,8 @@ void wolp::renderNextBlock (AudioSampleBuffer& outputBuffer,
 
         if (numThisTime > 0)
         {
+            generateVoiceSamples(numThisTime);
+
             for (int i = voices.size(); --i >= 0;)
 				voices.getUnchecked (i)->renderNextBlock (outputBuffer, startSample, numThisTime);
         }
@@ -512,6 +532,44 @@ void wolp::renderNextBlock (AudioSampleBuffer& outputBuffer,
 }
 
 
+void wolp::generateVoiceSamples(int numSamples)
+{
+	switch((int)getparam(oversampling))
+	{
+		case 1:
+			generateVoiceSamples<1>(numSamples);
+			break;
+		case blepOversampling:
+			generateVoiceSamples<blepOversampling>(numSamples);
+			break;
+		case 8:
+			generateVoiceSamples<8>(numSamples);
+			break;
+		default:
+			generateVoiceSamples<16>(numSamples);
+			break;
+	}
+}
+
+template<int factor>
+void wolp::generateVoiceSamples(int numSamples)
+{
+	WaveGenerator<factor> *generators[nVoicesMax];
+	int nGenerators= 0;
+
+	for(int i= 0; i<voices.size() && nGenerators<nVoicesMax; i++)
+	{
+		// voices of the previous kind are left while the oversampling changes,
+		// they generate their own samples
+		wolpVoice<factor> *voice= dynamic_cast<wolpVoice<factor>*>(voices.getUnchecked(i));
+		if(voice && voice->getCurrentlyPlayingNote()>=0)
+			generators[nGenerators++]= voice->prepareGenerator();
+	}
+
+	WaveGenerator<factor>::generateSamples(generators, nGenerators, numSamples);
+}
+
+
 #if ! JUCE_AUDIOPROCESSOR_NO_GUI
 AudioProcessorEditor* wolp::createEditor()
 {
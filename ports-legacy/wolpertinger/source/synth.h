@@ -151,6 +151,9 @@ class chebyshev_3pole
 };
 
 
+// oversampling of the band-limited mode, whose waveforms are smoothed with polyBLEPs
+enum { blepOversampling= 2 };
+
 template<int oversampling>
 class chebyshev_downsampling_lp
 {
@@ -159,11 +162,14 @@ class chebyshev_downsampling_lp
 
 		chebyshev_downsampling_lp() { memset(xv, 0, sizeof(xv)); memset(yv, 0, sizeof(yv)); }
 
-		double run(double nextvalue);
+		double run(double nextvalue) { return run(xv, yv, nextvalue); }
+
+		// runs the filter on the given state, which can hold several filters in SIMD lanes
+		template<typename Type> static Type run(Type *xv, Type *yv, Type nextvalue);
 };
 
-template<>
-inline double chebyshev_downsampling_lp<16>::run(double nextvalue)
+template<> template<typename Type>
+inline Type chebyshev_downsampling_lp<16>::run(Type *xv, Type *yv, Type nextvalue)
 {
 	/*
 		mkfilter/mkshape/gencode   A.J. Fisher
@@ -185,8 +191,8 @@ inline double chebyshev_downsampling_lp<16>::run(double nextvalue)
 	return yv[3];
 }
 
-template<>
-inline double chebyshev_downsampling_lp<8>::run(double nextvalue)
+template<> template<typename Type>
+inline Type chebyshev_downsampling_lp<8>::run(Type *xv, Type *yv, Type nextvalue)
 {
 	/*
 		mkfilter/mkshape/gencode   A.J. Fisher
@@ -208,8 +214,31 @@ inline double chebyshev_downsampling_lp<8>::run(double nextvalue)
 	return yv[3];
 }
 
-template<>
-inline double chebyshev_downsampling_lp<1>::run(double nextvalue)
+template<> template<typename Type>
+inline Type chebyshev_downsampling_lp<2>::run(Type *xv, Type *yv, Type nextvalue)
+{
+	/*
+		mkfilter/mkshape/gencode   A.J. Fisher
+		parameters:
+
+		filtertype 	= 	Chebyshev
+		passtype 	= 	Lowpass
+		ripple 		= 	-1
+		order 		= 	3
+		samplerate 	= 	96000
+		corner1 	= 	18000
+	*/
+	xv[0] = xv[1]; xv[1] = xv[2]; xv[2] = xv[3];
+	xv[3] = nextvalue * (1.0 / 1.610108939e+01);
+	yv[0] = yv[1]; yv[1] = yv[2]; yv[2] = yv[3];
+	yv[3] = (xv[0] + xv[3]) + 3 * (xv[1] + xv[2])
+			+ (  0.3160996394 * yv[0]) + ( -0.9434483339 * yv[1])
+			+ (  1.1304879041 * yv[2]);
+	return yv[3];
+}
+
+template<> template<typename Type>
+inline Type chebyshev_downsampling_lp<1>::run(Type *xv, Type *yv, Type nextvalue)
 {
 	return nextvalue;
 }
@@ -241,6 +270,7 @@ template<int oversampling> class WaveGenerator
 		void setFrequency(double sampleRate, double noteFrequency)
 		{
 			sampleStep= noteFrequency / (sampleRate*oversampling);
+			inverseStep= 1.0 / sampleStep;
 		}
 
 		void setMultipliers(double mSaw, double mRect, double mTri)
@@ -267,13 +297,93 @@ template<int oversampling> class WaveGenerator
 			return &sampleBuffer[0];
 		}
 
+		// generates nSamples on each of the generators like generateSamples(),
+		// running the generators and their downsampling filters in SIMD lanes
+		static void generateSamples(WaveGenerator **generators, int nGenerators, int nSamples)
+		{
+			int g= 0;
+			// the filters are recursive, two pairs at a time keep the pipeline busy
+			for(; g+4<=nGenerators; g+= 4)
+				generateSamplesInLanes<2>(generators+g, nSamples);
+			for(; g+2<=nGenerators; g+= 2)
+				generateSamplesInLanes<1>(generators+g, nSamples);
+			if(g<nGenerators)
+				generators[g]->generateSamples(nSamples);
+		}
+
+		float *getSamples() { return &sampleBuffer[0]; }
+
 	private:
-		double sawFactor, rectFactor, triFactor, sampleStep, phase;
+		double sawFactor, rectFactor, triFactor, sampleStep, inverseStep, phase;
 		int cyclecount;
 		std::vector<float> rawSampleBuffer;
 		std::vector<float> sampleBuffer;
 		chebyshev_downsampling_lp<oversampling> chebyshev_lp;
 
+		template<int nPairs> static void generateSamplesInLanes(WaveGenerator **generators, int nSamples)
+		{
+			v2df phase[nPairs], sampleStep[nPairs], inverseStep[nPairs];
+			v2df sawFactor[nPairs], rectFactor[nPairs], triFactor[nPairs];
+			v2df xv[nPairs][3+1], yv[nPairs][3+1], s[nPairs];
+			v2di cyclecount[nPairs];
+			for(int p= 0; p<nPairs; p++)
+			{
+				WaveGenerator *a= generators[2*p], *b= generators[2*p+1];
+				if(int(a->sampleBuffer.size())<nSamples)
+					a->sampleBuffer.resize(nSamples);
+				if(int(b->sampleBuffer.size())<nSamples)
+					b->sampleBuffer.resize(nSamples);
+				phase[p]= (v2df) { a->phase, b->phase };
+				sampleStep[p]= (v2df) { a->sampleStep, b->sampleStep };
+				inverseStep[p]= (v2df) { a->inverseStep, b->inverseStep };
+				sawFactor[p]= (v2df) { a->sawFactor, b->sawFactor };
+				rectFactor[p]= (v2df) { a->rectFactor, b->rectFactor };
+				triFactor[p]= (v2df) { a->triFactor, b->triFactor };
+				cyclecount[p]= (v2di) { a->cyclecount, b->cyclecount };
+				for(int k= 0; k<3+1; k++)
+				{
+					xv[p][k]= (v2df) { a->chebyshev_lp.xv[k], b->chebyshev_lp.xv[k] };
+					yv[p][k]= (v2df) { a->chebyshev_lp.yv[k], b->chebyshev_lp.yv[k] };
+				}
+			}
+
+			for(int i= 0; i<nSamples; i++)
+			{
+				for(int k= oversampling; k; k--)
+				{
+					for(int p= 0; p<nPairs; p++)
+					{
+						v2df val= getRawSample(phase[p], (v2di) ((cyclecount[p]&1)!=0), sampleStep[p], inverseStep[p],
+											   sawFactor[p], rectFactor[p], triFactor[p]);
+
+						phase[p]+= sampleStep[p];
+						v2di wrap= phase[p] > 1;
+						cyclecount[p]-= wrap;
+						phase[p]= selectLanes(wrap, phase[p]-2, phase[p]);
+
+						s[p]= chebyshev_downsampling_lp<oversampling>::run(xv[p], yv[p], val);
+					}
+				}
+				for(int p= 0; p<nPairs; p++)
+				{
+					generators[2*p]->sampleBuffer[i]= s[p][0];
+					generators[2*p+1]->sampleBuffer[i]= s[p][1];
+				}
+			}
+
+			for(int p= 0; p<nPairs; p++)
+			{
+				WaveGenerator *a= generators[2*p], *b= generators[2*p+1];
+				a->phase= phase[p][0]; b->phase= phase[p][1];
+				a->cyclecount= cyclecount[p][0]; b->cyclecount= cyclecount[p][1];
+				for(int k= 0; k<3+1; k++)
+				{
+					a->chebyshev_lp.xv[k]= xv[p][k][0]; b->chebyshev_lp.xv[k]= xv[p][k][1];
+					a->chebyshev_lp.yv[k]= yv[p][k][0]; b->chebyshev_lp.yv[k]= yv[p][k][1];
+				}
+			}
+		}
+
 		void generateRawSampleChunk(float *buffer, int nSamples)
 		{
 			double saw, rect, tri;
@@ -300,13 +410,55 @@ template<int oversampling> class WaveGenerator
 			}
 		}
 
-		double getNextRawSample()
+		// polyBLEP residual of a step of 2 at cycle position 0, dt is the step per sample
+		template<typename Type> static Type polyBlep(Type t, Type dt, Type inverseDt)
+		{
+			Type start= t*inverseDt, end= (t-1)*inverseDt;
+			return selectLanes(t<dt, start+start - start*start - 1,
+							   selectLanes(t>1-dt, end*end + end+end + 1, Type()));
+		}
+
+		// polyBLAMP residual of a corner at cycle position 0, for a slope rising by 1 per cycle
+		template<typename Type> static Type polyBlamp(Type t, Type dt, Type inverseDt)
 		{
-			double saw= phase,
-				   rect= (phase<0.5? -1: 1),
-				   tri= (cyclecount&1? 2-(phase+1)-1: phase);
+			Type start= t*inverseDt - 1, end= (t-1)*inverseDt + 1;
+			return selectLanes(t<dt, -1.0/6.0 * start*start*start * dt,
+							   selectLanes(t>1-dt, 1.0/6.0 * end*end*end * dt, Type()));
+		}
+
+		// the mix of the waveforms at phase, on doubles or on SIMD lanes of them
+		template<typename Type, typename Condition>
+		static Type getRawSample(Type phase, Condition odd, Type sampleStep, Type inverseStep,
+								 Type sawFactor, Type rectFactor, Type triFactor)
+		{
+			Type saw= phase,
+				 rect= selectLanes(phase<0.5, Type()-1, Type()+1),
+				 tri= selectLanes(odd, 2-(phase+1)-1, phase);
 
-			double val= saw*sawFactor + rect*rectFactor + tri*triFactor;
+			if(oversampling==blepOversampling)
+			{
+				// a cycle is a phase of 2: saw and rect step down at its end, rect steps up
+				// at phase 0.5, tri turns at the end of every cycle, alternately up and down
+				Type dt= sampleStep*0.5,
+					 inverseDt= inverseStep*2,
+					 t= (phase+1)*0.5,
+					 tRise= selectLanes(t<0.75, t+0.25, t-0.75),
+					 turn= selectLanes(odd, Type()-4, Type()+4);
+				if(anyLane((t<dt) | (t>1-dt) | (tRise<dt) | (tRise>1-dt)))
+				{
+					Type stepDown= polyBlep(t, dt, inverseDt);
+					saw-= stepDown;
+					rect+= polyBlep(tRise, dt, inverseDt) - stepDown;
+					tri+= selectLanes(t<0.5, turn, -turn) * polyBlamp(t, dt, inverseDt);
+				}
+			}
+
+			return saw*sawFactor + rect*rectFactor + tri*triFactor;
+		}
+
+		double getNextRawSample()
+		{
+			double val= getRawSample(phase, (cyclecount&1)!=0, sampleStep, inverseStep, sawFactor, rectFactor, triFactor);
 
 			phase+= sampleStep;
 			if (phase > 1)
@@ -343,6 +495,10 @@ template<int oversampling> class wolpVoice: public SynthesiserVoice
 		void setvolume(double v) { vol= v; }
 		void setfreq(double f) { freq= f; }
 
+		// sets the generator up for the next block, whose samples are then
+		// generated by wolp::generateVoiceSamples() instead of by process()
+		WaveGenerator<oversampling> *prepareGenerator();
+
 	protected:
 		void process(float* p1, float* p2, int samples);
 
@@ -350,6 +506,7 @@ template<int oversampling> class wolpVoice: public SynthesiserVoice
 		bool playing;
 		int cyclecount;
 		unsigned long samples_synthesized;
+		bool samples_generated;
 
 		WaveGenerator<oversampling> generator;
 		bandpass<8> filter;
@@ -464,6 +621,13 @@ class wolp:	public AudioProcessor,
 
         void loaddefaultparams();
 
+		// the most voices of a kind, see setParameter(oversampling)
+		enum { nVoicesMax= 16 };
+
+		// generates the waveforms of all playing voices side by side, in SIMD lanes
+		void generateVoiceSamples(int numSamples);
+		template<int factor> void generateVoiceSamples(int numSamples);
+
 		void renderNextBlock (AudioSampleBuffer& outputAudio,
 							  const MidiBuffer& inputMidi,
 							  int startSample,
@@ -512,6 +676,7 @@ class wolp:	public AudioProcessor,
 		bool isProcessing;	// whether we are in the processBlock callback
 
 		friend class wolpVoice<1>;
+		friend class wolpVoice<blepOversampling>;
 		friend class wolpVoice<8>;
 		friend class wolpVoice<16>;
 		friend class editor;
@@ -0,0 +1,211 @@
+/*
+  ==============================================================================
+
+    Anti-aliased versions of the CHOW curve
+
+    The curve is y = x up to the threshold and a line with slope 1/ratio
+    above it (0 with rect). With flip the same happens mirrored, below
+    -threshold. Written as y = x + (slope - 1) * g(x), where g is the part
+    of x past the threshold, its antiderivatives are simple polynomials in
+    g, which is what antiderivative anti-aliasing (ADAA) needs:
+
+        first order:  y[n] = (F1(x[n]) - F1(x[n-1])) / (x[n] - x[n-1])
+        second order: the same one step further, with F2
+
+    First order delays the signal by half a sample, second order by one.
+
+    The divided differences are rewritten so that they never cancel badly
+    (see ratio() and divided()), and every per-sample kernel is branch-free,
+    so that the block loops vectorise. No JUCE dependency, the benchmark
+    tool uses it on its own too.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cmath>
+
+namespace ChowADAA
+{
+
+/** Curve settings for one block. */
+struct Curve
+{
+    float threshold = 1.0f;      // as gain, >= 0
+    float slopeMinusOne = 0.0f;  // slope past the threshold minus 1, 1/ratio - 1, or -1 with rect
+    float sign = 1.0f;           // -1 with flip, the curve is then evaluated on -x and negated
+
+    Curve() = default;
+
+    Curve (float thresholdGain, float ratio, bool rect, bool flip)
+        : threshold (thresholdGain),
+          slopeMinusOne ((rect ? 0.0f : 1.0f / ratio) - 1.0f),
+          sign (flip ? -1.0f : 1.0f)
+    {
+    }
+};
+
+/** The last two inputs of a channel, needed by the anti-aliased modes. */
+struct History
+{
+    float x1 = 0.0f; // x[n-1]
+    float x2 = 0.0f; // x[n-2]
+};
+
+namespace detail
+{
+    // below this the divided differences fall back to evaluating at the midpoint
+    static constexpr float tolerance = 3.0e-4f;
+
+    static inline float select (bool condition, float a, float b) noexcept
+    {
+        return condition ? a : b;
+    }
+
+    // g'(x) averaged over [xa, xb], always in [0, 1]: (g(xb) - g(xa)) / (xb - xa)
+    // With the clamped inputs this is exactly 1 when both are past the threshold.
+    static inline float ratio (float xa, float xb, float ca, float cb, float threshold) noexcept
+    {
+        const float d = xb - xa;
+        const bool valid = std::abs (d) > 1.0e-9f;
+        const float r = (cb - ca) / select (valid, d, 1.0f);
+
+        return select (valid, std::fmin (std::fmax (r, 0.0f), 1.0f), select (xa > threshold, 1.0f, 0.0f));
+    }
+
+    // (G2(xb) - G2(xa)) / (xb - xa) with G2 = g^3 / 6, written without the subtraction
+    static inline float divided (float ga, float gb, float r) noexcept
+    {
+        return r * (ga * ga + ga * gb + gb * gb) * (1.0f / 6.0f);
+    }
+
+    static inline float direct (float x, float threshold, float slopeMinusOne) noexcept
+    {
+        return x + slopeMinusOne * std::fmax (x - threshold, 0.0f);
+    }
+
+    static inline float firstOrder (float x1, float x0, float threshold, float slopeMinusOne) noexcept
+    {
+        const float c1 = std::fmax (x1, threshold);
+        const float c0 = std::fmax (x0, threshold);
+
+        // (G1(x0) - G1(x1)) / (x0 - x1) with G1 = g^2 / 2 is the mean of g times the ratio
+        const float g = 0.5f * ((c1 - threshold) + (c0 - threshold)) * ratio (x1, x0, c1, c0, threshold);
+
+        return 0.5f * (x1 + x0) + slopeMinusOne * g;
+    }
+
+    static inline float secondOrder (float x2, float x1, float x0, float threshold, float slopeMinusOne) noexcept
+    {
+        const float c2 = std::fmax (x2, threshold);
+        const float c1 = std::fmax (x1, threshold);
+        const float c0 = std::fmax (x0, threshold);
+        const float g2 = c2 - threshold;
+        const float g1 = c1 - threshold;
+        const float g0 = c0 - threshold;
+
+        // all three past the threshold, g is linear there and this is exact
+        const float linear = (g2 + g1 + g0) * (1.0f / 3.0f);
+
+        // 2 * (D[x1, x0] - D[x2, x1]) / (x0 - x2)
+        const float d20 = x0 - x2;
+        const bool wide = std::abs (d20) > tolerance;
+        const float general = 2.0f * (divided (g1, g0, ratio (x1, x0, c1, c0, threshold))
+                                      - divided (g2, g1, ratio (x2, x1, c2, c1, threshold)))
+                                   / select (wide, d20, 1.0f);
+
+        // x0 close to x2, take the limit around their midpoint
+        const float xm = 0.5f * (x2 + x0);
+        const float cm = std::fmax (xm, threshold);
+        const float gm = cm - threshold;
+        const float dm1 = xm - x1;
+        const bool apart = std::abs (dm1) > tolerance;
+        const float limit = 2.0f * (0.5f * gm * gm - divided (g1, gm, ratio (x1, xm, c1, cm, threshold)))
+                                 / select (apart, dm1, 1.0f);
+
+        // all three close together
+        const float mean = std::fmax ((x2 + x1 + x0) * (1.0f / 3.0f), threshold) - threshold;
+
+        const float g = select (std::fmin (std::fmin (x2, x1), x0) >= threshold, linear,
+                                select (wide, general, select (apart, limit, mean)));
+
+        return (x2 + x1 + x0) * (1.0f / 3.0f) + slopeMinusOne * g;
+    }
+
+    // runs a kernel over a block in chunks, with the history in front of each chunk
+    template <int numPrevious, typename Kernel>
+    static inline void processChunked (float* data, int numSamples, History& history, Kernel kernel) noexcept
+    {
+        constexpr int chunkSize = 256;
+        float x[chunkSize + 2];
+
+        x[0] = history.x2;
+        x[1] = history.x1;
+
+        while (numSamples > 0)
+        {
+            const int num = numSamples < chunkSize ? numSamples : chunkSize;
+
+            for (int i = 0; i < num; ++i)
+                x[i + 2] = data[i];
+
+            kernel (x + 2 - numPrevious, data, num);
+
+            x[0] = x[num];
+            x[1] = x[num + 1];
+
+            data += num;
+            numSamples -= num;
+        }
+
+        history.x2 = x[0];
+        history.x1 = x[1];
+    }
+}
+
+/** Plain curve, aliases. Still keeps the history, so that switching modes doesn't click. */
+inline void processDirect (float* data, int numSamples, const Curve& curve, History& history) noexcept
+{
+    const float sign = curve.sign, threshold = curve.threshold, slopeMinusOne = curve.slopeMinusOne;
+
+    if (numSamples >= 2)
+    {
+        history.x2 = data[numSamples - 2];
+        history.x1 = data[numSamples - 1];
+    }
+    else if (numSamples == 1)
+    {
+        history.x2 = history.x1;
+        history.x1 = data[0];
+    }
+
+    for (int n = 0; n < numSamples; ++n)
+        data[n] = sign * detail::direct (sign * data[n], threshold, slopeMinusOne);
+}
+
+/** First order ADAA. */
+inline void processFirstOrder (float* data, int numSamples, const Curve& curve, History& history) noexcept
+{
+    const float sign = curve.sign, threshold = curve.threshold, slopeMinusOne = curve.slopeMinusOne;
+
+    detail::processChunked<1> (data, numSamples, history, [=] (const float* x, float* y, int num)
+    {
+        for (int n = 0; n < num; ++n)
+            y[n] = sign * detail::firstOrder (sign * x[n], sign * x[n + 1], threshold, slopeMinusOne);
+    });
+}
+
+/** Second order ADAA. */
+inline void processSecondOrder (float* data, int numSamples, const Curve& curve, History& history) noexcept
+{
+    const float sign = curve.sign, threshold = curve.threshold, slopeMinusOne = curve.slopeMinusOne;
+
+    detail::processChunked<2> (data, numSamples, history, [=] (const float* x, float* y, int num)
+    {
+        for (int n = 0; n < num; ++n)
+            y[n] = sign * detail::secondOrder (sign * x[n], sign * x[n + 1], sign * x[n + 2], threshold, slopeMinusOne);
+    });
+}
+
+} // namespace ChowADAA
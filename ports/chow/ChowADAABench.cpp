@@ -0,0 +1,213 @@
+/*
+  ==============================================================================
+
+    CHOW antialiasing benchmark
+
+    Runs the plain curve, both ADAA modes and the plain curve at 4x
+    oversampling over a hard driven sine, and prints the CPU time per sample
+    and how much aliasing each leaves.
+
+    The sine sits exactly on an FFT bin, so after the warm-up the output is
+    periodic in the FFT size and needs no window. Its harmonics below
+    Nyquist land on multiples of that bin, everything else that isn't DC
+    has been folded back.
+
+  ==============================================================================
+*/
+
+#include "JuceHeader.h"
+#include "ChowADAA.h"
+
+#include <cstdio>
+
+namespace
+{
+    const char* const usage =
+        "Usage: chow-adaa-bench [options]\n"
+        "\n"
+        "  --threshold <dB>   Curve threshold (default -27)\n"
+        "  --ratio <ratio>    Ratio past the threshold (default 10)\n"
+        "  --drive <dB>       Sine level (default 0)\n"
+        "  --rect             Rectify past the threshold\n"
+        "  --flip             Apply the curve below -threshold\n"
+        "  --block-size <n>   Samples per processed block (default 256)\n";
+
+    enum Mode
+    {
+        direct,
+        firstOrder,
+        secondOrder,
+        oversampled,
+        numModes
+    };
+
+    const char* const modeNames[numModes] = { "direct", "adaa1", "adaa2", "os4x" };
+
+    constexpr int fftOrder = 14;
+    constexpr int fftSize = 1 << fftOrder;
+
+    // prime, so that no harmonic folds onto another one, around 3.7 kHz at 44.1 kHz
+    constexpr int sineBin = 1367;
+
+    struct Processor
+    {
+        Processor (Mode m, const ChowADAA::Curve& c, int maxBlockSize)
+            : mode (m), curve (c),
+              oversampling (1, 2, dsp::Oversampling<float>::filterHalfBandPolyphaseIIR, true)
+        {
+            oversampling.initProcessing ((size_t) maxBlockSize);
+        }
+
+        void process (float* data, int numSamples)
+        {
+            switch (mode)
+            {
+            case firstOrder:
+                ChowADAA::processFirstOrder (data, numSamples, curve, history);
+                break;
+
+            case secondOrder:
+                ChowADAA::processSecondOrder (data, numSamples, curve, history);
+                break;
+
+            case oversampled:
+            {
+                dsp::AudioBlock<float> block (&data, 1, (size_t) numSamples);
+                auto upsampled = oversampling.processSamplesUp (block);
+                ChowADAA::processDirect (upsampled.getChannelPointer (0), (int) upsampled.getNumSamples(), curve, history);
+                oversampling.processSamplesDown (block);
+                break;
+            }
+
+            default:
+                ChowADAA::processDirect (data, numSamples, curve, history);
+                break;
+            }
+        }
+
+        const Mode mode;
+        const ChowADAA::Curve curve;
+        ChowADAA::History history;
+        dsp::Oversampling<float> oversampling;
+    };
+
+    void processInBlocks (Processor& processor, float* data, int numSamples, int blockSize)
+    {
+        for (int start = 0; start < numSamples; start += blockSize)
+            processor.process (data + start, jmin (blockSize, numSamples - start));
+    }
+
+    // nanoseconds per sample, best of a few runs over a few seconds of audio
+    double measureSpeed (Mode mode, const ChowADAA::Curve& curve, const std::vector<float>& sine, int blockSize)
+    {
+        Processor processor (mode, curve, blockSize);
+        std::vector<float> data (sine.size());
+        const int numSamples = (int) data.size();
+        const int numPasses = 16;
+        double best = 0.0;
+
+        for (int run = 0; run < 5; ++run)
+        {
+            const auto startTicks = Time::getHighResolutionTicks();
+
+            for (int pass = 0; pass < numPasses; ++pass)
+            {
+                std::copy (sine.begin(), sine.end(), data.begin());
+                processInBlocks (processor, data.data(), numSamples, blockSize);
+            }
+
+            const double seconds = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - startTicks);
+            const double nsPerSample = seconds * 1.0e9 / ((double) numSamples * numPasses);
+
+            if (run == 0 || nsPerSample < best)
+                best = nsPerSample;
+        }
+
+        return best;
+    }
+
+    // power of the folded back components relative to the harmonics, in dB
+    double measureAliasing (Mode mode, const ChowADAA::Curve& curve, const std::vector<float>& sine, int blockSize)
+    {
+        Processor processor (mode, curve, blockSize);
+        std::vector<float> data (sine.begin(), sine.end());
+
+        // the first periods let the oversampling filters settle, only the last one is analysed
+        processInBlocks (processor, data.data(), (int) data.size(), blockSize);
+
+        std::vector<float> spectrum ((size_t) fftSize * 2, 0.0f);
+        std::copy (data.end() - fftSize, data.end(), spectrum.begin());
+
+        dsp::FFT fft (fftOrder);
+        fft.performFrequencyOnlyForwardTransform (spectrum.data());
+
+        double harmonicPower = 0.0, aliasPower = 0.0;
+
+        for (int bin = 1; bin < fftSize / 2; ++bin)
+        {
+            const double power = (double) spectrum[(size_t) bin] * spectrum[(size_t) bin];
+
+            if (bin % sineBin == 0)
+                harmonicPower += power;
+            else
+                aliasPower += power;
+        }
+
+        return 10.0 * std::log10 (jmax (aliasPower, 1.0e-30) / jmax (harmonicPower, 1.0e-30));
+    }
+}
+
+int main (int argc, char** argv)
+{
+    float thresholdDB = -27.0f, ratio = 10.0f, driveDB = 0.0f;
+    bool rect = false, flip = false;
+    int blockSize = 256;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const String arg (argv[i]);
+
+        if (arg == "--rect")
+            rect = true;
+        else if (arg == "--flip")
+            flip = true;
+        else if (i + 1 < argc && arg == "--threshold")
+            thresholdDB = String (argv[++i]).getFloatValue();
+        else if (i + 1 < argc && arg == "--ratio")
+            ratio = String (argv[++i]).getFloatValue();
+        else if (i + 1 < argc && arg == "--drive")
+            driveDB = String (argv[++i]).getFloatValue();
+        else if (i + 1 < argc && arg == "--block-size")
+            blockSize = String (argv[++i]).getIntValue();
+        else
+        {
+            std::fputs (usage, arg == "--help" || arg == "-h" ? stdout : stderr);
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+    }
+
+    if (ratio < 1.0f || blockSize < 1)
+    {
+        std::fputs ("Invalid ratio or block size\n", stderr);
+        return 1;
+    }
+
+    const ChowADAA::Curve curve (Decibels::decibelsToGain (thresholdDB), ratio, rect, flip);
+    const float level = Decibels::decibelsToGain (driveDB);
+
+    std::vector<float> sine ((size_t) fftSize * 3);
+    for (size_t n = 0; n < sine.size(); ++n)
+        sine[n] = level * (float) std::sin (MathConstants<double>::twoPi * sineBin * (double) (n % fftSize) / fftSize);
+
+    std::printf ("%-8s %12s %12s\n", "MODE", "NS/SAMPLE", "ALIASING DB");
+
+    for (int mode = 0; mode < numModes; ++mode)
+    {
+        const double speed = measureSpeed ((Mode) mode, curve, sine, blockSize);
+        const double aliasing = measureAliasing ((Mode) mode, curve, sine, blockSize);
+
+        std::printf ("%-8s %12.2f %12.1f\n", modeNames[mode], speed, aliasing);
+    }
+
+    return 0;
+}
@@ -43,6 +43,8 @@ ChowAudioProcessorEditor::ChowAudioProcessorEditor (ChowAudioProcessor& p)
     initButtons();
 
     setSize (width, height);
+
+    startTimerHz (60);
 }
 
 ChowAudioProcessorEditor::~ChowAudioProcessorEditor()
@@ -55,6 +57,11 @@ ChowAudioProcessorEditor::~ChowAudioProcessorEditor()
     outGainSlide.setLookAndFeel (nullptr);
 }
 
+void ChowAudioProcessorEditor::timerCallback()
+{
+    processor.pullVisualiserSamples();
+}
+
 void ChowAudioProcessorEditor::initSliders()
 {
     auto setupSlider = [this] (Slider& slide, AudioParameterFloat* param,
@@ -19,7 +19,8 @@
 /**
 */
 class ChowAudioProcessorEditor  : public AudioProcessorEditor,
-                                  public Slider::Listener
+                                  public Slider::Listener,
+                                  private Timer
 {
 public:
     ChowAudioProcessorEditor (ChowAudioProcessor&);
@@ -37,6 +38,8 @@ public:
     void sliderDragEnded (Slider* slider) override;
 
 private:
+    void timerCallback() override;
+
     void initSliders();
     void initLabels();
     void initVisualizer();
@@ -41,20 +41,29 @@ ChowAudioProcessor::ChowAudioProcessor()
     addParameter (flip = new AudioParameterBool (String ("flip"), String ("Flip"), false));
     addParameter (rect = new AudioParameterBool (String ("rect"), String ("Rect"), false));
 
+    // off by default, so that existing sessions keep their sound
+    addParameter (antialiasing = new AudioParameterChoice (String ("antialiasing"), String ("Antialiasing"),
+                                                           StringArray ({ "Off", "ADAA 1st order", "ADAA 2nd order" }), 0));
+
     threshDB->addListener (this);
     ratio->addListener (this);
     inGainDB->addListener (this);
     outGainDB->addListener (this);
     flip->addListener (this);
     rect->addListener (this);
+    antialiasing->addListener (this);
 }
 
 ChowAudioProcessor::~ChowAudioProcessor()
 {
+    cancelPendingUpdate();
 }
 
 void ChowAudioProcessor::parameterValueChanged (int paramIndex, float /*newValue*/)
 {
+    if (getParameters()[paramIndex] == antialiasing)
+        triggerAsyncUpdate();
+
     auto* editor = dynamic_cast<ChowAudioProcessorEditor*> (getActiveEditor());
     if (editor != nullptr)
     {
@@ -205,6 +214,22 @@ void ChowAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
     setRateAndBufferSizeDetails (sampleRate, samplesPerBlock);
     vis->clear();
+
+    for (auto& h : history)
+        h = ChowADAA::History();
+
+    updateLatency();
+
+    // the editor's timer is the only reader, it drops what is left from before
+    visFifoStale = true;
+}
+
+void ChowAudioProcessor::updateLatency()
+{
+    // Second order ADAA delays by one sample. First order delays by half a
+    // sample, which the host can't compensate, rounding it either way would
+    // leave it just as far off, so it reports none.
+    setLatencySamples (antialiasing->getIndex() == 2 ? 1 : 0);
 }
 
 void ChowAudioProcessor::releaseResources()
@@ -236,46 +261,54 @@ bool ChowAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) con
 }
 #endif
 
-float ChowAudioProcessor::chow (float x)
-{
-    float y = x;
-
-    const float threshGain = Decibels::decibelsToGain (threshDB->get());
-
-    if (! *flip && x > threshGain)
-    {
-        y = threshGain;
-        
-        if (! *rect)
-            y += ((x - threshGain) / ratio->get());
-    }
-
-    else if (*flip && x < -threshGain)
-    {
-        y = -threshGain;
-        
-        if (! *rect)
-            y += ((x + threshGain) / ratio->get());
-    }
-
-    //set y
-    return y;
-}
-
 void ChowAudioProcessor::processBlock (AudioBuffer<float>& buffer, MidiBuffer& /*midiMessages*/)
 {
     ScopedNoDenormals noDenormals;
 
+    const int numSamples = buffer.getNumSamples();
+    const ChowADAA::Curve curve (Decibels::decibelsToGain (threshDB->get()), ratio->get(), *rect, *flip);
+    const int mode = antialiasing->getIndex();
+
     buffer.applyGain (Decibels::decibelsToGain (inGainDB->get()));
-    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+    for (int channel = 0; channel < jmin (buffer.getNumChannels(), (int) numElementsInArray (history)); ++channel)
     {
         auto* x = buffer.getWritePointer (channel);
-        for (int n = 0; n < buffer.getNumSamples(); n++)
-            x[n] = chow (x[n]);
+
+        switch (mode)
+        {
+        case 1:
+            ChowADAA::processFirstOrder (x, numSamples, curve, history[channel]);
+            break;
+
+        case 2:
+            ChowADAA::processSecondOrder (x, numSamples, curve, history[channel]);
+            break;
+
+        default:
+            ChowADAA::processDirect (x, numSamples, curve, history[channel]);
+            break;
+        }
     }
     buffer.applyGain (Decibels::decibelsToGain (outGainDB->get()));
 
-    vis->pushBuffer (buffer.getArrayOfReadPointers(), 1, buffer.getNumSamples());
+    // whatever doesn't fit is dropped, the editor may be closed
+    const auto write = visFifo.write (jmin (numSamples, visFifo.getFreeSpace()));
+    if (write.blockSize1 > 0)
+        visBuffer.copyFrom (0, write.startIndex1, buffer, 0, 0, write.blockSize1);
+    if (write.blockSize2 > 0)
+        visBuffer.copyFrom (0, write.startIndex2, buffer, 0, write.blockSize1, write.blockSize2);
+}
+
+void ChowAudioProcessor::pullVisualiserSamples()
+{
+    if (visFifoStale.exchange (false))
+        visFifo.finishedRead (visFifo.getNumReady());
+
+    const auto read = visFifo.read (visFifo.getNumReady());
+    if (read.blockSize1 > 0)
+        vis->pushBuffer (AudioSourceChannelInfo (&visBuffer, read.startIndex1, read.blockSize1));
+    if (read.blockSize2 > 0)
+        vis->pushBuffer (AudioSourceChannelInfo (&visBuffer, read.startIndex2, read.blockSize2));
 }
 
 //==============================================================================
@@ -299,6 +332,7 @@ void ChowAudioProcessor::getStateInformation (MemoryBlock& destData)
     xml->setAttribute ("inGainDB", (double) *inGainDB);
     xml->setAttribute ("outGainDB", (double) *outGainDB);
     xml->setAttribute ("flip", *flip);
+    xml->setAttribute ("antialiasing", antialiasing->getIndex());
 
     copyXmlToBinary (*xml, destData);
 }
@@ -315,6 +349,7 @@ void ChowAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
             *inGainDB = (float) xmlState->getDoubleAttribute ("inGainDB", 0.0);
             *outGainDB = (float) xmlState->getDoubleAttribute ("outGainDB", 0.0);
             *flip = xmlState->getBoolAttribute ("flip", false);
+            *antialiasing = xmlState->getIntAttribute ("antialiasing", 0);
         }
     }
 }
@@ -11,12 +11,14 @@
 #pragma once
 
 #include "JuceHeader.h"
+#include "ChowADAA.h"
 
 //==============================================================================
 /**
 */
 class ChowAudioProcessor : public AudioProcessor,
-                           private AudioProcessorParameter::Listener
+                           private AudioProcessorParameter::Listener,
+                           private AsyncUpdater
 {
 public:
     //==============================================================================
@@ -68,15 +70,32 @@ public:
     AudioParameterBool* flip;
     AudioParameterBool* rect;
 
+    AudioParameterChoice* antialiasing;
+
     //@MAYBELATER: Dry wet param??
     //@MAYBELATER: attack/release stuff??, or at least smooth param changes
 
     std::unique_ptr<AudioVisualiserComponent> vis;
 
+    /** Hands the samples processBlock left for the visualiser over to it, message thread only */
+    void pullVisualiserSamples();
+
 private:
     int programNum = 0;
 
-    float chow (float x);
+    void updateLatency();
+
+    // parameter changes can arrive on the audio thread, the latency is reported from the message thread
+    void handleAsyncUpdate() override { updateLatency(); }
+
+    ChowADAA::History history[2];
+
+    // processBlock only writes here, the visualiser paints from its own state
+    // on the message thread and pushing into it isn't thread safe
+    enum { visFifoSize = 8192 };
+    AbstractFifo visFifo { visFifoSize };
+    AudioBuffer<float> visBuffer { 1, visFifoSize };
+    std::atomic<bool> visFifoStale { false };
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ChowAudioProcessor)
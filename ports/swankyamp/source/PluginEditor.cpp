@@ -64,7 +64,7 @@ SwankyAmpAudioProcessorEditor::SwankyAmpAudioProcessorEditor(
     managerListenIds.push_back(parameterId);
   }
 
-  logoSvg = Drawable::createFromSVG(*XmlDocument::parse(BinaryData::logo_svg));
+  logoSvg = resources->createDrawable(BinaryData::logo_svg, BinaryData::logo_svgSize);
 
   versionLabel.setText("v" JucePlugin_VersionString, dontSendNotification);
   versionLabel.setColour(Label::textColourId, SwankyAmpLAF::colourDark);
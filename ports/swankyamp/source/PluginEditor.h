@@ -20,6 +20,7 @@
 
 #include "PluginProcessor.h"
 #include <JuceHeader.h>
+#include "JucePluginResourceCache.h"
 
 #include "Components/AmpGroup.h"
 #include "Components/PresetGroup.h"
@@ -83,6 +84,7 @@ private:
   TooltipsData tooltipsData;
   TooltipWindow tooltipWindow;
 
+  SharedResourcePointer<JucePluginResourceCache> resources;
   std::unique_ptr<Drawable> logoSvg;
 
   Image bgNoise;
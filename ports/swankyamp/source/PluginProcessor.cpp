@@ -26,6 +26,15 @@
 #include "Utils.h"
 
 #include "PluginProcessor.h"
+#include "JucePluginCpuDispatch.h"
+
+// runs the whole amp model, inlined here so that it is compiled once per CPU
+// level with cpu-dispatch
+JUCE_PLUGIN_CPU_DISPATCH_CLONES
+static void processAmp(PushPullAmp& amp, int count, float** buffer)
+{
+  amp.process(count, buffer);
+}
 
 // add parameter to the VTS with default range -1 to +1
 #define MAKE_PARAMETER_UNIT(n) \
@@ -355,13 +364,13 @@ void SwankyAmpAudioProcessor::processBlock(
   if (totalNumInputChannels == 1 && totalNumOutputChannels == 1)
   {
     float* amp_buffer = buffer.getWritePointer(0);
-    amp_channel[0].process(buffer.getNumSamples(), &amp_buffer);
+    processAmp(amp_channel[0], buffer.getNumSamples(), &amp_buffer);
   }
   // mono to stereo: run the amp once, copy the result
   else if (totalNumInputChannels == 1 && totalNumOutputChannels == 2)
   {
     float* amp_buffer = buffer.getWritePointer(0);
-    amp_channel[0].process(buffer.getNumSamples(), &amp_buffer);
+    processAmp(amp_channel[0], buffer.getNumSamples(), &amp_buffer);
     float* amp_buffer_other = buffer.getWritePointer(1);
     std::memcpy(
         (void*)amp_buffer_other, (void*)amp_buffer, numSamples * sizeof(float));
@@ -372,7 +381,7 @@ void SwankyAmpAudioProcessor::processBlock(
     for (int i = 0; i < 2; i++)
     {
       float* amp_buffer = buffer.getWritePointer(i);
-      amp_channel[i].process(buffer.getNumSamples(), &amp_buffer);
+      processAmp(amp_channel[i], buffer.getNumSamples(), &amp_buffer);
     }
   }
 
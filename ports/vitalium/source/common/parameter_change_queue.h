@@ -0,0 +1,106 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+// Bounded, preallocated queue of parameter changes that coalesces per parameter index.
+// Any number of threads may push, one thread pops. A parameter is in the queue at most once,
+// so the ring never fills up and pushing never allocates, locks or fails. Popping returns the
+// latest value pushed for that parameter.
+class ParameterChangeQueue {
+  public:
+    ParameterChangeQueue(int num_parameters) : num_parameters_(num_parameters) {
+      capacity_ = 1;
+      while (capacity_ < static_cast<size_t>(num_parameters))
+        capacity_ *= 2;
+
+      values_ = std::make_unique<std::atomic<float>[]>(num_parameters);
+      pending_ = std::make_unique<std::atomic<bool>[]>(num_parameters);
+      cells_ = std::make_unique<Cell[]>(capacity_);
+
+      for (int i = 0; i < num_parameters; ++i) {
+        values_[i].store(0.0f, std::memory_order_relaxed);
+        pending_[i].store(false, std::memory_order_relaxed);
+      }
+      for (size_t i = 0; i < capacity_; ++i)
+        cells_[i].sequence.store(i, std::memory_order_relaxed);
+
+      enqueue_position_.store(0, std::memory_order_relaxed);
+      dequeue_position_ = 0;
+    }
+
+    // Returns true if the parameter was not already waiting in the queue.
+    bool push(int index, float value) {
+      values_[index].store(value, std::memory_order_relaxed);
+      if (pending_[index].exchange(true, std::memory_order_acq_rel))
+        return false;
+
+      size_t position = enqueue_position_.load(std::memory_order_relaxed);
+      Cell* cell = nullptr;
+      while (true) {
+        cell = &cells_[position & (capacity_ - 1)];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        if (sequence == position) {
+          if (enqueue_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            break;
+        }
+        else
+          position = enqueue_position_.load(std::memory_order_relaxed);
+      }
+
+      cell->index = index;
+      cell->sequence.store(position + 1, std::memory_order_release);
+      return true;
+    }
+
+    // Single consumer only.
+    bool pop(int& index, float& value) {
+      Cell* cell = &cells_[dequeue_position_ & (capacity_ - 1)];
+      if (cell->sequence.load(std::memory_order_acquire) != dequeue_position_ + 1)
+        return false;
+
+      index = cell->index;
+      cell->sequence.store(dequeue_position_ + capacity_, std::memory_order_release);
+      dequeue_position_++;
+
+      // Clearing the flag before reading the value means a concurrent push either lands in
+      // this read or queues the parameter again.
+      pending_[index].exchange(false, std::memory_order_acq_rel);
+      value = values_[index].load(std::memory_order_relaxed);
+      return true;
+    }
+
+    int size() const { return num_parameters_; }
+
+  private:
+    struct Cell {
+      std::atomic<size_t> sequence;
+      int index;
+    };
+
+    int num_parameters_;
+    size_t capacity_;
+    std::unique_ptr<std::atomic<float>[]> values_;
+    std::unique_ptr<std::atomic<bool>[]> pending_;
+    std::unique_ptr<Cell[]> cells_;
+
+    std::atomic<size_t> enqueue_position_;
+    size_t dequeue_position_;
+};
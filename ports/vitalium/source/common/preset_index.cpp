@@ -0,0 +1,374 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "preset_index.h"
+
+#include "load_save.h"
+#include "synth_constants.h"
+
+namespace {
+  constexpr int kIndexVersion = 1;
+  constexpr int kReadBufferSize = 4096;
+  constexpr int kStopTimeout = 2000;
+
+  // Just enough of a JSON tokenizer to walk the top level of an object and skip nested values.
+  class JsonHeaderReader {
+    public:
+      JsonHeaderReader(InputStream& stream) : stream_(stream), pending_(0) { }
+
+      bool next(char& c) {
+        if (pending_) {
+          c = pending_;
+          pending_ = 0;
+          return true;
+        }
+        return stream_.read(&c, 1) == 1;
+      }
+
+      bool nextToken(char& c) {
+        while (next(c)) {
+          if (c != ' ' && c != '\n' && c != '\r' && c != '\t')
+            return true;
+        }
+        return false;
+      }
+
+      // Reads the rest of a string after its opening quote.
+      bool readString(std::string& result) {
+        char c;
+        while (next(c)) {
+          if (c == '"')
+            return true;
+          if (c != '\\') {
+            result += c;
+            continue;
+          }
+
+          if (!next(c))
+            return false;
+
+          switch (c) {
+            case 'b': result += '\b'; break;
+            case 'f': result += '\f'; break;
+            case 'n': result += '\n'; break;
+            case 'r': result += '\r'; break;
+            case 't': result += '\t'; break;
+            case 'u': {
+              juce_wchar code_point = 0;
+              if (!readHex(code_point))
+                return false;
+
+              juce_wchar low_surrogate = 0;
+              if (code_point >= 0xd800 && code_point < 0xdc00) {
+                if (!next(c) || c != '\\' || !next(c) || c != 'u' || !readHex(low_surrogate))
+                  return false;
+                code_point = 0x10000 + ((code_point - 0xd800) << 10) + (low_surrogate - 0xdc00);
+              }
+              result += String::charToString(code_point).toStdString();
+              break;
+            }
+            default: result += c;
+          }
+        }
+        return false;
+      }
+
+      // Skips a value starting with first and leaves the character after it to be read next.
+      bool skipValue(char first) {
+        char c = first;
+        if (c == '"') {
+          std::string ignored;
+          return readString(ignored);
+        }
+
+        if (c == '{' || c == '[') {
+          int depth = 1;
+          while (depth > 0 && next(c)) {
+            if (c == '"') {
+              std::string ignored;
+              if (!readString(ignored))
+                return false;
+            }
+            else if (c == '{' || c == '[')
+              depth++;
+            else if (c == '}' || c == ']')
+              depth--;
+          }
+          return depth == 0;
+        }
+
+        while (next(c)) {
+          if (c == ',' || c == '}' || c == ']') {
+            pending_ = c;
+            return true;
+          }
+        }
+        return false;
+      }
+
+    private:
+      bool readHex(juce_wchar& value) {
+        value = 0;
+        for (int i = 0; i < 4; ++i) {
+          char c;
+          if (!next(c))
+            return false;
+
+          int digit = CharacterFunctions::getHexDigitValue(c);
+          if (digit < 0)
+            return false;
+          value = (value << 4) | digit;
+        }
+        return true;
+      }
+
+      InputStream& stream_;
+      char pending_;
+  };
+} // namespace
+
+bool PresetIndex::readHeader(const File& preset, Entry& entry) {
+  FileInputStream file_stream(preset);
+  if (!file_stream.openedOk())
+    return false;
+
+  BufferedInputStream stream(file_stream, kReadBufferSize);
+  JsonHeaderReader reader(stream);
+  entry.name = preset.getFileNameWithoutExtension().toStdString();
+
+  char c;
+  if (!reader.nextToken(c) || c != '{')
+    return false;
+
+  while (reader.nextToken(c)) {
+    if (c == '}')
+      return true;
+    if (c == ',')
+      continue;
+
+    std::string key;
+    if (c != '"' || !reader.readString(key) || !reader.nextToken(c) || c != ':' || !reader.nextToken(c))
+      return false;
+
+    // Presets are saved with sorted keys so everything we need comes before the settings.
+    if (key == "settings")
+      return true;
+
+    if (c != '"') {
+      if (!reader.skipValue(c))
+        return false;
+      continue;
+    }
+
+    std::string value;
+    if (!reader.readString(value))
+      return false;
+
+    if (key == "preset_name" && !value.empty())
+      entry.name = value;
+    else if (key == "author")
+      entry.author = value;
+    else if (key == "preset_style")
+      entry.style = value;
+    else if (key == "license")
+      entry.license = value;
+    else if (key == "comments")
+      entry.comments = value;
+  }
+
+  return false;
+}
+
+PresetIndex::PresetIndex() : Thread("Preset Index"), ready_(false) {
+  startThread(1);
+}
+
+PresetIndex::~PresetIndex() {
+  signalThreadShouldExit();
+  notify();
+  stopThread(kStopTimeout);
+  cancelPendingUpdate();
+}
+
+bool PresetIndex::isReady() {
+  ScopedLock lock(lock_);
+  return ready_;
+}
+
+bool PresetIndex::getEntry(const File& preset, Entry& entry) {
+  ScopedLock lock(lock_);
+  auto found = entries_.find(preset.getFullPathName().toStdString());
+  if (found == entries_.end())
+    return false;
+
+  entry = found->second;
+  return true;
+}
+
+void PresetIndex::getAllPresets(Array<File>& presets) {
+  ScopedLock lock(lock_);
+  if (!ready_) {
+    LoadSave::getAllPresets(presets);
+    return;
+  }
+
+  presets.clear();
+  presets.ensureStorageAllocated(static_cast<int>(entries_.size()));
+  for (const auto& entry : entries_)
+    presets.add(File(entry.first));
+}
+
+void PresetIndex::getPresetsInFolder(const File& folder, Array<File>& presets) {
+  ScopedLock lock(lock_);
+  presets.clear();
+  if (!ready_) {
+    folder.findChildFiles(presets, File::findFiles, true, String("*.") + vital::kPresetExtension);
+    return;
+  }
+
+  for (const auto& entry : entries_) {
+    File file(entry.first);
+    if (file.isAChildOf(folder))
+      presets.add(file);
+  }
+}
+
+File PresetIndex::getIndexFile() {
+  File config_file = LoadSave::getConfigFile();
+  if (config_file == File())
+    return File();
+  return config_file.getSiblingFile("preset_index.json");
+}
+
+void PresetIndex::run() {
+  load();
+
+  while (!threadShouldExit()) {
+    if (update())
+      triggerAsyncUpdate();
+    wait(-1);
+  }
+}
+
+void PresetIndex::handleAsyncUpdate() {
+  for (Listener* listener : listeners_)
+    listener->presetIndexUpdated();
+}
+
+void PresetIndex::load() {
+  File index_file = getIndexFile();
+  if (!index_file.existsAsFile())
+    return;
+
+  std::map<std::string, Entry> entries;
+  try {
+    json data = json::parse(index_file.loadFileAsString().toStdString(), nullptr);
+    if (data["version"] != kIndexVersion)
+      return;
+
+    for (const json& item : data["presets"]) {
+      Entry entry;
+      entry.modified = item["modified"];
+      entry.size = item["size"];
+      entry.name = item["name"];
+      entry.author = item["author"];
+      entry.style = item["style"];
+      entry.license = item["license"];
+      entry.comments = item["comments"];
+      entries[item["path"]] = entry;
+    }
+  }
+  catch (const json::exception& e) {
+    return;
+  }
+
+  ScopedLock lock(lock_);
+  entries_ = std::move(entries);
+  ready_ = true;
+}
+
+void PresetIndex::save(const std::map<std::string, Entry>& entries) {
+  File index_file = getIndexFile();
+  if (index_file == File())
+    return;
+
+  json presets = json::array();
+  for (const auto& entry : entries) {
+    json item;
+    item["path"] = entry.first;
+    item["modified"] = entry.second.modified;
+    item["size"] = entry.second.size;
+    item["name"] = entry.second.name;
+    item["author"] = entry.second.author;
+    item["style"] = entry.second.style;
+    item["license"] = entry.second.license;
+    item["comments"] = entry.second.comments;
+    presets.push_back(item);
+  }
+
+  json data;
+  data["version"] = kIndexVersion;
+  data["presets"] = presets;
+  index_file.getParentDirectory().createDirectory();
+  index_file.replaceWithText(data.dump());
+}
+
+bool PresetIndex::update() {
+  std::map<std::string, Entry> entries;
+  {
+    ScopedLock lock(lock_);
+    entries = entries_;
+  }
+
+  std::map<std::string, Entry> updated;
+  bool changed = false;
+  String wildcard = String("*.") + vital::kPresetExtension;
+  for (const File& directory : LoadSave::getPresetDirectories()) {
+    if (!directory.isDirectory())
+      continue;
+
+    for (const DirectoryEntry& file : RangedDirectoryIterator(directory, true, wildcard, File::findFiles)) {
+      if (threadShouldExit())
+        return false;
+
+      std::string path = file.getFile().getFullPathName().toStdString();
+      int64 modified = file.getModificationTime().toMilliseconds();
+      int64 size = file.getFileSize();
+
+      auto existing = entries.find(path);
+      if (existing != entries.end() && existing->second.modified == modified && existing->second.size == size) {
+        updated[path] = existing->second;
+        continue;
+      }
+
+      Entry entry;
+      entry.modified = modified;
+      entry.size = size;
+      readHeader(file.getFile(), entry);
+      updated[path] = entry;
+      changed = true;
+    }
+  }
+
+  changed = changed || updated.size() != entries.size();
+  if (changed)
+    save(updated);
+
+  ScopedLock lock(lock_);
+  entries_ = std::move(updated);
+  ready_ = true;
+  return changed;
+}
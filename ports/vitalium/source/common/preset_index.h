@@ -0,0 +1,82 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "JuceHeader.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+// On disk index of the header fields of all presets in the preset directories.
+// The index is loaded once and brought up to date on a background thread: only presets whose
+// modification time or size changed get read again, and only up to their "settings" block.
+// Share it between browsers with SharedResourcePointer<PresetIndex>.
+class PresetIndex : private Thread, private AsyncUpdater {
+  public:
+    struct Entry {
+      int64 modified = 0;
+      int64 size = 0;
+      std::string name;
+      std::string author;
+      std::string style;
+      std::string license;
+      std::string comments;
+    };
+
+    class Listener {
+      public:
+        virtual ~Listener() { }
+
+        virtual void presetIndexUpdated() = 0;
+    };
+
+    // Reads the top level string fields of a preset without parsing its settings.
+    static bool readHeader(const File& preset, Entry& entry);
+
+    PresetIndex();
+    virtual ~PresetIndex();
+
+    void requestUpdate() { notify(); }
+    bool isReady();
+
+    bool getEntry(const File& preset, Entry& entry);
+    void getAllPresets(Array<File>& presets);
+    void getPresetsInFolder(const File& folder, Array<File>& presets);
+
+    void addListener(Listener* listener) { listeners_.push_back(listener); }
+    void removeListener(Listener* listener) {
+      listeners_.erase(std::remove(listeners_.begin(), listeners_.end(), listener), listeners_.end());
+    }
+
+  private:
+    static File getIndexFile();
+
+    void run() override;
+    void handleAsyncUpdate() override;
+
+    void load();
+    void save(const std::map<std::string, Entry>& entries);
+    bool update();
+
+    CriticalSection lock_;
+    std::map<std::string, Entry> entries_;
+    bool ready_;
+    std::vector<Listener*> listeners_;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetIndex)
+};
@@ -58,6 +58,11 @@ SynthBase::SynthBase() : expired_(false) {
 
   controls_ = engine_->getControls();
 
+  int num_parameters = vital::Parameters::getNumParameters();
+  external_controls_.reserve(num_parameters);
+  external_change_queue_ = std::make_unique<ParameterChangeQueue>(num_parameters);
+  external_change_updater_ = std::make_unique<ExternalChangeUpdater>(this);
+
   Startup::doStartupChecks();
 }
 
@@ -74,19 +79,16 @@ void SynthBase::valueChangedInternal(const std::string& name, vital::mono_float
 
 void SynthBase::valueChangedThroughMidi(const std::string& name, vital::mono_float value) {
   controls_[name]->set(value);
-  ValueChangedCallback* callback = new ValueChangedCallback(self_reference_, name, value);
   setValueNotifyHost(name, value);
-  callback->post();
+  postValueChanged(name, value);
 }
 
 void SynthBase::pitchWheelMidiChanged(vital::mono_float value) {
-  ValueChangedCallback* callback = new ValueChangedCallback(self_reference_, "pitch_wheel", value);
-  callback->post();
+  postValueChanged("pitch_wheel", value);
 }
 
 void SynthBase::modWheelMidiChanged(vital::mono_float value) {
-  ValueChangedCallback* callback = new ValueChangedCallback(self_reference_, "mod_wheel", value);
-  callback->post();
+  postValueChanged("mod_wheel", value);
 }
 
 void SynthBase::pitchWheelGuiChanged(vital::mono_float value) {
@@ -112,8 +114,68 @@ void SynthBase::valueChangedExternal(const std::string& name, vital::mono_float
   else if (name == "pitch_wheel")
     engine_->setZonedPitchWheel(value, 0, vital::kNumMidiChannels - 1);
 
-  ValueChangedCallback* callback = new ValueChangedCallback(self_reference_, name, value);
-  callback->post();
+  postValueChanged(name, value);
+}
+
+int SynthBase::addExternalControl(const std::string& name) {
+  VITAL_ASSERT(controls_.count(name));
+  VITAL_ASSERT(external_controls_.size() < external_controls_.capacity());
+
+  ExternalControl::Type type = ExternalControl::kValue;
+  if (name == "mod_wheel")
+    type = ExternalControl::kModWheel;
+  else if (name == "pitch_wheel")
+    type = ExternalControl::kPitchWheel;
+
+  external_controls_.push_back({ name, controls_[name], type });
+  return static_cast<int>(external_controls_.size()) - 1;
+}
+
+void SynthBase::valueChangedExternal(int index, vital::mono_float value) {
+  const ExternalControl& control = external_controls_[index];
+  control.value->set(value);
+  if (control.type == ExternalControl::kModWheel)
+    engine_->setModWheelAllChannels(value);
+  else if (control.type == ExternalControl::kPitchWheel)
+    engine_->setZonedPitchWheel(value, 0, vital::kNumMidiChannels - 1);
+
+  if (!external_change_queue_->push(index, value))
+    return;
+
+  if (hasMessageLoop())
+    external_change_updater_->triggerAsyncUpdate();
+  else
+    updateGuiFromExternalChanges();
+}
+
+void SynthBase::postValueChanged(const std::string& name, vital::mono_float value) {
+  if (hasMessageLoop()) {
+    ValueChangedCallback* callback = new ValueChangedCallback(self_reference_, name, value);
+    callback->post();
+  }
+  else {
+    ValueChangedCallback callback(self_reference_, name, value);
+    callback.messageCallback();
+  }
+}
+
+void SynthBase::updateGuiFromExternalChanges() {
+  SynthGuiInterface* gui_interface = getGuiInterface();
+  bool changed = false;
+
+  int index = 0;
+  vital::mono_float value = 0.0f;
+  while (external_change_queue_->pop(index, value)) {
+    if (gui_interface == nullptr)
+      continue;
+
+    const ExternalControl& control = external_controls_[index];
+    gui_interface->updateGuiControl(control.name, value);
+    changed = changed || control.type != ExternalControl::kPitchWheel;
+  }
+
+  if (changed)
+    gui_interface->notifyChange();
 }
 
 vital::ModulationConnection* SynthBase::getConnection(const std::string& source, const std::string& destination) {
@@ -334,6 +396,7 @@ void SynthBase::loadInitPreset() {
   engine_->allSoundsOff();
   initEngine();
   LoadSave::initSaveInfo(save_info_);
+  prepareOutputArena();
   pauseProcessing(false);
 }
 
@@ -342,6 +405,7 @@ bool SynthBase::loadFromJson(const json& data) {
   engine_->allSoundsOff();
   try {
     bool result = LoadSave::jsonToState(this, save_info_, data);
+    prepareOutputArena();
     pauseProcessing(false);
     return result;
   }
@@ -594,6 +658,11 @@ void SynthBase::processAudioWithInput(AudioSampleBuffer* buffer, const vital::po
   writeAudio(buffer, channels, samples, offset);
 }
 
+void SynthBase::prepareOutputArena() {
+  processModulationChanges();
+  engine_->updateVoiceOutputArena();
+}
+
 void SynthBase::writeAudio(AudioSampleBuffer* buffer, int channels, int samples, int offset) {
   const vital::mono_float* engine_output = (const vital::mono_float*)engine_->output(0)->buffer;
   for (int channel = 0; channel < channels; ++channel) {
@@ -735,6 +804,7 @@ void SynthBase::notifyOversamplingChanged() {
   pauseProcessing(true);
   engine_->allSoundsOff();
   checkOversampling();
+  prepareOutputArena();
   pauseProcessing(false);
 }
 
@@ -19,6 +19,7 @@
 #include "JuceHeader.h"
 #include "concurrentqueue/concurrentqueue.h"
 #include "line_generator.h"
+#include "parameter_change_queue.h"
 #include "synth_constants.h"
 #include "synth_types.h"
 #include "midi_manager.h"
@@ -56,6 +57,9 @@ class SynthBase : public MidiManager::Listener {
     void modWheelGuiChanged(vital::mono_float value);
     void presetChangedThroughMidi(File preset) override;
     void valueChangedExternal(const std::string& name, vital::mono_float value);
+    void valueChangedExternal(int index, vital::mono_float value);
+    int addExternalControl(const std::string& name);
+    void updateGuiFromExternalChanges();
     void valueChangedInternal(const std::string& name, vital::mono_float value);
     bool connectModulation(const std::string& source, const std::string& destination);
     void connectModulation(vital::ModulationConnection* connection);
@@ -117,6 +121,10 @@ class SynthBase : public MidiManager::Listener {
     void checkOversampling();
     virtual const CriticalSection& getCriticalSection() = 0;
     virtual void pauseProcessing(bool pause) = 0;
+
+    // Deferred GUI updates are posted to the message thread. Synths that run without a message
+    // loop return false and get them run synchronously on the calling thread instead.
+    virtual bool hasMessageLoop() const { return true; }
     Tuning* getTuning() { return &tuning_; }
 
     struct ValueChangedCallback : public CallbackMessage {
@@ -130,7 +138,28 @@ class SynthBase : public MidiManager::Listener {
       vital::mono_float value;
     };
 
+    class ExternalChangeUpdater : public AsyncUpdater {
+      public:
+        ExternalChangeUpdater(SynthBase* synth) : synth_(synth) { }
+        void handleAsyncUpdate() override { synth_->updateGuiFromExternalChanges(); }
+
+      private:
+        SynthBase* synth_;
+    };
+
   protected:
+    struct ExternalControl {
+      enum Type {
+        kValue,
+        kModWheel,
+        kPitchWheel
+      };
+
+      std::string name;
+      vital::Value* value;
+      Type type;
+    };
+
     vital::modulation_change createModulationChange(vital::ModulationConnection* connection);
     bool isInvalidConnection(const vital::modulation_change& change);
     virtual SynthGuiInterface* getGuiInterface() = 0;
@@ -155,7 +184,13 @@ class SynthBase : public MidiManager::Listener {
     void processMidi(MidiBuffer& buffer, int start_sample = 0, int end_sample = 0);
     void processKeyboardEvents(MidiBuffer& buffer, int num_samples);
     void processModulationChanges();
+
+    // Applies the queued modulation changes and pools the voice buffers. Allocates, so only call
+    // this from prepareToPlay() or while processing is paused.
+    void prepareOutputArena();
+
     void updateMemoryOutput(int samples, const vital::poly_float* audio);
+    void postValueChanged(const std::string& name, vital::mono_float value);
 
     std::unique_ptr<vital::SoundEngine> engine_;
     std::unique_ptr<MidiManager> midi_manager_;
@@ -180,6 +215,9 @@ class SynthBase : public MidiManager::Listener {
     vital::CircularQueue<vital::ModulationConnection*> mod_connections_;
     moodycamel::ConcurrentQueue<vital::control_change> value_change_queue_;
     moodycamel::ConcurrentQueue<vital::modulation_change> modulation_change_queue_;
+    std::vector<ExternalControl> external_controls_;
+    std::unique_ptr<ParameterChangeQueue> external_change_queue_;
+    std::unique_ptr<ExternalChangeUpdater> external_change_updater_;
     Tuning tuning_;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SynthBase)
@@ -198,6 +236,8 @@ class HeadlessSynth : public SynthBase {
         critical_section_.exit();
     }
 
+    virtual bool hasMessageLoop() const override { return false; }
+
   protected:
     virtual SynthGuiInterface* getGuiInterface() override { return nullptr; }
 
@@ -0,0 +1,218 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "JuceHeader.h"
+#include "offline_renderer.h"
+
+#include <atomic>
+#include <thread>
+
+namespace {
+  const std::string kUsage =
+      "Usage: vitalium-render [options] --output <dir> --preset <file>... --midi <file>...\n"
+      "Renders every preset with every MIDI file to <dir>/<preset>_<midi>.wav\n"
+      "\n"
+      "  --sample-rate <hz>     Sample rate (default 44100)\n"
+      "  --bit-depth <bits>     16, 24 or 32 (default 24)\n"
+      "  --block-size <n>       Samples per processed block (default 64)\n"
+      "  --bpm <bpm>            Tempo for synced modulation (default 120)\n"
+      "  --tail <seconds>       Rendered time after the last MIDI event (default 2)\n"
+      "  --pre-roll <seconds>   Processed before the first written sample, so the preset\n"
+      "                         settles (default 0.1)\n"
+      "  --threads <n>          Worker threads (default: number of cores)\n";
+
+  struct Preset {
+    String name;
+    json state;
+  };
+
+  struct Midi {
+    String name;
+    MidiMessageSequence sequence;
+  };
+
+  struct Job {
+    int preset_index;
+    int midi_index;
+    File output;
+    OfflineRenderer::Result result;
+  };
+
+  bool loadPreset(const File& file, Preset& preset) {
+    try {
+      preset.name = file.getFileNameWithoutExtension();
+      preset.state = json::parse(file.loadFileAsString().toStdString(), nullptr);
+      return true;
+    }
+    catch (const json::exception& e) {
+      return false;
+    }
+  }
+
+  bool loadMidi(const File& file, Midi& midi) {
+    FileInputStream stream(file);
+    MidiFile midi_file;
+    if (!stream.openedOk() || !midi_file.readFrom(stream))
+      return false;
+
+    midi_file.convertTimestampTicksToSeconds();
+    for (int i = 0; i < midi_file.getNumTracks(); ++i)
+      midi.sequence.addSequence(*midi_file.getTrack(i), 0.0);
+    midi.sequence.updateMatchedPairs();
+    midi.name = file.getFileNameWithoutExtension();
+    return true;
+  }
+
+  void renderJobs(OfflineRenderer* renderer, const std::vector<Preset>& presets, const std::vector<Midi>& midis,
+                  std::vector<Job>& jobs, std::atomic<int>& next_job, const OfflineRenderer::Settings& settings) {
+    int loaded_preset = -1;
+    for (int index = next_job++; index < jobs.size(); index = next_job++) {
+      Job& job = jobs[index];
+      if (job.preset_index != loaded_preset) {
+        loaded_preset = -1;
+        if (!renderer->loadPreset(presets[job.preset_index].state, job.result.error))
+          continue;
+        loaded_preset = job.preset_index;
+      }
+
+      job.result = renderer->render(midis[job.midi_index].sequence, settings, job.output);
+    }
+  }
+} // namespace
+
+int main(int argc, char** argv) {
+  ScopedJuceInitialiser_GUI juce_initialiser;
+
+  OfflineRenderer::Settings settings;
+  int num_threads = SystemStats::getNumCpus();
+  File output_directory;
+  std::vector<Preset> presets;
+  std::vector<Midi> midis;
+
+  StringArray args;
+  for (int i = 1; i < argc; ++i)
+    args.add(argv[i]);
+
+  for (int i = 0; i < args.size(); ++i) {
+    String arg = args[i];
+    if (arg == "--help" || arg == "-h") {
+      std::cout << kUsage;
+      return 0;
+    }
+    if (i + 1 >= args.size()) {
+      std::cerr << "Missing value for " << arg << std::endl << kUsage;
+      return 1;
+    }
+
+    String value = args[++i];
+    File file = File::getCurrentWorkingDirectory().getChildFile(value);
+    if (arg == "--sample-rate")
+      settings.sample_rate = value.getDoubleValue();
+    else if (arg == "--bit-depth")
+      settings.bit_depth = value.getIntValue();
+    else if (arg == "--block-size")
+      settings.block_size = value.getIntValue();
+    else if (arg == "--bpm")
+      settings.bpm = value.getFloatValue();
+    else if (arg == "--tail")
+      settings.tail_seconds = value.getFloatValue();
+    else if (arg == "--pre-roll")
+      settings.pre_roll_seconds = value.getFloatValue();
+    else if (arg == "--threads")
+      num_threads = value.getIntValue();
+    else if (arg == "--output")
+      output_directory = file;
+    else if (arg == "--preset") {
+      Preset preset;
+      if (!loadPreset(file, preset)) {
+        std::cerr << "Couldn't read preset " << file.getFullPathName() << std::endl;
+        return 1;
+      }
+      presets.push_back(std::move(preset));
+    }
+    else if (arg == "--midi") {
+      Midi midi;
+      if (!loadMidi(file, midi)) {
+        std::cerr << "Couldn't read MIDI file " << file.getFullPathName() << std::endl;
+        return 1;
+      }
+      midis.push_back(std::move(midi));
+    }
+    else {
+      std::cerr << "Unknown option " << arg << std::endl << kUsage;
+      return 1;
+    }
+  }
+
+  if (presets.empty() || midis.empty() || output_directory == File()) {
+    std::cerr << kUsage;
+    return 1;
+  }
+  if (settings.sample_rate <= 0.0 || settings.block_size <= 0 || settings.pre_roll_seconds < 0.0f ||
+      (settings.bit_depth != 16 && settings.bit_depth != 24 && settings.bit_depth != 32)) {
+    std::cerr << "Invalid sample rate, block size, bit depth or pre-roll" << std::endl;
+    return 1;
+  }
+  output_directory.createDirectory();
+
+  // Jobs are ordered by preset so a worker only reloads a preset when it moves on to the next one.
+  std::vector<Job> jobs;
+  for (int p = 0; p < presets.size(); ++p) {
+    for (int m = 0; m < midis.size(); ++m) {
+      String name = presets[p].name + "_" + midis[m].name + ".wav";
+      jobs.push_back({ p, m, output_directory.getChildFile(File::createLegalFileName(name)), {} });
+    }
+  }
+
+  num_threads = jlimit(1, (int)jobs.size(), num_threads);
+
+  // Renderers are created up front so shared lookup tables get initialized on this thread.
+  std::vector<std::unique_ptr<OfflineRenderer>> renderers;
+  for (int i = 0; i < num_threads; ++i)
+    renderers.push_back(std::make_unique<OfflineRenderer>());
+
+  double start_time = Time::getMillisecondCounterHiRes();
+  std::atomic<int> next_job(0);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.emplace_back(renderJobs, renderers[i].get(), std::cref(presets), std::cref(midis),
+                         std::ref(jobs), std::ref(next_job), std::cref(settings));
+  }
+  for (std::thread& thread : threads)
+    thread.join();
+  double total_seconds = (Time::getMillisecondCounterHiRes() - start_time) * 0.001;
+
+  int num_failed = 0;
+  double total_audio_seconds = 0.0;
+  for (const Job& job : jobs) {
+    if (job.result.success) {
+      total_audio_seconds += job.result.audio_seconds;
+      std::cout << job.output.getFileName() << ": " << String(job.result.audio_seconds, 2) << "s audio in "
+                << String(job.result.render_seconds, 2) << "s, "
+                << String(job.result.realtimeFactor(), 1) << "x realtime" << std::endl;
+    }
+    else {
+      num_failed++;
+      std::cerr << job.output.getFileName() << ": " << job.result.error << std::endl;
+    }
+  }
+
+  std::cout << jobs.size() - num_failed << " files, " << String(total_audio_seconds, 2) << "s audio in "
+            << String(total_seconds, 2) << "s on " << num_threads << " threads, "
+            << String(total_audio_seconds / std::max(total_seconds, 0.001), 1) << "x realtime" << std::endl;
+
+  return num_failed ? 1 : 0;
+}
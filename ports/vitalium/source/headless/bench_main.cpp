@@ -0,0 +1,396 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "JuceHeader.h"
+#include "synth_base.h"
+#include "sound_engine.h"
+#include "synth_oscillator.h"
+#include "synth_parameters.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+namespace {
+  const std::string kUsage =
+      "Usage: vitalium-bench <benchmark> [options]\n"
+      "\n"
+      "Benchmarks:\n"
+      "  arena                  Voice processing with and without the voice output arena\n"
+      "  automation             Dense host automation by parameter index and by name\n"
+      "  morph                  A chord sharing spectral morph settings, with and without\n"
+      "                         the morph cache. The init preset gets a harmonic stretch on\n"
+      "                         the first oscillator\n"
+      "\n"
+      "Options:\n"
+      "  --preset <file>        Preset to load (default: init preset)\n"
+      "  --notes <n>            Notes held at once (default 8)\n"
+      "  --parameters <n>       Automated parameters, each moved every block (default 50)\n"
+      "  --seconds <seconds>    Processed time per run (default 10)\n"
+      "  --runs <n>             Runs of each variant, the fastest counts (default 3)\n";
+
+  constexpr int kSampleRate = 44100;
+  constexpr int kBlockSize = 64;
+
+  struct Options {
+    File preset;
+    int num_notes = 8;
+    int num_parameters = 50;
+    double seconds = 10.0;
+    int runs = 3;
+  };
+
+  double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  class BenchSynth : public HeadlessSynth {
+    public:
+      bool prepare(const Options& options) {
+        if (options.preset != File()) {
+          try {
+            json state = json::parse(options.preset.loadFileAsString().toStdString(), nullptr);
+            if (!loadFromJson(state))
+              return false;
+          }
+          catch (const json::exception& e) {
+            return false;
+          }
+          processModulationChanges();
+        }
+
+        engine_->setSampleRate(kSampleRate);
+        engine_->updateAllModulationSwitches();
+        return true;
+      }
+
+      // Plays a chord for the whole run, returns the seconds spent in the engine.
+      double playChord(int num_notes, int num_samples, std::vector<float>* output) {
+        startChord(num_notes);
+
+        double total = 0.0;
+        for (int samples = 0; samples < num_samples; samples += kBlockSize) {
+          auto start = std::chrono::steady_clock::now();
+          engine_->process(kBlockSize);
+          total += secondsSince(start);
+
+          if (output) {
+            const vital::poly_float* buffer = engine_->output()->buffer;
+            for (int i = 0; i < kBlockSize; ++i) {
+              output->push_back(buffer[i][0]);
+              output->push_back(buffer[i][1]);
+            }
+          }
+        }
+
+        engine_->allSoundsOff();
+        return total;
+      }
+
+      // Registers the first continuous parameters the same way the plugin exposes them to the
+      // host, so parameter i has external control index i.
+      std::vector<const vital::ValueDetails*> addAutomatedParameters(int num_parameters) {
+        std::vector<const vital::ValueDetails*> parameters;
+        int total = vital::Parameters::getNumParameters();
+        for (int i = 0; i < total && static_cast<int>(parameters.size()) < num_parameters; ++i) {
+          const vital::ValueDetails* details = vital::Parameters::getDetails(i);
+          if (controls_.count(details->name) == 0 || details->value_scale == vital::ValueDetails::kIndexed)
+            continue;
+
+          addExternalControl(details->name);
+          parameters.push_back(details);
+        }
+        return parameters;
+      }
+
+      // Plays a chord while every parameter is moved before every block. Returns the seconds
+      // spent in the automation calls, and in the calls plus the engine in total_seconds.
+      double playAutomated(const std::vector<const vital::ValueDetails*>& parameters, bool by_index,
+                           int num_notes, int num_samples, double& total_seconds) {
+        static constexpr int kSweepBlocks = 128;
+
+        startChord(num_notes);
+
+        int num_parameters = static_cast<int>(parameters.size());
+        std::vector<vital::mono_float> values(num_parameters);
+        double automation = 0.0;
+        total_seconds = 0.0;
+        for (int block = 0; block * kBlockSize < num_samples; ++block) {
+          for (int i = 0; i < num_parameters; ++i) {
+            float sweep = ((block + 7 * i) % kSweepBlocks) / (kSweepBlocks - 1.0f);
+            values[i] = parameters[i]->min + sweep * (parameters[i]->max - parameters[i]->min);
+          }
+
+          auto start = std::chrono::steady_clock::now();
+          for (int i = 0; i < num_parameters; ++i) {
+            if (by_index)
+              valueChangedExternal(i, values[i]);
+            else {
+              // The host callback used to get its own copy of the name.
+              std::string name = parameters[i]->name;
+              valueChangedExternal(name, values[i]);
+            }
+          }
+          double automation_seconds = secondsSince(start);
+          engine_->process(kBlockSize);
+
+          automation += automation_seconds;
+          total_seconds += secondsSince(start);
+        }
+
+        engine_->allSoundsOff();
+        return automation;
+      }
+
+      // The init preset has no spectral morph, so give the first oscillator one.
+      void addSpectralMorph() {
+        controls_["osc_1_spectral_morph_type"]->set(vital::SynthOscillator::kHarmonicScale);
+        controls_["osc_1_spectral_morph_amount"]->set(0.5f);
+      }
+
+      void setSpectralMorphCaching(bool enabled) {
+        for (int i = 0; i < vital::kNumOscillators; ++i)
+          engine_->getSpectralMorphCache(i)->setEnabled(enabled);
+      }
+
+      std::string getSpectralMorphHitRates() {
+        std::string hit_rates;
+        for (int i = 0; i < vital::kNumOscillators; ++i) {
+          vital::SpectralMorphCache* cache = engine_->getSpectralMorphCache(i);
+          hit_rates += (i ? ", osc " : "osc ") + std::to_string(i + 1) + " ";
+          hit_rates += String(cache->getHitRate() * 100.0f, 1).toStdString() + "%";
+          cache->resetStats();
+        }
+        return hit_rates;
+      }
+
+    private:
+      void startChord(int num_notes) {
+        static constexpr int kLowestNote = 48;
+        static constexpr int kNoteSpacing = 4;
+
+        engine_->allSoundsOff();
+        for (int i = 0; i < num_notes; ++i)
+          engine_->noteOn(kLowestNote + i * kNoteSpacing, 0.8f, 0, 0);
+      }
+  };
+
+  std::string kilobytes(size_t bytes) {
+    return String(bytes / 1024.0, 1).toStdString() + " KiB";
+  }
+
+  // Renders the chord with a fresh engine so both variants start from the same state.
+  template<typename Setup>
+  bool renderChord(const Options& options, Setup setup, std::vector<float>& output) {
+    vital::utils::RandomGenerator::next_seed_ = 0;
+    BenchSynth synth;
+    if (!synth.prepare(options))
+      return false;
+
+    setup(synth);
+    synth.playChord(options.num_notes, options.seconds * kSampleRate, &output);
+    return true;
+  }
+
+  float maxDifference(const std::vector<float>& a, const std::vector<float>& b) {
+    float max_difference = 0.0f;
+    for (size_t i = 0; i < std::min(a.size(), b.size()); ++i)
+      max_difference = std::max(max_difference, std::abs(a[i] - b[i]));
+    return max_difference;
+  }
+
+  int runArena(const Options& options) {
+    BenchSynth synth;
+    if (!synth.prepare(options)) {
+      std::cerr << "Couldn't load preset " << options.preset.getFullPathName() << std::endl;
+      return 1;
+    }
+
+    vital::SoundEngine* engine = synth.getEngine();
+    int num_samples = options.seconds * kSampleRate;
+
+    auto plan_start = std::chrono::steady_clock::now();
+    engine->updateVoiceOutputArena();
+    double plan_seconds = secondsSince(plan_start);
+    vital::ProcessorRouter::OutputMemoryStats stats = engine->getVoiceOutputMemoryStats();
+
+    std::cout << "Voice graph: " << stats.num_outputs << " audio rate outputs, " << kilobytes(stats.output_bytes)
+              << " of buffers, " << kilobytes(stats.pooled_output_bytes) << " with the arena ("
+              << stats.num_shared_slots << " shared slots)" << std::endl;
+    std::cout << "Arena planned and applied in " << String(plan_seconds * 1000.0, 2) << " ms" << std::endl;
+
+    std::vector<float> pooled_output, owned_output;
+    renderChord(options, [](BenchSynth& synth) { synth.getEngine()->updateVoiceOutputArena(); }, pooled_output);
+    renderChord(options, [](BenchSynth& synth) { }, owned_output);
+    float max_difference = maxDifference(pooled_output, owned_output);
+
+    double best_pooled = std::numeric_limits<double>::max();
+    double best_owned = std::numeric_limits<double>::max();
+    for (int run = 0; run < options.runs; ++run) {
+      engine->releaseVoiceOutputArena();
+      best_owned = std::min(best_owned, synth.playChord(options.num_notes, num_samples, nullptr));
+      engine->updateVoiceOutputArena();
+      best_pooled = std::min(best_pooled, synth.playChord(options.num_notes, num_samples, nullptr));
+    }
+
+    double num_blocks = num_samples / kBlockSize;
+    std::cout << options.num_notes << " notes, " << String(options.seconds, 1) << "s per run" << std::endl;
+    std::cout << "  own buffers: " << String(best_owned * 1e6 / num_blocks, 2) << " us per block, "
+              << String(options.seconds / best_owned, 1) << "x realtime" << std::endl;
+    std::cout << "  arena:       " << String(best_pooled * 1e6 / num_blocks, 2) << " us per block, "
+              << String(options.seconds / best_pooled, 1) << "x realtime" << std::endl;
+    std::cout << "  max output difference: " << max_difference << std::endl;
+    return 0;
+  }
+
+  int runMorph(const Options& options) {
+    bool add_morph = options.preset == File();
+    BenchSynth synth;
+    if (!synth.prepare(options)) {
+      std::cerr << "Couldn't load preset " << options.preset.getFullPathName() << std::endl;
+      return 1;
+    }
+    if (add_morph)
+      synth.addSpectralMorph();
+
+    auto setup = [add_morph](bool caching) {
+      return [add_morph, caching](BenchSynth& synth) {
+        if (add_morph)
+          synth.addSpectralMorph();
+        synth.setSpectralMorphCaching(caching);
+      };
+    };
+
+    std::vector<float> cached_output, uncached_output;
+    renderChord(options, setup(true), cached_output);
+    renderChord(options, setup(false), uncached_output);
+    float max_difference = maxDifference(cached_output, uncached_output);
+
+    int num_samples = options.seconds * kSampleRate;
+    double best_cached = std::numeric_limits<double>::max();
+    double best_uncached = std::numeric_limits<double>::max();
+    std::string hit_rates;
+    for (int run = 0; run < options.runs; ++run) {
+      synth.setSpectralMorphCaching(false);
+      best_uncached = std::min(best_uncached, synth.playChord(options.num_notes, num_samples, nullptr));
+      synth.setSpectralMorphCaching(true);
+      best_cached = std::min(best_cached, synth.playChord(options.num_notes, num_samples, nullptr));
+      hit_rates = synth.getSpectralMorphHitRates();
+    }
+
+    double num_blocks = num_samples / kBlockSize;
+    std::cout << options.num_notes << " notes, " << String(options.seconds, 1) << "s per run" << std::endl;
+    std::cout << "  uncached: " << String(best_uncached * 1e6 / num_blocks, 2) << " us per block, "
+              << String(options.seconds / best_uncached, 1) << "x realtime" << std::endl;
+    std::cout << "  cached:   " << String(best_cached * 1e6 / num_blocks, 2) << " us per block, "
+              << String(options.seconds / best_cached, 1) << "x realtime" << std::endl;
+    std::cout << "  cache hit rate: " << hit_rates << std::endl;
+    std::cout << "  max output difference: " << max_difference << std::endl;
+    return 0;
+  }
+
+  int runAutomation(const Options& options) {
+    BenchSynth synth;
+    if (!synth.prepare(options)) {
+      std::cerr << "Couldn't load preset " << options.preset.getFullPathName() << std::endl;
+      return 1;
+    }
+
+    std::vector<const vital::ValueDetails*> parameters = synth.addAutomatedParameters(options.num_parameters);
+    int num_samples = options.seconds * kSampleRate;
+
+    // The name path posts a message per change. Nothing dispatches them here, so they pile up
+    // for the whole run, which is what a busy message thread looks like to the audio thread.
+    double best_index = std::numeric_limits<double>::max();
+    double best_name = std::numeric_limits<double>::max();
+    double best_index_total = std::numeric_limits<double>::max();
+    double best_name_total = std::numeric_limits<double>::max();
+    for (int run = 0; run < options.runs; ++run) {
+      double total = 0.0;
+      best_name = std::min(best_name, synth.playAutomated(parameters, false, options.num_notes, num_samples, total));
+      best_name_total = std::min(best_name_total, total);
+      best_index = std::min(best_index, synth.playAutomated(parameters, true, options.num_notes, num_samples, total));
+      best_index_total = std::min(best_index_total, total);
+    }
+
+    double num_blocks = num_samples / kBlockSize;
+    double num_events = num_blocks * parameters.size();
+    std::cout << parameters.size() << " parameters moved every " << kBlockSize << " samples, "
+              << options.num_notes << " notes, " << String(options.seconds, 1) << "s per run" << std::endl;
+    std::cout << "  by name:  " << String(best_name * 1e9 / num_events, 1) << " ns per change, "
+              << String(best_name_total * 1e6 / num_blocks, 2) << " us per block, "
+              << String(options.seconds / best_name_total, 1) << "x realtime" << std::endl;
+    std::cout << "  by index: " << String(best_index * 1e9 / num_events, 1) << " ns per change, "
+              << String(best_index_total * 1e6 / num_blocks, 2) << " us per block, "
+              << String(options.seconds / best_index_total, 1) << "x realtime" << std::endl;
+    return 0;
+  }
+} // namespace
+
+int main(int argc, char** argv) {
+  ScopedJuceInitialiser_GUI juce_initialiser;
+
+  if (argc < 2) {
+    std::cerr << kUsage;
+    return 1;
+  }
+
+  String benchmark = argv[1];
+  if (benchmark == "--help" || benchmark == "-h") {
+    std::cout << kUsage;
+    return 0;
+  }
+
+  Options options;
+  for (int i = 2; i < argc; ++i) {
+    String arg = argv[i];
+    if (i + 1 >= argc) {
+      std::cerr << "Missing value for " << arg << std::endl << kUsage;
+      return 1;
+    }
+
+    String value = argv[++i];
+    if (arg == "--preset")
+      options.preset = File::getCurrentWorkingDirectory().getChildFile(value);
+    else if (arg == "--notes")
+      options.num_notes = value.getIntValue();
+    else if (arg == "--parameters")
+      options.num_parameters = value.getIntValue();
+    else if (arg == "--seconds")
+      options.seconds = value.getDoubleValue();
+    else if (arg == "--runs")
+      options.runs = value.getIntValue();
+    else {
+      std::cerr << "Unknown option " << arg << std::endl << kUsage;
+      return 1;
+    }
+  }
+
+  if (options.num_notes <= 0 || options.num_parameters <= 0 || options.seconds <= 0.0 || options.runs <= 0) {
+    std::cerr << "Invalid number of notes, parameters, seconds or runs" << std::endl;
+    return 1;
+  }
+
+  if (benchmark == "arena")
+    return runArena(options);
+  if (benchmark == "automation")
+    return runAutomation(options);
+  if (benchmark == "morph")
+    return runMorph(options);
+
+  std::cerr << "Unknown benchmark " << benchmark << std::endl << kUsage;
+  return 1;
+}
@@ -0,0 +1,126 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "offline_renderer.h"
+
+#include "sound_engine.h"
+#include "synth_constants.h"
+
+bool OfflineRenderer::loadPreset(const json& state, std::string& error) {
+  // Loading creates wavetable sources and samples that take their seed from the shared
+  // utils::RandomGenerator::next_seed_ counter, so only one renderer loads at a time.
+  static CriticalSection load_lock;
+  ScopedLock lock(load_lock);
+
+  try {
+    if (!loadFromJson(state)) {
+      error = "Preset was created with a newer version.";
+      return false;
+    }
+  }
+  catch (const json::exception& e) {
+    error = "Preset file is corrupted.";
+    return false;
+  }
+
+  processModulationChanges();
+  return true;
+}
+
+OfflineRenderer::Result OfflineRenderer::render(const MidiMessageSequence& sequence,
+                                                const Settings& settings, const File& output) {
+  static constexpr int kNumChannels = 2;
+
+  Result result;
+  double start_time = Time::getMillisecondCounterHiRes();
+
+  output.deleteFile();
+  std::unique_ptr<FileOutputStream> file_stream = output.createOutputStream();
+  if (file_stream == nullptr) {
+    result.error = "Couldn't open " + output.getFullPathName().toStdString();
+    return result;
+  }
+
+  WavAudioFormat wav_format;
+  std::unique_ptr<AudioFormatWriter> writer(wav_format.createWriterFor(file_stream.get(), settings.sample_rate,
+                                                                       kNumChannels, settings.bit_depth, {}, 0));
+  if (writer == nullptr) {
+    result.error = "Unsupported wav format";
+    return result;
+  }
+  file_stream.release();
+
+  ScopedLock lock(getCriticalSection());
+
+  engine_->allSoundsOff();
+  engine_->setSampleRate(settings.sample_rate);
+  engine_->setBpm(settings.bpm);
+  engine_->updateAllModulationSwitches();
+  prepareOutputArena();
+
+  int block_size = std::max(1, settings.block_size);
+  int total_samples = (sequence.getEndTime() + settings.tail_seconds) * settings.sample_rate;
+  int pre_roll_samples = std::max(0.0f, settings.pre_roll_seconds) * settings.sample_rate;
+  int num_events = sequence.getNumEvents();
+  int event_index = 0;
+  double sample_time = 1.0 / settings.sample_rate;
+  double current_time = -pre_roll_samples * sample_time;
+
+  AudioSampleBuffer buffer(kNumChannels, block_size);
+  MidiBuffer midi_messages;
+
+  // Lets smoothed values and effects settle on the preset before anything is written.
+  for (int samples = 0; samples < pre_roll_samples; samples += block_size)
+    processBlock(buffer, midi_messages, std::min(block_size, pre_roll_samples - samples), current_time, sample_time);
+
+  for (int samples = 0; samples < total_samples; samples += block_size) {
+    int num_samples = std::min(block_size, total_samples - samples);
+
+    midi_messages.clear();
+    for (; event_index < num_events; ++event_index) {
+      const MidiMessage& message = sequence.getEventPointer(event_index)->message;
+      int sample = std::max(0, roundToInt(message.getTimeStamp() * settings.sample_rate) - samples);
+      if (sample >= num_samples)
+        break;
+
+      midi_messages.addEvent(message, sample);
+    }
+
+    processBlock(buffer, midi_messages, num_samples, current_time, sample_time);
+    writer->writeFromAudioSampleBuffer(buffer, 0, num_samples);
+  }
+
+  writer = nullptr;
+  result.success = true;
+  result.audio_seconds = total_samples * sample_time;
+  result.render_seconds = (Time::getMillisecondCounterHiRes() - start_time) * 0.001;
+  return result;
+}
+
+void OfflineRenderer::processBlock(AudioSampleBuffer& buffer, MidiBuffer& midi_messages, int num_samples,
+                                   double& current_time, double sample_time) {
+  // The engine can't process more than kMaxBufferSize samples at once.
+  for (int offset = 0; offset < num_samples;) {
+    int process_samples = std::min(num_samples - offset, vital::kMaxBufferSize);
+
+    engine_->correctToTime(current_time);
+    processMidi(midi_messages, offset, offset + process_samples);
+    processAudio(&buffer, buffer.getNumChannels(), process_samples, offset);
+
+    current_time += process_samples * sample_time;
+    offset += process_samples;
+  }
+}
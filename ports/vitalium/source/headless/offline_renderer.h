@@ -0,0 +1,57 @@
+/* Copyright 2013-2019 Matt Tytel
+ *
+ * vital is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * vital is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with vital.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "JuceHeader.h"
+#include "synth_base.h"
+
+// Renders MIDI sequences through its own SoundEngine without any GUI or audio device.
+// Each instance renders independently, so one per thread can render in parallel. Loading presets
+// is serialized between instances and every instance builds its own wavetable data.
+class OfflineRenderer : public HeadlessSynth {
+  public:
+    struct Settings {
+      double sample_rate = 44100.0;
+      int bit_depth = 24;
+      int block_size = 64;
+      float bpm = 120.0f;
+      float tail_seconds = 2.0f;
+      float pre_roll_seconds = 0.1f;
+    };
+
+    struct Result {
+      bool success = false;
+      std::string error;
+      double audio_seconds = 0.0;
+      double render_seconds = 0.0;
+
+      double realtimeFactor() const {
+        return render_seconds > 0.0 ? audio_seconds / render_seconds : 0.0;
+      }
+    };
+
+    OfflineRenderer() { }
+
+    bool loadPreset(const json& state, std::string& error);
+    Result render(const MidiMessageSequence& sequence, const Settings& settings, const File& output);
+
+  private:
+    void processBlock(AudioSampleBuffer& buffer, MidiBuffer& midi_messages, int num_samples,
+                      double& current_time, double sample_time);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OfflineRenderer)
+};
@@ -53,7 +53,7 @@ namespace {
 }
 
 PresetList::PresetList() : SynthSection("Preset List"),
-    num_view_presets_(0), hover_preset_(-1), click_preset_(-1), cache_position_(0),
+    num_view_presets_(0), preset_source_(kFolderPresets), hover_preset_(-1), click_preset_(-1), cache_position_(0),
     highlight_(Shaders::kColorFragment), hover_(Shaders::kColorFragment),
     view_position_(0), sort_column_(kName), sort_ascending_(true) {
   addAndMakeVisible(browse_area_);
@@ -171,6 +171,7 @@ void PresetList::sort() {
 
 void PresetList::setPresets(Array<File> presets) {
   presets_ = presets;
+  preset_source_ = kGivenPresets;
   sort();
   redoCache();
 }
@@ -348,18 +349,38 @@ void PresetList::finishRename() {
 
   File parent = renaming_preset_.getParentDirectory();
   File new_file = parent.getChildFile(text + renaming_preset_.getFileExtension());
-  renaming_preset_.moveFileTo(new_file);
+  if (renaming_preset_.moveFileTo(new_file) && preset_source_ == kGivenPresets) {
+    int index = presets_.indexOf(renaming_preset_);
+    if (index >= 0)
+      presets_.set(index, new_file);
+  }
   renaming_preset_ = File();
 
   reloadPresets();
 }
 
 void PresetList::reloadPresets() {
-  presets_.clear();
-  if (current_folder_.exists() && current_folder_.isDirectory())
-    current_folder_.findChildFiles(presets_, File::findFiles, true, "*." + vital::kPresetExtension);
-  else
-    LoadSave::getAllPresets(presets_);
+  preset_info_cache_.clear();
+
+  if (preset_source_ == kFavoritePresets) {
+    Array<File> all_presets;
+    preset_index_->getAllPresets(all_presets);
+
+    presets_.clear();
+    std::set<std::string> favorite_lookup = LoadSave::getFavorites();
+    for (const File& file : all_presets) {
+      if (favorite_lookup.count(file.getFullPathName().toStdString()))
+        presets_.add(file);
+    }
+  }
+  else if (preset_source_ == kFolderPresets) {
+    presets_.clear();
+    if (current_folder_.exists() && current_folder_.isDirectory())
+      preset_index_->getPresetsInFolder(current_folder_, presets_);
+    else
+      preset_index_->getAllPresets(presets_);
+  }
+
   sort();
   redoCache();
 }
@@ -654,16 +675,17 @@ PresetBrowser::PresetBrowser() : SynthSection("preset_browser") {
   comments_->setMultiLine(true, true);
 #endif
 
-  Array<File> presets;
-  LoadSave::getAllPresets(presets);
-  preset_list_->setPresets(presets);
+  preset_list_->showAllPresets();
+  preset_index_->addListener(this);
 
   setWantsKeyboardFocus(true);
   setMouseClickGrabsKeyboardFocus(true);
   setSkinOverride(Skin::kPresetBrowser);
 }
 
-PresetBrowser::~PresetBrowser() { }
+PresetBrowser::~PresetBrowser() {
+  preset_index_->removeListener(this);
+}
 
 void PresetBrowser::paintBackground(Graphics& g) {
   Rectangle<int> search_rect = getSearchRect();
@@ -803,6 +825,7 @@ void PresetBrowser::visibilityChanged() {
     search_box_->setText("");
 
   if (isVisible()) {
+    preset_index_->requestUpdate();
     preset_list_->redoCache();
     folder_list_->redoCache();
     more_author_presets_.clear();
@@ -849,6 +872,7 @@ Rectangle<int> PresetBrowser::getInfoRect() {
 }
 
 void PresetBrowser::loadPresets() {
+  preset_index_->requestUpdate();
   if (search_box_)
     search_box_->setText("");
   preset_list_->reloadPresets();
@@ -861,6 +885,12 @@ void PresetBrowser::loadPresets() {
   folder_list_->setSelections(selections);
 }
 
+void PresetBrowser::presetIndexUpdated() {
+  // stays in the folder or favorites view the user picked, a given list is only sorted again
+  preset_list_->reloadPresets();
+  filterPresets();
+}
+
 void PresetBrowser::filterPresets() {
   std::set<std::string> styles;
   for (int i = 0; i < LoadSave::kNumPresetStyles; ++i) {
@@ -1024,7 +1054,12 @@ void PresetBrowser::loadPresetInfo() {
 }
 
 void PresetBrowser::setPresetInfo(File& preset) {
-  if (preset.exists()) {
+  PresetIndex::Entry entry;
+  if (preset_index_->getEntry(preset, entry)) {
+    author_ = entry.author;
+    license_ = entry.license;
+  }
+  else if (preset.exists()) {
     try {
       json parsed_json_state = json::parse(preset.loadFileAsString().toStdString(), nullptr, false);
       author_ = LoadSave::getAuthorFromFile(preset);
@@ -1055,21 +1090,9 @@ void PresetBrowser::newSelection(File selection) {
 }
 
 void PresetBrowser::allSelected() {
-  Array<File> presets;
-  LoadSave::getAllPresets(presets);
-  preset_list_->setPresets(presets);
+  preset_list_->showAllPresets();
 }
 
 void PresetBrowser::favoritesSelected() {
-  Array<File> presets;
-  LoadSave::getAllPresets(presets);
-
-  Array<File> favorites;
-  std::set<std::string> favorite_lookup = LoadSave::getFavorites();
-
-  for (const File& file : presets) {
-    if (favorite_lookup.count(file.getFullPathName().toStdString()))
-      favorites.add(file);
-  }
-  preset_list_->setPresets(favorites);
+  preset_list_->showFavorites();
 }
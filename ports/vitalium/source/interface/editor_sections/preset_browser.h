@@ -25,12 +25,17 @@
 #include "open_gl_multi_quad.h"
 #include "overlay.h"
 #include "popup_browser.h"
+#include "preset_index.h"
 #include "save_section.h"
 #include "synth_section.h"
 
 class PresetInfoCache {
   public:
     std::string getAuthor(const File& preset) {
+      PresetIndex::Entry entry;
+      if (preset_index_->getEntry(preset, entry))
+        return entry.author;
+
       std::string path = preset.getFullPathName().toStdString();
       if (author_cache_.count(path) == 0)
         author_cache_[path] = LoadSave::getAuthorFromFile(preset).toStdString();
@@ -39,6 +44,10 @@ class PresetInfoCache {
     }
 
     std::string getStyle(const File& preset) {
+      PresetIndex::Entry entry;
+      if (preset_index_->getEntry(preset, entry))
+        return String(entry.style).toLowerCase().toStdString();
+
       std::string path = preset.getFullPathName().toStdString();
       if (style_cache_.count(path) == 0)
         style_cache_[path] = LoadSave::getStyleFromFile(preset).toLowerCase().toStdString();
@@ -46,7 +55,13 @@ class PresetInfoCache {
       return style_cache_[path];
     }
 
+    void clear() {
+      author_cache_.clear();
+      style_cache_.clear();
+    }
+
   private:
+    SharedResourcePointer<PresetIndex> preset_index_;
     std::map<std::string, std::string> author_cache_;
     std::map<std::string, std::string> style_cache_;
 };
@@ -71,6 +86,13 @@ class PresetList : public SynthSection, public TextEditor::Listener, ScrollBar::
       kNumColumns
     };
 
+    // where the listed presets come from, reloadPresets() refreshes them from there
+    enum PresetSource {
+      kFolderPresets,
+      kFavoritePresets,
+      kGivenPresets
+    };
+
     enum MenuOptions {
       kCancel,
       kOpenFileLocation,
@@ -257,6 +279,14 @@ class PresetList : public SynthSection, public TextEditor::Listener, ScrollBar::
     }
     void setCurrentFolder(const File& folder) {
       current_folder_ = folder;
+      preset_source_ = kFolderPresets;
+      reloadPresets();
+    }
+    void showAllPresets() {
+      setCurrentFolder(File());
+    }
+    void showFavorites() {
+      preset_source_ = kFavoritePresets;
       reloadPresets();
     }
 
@@ -282,10 +312,12 @@ class PresetList : public SynthSection, public TextEditor::Listener, ScrollBar::
     File selected_preset_;
     File renaming_preset_;
     File current_folder_;
+    PresetSource preset_source_;
     int hover_preset_;
     int click_preset_;
 
     PresetInfoCache preset_info_cache_;
+    SharedResourcePointer<PresetIndex> preset_index_;
 
     Component browse_area_;
     int cache_position_;
@@ -303,7 +335,8 @@ class PresetBrowser : public SynthSection,
                       public KeyListener,
                       public SaveSection::Listener,
                       public DeleteSection::Listener,
-                      public SelectionList::Listener {
+                      public SelectionList::Listener,
+                      public PresetIndex::Listener {
   public:
     static constexpr int kLeftPadding = 24;
     static constexpr int kTopPadding = 24;
@@ -378,6 +411,8 @@ class PresetBrowser : public SynthSection,
     void favoritesSelected() override;
     void doubleClickedSelected(File selection) override { }
 
+    void presetIndexUpdated() override;
+
   private:
     bool loadFromFile(File& preset);
     void loadPresetInfo();
@@ -401,6 +436,7 @@ class PresetBrowser : public SynthSection,
     String author_;
     String license_;
     std::set<std::string> more_author_presets_;
+    SharedResourcePointer<PresetIndex> preset_index_;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetBrowser)
 };
@@ -28,7 +28,8 @@ SynthPlugin::SynthPlugin() {
     if (controls_.count(details->name) == 0)
       continue;
 
-    ValueBridge* bridge = new ValueBridge(details->name, controls_[details->name]);
+    int index = addExternalControl(details->name);
+    ValueBridge* bridge = new ValueBridge(details->name, controls_[details->name], index);
     bridge->setListener(this);
     bridge_lookup_[details->name] = bridge;
     addParameter(bridge);
@@ -129,6 +130,14 @@ const String SynthPlugin::getProgramName(int index) {
 void SynthPlugin::prepareToPlay(double sample_rate, int buffer_size) {
   engine_->setSampleRate(sample_rate);
   engine_->updateAllModulationSwitches();
+  prepareOutputArena();
+
+#if JUCE_DEBUG
+  vital::ProcessorRouter::OutputMemoryStats stats = engine_->getVoiceOutputMemoryStats();
+  DBG("Voice outputs: " + String(stats.num_outputs) + ", " + String((int)stats.output_bytes) +
+      " bytes per voice, " + String((int)stats.pooled_output_bytes) + " bytes with " +
+      String(stats.num_shared_slots) + " shared slots");
+#endif
 }
 
 void SynthPlugin::releaseResources() {
@@ -181,8 +190,8 @@ AudioProcessorEditor* SynthPlugin::createEditor() {
   return new SynthEditor(*this);
 }
 
-void SynthPlugin::parameterChanged(std::string name, vital::mono_float value) {
-  valueChangedExternal(name, value);
+void SynthPlugin::parameterChanged(int index, vital::mono_float value) {
+  valueChangedExternal(index, value);
 }
 
 void SynthPlugin::getStateInformation(MemoryBlock& dest_data) {
@@ -206,6 +215,8 @@ void SynthPlugin::setStateInformation(const void* data, int size_in_bytes) {
 
     if (json_data.count("tuning"))
       getTuning()->jsonToState(json_data["tuning"]);
+
+    prepareOutputArena();
   }
   catch (const json::exception& e) {
     std::string error = "There was an error open the preset. Preset file is corrupted.";
@@ -67,7 +67,7 @@ class SynthPlugin : public SynthBase, public AudioProcessor, public ValueBridge:
     void setStateInformation(const void* data, int size_in_bytes) override;
     AudioProcessorParameter* getBypassParameter() const override { return bypass_parameter_; }
 
-    void parameterChanged(std::string name, vital::mono_float value) override;
+    void parameterChanged(int index, vital::mono_float value) override;
 
   private:
     ValueBridge* bypass_parameter_;
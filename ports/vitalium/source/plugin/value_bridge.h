@@ -25,13 +25,13 @@ class ValueBridge : public AudioProcessorParameter {
     class Listener {
       public:
         virtual ~Listener() { }
-        virtual void parameterChanged(std::string name, vital::mono_float value) = 0;
+        virtual void parameterChanged(int index, vital::mono_float value) = 0;
     };
 
     ValueBridge() = delete;
 
-    ValueBridge(std::string name, vital::Value* value) :
-        AudioProcessorParameter(), name_(name), value_(value), listener_(nullptr),
+    ValueBridge(std::string name, vital::Value* value, int index) :
+        AudioProcessorParameter(), name_(name), value_(value), index_(index), listener_(nullptr),
         source_changed_(false) {
       details_ = vital::Parameters::getDetails(name);
       span_ = details_.max - details_.min;
@@ -47,7 +47,7 @@ class ValueBridge : public AudioProcessorParameter {
       if (listener_ && !source_changed_) {
         source_changed_ = true;
         vital::mono_float synth_value = convertToEngineValue(value);
-        listener_->parameterChanged(name_.toStdString(), synth_value);
+        listener_->parameterChanged(index_, synth_value);
         source_changed_ = false;
       }
     }
@@ -172,6 +172,7 @@ class ValueBridge : public AudioProcessorParameter {
     vital::ValueDetails details_;
     vital::mono_float span_;
     vital::Value* value_;
+    int index_;
     Listener* listener_;
     bool source_changed_;
 
@@ -205,6 +205,13 @@ namespace vital {
     band_high_compressor_.setSampleRate(sample_rate);
   }
 
+  mono_float MultibandCompressor::getTailTime(mono_float threshold) const {
+    // The envelopes follow the mean square and release exponentially, the low band is the slowest.
+    mono_float release_exponent = utils::clamp(input(kRelease)->at(0)[0], 0.0f, 1.0f) * 8.0f - 4.0f;
+    mono_float release_time = expf(release_exponent) * kLowReleaseMs / kMsPerSec;
+    return kRmsTime - 2.0f * release_time * logf(threshold);
+  }
+
   void MultibandCompressor::reset(poly_mask reset_mask) {
     low_band_filter_.reset(reset_mask);
     band_high_filter_.reset(reset_mask);
@@ -128,6 +128,9 @@ namespace vital {
       void setSampleRate(int sample_rate) override;
       void reset(poly_mask reset_mask) override;
 
+      // Seconds the envelopes take to release below threshold once the input stopped.
+      mono_float getTailTime(mono_float threshold) const;
+
     protected:
       void packFilterOutput(LinkwitzRileyFilter* filter, int num_samples, poly_float* dest);
       void packLowBandCompressor(int num_samples, poly_float* dest);
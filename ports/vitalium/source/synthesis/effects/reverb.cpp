@@ -368,6 +368,13 @@ namespace vital {
     setupBuffersForSampleRate(getSampleRate());
   }
 
+  mono_float Reverb::getTailTime(mono_float threshold) const {
+    // The network loses kT60Amplitude over the decay time, the pre delay comes on top.
+    mono_float decay_time = utils::clamp(input(kDecayTime)->at(0)[0], kMinDecayTime, kMaxDecayTime);
+    mono_float pre_delay = std::max(input(kDelay)->at(0)[0], 0.0f);
+    return pre_delay + decay_time * logf(threshold) / logf(kT60Amplitude);
+  }
+
   void Reverb::hardReset() {
     wet_ = 0.0f;
     dry_ = 0.0f;
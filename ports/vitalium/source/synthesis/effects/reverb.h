@@ -79,6 +79,9 @@ namespace vital {
       void setupBuffersForSampleRate(int sample_rate);
       void hardReset() override;
 
+      // Seconds the feedback network takes to fall below threshold once the input stopped.
+      mono_float getTailTime(mono_float threshold) const;
+
       force_inline poly_float readFeedback(const mono_float* const* lookups, poly_float offset) {
         poly_float write_offset = poly_float(write_index_) - offset;
         poly_float floored_offset = utils::floor(write_offset);
@@ -311,6 +311,7 @@ namespace vital {
       }
 
       void process(int num_samples) override;
+      bool usesPreviousOutput() const override { return true; }
 
     private:
       JUCE_LEAK_DETECTOR(SampleAndHoldBuffer)
@@ -32,6 +32,7 @@ namespace vital {
       VITAL_ASSERT(size > 0);
 
       owner = nullptr;
+      pooled = false;
       buffer_size = size * max_oversample;
       owned_buffer = std::make_unique<poly_float[]>(buffer_size);
       buffer = owned_buffer.get();
@@ -55,6 +56,18 @@ namespace vital {
 
     void clearBuffer() {
       utils::zeroBuffer(owned_buffer.get(), buffer_size);
+      if (pooled)
+        utils::zeroBuffer(buffer, buffer_size);
+    }
+
+    // Moves the output out of a ProcessorRouter output arena back into its own buffer.
+    void unpool() {
+      if (!pooled)
+        return;
+
+      pooled = false;
+      buffer = owned_buffer.get();
+      clearBuffer();
     }
 
     force_inline bool isControlRate() const { return buffer_size == 1; }
@@ -64,7 +77,8 @@ namespace vital {
         return;
 
       buffer_size = new_max_buffer_size;
-      bool buffer_is_original = buffer == owned_buffer.get();
+      bool buffer_is_original = buffer == owned_buffer.get() || pooled;
+      pooled = false;
       owned_buffer = std::make_unique<poly_float[]>(buffer_size);
       if (buffer_is_original)
         buffer = owned_buffer.get();
@@ -75,6 +89,8 @@ namespace vital {
     std::unique_ptr<poly_float[]> owned_buffer;
     Processor* owner;
 
+    // Set while _buffer_ points into a shared slot of a ProcessorRouter output arena.
+    bool pooled;
     int buffer_size;
     poly_mask trigger_mask;
     poly_float trigger_value;
@@ -178,6 +194,8 @@ namespace vital {
 
       virtual void enable(bool enable) {
         state_->enabled = enable;
+        if (!enable)
+          unpoolOwnedOutputs();
       }
 
       force_inline int getSampleRate() const {
@@ -194,8 +212,14 @@ namespace vital {
 
       virtual void setControlRate(bool control_rate) {
         state_->control_rate = control_rate;
+        if (control_rate)
+          unpoolOwnedOutputs();
       }
 
+      // Override this if process() skips writing its outputs or reads what it wrote last block.
+      // Outputs of such processors have to keep their contents and are never pooled.
+      virtual bool usesPreviousOutput() const { return false; }
+
       force_inline poly_mask getResetMask(int input_index) const {
         poly_float trigger_value = inputs_->at(input_index)->source->trigger_value;
         return poly_float::equal(trigger_value, kVoiceOn);
@@ -301,6 +325,11 @@ namespace vital {
 
     protected:
       Output* addOutput(int oversample = 1);
+      void unpoolOwnedOutputs() {
+        for (auto& output : owned_outputs_)
+          output->unpool();
+      }
+
       Input* addInput();
 
       std::shared_ptr<ProcessorState> state_;
@@ -24,6 +24,15 @@
 
 namespace vital {
 
+  struct ProcessorRouter::OutputArena {
+    std::unique_ptr<poly_float[]> memory;
+    std::vector<Output*> outputs;
+    std::vector<std::pair<std::shared_ptr<OutputArena>, int>> planned_generations;
+    OutputMemoryStats stats;
+    int generation = 0;
+    bool stale = true;
+  };
+
   ProcessorRouter::ProcessorRouter(int num_inputs, int num_outputs, bool control_rate) :
       Processor(num_inputs, num_outputs, control_rate),
       global_order_(new CircularQueue<Processor*>(kMaxModulationConnections)),
@@ -33,13 +42,14 @@ namespace vital {
       global_changes_(new int(0)), local_changes_(0),
       dependencies_(new CircularQueue<const Processor*>(kMaxModulationConnections)),
       dependencies_visited_(new CircularQueue<const Processor*>(kMaxModulationConnections)),
-      dependency_inputs_(new CircularQueue<const Processor*>(kMaxModulationConnections)) { }
+      dependency_inputs_(new CircularQueue<const Processor*>(kMaxModulationConnections)),
+      output_arena_(std::make_shared<OutputArena>()) { }
 
   ProcessorRouter::ProcessorRouter(const ProcessorRouter& original) :
       Processor(original), global_order_(original.global_order_), global_reorder_(original.global_reorder_),
       global_feedback_order_(original.global_feedback_order_),
       global_changes_(original.global_changes_),
-      local_changes_(original.local_changes_) {
+      local_changes_(original.local_changes_), output_arena_(original.output_arena_) {
     local_order_.reserve(global_order_->capacity());
     local_order_.assign(global_order_->size(), 0);
     local_feedback_order_.assign(global_feedback_order_->size(), nullptr);
@@ -141,6 +151,7 @@ namespace vital {
     VITAL_ASSERT(processor->router() == nullptr);
     (*global_changes_)++;
     local_changes_++;
+    graphChanged();
 
     processor->router(this);
     if (getOversampleAmount() > 1)
@@ -166,6 +177,7 @@ namespace vital {
     VITAL_ASSERT(processor->router() == this);
     (*global_changes_)++;
     local_changes_++;
+    graphChanged();
     global_order_->remove(processor);
     local_order_.remove(processor);
 
@@ -209,6 +221,7 @@ namespace vital {
   void ProcessorRouter::reorder(Processor* processor) {
     (*global_changes_)++;
     local_changes_++;
+    graphChanged();
 
     getDependencies(processor);
     if (dependencies_->size() == 0) {
@@ -288,7 +301,241 @@ namespace vital {
       feedback->reset(reset_mask);
   }
 
+  ProcessorRouter::OutputMemoryStats ProcessorRouter::applyOutputArena(const std::set<const Output*>& external_outputs) {
+    struct Lifetime {
+      Output* output;
+      int writer;
+      int start;
+      int end;
+      size_t bytes;
+      bool pinned;
+    };
+
+    struct Slot {
+      int end;
+      size_t size;
+      std::vector<Output*> outputs;
+    };
+
+    releaseOutputArena();
+
+    std::vector<OrderEntry> order;
+    std::vector<const ProcessorRouter*> routers;
+    collectProcessingOrder(order, -1, routers);
+
+    OutputMemoryStats stats;
+    std::map<const Output*, Lifetime> lifetimes;
+    int num_processors = static_cast<int>(order.size());
+    for (int i = 0; i < num_processors; ++i) {
+      const Processor* processor = order[i].processor;
+      for (int o = 0; o < processor->numOwnedOutputs(); ++o) {
+        Output* output = processor->ownedOutput(o);
+        if (output->isControlRate() || output->buffer != output->owned_buffer.get() || lifetimes.count(output))
+          continue;
+
+        size_t bytes = output->buffer_size * sizeof(poly_float);
+        bool pinned = !processor->enabled() || processor->isControlRate() || processor->usesPreviousOutput() ||
+                      external_outputs.count(output);
+        lifetimes[output] = { output, i, i, -1, bytes, pinned };
+        stats.num_outputs++;
+        stats.output_bytes += bytes;
+      }
+    }
+
+    auto pin = [&lifetimes](const Output* output) {
+      auto lifetime = lifetimes.find(output);
+      if (lifetime != lifetimes.end())
+        lifetime->second.pinned = true;
+    };
+
+    // Router outputs are read by the parent module directly, idle processors are run by hand
+    // at no fixed point of the order and Feedback nodes read their source on the next block.
+    for (const ProcessorRouter* router : routers) {
+      for (int o = 0; o < router->numOutputs(); ++o)
+        pin(router->output(o));
+
+      for (auto& idle_processor : router->idle_processors_) {
+        for (int in = 0; in < idle_processor.first->numInputs(); ++in)
+          pin(idle_processor.first->input(in)->source);
+      }
+
+      for (const Feedback* feedback : *router->global_feedback_order_)
+        pin(feedback->input()->source);
+    }
+
+    for (int i = 0; i < num_processors; ++i) {
+      const Processor* processor = order[i].processor;
+
+      // Outputs shared with useOutput() have another writer.
+      for (int o = 0; o < processor->numOutputs(); ++o) {
+        if (processor->output(o)->owner != processor)
+          pin(processor->output(o));
+      }
+
+      for (int in = 0; in < processor->numInputs(); ++in) {
+        auto lifetime = lifetimes.find(processor->input(in)->source);
+        if (lifetime == lifetimes.end() || lifetime->second.pinned)
+          continue;
+
+        // Readers have to run after the writer is done and inside the writer's enclosing router.
+        const OrderEntry& writer = order[lifetime->second.writer];
+        bool after_writer = i > writer.scope_end;
+        bool in_scope = writer.scope < 0 || (i > writer.scope && i <= order[writer.scope].scope_end);
+        if (after_writer && in_scope)
+          lifetime->second.end = std::max(lifetime->second.end, i);
+        else
+          lifetime->second.pinned = true;
+      }
+    }
+
+    std::vector<Lifetime> shareable;
+    for (auto& lifetime : lifetimes) {
+      Lifetime& current = lifetime.second;
+      if (current.pinned || current.end < 0) {
+        stats.pooled_output_bytes += current.bytes;
+        continue;
+      }
+
+      // Nested routers may run their children in any order, so an output written inside one lives
+      // for the whole router. Directly under _this_ the order is fixed and we can go by top level entries.
+      int scope = order[current.writer].scope;
+      if (scope >= 0) {
+        current.start = scope + 1;
+        current.end = order[scope].scope_end;
+      }
+      else {
+        int last_reader = current.end;
+        while (order[last_reader].scope >= 0)
+          last_reader = order[last_reader].scope;
+        current.end = order[last_reader].scope_end;
+      }
+      shareable.push_back(current);
+    }
+
+    std::sort(shareable.begin(), shareable.end(), [](const Lifetime& a, const Lifetime& b) {
+      return a.start < b.start || (a.start == b.start && a.output < b.output);
+    });
+
+    // Greedy interval coloring, a slot is free once the last output in it has been read.
+    std::vector<Slot> slots;
+    for (const Lifetime& lifetime : shareable) {
+      Slot* free_slot = nullptr;
+      for (Slot& slot : slots) {
+        if (slot.end < lifetime.start && (free_slot == nullptr || slot.size > free_slot->size))
+          free_slot = &slot;
+      }
+
+      if (free_slot == nullptr) {
+        slots.push_back({ 0, 0, {} });
+        free_slot = &slots.back();
+      }
+
+      free_slot->end = lifetime.end;
+      free_slot->size = std::max<size_t>(free_slot->size, lifetime.output->buffer_size);
+      free_slot->outputs.push_back(lifetime.output);
+    }
+
+    size_t arena_size = 0;
+    for (const Slot& slot : slots)
+      arena_size += slot.size;
+
+    OutputArena* arena = output_arena_.get();
+    arena->memory = std::make_unique<poly_float[]>(std::max<size_t>(arena_size, 1));
+    utils::zeroBuffer(arena->memory.get(), static_cast<int>(arena_size));
+
+    poly_float* slot_memory = arena->memory.get();
+    for (const Slot& slot : slots) {
+      for (Output* output : slot.outputs) {
+        output->buffer = slot_memory;
+        output->pooled = true;
+        arena->outputs.push_back(output);
+      }
+      slot_memory += slot.size;
+    }
+
+    // Changes inside the tree bump this generation, changes further up only their own.
+    arena->planned_generations.clear();
+    for (const ProcessorRouter* router = this; router; router = router->router_)
+      arena->planned_generations.push_back({ router->output_arena_, router->output_arena_->generation });
+
+    stats.num_shared_slots = static_cast<int>(slots.size());
+    stats.pooled_output_bytes += arena_size * sizeof(poly_float);
+    arena->stats = stats;
+    arena->stale = false;
+    return stats;
+  }
+
+  void ProcessorRouter::releaseOutputArena() {
+    OutputArena* arena = output_arena_.get();
+    for (Output* output : arena->outputs)
+      output->unpool();
+
+    arena->outputs.clear();
+    arena->stale = true;
+  }
+
+  void ProcessorRouter::checkOutputArena() {
+    OutputArena* arena = output_arena_.get();
+    if (arena->outputs.empty())
+      return;
+
+    for (auto& planned : arena->planned_generations) {
+      if (planned.first->generation != planned.second) {
+        releaseOutputArena();
+        return;
+      }
+    }
+  }
+
+  void ProcessorRouter::graphChanged() {
+    for (ProcessorRouter* router = this; router; router = router->router_)
+      router->output_arena_->generation++;
+  }
+
+  bool ProcessorRouter::isOutputArenaStale() const {
+    return output_arena_->stale;
+  }
+
+  ProcessorRouter::OutputMemoryStats ProcessorRouter::getOutputMemoryStats() const {
+    return output_arena_->stats;
+  }
+
+  void ProcessorRouter::collectInputSources(std::set<const Output*>& sources) const {
+    auto collect = [&sources](const Processor* processor) {
+      for (int in = 0; in < processor->numInputs(); ++in)
+        sources.insert(processor->input(in)->source);
+    };
+
+    for (const Processor* processor : *global_order_) {
+      collect(processor);
+      const ProcessorRouter* router = dynamic_cast<const ProcessorRouter*>(processor);
+      if (router)
+        router->collectInputSources(sources);
+    }
+
+    for (auto& idle_processor : idle_processors_)
+      collect(idle_processor.first);
+    for (const Feedback* feedback : *global_feedback_order_)
+      collect(feedback);
+  }
+
+  void ProcessorRouter::collectProcessingOrder(std::vector<OrderEntry>& order, int scope,
+                                               std::vector<const ProcessorRouter*>& routers) const {
+    routers.push_back(this);
+    for (const Processor* processor : *global_order_) {
+      int index = static_cast<int>(order.size());
+      order.push_back({ processor, scope, index });
+
+      const ProcessorRouter* router = dynamic_cast<const ProcessorRouter*>(processor);
+      if (router) {
+        router->collectProcessingOrder(order, index, routers);
+        order[index].scope_end = static_cast<int>(order.size()) - 1;
+      }
+    }
+  }
+
   void ProcessorRouter::addFeedback(Feedback* feedback) {
+    graphChanged();
     feedback->router(this);
     global_feedback_order_->push_back(feedback);
     local_feedback_order_.push_back(feedback);
@@ -298,6 +545,7 @@ namespace vital {
   void ProcessorRouter::removeFeedback(Feedback* feedback) {
     (*global_changes_)++;
     local_changes_++;
+    graphChanged();
 
     auto pos = std::find(global_feedback_order_->begin(), global_feedback_order_->end(), feedback);
     VITAL_ASSERT(pos != global_feedback_order_->end());
@@ -29,6 +29,13 @@ namespace vital {
 
   class ProcessorRouter : public Processor {
     public:
+      struct OutputMemoryStats {
+        int num_outputs = 0;
+        int num_shared_slots = 0;
+        size_t output_bytes = 0;
+        size_t pooled_output_bytes = 0;
+      };
+
       ProcessorRouter(int num_inputs = 0, int num_outputs = 0, bool control_rate = false);
       ProcessorRouter(const ProcessorRouter& original);
 
@@ -61,6 +68,26 @@ namespace vital {
       virtual ProcessorRouter* getPolyRouter();
       virtual void resetFeedbacks(poly_mask reset_mask);
 
+      // Rebinds the audio rate outputs that are only used inside this router's tree to slots of one
+      // shared arena. Outputs whose lifetimes over the flattened processing order don't overlap
+      // share a slot. Outputs in _external_outputs_ are read from outside the tree and stay put.
+      // Allocates, so don't call this from the audio thread.
+      OutputMemoryStats applyOutputArena(const std::set<const Output*>& external_outputs);
+
+      // Moves all pooled outputs back into their own buffers. Doesn't allocate.
+      void releaseOutputArena();
+
+      // Call once per block before processing. Releases the arena if the graph of this router or one
+      // of its parents changed since it was applied, then isOutputArenaStale() returns true.
+      // Outputs resized by setOversampleAmount() leave their slot, release the arena before that.
+      void checkOutputArena();
+
+      bool isOutputArenaStale() const;
+      OutputMemoryStats getOutputMemoryStats() const;
+
+      // Adds the sources of all inputs of the processors, idle processors and feedbacks in this tree.
+      void collectInputSources(std::set<const Output*>& sources) const;
+
     protected:
       // When we create a cycle into the ProcessorRouter graph, we must insert
       // a Feedback node and add it here.
@@ -71,6 +98,9 @@ namespace vital {
       // relation to all other Processors in _this_.
       void reorder(Processor* processor);
 
+      // Invalidates the output arenas planned for this router and its parents.
+      void graphChanged();
+
       // Ensures our local copies of all processors and feedback processors match the master order.
       virtual void updateAllProcessors();
 
@@ -87,6 +117,18 @@ namespace vital {
       const Processor* getContext(const Processor* processor) const;
       void getDependencies(const Processor* processor) const;
 
+      struct OrderEntry {
+        const Processor* processor;
+        // Index of the enclosing router's entry, -1 for _this_.
+        int scope;
+        // Last index of the router's subtree, the entry's own index for plain processors.
+        int scope_end;
+      };
+
+      // Appends global_order_ to _order_, expanding nested routers in the order they run.
+      void collectProcessingOrder(std::vector<OrderEntry>& order, int scope,
+                                  std::vector<const ProcessorRouter*>& routers) const;
+
       // Returns the processor for this voice from the globally created one.
       Processor* getLocalProcessor(const Processor* global_processor);
 
@@ -107,6 +149,9 @@ namespace vital {
       std::shared_ptr<CircularQueue<const Processor*>> dependencies_visited_;
       std::shared_ptr<CircularQueue<const Processor*>> dependency_inputs_;
 
+      struct OutputArena;
+      std::shared_ptr<OutputArena> output_arena_;
+
       JUCE_LEAK_DETECTOR(ProcessorRouter)
   };
 } // namespace vital
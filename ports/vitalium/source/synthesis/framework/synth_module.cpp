@@ -325,6 +325,20 @@ namespace vital {
     return nullptr;
   }
 
+  void SynthModule::collectDirectlyReadOutputs(std::set<const Output*>& outputs) const {
+    for (auto& mod_source : data_->mod_sources)
+      outputs.insert(mod_source.second);
+    for (auto& status_output : data_->status_outputs)
+      outputs.insert(status_output.second->source());
+    for (auto& readout : data_->mono_modulation_readout)
+      outputs.insert(readout.second);
+    for (auto& readout : data_->poly_modulation_readout)
+      outputs.insert(readout.second);
+
+    for (SynthModule* sub_module : data_->sub_modules)
+      sub_module->collectDirectlyReadOutputs(outputs);
+  }
+
   Processor* SynthModule::getModulationDestination(std::string name, bool poly) {
     Processor* poly_destination = getPolyModulationDestination(name);
 
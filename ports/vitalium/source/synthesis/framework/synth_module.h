@@ -44,6 +44,7 @@ namespace vital {
       }
 
       force_inline void clear() { value_ = kClearValue; }
+      force_inline const Output* source() const { return source_; }
       force_inline bool isClearValue(poly_float value) const { return poly_float::equal(value, kClearValue).anyMask(); }
       force_inline bool isClearValue(float value) const { return value == kClearValue; }
 
@@ -84,6 +85,10 @@ namespace vital {
 
       Output* getModulationSource(std::string name);
       const StatusOutput* getStatusOutput(std::string name) const;
+
+      // Adds the modulation sources, status sources and modulation readouts of this module and all
+      // submodules. These are read by the interface or the engine without going through an Input.
+      void collectDirectlyReadOutputs(std::set<const Output*>& outputs) const;
       Processor* getModulationDestination(std::string name, bool poly);
       Processor* getMonoModulationDestination(std::string name);
       Processor* getPolyModulationDestination(std::string name);
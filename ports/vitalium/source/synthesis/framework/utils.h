@@ -21,6 +21,7 @@
 #include <cmath>
 #include <complex>
 #include <cstdlib>
+#include <limits>
 #include <random>
 
 namespace vital {
@@ -178,6 +179,16 @@ namespace vital {
       return powf(10.0f, decibels / kDbGainConversionMult);
     }
 
+    // Time until a loop with the given feedback and period decays below threshold, infinite at unity feedback.
+    force_inline mono_float feedbackDecayTime(mono_float feedback, mono_float period, mono_float threshold) {
+      mono_float gain = fabsf(feedback);
+      if (gain >= 1.0f)
+        return std::numeric_limits<mono_float>::infinity();
+      if (gain <= threshold)
+        return period;
+      return period * (1.0f + logf(threshold) / logf(gain));
+    }
+
     force_inline mono_float centsToRatio(mono_float cents) {
       return powf(2.0f, cents / kCentsPerOctave);
     }
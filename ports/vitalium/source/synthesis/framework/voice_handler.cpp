@@ -273,6 +273,7 @@ namespace vital {
   }
 
   void VoiceHandler::process(int num_samples) {
+    voice_router_.checkOutputArena();
     global_router_.process(num_samples);
 
     int num_voices = active_voices_.size();
@@ -849,6 +850,18 @@ namespace vital {
     return output;
   }
 
+  ProcessorRouter::OutputMemoryStats VoiceHandler::applyVoiceOutputArena(std::set<const Output*> external_outputs) {
+    for (auto& accumulated : accumulated_outputs_)
+      external_outputs.insert(accumulated.first);
+    for (auto& last_voice : last_voice_outputs_)
+      external_outputs.insert(last_voice.first);
+    external_outputs.insert(voice_killer_);
+    external_outputs.insert(voice_midi_);
+    global_router_.collectInputSources(external_outputs);
+
+    return voice_router_.applyOutputArena(external_outputs);
+  }
+
   bool VoiceHandler::isPolyphonic(const Processor* processor) const {
     return processor == &voice_router_;
   }
@@ -411,6 +411,15 @@ namespace vital {
       void setActiveNonaccumulatedOutput(Output* output);
       void setInactiveNonaccumulatedOutput(Output* output);
 
+      // Pools the intermediate buffers of the voice graph, see ProcessorRouter::applyOutputArena().
+      // _external_outputs_ are the outputs read from outside the voice handler.
+      ProcessorRouter::OutputMemoryStats applyVoiceOutputArena(std::set<const Output*> external_outputs);
+      void releaseVoiceOutputArena() { voice_router_.releaseOutputArena(); }
+      bool isVoiceOutputArenaStale() const { return voice_router_.isOutputArenaStale(); }
+      ProcessorRouter::OutputMemoryStats getVoiceOutputMemoryStats() const {
+        return voice_router_.getOutputMemoryStats();
+      }
+
     protected:
       virtual bool shouldAccumulate(Output* output);
 
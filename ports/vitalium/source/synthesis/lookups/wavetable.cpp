@@ -25,7 +25,7 @@ namespace vital {
 
   Wavetable::Wavetable(int max_frames) :
       max_frames_(max_frames), current_data_(nullptr), 
-      active_audio_data_(nullptr), shepard_table_(false), fft_data_() {
+      active_audio_data_(nullptr), revision_(0), shepard_table_(false), fft_data_() {
     loadDefaultWavetable();
   }
 
@@ -83,6 +83,7 @@ namespace vital {
     }
 
     current_data_ = data_.get();
+    revision_.fetch_add(1, std::memory_order_acq_rel);
     while (active_audio_data_.load())
       std::this_thread::yield(); // Wait for audio thread to finish using old_data.
   }
@@ -106,6 +107,7 @@ namespace vital {
     loadFrequencyAmplitudes(wave_frame->frequency_domain, to_index);
     loadNormalizedFrequencies(wave_frame->frequency_domain, to_index);
     memcpy(current_data_->wave_data[to_index], wave_frame->time_domain, kWaveformSize * sizeof(mono_float));
+    revision_.fetch_add(1, std::memory_order_acq_rel);
   }
 
   void Wavetable::postProcess(float max_span) {
@@ -155,6 +157,8 @@ namespace vital {
       for (int frame = last_min_amp_frame + 1; frame < current_data_->num_frames; ++frame)
         ((std::complex<float>*)current_data_->normalized_frequencies[frame])[i] = last_normalized_frequency;
     }
+
+    revision_.fetch_add(1, std::memory_order_acq_rel);
   }
 
   void Wavetable::loadFrequencyAmplitudes(const std::complex<float>* frequencies, int to_index) {
@@ -121,6 +121,11 @@ namespace vital {
         return active_audio_data_.load()->version;
       }
 
+      // Changes whenever any frame data changes, including frames loaded in place.
+      force_inline int getRevision() const {
+        return revision_.load(std::memory_order_acquire);
+      }
+
       void loadWaveFrame(const WaveFrame* wave_frame);
       void loadWaveFrame(const WaveFrame* wave_frame, int to_index);
       void postProcess(float max_span);
@@ -148,6 +153,7 @@ namespace vital {
       WavetableData* current_data_;
       std::atomic<WavetableData*> active_audio_data_;
       std::unique_ptr<WavetableData> data_;
+      std::atomic<int> revision_;
       bool shepard_table_;
 
       mono_float fft_data_[2 * kWaveformSize];
@@ -89,6 +89,14 @@ namespace vital {
   }
 
 
+  mono_float ChorusModule::getTailTime(mono_float threshold) const {
+    poly_float delay = utils::max(delay_time_1_->buffer[0], delay_time_2_->buffer[0]);
+    mono_float mod_depth = mod_depth_->buffer[0][0] * kMaxChorusModulation;
+    mono_float period = std::max(delay[0], delay[1]) + 1.5f * mod_depth;
+    poly_float feedback = delays_[0]->input(MultiDelay::kFeedback)->at(0);
+    return utils::feedbackDecayTime(feedback[0], std::min(period, kMaxChorusDelay + kMaxChorusModulation), threshold);
+  }
+
   void ChorusModule::processWithInput(const poly_float* audio_in, int num_samples) {
     SynthModule::process(num_samples);
     poly_float frequency = frequency_->buffer[0];
@@ -38,6 +38,9 @@ namespace vital {
 
       int getNextNumVoicePairs();
 
+      // Seconds the feedback takes to fall below threshold once the input stopped.
+      mono_float getTailTime(mono_float threshold) const;
+
     protected:
       const Output* beats_per_second_;
       Value* voices_;
@@ -90,6 +90,10 @@ namespace vital {
     compressor_->setSampleRate(sample_rate);
   }
 
+  mono_float CompressorModule::getTailTime(mono_float threshold) const {
+    return compressor_->getTailTime(threshold);
+  }
+
   void CompressorModule::processWithInput(const poly_float* audio_in, int num_samples) {
     SynthModule::process(num_samples);
     compressor_->processWithInput(audio_in, num_samples);
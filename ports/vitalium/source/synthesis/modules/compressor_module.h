@@ -46,6 +46,8 @@ namespace vital {
       virtual void hardReset() override;
       virtual Processor* clone() const override { return new CompressorModule(*this); }
 
+      mono_float getTailTime(mono_float threshold) const;
+
     protected:
       MultibandCompressor* compressor_;
 
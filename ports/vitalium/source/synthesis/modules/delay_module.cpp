@@ -66,6 +66,15 @@ namespace vital {
     delay_->setMaxSamples(kMaxDelayTime * getSampleRate());
   }
   
+  mono_float DelayModule::getTailTime(mono_float threshold) const {
+    poly_float frequency = utils::min(delay_->input(StereoDelay::kFrequency)->at(0),
+                                      delay_->input(StereoDelay::kFrequencyAux)->at(0));
+    mono_float period = 1.0f / std::max(std::min(frequency[0], frequency[1]), 1.0f / kMaxDelayTime);
+    poly_float feedback = delay_->input(StereoDelay::kFeedback)->at(0);
+    mono_float max_feedback = std::max(fabsf(feedback[0]), fabsf(feedback[1]));
+    return utils::feedbackDecayTime(max_feedback, period, threshold);
+  }
+
   void DelayModule::processWithInput(const poly_float* audio_in, int num_samples) {
     SynthModule::process(num_samples);
     delay_->processWithInput(audio_in, num_samples);
@@ -42,6 +42,9 @@ namespace vital {
       virtual void setOversampleAmount(int oversample) override;
       virtual void processWithInput(const poly_float* audio_in, int num_samples) override;
       virtual Processor* clone() const override { return new DelayModule(*this); }
+
+      // Seconds the echoes take to fall below threshold once the input stopped.
+      mono_float getTailTime(mono_float threshold) const;
     
     protected:
       const Output* beats_per_second_;
@@ -152,8 +152,11 @@ namespace vital {
     band_processor->processWithInput(low_processor->output()->buffer, num_samples);
     high_processor->processWithInput(band_processor->output()->buffer, num_samples);
 
-    const poly_float* output_buffer = high_processor->output()->buffer;
+    pushAudioMemory(high_processor->output()->buffer, num_samples);
+  }
+
+  void EqualizerModule::pushAudioMemory(const poly_float* audio, int num_samples) {
     for (int i = 0; i < num_samples; ++i)
-      audio_memory_->push(output_buffer[i]);
+      audio_memory_->push(audio[i]);
   }
 } // namespace vital
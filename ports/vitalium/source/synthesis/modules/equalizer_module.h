@@ -35,6 +35,7 @@ namespace vital {
       Processor* clone() const override { return new EqualizerModule(*this); }
 
       const StereoMemory* getAudioMemory() { return audio_memory_.get(); }
+      void pushAudioMemory(const poly_float* audio, int num_samples);
 
     protected:
       Value* low_mode_;
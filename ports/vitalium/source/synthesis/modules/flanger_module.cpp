@@ -77,6 +77,13 @@ namespace vital {
     delay_->processWithInput(audio_in, num_samples);
   }
 
+  mono_float FlangerModule::getTailTime(mono_float threshold) const {
+    poly_float frequency = delay_->input(StereoDelay::kFrequency)->at(0);
+    mono_float period = 1.0f / std::max(std::min(frequency[0], frequency[1]), 1.0f);
+    poly_float feedback = delay_->input(StereoDelay::kFeedback)->at(0);
+    return utils::feedbackDecayTime(feedback[0], period, threshold);
+  }
+
   void FlangerModule::correctToTime(double seconds) {
     phase_ = utils::getCycleOffsetFromSeconds(seconds, frequency_->buffer[0]);
   }
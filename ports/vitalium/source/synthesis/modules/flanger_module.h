@@ -51,6 +51,9 @@ namespace vital {
 
       Processor* clone() const override { VITAL_ASSERT(false); return nullptr; }
 
+      // Seconds the feedback takes to fall below threshold once the input stopped.
+      mono_float getTailTime(mono_float threshold) const;
+
     protected:
       const Output* beats_per_second_;
       Output* frequency_;
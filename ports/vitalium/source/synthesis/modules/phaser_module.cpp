@@ -17,6 +17,7 @@
 #include "phaser_module.h"
 
 #include "phaser.h"
+#include "phaser_filter.h"
 
 namespace vital {
 
@@ -75,6 +76,13 @@ namespace vital {
     phaser_->setSampleRate(sample_rate);
   }
 
+  mono_float PhaserModule::getTailTime(mono_float threshold) const {
+    // The feedback goes around the allpass stages, which delay the lowest cutoff by about a period.
+    mono_float lowest_cutoff = phaser_->input(Phaser::kCenter)->at(0)[0] - fabsf(phaser_->input(Phaser::kModDepth)->at(0)[0]);
+    mono_float period = 1.0f / std::max(utils::midiNoteToFrequency(lowest_cutoff), PhaserFilter::kMinCutoff);
+    return utils::feedbackDecayTime(phaser_->input(Phaser::kFeedbackGain)->at(0)[0], period, threshold);
+  }
+
   void PhaserModule::processWithInput(const poly_float* audio_in, int num_samples) {
     SynthModule::process(num_samples);
     phaser_->processWithInput(audio_in, num_samples);
@@ -43,6 +43,9 @@ namespace vital {
       void processWithInput(const poly_float* audio_in, int num_samples) override;
       Processor* clone() const override { return new PhaserModule(*this); }
 
+      // Seconds the feedback takes to fall below threshold once the input stopped.
+      mono_float getTailTime(mono_float threshold) const;
+
     protected:
       const Output* beats_per_second_;
       Phaser* phaser_;
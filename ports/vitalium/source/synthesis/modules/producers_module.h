@@ -59,6 +59,10 @@ namespace vital {
         return oscillators_[index]->getWavetable();
       }
 
+      SpectralMorphCache* getSpectralMorphCache(int index) {
+        return oscillators_[index]->oscillator()->getSpectralMorphCache();
+      }
+
       Sample* getSample() { return sampler_->getSample(); }
       Output* samplePhaseOutput() { return sampler_->getPhaseOutput(); }
       void setFilter1On(const Value* on) { filter1_on_ = on; }
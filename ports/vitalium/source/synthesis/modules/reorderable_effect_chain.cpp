@@ -29,6 +29,13 @@
 
 namespace vital {
 
+  namespace {
+    force_inline bool isQuiet(const poly_float* buffer, int num_samples) {
+      poly_float peak = utils::peak(buffer, num_samples);
+      return !poly_float::greaterThan(peak, ReorderableEffectChain::kSleepThreshold).anyMask();
+    }
+  } // namespace
+
   class FilterFxModule : public SynthModule {
     public:
       enum {
@@ -65,7 +72,7 @@ namespace vital {
 
   ReorderableEffectChain::ReorderableEffectChain(const Output* beats_per_second, const Output* keytrack) :
       vital::SynthModule(kNumInputs, 1), equalizer_memory_(nullptr),
-      beats_per_second_(beats_per_second), keytrack_(keytrack), last_order_(0.0f) {
+      beats_per_second_(beats_per_second), keytrack_(keytrack), last_order_(0.0f), skipped_effect_blocks_(0) {
     for (int i = 0; i < constants::kNumEffects; ++i) {
       SynthModule* effect_module = createEffectModule(i);
       VITAL_ASSERT(effect_module);
@@ -75,6 +82,9 @@ namespace vital {
       effects_on_[i] = createBaseControl(strings::kEffectOrder[i] + "_on");
       effects_[i] = effect_module;
       effect_order_[i] = i;
+      silent_samples_[i] = 0;
+      tail_samples_[i] = 0;
+      sleeping_[i] = false;
     }
 
     last_order_ = utils::encodeOrderToFloat(effect_order_, constants::kNumEffects);
@@ -108,6 +118,44 @@ namespace vital {
     }
   }
 
+  int ReorderableEffectChain::getTailSamples(int index) const {
+    // How long the effect keeps sounding after its input went quiet at the current settings, the
+    // output level doesn't tell as the dry/wet mix can hide a ringing memory.
+    mono_float tail = 0.0f;
+    switch(index) {
+      case constants::kChorus:
+        tail = static_cast<const ChorusModule*>(effects_[index])->getTailTime(kSleepThreshold);
+        break;
+      case constants::kCompressor:
+        tail = static_cast<const CompressorModule*>(effects_[index])->getTailTime(kSleepThreshold);
+        break;
+      case constants::kDelay:
+        tail = static_cast<const DelayModule*>(effects_[index])->getTailTime(kSleepThreshold);
+        break;
+      case constants::kFlanger:
+        tail = static_cast<const FlangerModule*>(effects_[index])->getTailTime(kSleepThreshold);
+        break;
+      case constants::kPhaser:
+        tail = static_cast<const PhaserModule*>(effects_[index])->getTailTime(kSleepThreshold);
+        break;
+      case constants::kReverb:
+        tail = static_cast<const ReverbModule*>(effects_[index])->getTailTime(kSleepThreshold);
+        break;
+      default:
+        break;
+    }
+
+    if (!(tail < kMaxTailTime))
+      return kNeverSleeps;
+    return (kMinTailTime + tail) * getSampleRate();
+  }
+
+  void ReorderableEffectChain::wakeEffect(int index) {
+    silent_samples_[index] = 0;
+    tail_samples_[index] = 0;
+    sleeping_[index] = false;
+  }
+
   void ReorderableEffectChain::process(int num_samples) {
     const poly_float* audio_in = input(kAudio)->source->buffer;
     processWithInput(audio_in, num_samples);
@@ -125,12 +173,41 @@ namespace vital {
       int index = effect_order_[i];
       bool on = effects_on_[index]->value();
       bool enabled = effects_[index]->enabled();
-      if (on != enabled)
+      if (on != enabled) {
         effects_[index]->enable(on);
+        wakeEffect(index);
+      }
+
+      if (!on)
+        continue;
 
-      if (on) {
-        effects_[index]->processWithInput(audio_in, num_samples);
-        audio_in = effects_[index]->output(0)->buffer;
+      bool quiet_input = isQuiet(audio_in, num_samples);
+      if (!quiet_input)
+        wakeEffect(index);
+
+      // A sleeping effect lets its quiet input through, its state has decayed so it picks up
+      // again without a click. The equalizer display still follows the audio.
+      if (sleeping_[index]) {
+        if (index == constants::kEq)
+          static_cast<EqualizerModule*>(effects_[index])->pushAudioMemory(audio_in, num_samples);
+        skipped_effect_blocks_++;
+        continue;
+      }
+
+      effects_[index]->processWithInput(audio_in, num_samples);
+      audio_in = effects_[index]->output(0)->buffer;
+
+      // The longest tail since the input went quiet counts, settings can change during it. A tail
+      // too long to wait for starts over once the settings allow a shorter one.
+      if (quiet_input) {
+        int tail_samples = getTailSamples(index);
+        if (tail_samples == kNeverSleeps)
+          wakeEffect(index);
+        else {
+          tail_samples_[index] = std::max(tail_samples_[index], tail_samples);
+          silent_samples_[index] += num_samples;
+          sleeping_[index] = silent_samples_[index] >= tail_samples_[index];
+        }
       }
     }
 
@@ -139,8 +216,10 @@ namespace vital {
   }
 
   void ReorderableEffectChain::hardReset() {
-    for (int i = 0; i < constants::kNumEffects; ++i)
+    for (int i = 0; i < constants::kNumEffects; ++i) {
       effects_[i]->hardReset();
+      wakeEffect(i);
+    }
   }
 
   void ReorderableEffectChain::correctToTime(double seconds) {
@@ -32,6 +32,14 @@ namespace vital {
         kNumInputs
       };
 
+      // Effects go to sleep once their input stayed below this for their whole tail. The tail comes
+      // from the effect's decay and feedback settings, effects with a longer tail than kMaxTailTime
+      // never sleep.
+      static constexpr mono_float kSleepThreshold = 0.00001f;
+      static constexpr mono_float kMinTailTime = 0.1f;
+      static constexpr mono_float kMaxTailTime = 600.0f;
+      static constexpr int kNeverSleeps = -1;
+
       ReorderableEffectChain(const Output* beats_per_second, const Output* keytrack);
 
       virtual void process(int num_samples) override;
@@ -43,9 +51,13 @@ namespace vital {
 
       SynthModule* getEffect(constants::Effect effect) { return effects_[effect]; }
       const StereoMemory* getEqualizerMemory() { return equalizer_memory_; }
+      bool isEffectSleeping(constants::Effect effect) const { return sleeping_[effect]; }
+      long long getNumSkippedEffectBlocks() const { return skipped_effect_blocks_; }
 
     protected:
       SynthModule* createEffectModule(int index);
+      int getTailSamples(int index) const;
+      void wakeEffect(int index);
 
       const StereoMemory* equalizer_memory_;
       const Output* beats_per_second_;
@@ -55,6 +67,11 @@ namespace vital {
       int effect_order_[constants::kNumEffects];
       float last_order_;
 
+      int silent_samples_[constants::kNumEffects];
+      int tail_samples_[constants::kNumEffects];
+      bool sleeping_[constants::kNumEffects];
+      long long skipped_effect_blocks_;
+
       JUCE_LEAK_DETECTOR(ReorderableEffectChain)
   };
 } // namespace vital
@@ -75,6 +75,10 @@ namespace vital {
     reverb_->setSampleRate(sample_rate);
   }
 
+  mono_float ReverbModule::getTailTime(mono_float threshold) const {
+    return reverb_->getTailTime(threshold);
+  }
+
   void ReverbModule::processWithInput(const poly_float* audio_in, int num_samples) {
     SynthModule::process(num_samples);
     reverb_->processWithInput(audio_in, num_samples);
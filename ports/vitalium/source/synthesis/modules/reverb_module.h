@@ -36,6 +36,8 @@ namespace vital {
       void processWithInput(const poly_float* audio_in, int num_samples) override;
       Processor* clone() const override { return new ReverbModule(*this); }
 
+      mono_float getTailTime(mono_float threshold) const;
+
     protected:
       Reverb* reverb_;
 
@@ -21,6 +21,8 @@
 #include "matrix.h"
 #include "wavetable.h"
 
+#include "JucePluginCpuDispatch.h"
+
 #include <climits>
 
 namespace vital {
@@ -561,6 +563,7 @@ namespace vital {
     resetWavetableBuffers();
 
     fourier_transform_ = std::make_shared<FourierTransform>(kWaveformBits);
+    spectral_morph_cache_ = std::make_shared<SpectralMorphCache>();
     phase_inc_buffer_ = std::make_shared<Output>();
     phase_buffer_ = std::make_shared<PhaseBuffer>();
     voice_block_.phase_inc_buffer = phase_inc_buffer_->buffer;
@@ -790,8 +793,16 @@ namespace vital {
       int last_harmonic = std::max<int>(0, WaveFrame::kWaveformSize * futils::exp2(-bin_shift));
       last_harmonic = std::min(last_harmonic, WaveFrame::kWaveformSize / 2);
 
-      spectralMorph(wavetable_data, table_index, fourier_buffer,
-                    fourier_transform_.get(), shift, last_harmonic, RandomValues::instance()->buffer());
+      SpectralMorphCache::Key key = { wavetable_->getRevision(), table_index, voice_block_.spectral_morph,
+                                      shift, last_harmonic };
+      if (!spectral_morph_cache_->load(key, fourier_buffer)) {
+        // The inverse transform reads the Nyquist bin even when the morph doesn't write it, and it
+        // still holds the wrap of the last waveform. Clear it so cached results match.
+        fourier_buffer[Wavetable::kWaveformSize / poly_float::kSize + 1] = 0.0f;
+        spectralMorph(wavetable_data, table_index, fourier_buffer,
+                      fourier_transform_.get(), shift, last_harmonic, RandomValues::instance()->buffer());
+        spectral_morph_cache_->store(key, fourier_buffer);
+      }
       wave_buffers_[buffer_index] = ((mono_float*)fourier_buffer) + poly_float::kSize - 1;
 
       if (i == index && morph_amount[i] == morph_amount[i + 1] && wave_index[i] == wave_index[i + 1]) {
@@ -1335,6 +1346,8 @@ namespace vital {
     }
   }
 
+  // the per-sample pitch loops, compiled once per CPU level with cpu-dispatch
+  JUCE_PLUGIN_CPU_DISPATCH_CLONES
   void SynthOscillator::setPhaseIncBuffer(int num_samples, poly_mask reset_mask, 
                                           poly_int trigger_sample, poly_mask active_mask) {
     int transpose_quantize = static_cast<int>(input(kTransposeQuantize)->at(0)[0]);
@@ -1437,8 +1450,10 @@ namespace vital {
     processBlend(num_samples, reset_mask);
   }
 
+  // the unison voice loops, one set of clones per distortion type with cpu-dispatch
   template<poly_int(*phaseDistort)(poly_int, poly_float, poly_int, const poly_float*, int),
            poly_float(*window)(poly_int, poly_int, poly_float, const poly_float*, int)>
+  JUCE_PLUGIN_CPU_DISPATCH_CLONES
   void SynthOscillator::processChunk(poly_float current_center_amplitude, poly_float current_detuned_amplitude) {
     int active_channels = input(kActiveVoices)->at(0).sum();
     if (active_channels < 2)
@@ -1506,6 +1521,8 @@ namespace vital {
       phases_[0] = center_phase;
   }
 
+  // stereo spread and level loops, inlined here for cpu-dispatch
+  JUCE_PLUGIN_CPU_DISPATCH_CLONES
   void SynthOscillator::processBlend(int num_samples, poly_mask reset_mask) {
     poly_float* audio_out = output(kRaw)->buffer;
     stereoBlend(audio_out, num_samples, reset_mask);
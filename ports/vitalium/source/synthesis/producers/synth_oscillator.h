@@ -55,6 +55,93 @@ namespace vital {
       std::unique_ptr<poly_float[]> data_;
   };
 
+  // Holds the last few spectral morph results of an oscillator. It's shared between all voice
+  // clones of the oscillator, so voices playing the same frame with the same morph settings
+  // only pay for the inverse FFT once. Only used from the audio thread.
+  class SpectralMorphCache {
+    public:
+      static constexpr int kNumEntries = 16;
+      static constexpr int kBufferSize = Wavetable::kWaveformSize / poly_float::kSize + 2;
+
+      struct Key {
+        bool operator==(const Key& other) const {
+          return revision == other.revision && frame == other.frame && morph_type == other.morph_type &&
+                 amount == other.amount && last_harmonic == other.last_harmonic;
+        }
+
+        int revision;
+        int frame;
+        int morph_type;
+        float amount;
+        int last_harmonic;
+      };
+
+      SpectralMorphCache() : enabled_(true), next_entry_(0), lookups_(0), hits_(0) {
+        entries_ = std::make_unique<Entry[]>(kNumEntries);
+        for (int i = 0; i < kNumEntries; ++i)
+          entries_[i].valid = false;
+      }
+
+      bool load(const Key& key, poly_float* dest) {
+        if (!enabled_)
+          return false;
+
+        lookups_.fetch_add(1, std::memory_order_relaxed);
+        for (int i = 0; i < kNumEntries; ++i) {
+          if (entries_[i].valid && entries_[i].key == key) {
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            memcpy(dest, entries_[i].buffer, kBufferSize * sizeof(poly_float));
+            return true;
+          }
+        }
+        return false;
+      }
+
+      void store(const Key& key, const poly_float* source) {
+        if (!enabled_)
+          return;
+
+        Entry& entry = entries_[next_entry_];
+        next_entry_ = (next_entry_ + 1) % kNumEntries;
+
+        entry.key = key;
+        entry.valid = true;
+        memcpy(entry.buffer, source, kBufferSize * sizeof(poly_float));
+      }
+
+      float getHitRate() const {
+        long long lookups = lookups_.load(std::memory_order_relaxed);
+        if (lookups == 0)
+          return 0.0f;
+        return hits_.load(std::memory_order_relaxed) / (1.0f * lookups);
+      }
+
+      void resetStats() {
+        lookups_.store(0, std::memory_order_relaxed);
+        hits_.store(0, std::memory_order_relaxed);
+      }
+
+      // For comparing against the uncached morph. Call it with processing paused.
+      void setEnabled(bool enabled) {
+        enabled_ = enabled;
+        for (int i = 0; i < kNumEntries; ++i)
+          entries_[i].valid = false;
+      }
+
+    private:
+      struct Entry {
+        Key key;
+        bool valid;
+        poly_float buffer[kBufferSize];
+      };
+
+      std::unique_ptr<Entry[]> entries_;
+      bool enabled_;
+      int next_entry_;
+      std::atomic<long long> lookups_;
+      std::atomic<long long> hits_;
+  };
+
   class SynthOscillator : public Processor {
     public:
       enum {
@@ -220,6 +307,8 @@ namespace vital {
       void setSecondOscillatorOutput(Output* oscillator) { second_mod_oscillator_ = oscillator; }
       void setSampleOutput(Output* sample) { sample_ = sample; }
 
+      SpectralMorphCache* getSpectralMorphCache() { return spectral_morph_cache_.get(); }
+
       virtual void setOversampleAmount(int oversample) override {
         Processor::setOversampleAmount(oversample);
         phase_inc_buffer_->ensureBufferSize(oversample * kMaxBufferSize);
@@ -312,6 +401,7 @@ namespace vital {
       poly_float fourier_frames1_[kNumBuffers + 1][kSpectralBufferSize];
       poly_float fourier_frames2_[kNumBuffers + 1][kSpectralBufferSize];
       std::shared_ptr<FourierTransform> fourier_transform_;
+      std::shared_ptr<SpectralMorphCache> spectral_morph_cache_;
       std::shared_ptr<Output> phase_inc_buffer_;
       std::shared_ptr<PhaseBuffer> phase_buffer_;
 
@@ -137,6 +137,7 @@ namespace vital {
   }
 
   void SoundEngine::connectModulation(const modulation_change& change) {
+    releaseVoiceOutputArena();
     change.modulation_processor->plug(change.source, ModulationConnectionProcessor::kModulationInput);
     change.modulation_processor->setDestinationScale(change.destination_scale);
     VITAL_ASSERT(vital::utils::isFinite(change.destination_scale));
@@ -172,6 +173,7 @@ namespace vital {
   }
 
   void SoundEngine::disconnectModulation(const modulation_change& change) {
+    releaseVoiceOutputArena();
     change.modulation_processor->setDestinationScale(0.0f);
 
     Processor* destination = change.mono_destination;
@@ -203,6 +205,38 @@ namespace vital {
     return voice_handler_->getNumActiveVoices();
   }
 
+  ProcessorRouter::OutputMemoryStats SoundEngine::getVoiceOutputMemoryStats() const {
+    return voice_handler_->getVoiceOutputMemoryStats();
+  }
+
+  bool SoundEngine::isVoiceOutputArenaStale() const {
+    return voice_handler_->isVoiceOutputArenaStale();
+  }
+
+  void SoundEngine::updateVoiceOutputArena() {
+    std::set<const Output*> external_outputs;
+    collectInputSources(external_outputs);
+    collectDirectlyReadOutputs(external_outputs);
+
+    // Enabled connections are also run from process() when no voice is active.
+    ModulationConnectionBank& modulation_bank = getModulationBank();
+    for (int i = 0; i < modulation_bank.numConnections(); ++i) {
+      ModulationConnectionProcessor* processor = modulation_bank.atIndex(i)->modulation_processor.get();
+      for (int o = 0; o < processor->numOutputs(); ++o)
+        external_outputs.insert(processor->output(o));
+    }
+
+    voice_handler_->applyVoiceOutputArena(external_outputs);
+  }
+
+  void SoundEngine::releaseVoiceOutputArena() {
+    voice_handler_->releaseVoiceOutputArena();
+  }
+
+  long long SoundEngine::getNumSkippedEffectBlocks() const {
+    return effect_chain_->getNumSkippedEffectBlocks();
+  }
+
   ModulationConnectionBank& SoundEngine::getModulationBank() {
     return voice_handler_->getModulationBank();
   }
@@ -232,6 +266,7 @@ namespace vital {
       sample_rate_mult >>= 1;
       oversample >>= 1;
     }
+    releaseVoiceOutputArena();
     voice_handler_->setOversampleAmount(oversample);
     effect_chain_->setOversampleAmount(oversample);
     output_total_->setOversampleAmount(oversample);
@@ -355,6 +390,10 @@ namespace vital {
     return voice_handler_->getWavetable(index);
   }
 
+  SpectralMorphCache* SoundEngine::getSpectralMorphCache(int index) {
+    return voice_handler_->getSpectralMorphCache(index);
+  }
+
   Sample* SoundEngine::getSample() {
     return voice_handler_->getSample();
   }
@@ -30,6 +30,7 @@ namespace vital {
   class ReorderableEffectChain;
   class StereoMemory;
   class SynthVoiceHandler;
+  class SpectralMorphCache;
   class SynthLfo;
   class Value;
   class ValueSwitch;
@@ -52,6 +53,14 @@ namespace vital {
       void connectModulation(const modulation_change& change);
       void disconnectModulation(const modulation_change& change);
       int getNumActiveVoices();
+      ProcessorRouter::OutputMemoryStats getVoiceOutputMemoryStats() const;
+      bool isVoiceOutputArenaStale() const;
+
+      // Pools the intermediate buffers of the voice graph. Allocates, so call it with processing
+      // paused. Modulation changes release the arena until it's planned again on the next load.
+      void updateVoiceOutputArena();
+      void releaseVoiceOutputArena();
+      long long getNumSkippedEffectBlocks() const;
       ModulationConnectionBank& getModulationBank();
       mono_float getLastActiveNote() const;
 
@@ -81,6 +90,7 @@ namespace vital {
       void setChannelSlide(int channel, mono_float value, int sample);
       void setChannelRangeSlide(int from_channel, int to_channel, mono_float value, int sample);
       Wavetable* getWavetable(int index);
+      SpectralMorphCache* getSpectralMorphCache(int index);
       Sample* getSample();
       LineGenerator* getLfoSource(int index);
 